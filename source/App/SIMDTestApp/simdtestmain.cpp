@@ -0,0 +1,323 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     simdtestmain.cpp
+    \brief    Compares the x86 SIMD distortion functions of TComRdCost with the C functions
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <limits>
+
+#include "TLibCommon/TComRdCost.h"
+#ifdef TARGET_SIMD_X86
+#include "TLibCommon/x86/CommonDefX86.h"
+#endif
+
+//! \ingroup SIMDTestApp
+//! \{
+
+#if ENABLE_SIMD_OPT_DIST
+
+static const Int NUM_TESTS_PER_FUNCTION = 200;
+static const Int MAX_NUM_CANDIDATES     = 9;
+static const Int CUR_STRIDE             = 128;
+static const Int CUR_HEIGHT             = MAX_CU_SIZE + 16;
+
+enum DistKind
+{
+  DIST_SSE,
+  DIST_SAD,
+  DIST_HAD
+};
+
+struct DistFuncEntry
+{
+  DFunc       eDFunc;
+  const TChar *name;
+  DistKind    kind;
+  Int         width;     ///< number of columns the function is specialised for, 0: any width
+  Bool        multiple;  ///< width is a multiple of 16
+};
+
+static const DistFuncEntry s_distFuncs[] =
+{
+  { DF_SSE,     "SSE",     DIST_SSE,  0, false },
+  { DF_SSE4,    "SSE4",    DIST_SSE,  4, false },
+  { DF_SSE8,    "SSE8",    DIST_SSE,  8, false },
+  { DF_SSE16,   "SSE16",   DIST_SSE, 16, false },
+  { DF_SSE32,   "SSE32",   DIST_SSE, 32, false },
+  { DF_SSE64,   "SSE64",   DIST_SSE, 64, false },
+  { DF_SSE16N,  "SSE16N",  DIST_SSE, 16, true  },
+  { DF_SAD,     "SAD",     DIST_SAD,  0, false },
+  { DF_SAD4,    "SAD4",    DIST_SAD,  4, false },
+  { DF_SAD8,    "SAD8",    DIST_SAD,  8, false },
+  { DF_SAD16,   "SAD16",   DIST_SAD, 16, false },
+  { DF_SAD32,   "SAD32",   DIST_SAD, 32, false },
+  { DF_SAD64,   "SAD64",   DIST_SAD, 64, false },
+  { DF_SAD16N,  "SAD16N",  DIST_SAD, 16, true  },
+  { DF_SADS,    "SADS",    DIST_SAD,  0, false },
+  { DF_SADS4,   "SADS4",   DIST_SAD,  4, false },
+  { DF_SADS8,   "SADS8",   DIST_SAD,  8, false },
+  { DF_SADS16,  "SADS16",  DIST_SAD, 16, false },
+  { DF_SADS32,  "SADS32",  DIST_SAD, 32, false },
+  { DF_SADS64,  "SADS64",  DIST_SAD, 64, false },
+  { DF_SADS16N, "SADS16N", DIST_SAD, 16, true  },
+  { DF_SAD12,   "SAD12",   DIST_SAD, 12, false },
+  { DF_SAD24,   "SAD24",   DIST_SAD, 24, false },
+  { DF_SAD48,   "SAD48",   DIST_SAD, 48, false },
+  { DF_SADS12,  "SADS12",  DIST_SAD, 12, false },
+  { DF_SADS24,  "SADS24",  DIST_SAD, 24, false },
+  { DF_SADS48,  "SADS48",  DIST_SAD, 48, false },
+  { DF_HADS,    "HADS",    DIST_HAD,  0, false },
+  { DF_HADS4,   "HADS4",   DIST_HAD,  4, false },
+  { DF_HADS8,   "HADS8",   DIST_HAD,  8, false },
+  { DF_HADS16,  "HADS16",  DIST_HAD, 16, false },
+  { DF_HADS32,  "HADS32",  DIST_HAD, 32, false },
+  { DF_HADS64,  "HADS64",  DIST_HAD, 64, false },
+  { DF_HADS16N, "HADS16N", DIST_HAD, 16, true  },
+};
+
+static Int xRandom( std::mt19937 &rng, Int minVal, Int maxVal )
+{
+  return std::uniform_int_distribution<Int>( minVal, maxVal )( rng );
+}
+
+/** Fills a block with samples of the given bit depth.
+ * Besides uniformly distributed samples, blocks with only the extreme values and blocks close to a reference block
+ * are produced, which give the largest and the smallest differences.
+ */
+static Void xFillBlock( std::mt19937 &rng, Pel *pBlock, Int stride, Int width, Int height, Int bitDepth, Int mode, const Pel *pRef, Int refStride )
+{
+  const Int maxVal = ( 1 << bitDepth ) - 1;
+  for( Int y = 0; y < height; y++ )
+  {
+    for( Int x = 0; x < width; x++ )
+    {
+      Int val;
+      switch( mode )
+      {
+      case 0:
+        val = xRandom( rng, 0, maxVal );
+        break;
+      case 1:
+        val = xRandom( rng, 0, 1 ) ? maxVal : 0;
+        break;
+      default:
+        val = Clip3( 0, maxVal, pRef[y * refStride + x] + xRandom( rng, -4, 4 ) );
+        break;
+      }
+      pBlock[y * stride + x] = Pel( val );
+    }
+  }
+}
+
+/** Picks the block size and vertical subsampling a distortion function may be called with. */
+static Void xPickBlockSize( std::mt19937 &rng, const DistFuncEntry &entry, Int &width, Int &height, Int &subShift )
+{
+  if( entry.multiple )
+  {
+    width = entry.width * xRandom( rng, 1, MAX_CU_SIZE / entry.width );
+  }
+  else if( entry.width )
+  {
+    width = entry.width;
+  }
+  else
+  {
+    // the general C SAD handles multiples of 4 columns, the Hadamard functions multiples of 2
+    switch( entry.kind )
+    {
+    case DIST_SSE:
+      width = xRandom( rng, 1, MAX_CU_SIZE );
+      break;
+    case DIST_SAD:
+      width = 4 * xRandom( rng, 1, MAX_CU_SIZE / 4 );
+      break;
+    default:
+      width = 2 * xRandom( rng, 1, MAX_CU_SIZE / 2 );
+      break;
+    }
+  }
+
+  subShift = 0;
+  if( entry.kind == DIST_HAD )
+  {
+    // the Hadamard functions work on 8x8, 4x4 or 2x2 blocks
+    const Int unit = ( width % 8 == 0 ) ? 8 : ( width % 4 == 0 ? 4 : 2 );
+    height = unit * xRandom( rng, 1, MAX_CU_SIZE / unit );
+  }
+  else if( entry.kind == DIST_SAD && entry.width )
+  {
+    subShift = xRandom( rng, 0, 2 );
+    height   = ( 1 << subShift ) * xRandom( rng, 1, MAX_CU_SIZE >> subShift );
+  }
+  else
+  {
+    height = xRandom( rng, 1, MAX_CU_SIZE );
+  }
+}
+
+/** Runs the distortion functions of the SIMD table against those of the C table.
+ * Returns the number of mismatches.
+ */
+static Int xTestDistFuncs( const TComRdCost &cRdCostC, const TComRdCost &cRdCostSimd, const TChar *extensionName, std::mt19937 &rng )
+{
+  std::vector<Pel> org( MAX_CU_SIZE * ( MAX_CU_SIZE + 16 ) );
+  std::vector<Pel> cur( CUR_STRIDE * CUR_HEIGHT + MAX_CU_SIZE );
+  Int numMismatches = 0;
+  Int numChecks     = 0;
+
+  for( Int bitDepth = 8; bitDepth <= 12; bitDepth++ )
+  {
+    for( UInt i = 0; i < sizeof( s_distFuncs ) / sizeof( s_distFuncs[0] ); i++ )
+    {
+      const DistFuncEntry &entry  = s_distFuncs[i];
+      FpDistFunc      distFuncC   = cRdCostC.getDistFunc( entry.eDFunc );
+      FpDistFunc      distFunc    = cRdCostSimd.getDistFunc( entry.eDFunc );
+      FpMultiDistFunc multiFunc   = cRdCostSimd.getMultiDistFunc( entry.eDFunc );
+
+      for( Int test = 0; test < NUM_TESTS_PER_FUNCTION; test++ )
+      {
+        Int width, height, subShift;
+        xPickBlockSize( rng, entry, width, height, subShift );
+
+        const Int mode      = xRandom( rng, 0, 2 );
+        const Int strideOrg = width + xRandom( rng, 0, 16 );
+        const Int maxOffset = CUR_STRIDE - width;
+
+        xFillBlock( rng, &cur[0], CUR_STRIDE, CUR_STRIDE, CUR_HEIGHT, bitDepth, mode == 2 ? 0 : mode, NULL, 0 );
+        const Int  refOffset = xRandom( rng, 0, 16 ) * CUR_STRIDE + xRandom( rng, 0, maxOffset );
+        xFillBlock( rng, &org[0], strideOrg, width, height, bitDepth, mode, &cur[refOffset], CUR_STRIDE );
+
+        DistParam cDtParam;
+        cDtParam.pOrg       = &org[0];
+        cDtParam.pCur       = &cur[refOffset];
+        cDtParam.iStrideOrg = strideOrg;
+        cDtParam.iStrideCur = CUR_STRIDE;
+        cDtParam.iRows      = height;
+        cDtParam.iCols      = width;
+        cDtParam.iStep      = 1;
+        cDtParam.bitDepth   = bitDepth;
+        cDtParam.iSubShift  = subShift;
+        cDtParam.compIdx    = COMPONENT_Y;
+        if( entry.kind == DIST_SAD && xRandom( rng, 0, 1 ) )
+        {
+          // early termination only returns a value above the threshold, which may differ between implementations
+          cDtParam.m_maximumDistortionForEarlyExit = Distortion( xRandom( rng, 0, width * height * ( 1 << ( bitDepth - 2 ) ) ) );
+        }
+
+        cDtParam.DistFunc            = distFuncC;
+        const Distortion distC       = distFuncC( &cDtParam );
+        cDtParam.DistFunc            = distFunc;
+        const Distortion distSimd    = distFunc( &cDtParam );
+        const Distortion maxDist     = cDtParam.m_maximumDistortionForEarlyExit;
+
+        numChecks++;
+        if( distC != distSimd && ( distC <= maxDist || distSimd <= maxDist ) )
+        {
+          printf( "%s %s mismatch: %dx%d, %d bit, subsampling %d: C %llu, SIMD %llu\n", extensionName, entry.name, width, height,
+                  bitDepth, subShift, (unsigned long long)distC, (unsigned long long)distSimd );
+          numMismatches++;
+        }
+
+        if( multiFunc != NULL )
+        {
+          const Int   numCand = xRandom( rng, 1, MAX_NUM_CANDIDATES );
+          const Pel  *ppCur[MAX_NUM_CANDIDATES];
+          Distortion  puiDist[MAX_NUM_CANDIDATES];
+
+          cDtParam.m_maximumDistortionForEarlyExit = std::numeric_limits<Distortion>::max();
+          for( Int cand = 0; cand < numCand; cand++ )
+          {
+            ppCur[cand] = &cur[xRandom( rng, 0, 16 ) * CUR_STRIDE + xRandom( rng, 0, maxOffset )];
+          }
+          multiFunc( &cDtParam, ppCur, numCand, puiDist );
+
+          for( Int cand = 0; cand < numCand; cand++ )
+          {
+            cDtParam.pCur = ppCur[cand];
+            const Distortion distCand = distFuncC( &cDtParam );
+            numChecks++;
+            if( distCand != puiDist[cand] )
+            {
+              printf( "%s %s multi mismatch: %dx%d, %d bit, subsampling %d, candidate %d of %d: C %llu, SIMD %llu\n", extensionName, entry.name,
+                      width, height, bitDepth, subShift, cand, numCand, (unsigned long long)distCand, (unsigned long long)puiDist[cand] );
+              numMismatches++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  printf( "%-7s %d checks, %d mismatches\n", extensionName, numChecks, numMismatches );
+  return numMismatches;
+}
+
+#endif
+
+// ====================================================================================================================
+// Main function
+// ====================================================================================================================
+
+int main()
+{
+#if ENABLE_SIMD_OPT_DIST
+  const X86_VEXT detected = read_x86_extension_flags();
+  printf( "SIMD distortion function test, CPU supports %s\n", getX86ExtensionName( detected ) );
+
+  // the C functions are the ones installed when no extension may be used
+  read_x86_extension_flags( getX86ExtensionName( SCALAR ) );
+  const TComRdCost cRdCostC;
+
+  std::mt19937 rng( 1 );
+  Int numMismatches = 0;
+  for( Int vext = SSE41; vext <= detected; vext++ )
+  {
+    read_x86_extension_flags( getX86ExtensionName( X86_VEXT( vext ) ) );
+    const TComRdCost cRdCostSimd;
+    numMismatches += xTestDistFuncs( cRdCostC, cRdCostSimd, getX86ExtensionName( X86_VEXT( vext ) ), rng );
+  }
+
+  return numMismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+#else
+  printf( "SIMD distortion functions are disabled in this build\n" );
+  return EXIT_SUCCESS;
+#endif
+}
+
+//! \}
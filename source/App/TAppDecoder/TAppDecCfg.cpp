@@ -101,6 +101,8 @@ Bool TAppDecCfg::parseCfg( Int argc, TChar* argv[] )
 #if MCTS_ENC_CHECK
   ("TMCTSCheck",                  m_tmctsCheck,                          false,    "If enabled, the decoder checks for violations of mc_exact_sample_value_match_flag in Temporal MCTS ")
 #endif
+  ("Threads",                   m_numThreads,                          1,          "Number of worker threads used to decode tiles and WaveFrontSynchro CTU rows and to deblock CTU rows in parallel (1: single-threaded)")
+  ("PipelinedFiltering",        m_pipelinedFiltering,                  false,      "Run deblocking and SAO a few CTU rows behind the reconstruction on a separate thread, and check the decoded picture hash while the next picture is decoded")
   ;
 
   po::setDefaults(opts);
@@ -140,6 +142,12 @@ Bool TAppDecCfg::parseCfg( Int argc, TChar* argv[] )
     return false;
   }
 
+  if (m_numThreads < 1)
+  {
+    fprintf(stderr, "Threads must be at least 1\n");
+    return false;
+  }
+
   if ( !cfg_TargetDecLayerIdSetFile.empty() )
   {
     FILE* targetDecLayerIdSetFile = fopen ( cfg_TargetDecLayerIdSetFile.c_str(), "r" );
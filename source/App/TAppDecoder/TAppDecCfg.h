@@ -83,6 +83,8 @@ protected:
 #if MCTS_ENC_CHECK
   Bool          m_tmctsCheck;
 #endif
+  Int           m_numThreads;                         ///< number of worker threads for parallel substream decoding
+  Bool          m_pipelinedFiltering;                 ///< in-loop filtering follows the reconstruction on a separate thread
 
 public:
   TAppDecCfg()
@@ -112,6 +114,8 @@ public:
 #if MCTS_ENC_CHECK
   , m_tmctsCheck(false)
 #endif
+  , m_numThreads(1)
+  , m_pipelinedFiltering(false)
   {
     for (UInt channelTypeIndex = 0; channelTypeIndex < MAX_NUM_CHANNEL_TYPE; channelTypeIndex++)
     {
@@ -160,10 +160,8 @@ Void TAppDecTop::decode()
      * nal unit. */
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
     TComCodingStatistics::TComCodingStatisticsData backupStats(TComCodingStatistics::GetStatistics());
-    streampos location = bitstreamFile.tellg() - streampos(bytestream.GetNumBufferedBytes());
-#else
-    streampos location = bitstreamFile.tellg();
 #endif
+    streampos location = bytestream.getPosition();
     AnnexBStats stats = AnnexBStats();
 
     InputNALUnit nalu;
@@ -192,18 +190,10 @@ Void TAppDecTop::decode()
         bNewPicture = m_cTDecTop.decode(nalu, m_iSkipFrame, m_iPOCLastDisplay);
         if (bNewPicture)
         {
-          bitstreamFile.clear();
-          /* location points to the current nalunit payload[1] due to the
-           * need for the annexB parser to read three extra bytes.
-           * [1] except for the first NAL unit in the file
-           *     (but bNewPicture doesn't happen then) */
+          /* location points to the start code of the current nalunit */
+          bytestream.setPosition(location);
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
-          bitstreamFile.seekg(location);
-          bytestream.reset();
           TComCodingStatistics::SetStatistics(backupStats);
-#else
-          bitstreamFile.seekg(location-streamoff(3));
-          bytestream.reset();
 #endif
         }
       }
@@ -367,6 +357,8 @@ Void TAppDecTop::decode()
 Void TAppDecTop::xCreateDecLib()
 {
   // create decoder class
+  m_cTDecTop.setNumThreads(m_numThreads);
+  m_cTDecTop.setPipelinedFiltering(m_pipelinedFiltering);
   m_cTDecTop.create();
 }
 
@@ -649,6 +641,8 @@ Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
   {
     return;
   }
+  // the pictures are destroyed below
+  m_cTDecTop.waitForPictureHashes();
   TComList<TComPic*>::iterator iterPic   = pcListPic->begin();
 
   iterPic   = pcListPic->begin();
@@ -48,6 +48,9 @@
 #if DPB_ENCODER_USAGE_CHECK
 #include "TLibCommon/ProfileLevelTierFeatures.h"
 #endif
+#ifdef TARGET_SIMD_X86
+#include "TLibCommon/x86/CommonDefX86.h"
+#endif
 
 template <class T1, class T2>
 static inline std::istream& operator >> (std::istream &in, std::map<T1, T2> &map);
@@ -358,6 +361,43 @@ strToCostMode[] =
   {"mixed_lossless_lossy",      COST_MIXED_LOSSLESS_LOSSY_CODING}
 };
 
+//! encoder speed presets, from the fastest to the slowest
+static const TChar* presetNames[] =
+{
+  "ultrafast", "superfast", "veryfast", "faster", "fast", "medium", "slow", "slower", "veryslow", "placebo"
+};
+static const Int NUM_PRESETS = sizeof( presetNames ) / sizeof( presetNames[0] );
+
+//! options set by each preset (NULL: left unchanged)
+static const struct PresetOption
+{
+  const TChar* option;
+  const TChar* values[NUM_PRESETS];
+}
+presetOptions[] =
+{
+  // option                            ultrafast superfast veryfast faster  fast    medium  slow    slower  veryslow placebo
+  {"FastSearch",                    {  "1",      "1",      "1",     "1",    "1",    "1",    "1",    "1",    "1",     "3" }},
+  {"SearchRange",                   {  "16",     "24",     "32",    "48",   "64",   NULL,   NULL,   NULL,   NULL,    NULL}},
+  {"BipredSearchRange",             {  "1",      "2",      "4",     "4",    "4",    "4",    "4",    "4",    "8",     "8" }},
+  {"HadamardME",                    {  "0",      "0",      "1",     "1",    "1",    "1",    "1",    "1",    "1",     "1" }},
+  {"FEN",                           {  "1",      "1",      "1",     "1",    "1",    "1",    "0",    "0",    "0",     "0" }},
+  {"FDM",                           {  "1",      "1",      "1",     "1",    "1",    "1",    "1",    "0",    "0",     "0" }},
+  {"ECU",                           {  "1",      "1",      "1",     "0",    "0",    "0",    "0",    "0",    "0",     "0" }},
+  {"ESD",                           {  "1",      "1",      "1",     "1",    "1",    "0",    "0",    "0",    "0",     "0" }},
+  {"CFM",                           {  "1",      "1",      "1",     "0",    "0",    "0",    "0",    "0",    "0",     "0" }},
+  {"RDOQ",                          {  "0",      "1",      "1",     "1",    "1",    "1",    "1",    "1",    "1",     "1" }},
+  {"RDOQTS",                        {  "0",      "1",      "1",     "1",    "1",    "1",    "1",    "1",    "1",     "1" }},
+  {"AMP",                           {  "0",      "0",      "0",     "1",    "1",    "1",    "1",    "1",    "1",     "1" }},
+  {"TransformSkipFast",             {  "1",      "1",      "1",     "1",    "1",    "1",    "1",    "1",    "0",     "0" }},
+  {"FastMEForGenBLowDelayEnabled",  {  "1",      "1",      "1",     "1",    "1",    "1",    "1",    "0",    "0",     "0" }},
+  {"QuadtreeTUMaxDepthInter",       {  "1",      "1",      "2",     "2",    "3",    "3",    "3",    "3",    "3",     "3" }},
+  {"QuadtreeTUMaxDepthIntra",       {  "1",      "1",      "2",     "3",    "3",    "3",    "3",    "3",    "3",     "3" }},
+  {"PreMotionSearch",               {  "1",      "1",      "1",     "1",    "0",    "0",    "0",    "0",    "0",     "0" }},
+  {"MotionSearchCache",             {  "1",      "1",      "1",     "1",    "1",    "0",    "0",    "0",    "0",     "0" }},
+  {"CUSplitClassifier",             {  "2",      "2",      "2",     "1",    "0",    "0",    "0",    "0",    "0",     "0" }},
+};
+
 static const struct MapStrToScalingListMode
 {
   const TChar* str;
@@ -661,6 +701,30 @@ automaticallySelectRExtProfile(const Bool bUsingGeneralRExtTools,
     }
   }
 }
+/** Applies the options of a speed preset as if they were given at the position of the Preset option, so that
+ *  options following it override the preset.
+ */
+static Void applyPreset(po::Options &opts, const std::string &name, po::ErrorReporter &err)
+{
+  for( Int preset = 0; preset < NUM_PRESETS; preset++ )
+  {
+    if( name == presetNames[preset] )
+    {
+      std::stringstream options;
+      for( UInt i = 0; i < sizeof( presetOptions ) / sizeof( presetOptions[0] ); i++ )
+      {
+        if( presetOptions[i].values[preset] != NULL )
+        {
+          options << presetOptions[i].option << ": " << presetOptions[i].values[preset] << "\n";
+        }
+      }
+      po::parseConfigStream( opts, "Preset " + name, options, err );
+      return;
+    }
+  }
+  err.error( "Preset" ) << "unknown preset " << name << " (ultrafast, superfast, veryfast, faster, fast, medium, slow, slower, veryslow, placebo)\n";
+}
+
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
@@ -780,6 +844,7 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   opts.addOptions()
   ("help",                                            do_help,                                          false, "this help text")
   ("c",    po::parseConfigFile, "configuration file name")
+  ("Preset", applyPreset, "encoder speed preset (ultrafast, superfast, veryfast, faster, fast, medium, slow, slower, veryslow, placebo), overriding the fast encoder options given before it")
   ("WarnUnknowParameter,w",                           warnUnknowParameter,                                  0, "warn for unknown configuration parameters instead of failing")
 
   // File, I/O and source parameters
@@ -834,6 +899,9 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   ("SummaryOutFilename",                              m_summaryOutFilename,                          string(), "Filename to use for producing summary output file. If empty, do not produce a file.")
   ("SummaryPicFilenameBase",                          m_summaryPicFilenameBase,                      string(), "Base filename to use for producing summary picture output files. The actual filenames used will have I.txt, P.txt and B.txt appended. If empty, do not produce a file.")
   ("SummaryVerboseness",                              m_summaryVerboseness,                                0u, "Specifies the level of the verboseness of the text output")
+#ifdef TARGET_SIMD_X86
+  ("SIMD",                                            m_simdExtension,                               string(""), "SIMD extension to use (SCALAR, SSE41, SSE42, AVX, AVX2, AVX512); default: the best supported by the CPU")
+#endif
 
   //Field coding parameters
   ("FieldCoding",                                     m_isField,                                        false, "Signals if it's a field based coding")
@@ -885,6 +953,9 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   ("RestrictMESampling",                              m_bRestrictMESampling,                            false, "Restrict ME Sampling for selective inter motion search")
   ("ClipForBiPredMEEnabled",                          m_bClipForBiPredMeEnabled,                        false, "Enables clipping in the Bi-Pred ME. It is disabled to reduce encoder run-time")
   ("FastMEAssumingSmootherMVEnabled",                 m_bFastMEAssumingSmootherMVEnabled,                true, "Enables fast ME assuming a smoother MV.")
+  ("PreMotionSearch",                                 m_bPreMotionSearchEnabled,                        false, "Enables a motion search on downsampled pictures whose vectors are used as start candidates of the fast integer ME")
+  ("SubPelPlanes",                                    m_bUseSubPelPlanes,                               false, "Interpolates each reference picture once into quarter-sample planes used by the fractional ME")
+  ("MotionSearchCache",                               m_bUseMotionSearchCache,                          false, "Uses the integer vectors found for the enclosing CUs of the CTU as start candidates of the fast integer ME")
 
   ("HadamardME",                                      m_bUseHADME,                                       true, "Hadamard ME for fractional-pel")
   ("ASR",                                             m_bUseASR,                                        false, "Adaptive motion search range");
@@ -1012,6 +1083,9 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   ("TileRowHeightArray",                              cfg_RowHeight,                            cfg_RowHeight, "Array containing tile row height values in units of CTU")
   ("LFCrossTileBoundaryFlag",                         m_bLFCrossTileBoundaryFlag,                        true, "1: cross-tile-boundary loop filtering. 0:non-cross-tile-boundary loop filtering")
   ("WaveFrontSynchro",                                m_entropyCodingSyncEnabledFlag,                   false, "0: entropy coding sync disabled; 1 entropy coding sync enabled")
+  ("Threads",                                         m_numThreads,                                         1, "Number of worker threads used to compress tiles, WaveFrontSynchro CTU rows and independent pictures and to deblock CTU rows in parallel (1: single-threaded). "
+                                                                                                               "The output does not depend on it; the TZ start vector is reset at each tile and WaveFrontSynchro CTU row for any value")
+  ("ParallelPictures",                                m_numParallelPictures,                                1, "Maximum number of consecutive pictures of a GOP, not referencing each other, that are compressed concurrently (1: disabled)")
   ("ScalingList",                                     m_useScalingListId,                    SCALING_LIST_OFF, "0/off: no scaling list, 1/default: default scaling lists, 2/file: scaling lists specified in ScalingListFile")
   ("ScalingListFile",                                 m_scalingListFileName,                       string(""), "Scaling list file name. Use an empty string to produce help.")
   ("SignHideFlag,-SBH",                               m_signDataHidingEnabledFlag,                                    true)
@@ -1028,6 +1102,9 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   ("FDM",                                             m_useFastDecisionForMerge,                         true, "Fast decision for Merge RD Cost")
   ("CFM",                                             m_bUseCbfFastMode,                                false, "Cbf fast mode setting")
   ("ESD",                                             m_useEarlySkipDetection,                          false, "Early SKIP detection setting")
+  ("CUSplitClassifier",                               m_cuSplitClassifier,                                  0, "Early CU split decisions from the CU variance, SATD and neighbour depths: 0: off, 1: early termination of the split, 2: early termination and early split")
+  ("CUSplitThresholdFile",                            m_cuSplitThresholdFileName,                    string(""), "File of the CUSplitClassifier thresholds, replacing the built-in ones")
+  ("CUSplitStatsFile",                                m_cuSplitStatsFileName,                        string(""), "Output file of the CU features and split decisions, from which CUSplitThresholdFile can be derived")
   ( "RateControl",                                    m_RCEnableRateControl,                            false, "Rate control: enable rate control" )
   ( "TargetBitrate",                                  m_RCTargetBitrate,                                    0, "Rate control: target bit-rate" )
   ( "KeepHierarchicalBit",                            m_RCKeepHierarchicalBit,                              0, "Rate control: 0: equal bit allocation; 1: fixed ratio bit allocation; 2: adaptive ratio bit allocation" )
@@ -2135,6 +2212,10 @@ Bool TAppEncCfg::parseCfg( Int argc, TChar* argv[] )
   // check validity of input parameters
   xCheckParameter();
 
+#ifdef TARGET_SIMD_X86
+  read_x86_extension_flags( m_simdExtension );
+#endif
+
   // compute actual CU depth with respect to config depth and max transform size
   UInt uiAddCUDepth  = 0;
   while( (m_uiMaxCUWidth>>m_uiMaxCUDepth) > ( 1 << ( m_uiQuadtreeTULog2MinSize + uiAddCUDepth )  ) )
@@ -2378,6 +2459,7 @@ Void TAppEncCfg::xCheckParameter()
   xConfirmPara( m_iSearchRange < 0 ,                                                        "Search Range must be more than 0" );
   xConfirmPara( m_bipredSearchRange < 0 ,                                                   "Bi-prediction refinement search range must be more than 0" );
   xConfirmPara( m_minSearchWindow < 0,                                                      "Minimum motion search window size for the adaptive window ME must be greater than or equal to 0" );
+  xConfirmPara( m_cuSplitClassifier < 0 || m_cuSplitClassifier > 2,                         "CUSplitClassifier must be 0, 1 or 2" );
   xConfirmPara( m_iMaxDeltaQP > 7,                                                          "Absolute Delta QP exceeds supported range (0 to 7)" );
   xConfirmPara(m_lumaLevelToDeltaQPMapping.mode &&  m_uiDeltaQpRD > 0, "Luma-level-based Delta QP cannot be used together with slice level multiple-QP optimization\n" );
   xConfirmPara( m_iMaxCuDQPDepth > m_uiMaxCUDepth - 1,                                          "Absolute depth for a minimum CuDQP exceeds maximum coding unit depth" );
@@ -2445,6 +2527,9 @@ Void TAppEncCfg::xCheckParameter()
   {
     xConfirmPara( tileFlag && m_entropyCodingSyncEnabledFlag, "Tiles and entropy-coding-sync (Wavefronts) can not be applied together, except in the High Throughput Intra 4:4:4 16 profile");
   }
+  xConfirmPara( m_numThreads < 1, "Threads must be at least 1");
+  xConfirmPara( m_numParallelPictures < 1, "ParallelPictures must be at least 1");
+  xConfirmPara( m_numParallelPictures > MAX_GOP, "ParallelPictures must not exceed the maximum GOP size");
 
   xConfirmPara( m_sourceWidth  % TComSPS::getWinUnitX(m_chromaFormatIDC) != 0, "Picture width must be an integer multiple of the specified chroma subsampling");
   xConfirmPara( m_sourceHeight % TComSPS::getWinUnitY(m_chromaFormatIDC) != 0, "Picture height must be an integer multiple of the specified chroma subsampling");
@@ -3196,6 +3281,9 @@ Void TAppEncCfg::xPrintParameter()
     printf("xPSNR Weights                          : (%8.3f, %8.3f, %8.3f)\n", m_dXPSNRWeight[COMPONENT_Y], m_dXPSNRWeight[COMPONENT_Cb], m_dXPSNRWeight[COMPONENT_Cr]);
   }
   printf("Cabac-zero-word-padding                : %s\n", (m_cabacZeroWordPaddingEnabled? "Enabled" : "Disabled") );
+#ifdef TARGET_SIMD_X86
+  printf("SIMD extension                         : %s\n", read_x86_extension() );
+#endif
   if (m_isField)
   {
     printf("Frame/Field                            : Field based coding\n");
@@ -3345,6 +3433,7 @@ Void TAppEncCfg::xPrintParameter()
   printf("FDM:%d ", m_useFastDecisionForMerge            );
   printf("CFM:%d ", m_bUseCbfFastMode                    );
   printf("ESD:%d ", m_useEarlySkipDetection              );
+  printf("CUSplitClassifier:%d ", m_cuSplitClassifier    );
   printf("RQT:%d ", 1                                    );
   printf("TransformSkip:%d ",     m_useTransformSkip     );
   printf("TransformSkipFast:%d ", m_useTransformSkipFast );
@@ -3377,6 +3466,7 @@ Void TAppEncCfg::xPrintParameter()
   printf("PME:%d ", m_log2ParallelMergeLevel);
   const Int iWaveFrontSubstreams = m_entropyCodingSyncEnabledFlag ? (m_sourceHeight + m_uiMaxCUHeight - 1) / m_uiMaxCUHeight : 1;
   printf(" WaveFrontSynchro:%d WaveFrontSubstreams:%d", m_entropyCodingSyncEnabledFlag?1:0, iWaveFrontSubstreams);
+  printf(" Threads:%d ParallelPictures:%d", m_numThreads, m_numParallelPictures);
   printf(" ScalingList:%d ", m_useScalingListId );
   printf("TMVPMode:%d ", m_TMVPModeId     );
 #if ADAPTIVE_QP_SELECTION
@@ -264,11 +264,17 @@ protected:
   Int       m_minSearchWindow;                                ///< ME minimum search window size for the Adaptive Window ME
   Bool      m_bClipForBiPredMeEnabled;                        ///< Enables clipping for Bi-Pred ME.
   Bool      m_bFastMEAssumingSmootherMVEnabled;               ///< Enables fast ME assuming a smoother MV.
+  Bool      m_bPreMotionSearchEnabled;                        ///< Enables start candidates of the integer ME from a motion search on downsampled pictures
+  Bool      m_bUseSubPelPlanes;                               ///< Enables the fractional ME on precomputed quarter-sample planes of the reference pictures
+  Bool      m_bUseMotionSearchCache;                          ///< Enables start candidates of the integer ME from the vectors found for the enclosing CUs
   FastInterSearchMode m_fastInterSearchMode;                  ///< Parameter that controls fast encoder settings
   Bool      m_bUseEarlyCU;                                    ///< flag for using Early CU setting
   Bool      m_useFastDecisionForMerge;                        ///< flag for using Fast Decision Merge RD-Cost
   Bool      m_bUseCbfFastMode;                                ///< flag for using Cbf Fast PU Mode Decision
   Bool      m_useEarlySkipDetection;                          ///< flag for using Early SKIP Detection
+  Int       m_cuSplitClassifier;                              ///< early CU split decisions: 0 off, 1 early termination, 2 early termination and early split
+  std::string m_cuSplitThresholdFileName;                     ///< thresholds of the early CU split decisions, replacing the built-in ones
+  std::string m_cuSplitStatsFileName;                         ///< output file of the CU features and split decisions used to derive the thresholds
   SliceConstraint m_sliceMode;
   Int             m_sliceArgument;                            ///< argument according to selected slice mode
   SliceConstraint m_sliceSegmentMode;
@@ -282,6 +288,8 @@ protected:
   std::vector<Int> m_tileColumnWidth;
   std::vector<Int> m_tileRowHeight;
   Bool      m_entropyCodingSyncEnabledFlag;
+  Int       m_numThreads;                                     ///< number of worker threads for parallel CTU compression
+  Int       m_numParallelPictures;                            ///< maximum number of independent pictures compressed concurrently
 
   Bool      m_bUseConstrainedIntraPred;                       ///< flag for using constrained intra prediction
   Bool      m_bFastUDIUseMPMEnabled;
@@ -528,6 +536,9 @@ protected:
   std::string m_summaryOutFilename;                           ///< filename to use for producing summary output file.
   std::string m_summaryPicFilenameBase;                       ///< Base filename to use for producing summary picture output files. The actual filenames used will have I.txt, P.txt and B.txt appended.
   UInt        m_summaryVerboseness;                           ///< Specifies the level of the verboseness of the text output.
+#ifdef TARGET_SIMD_X86
+  std::string m_simdExtension;                                ///< requested SIMD extension (empty = best supported by the CPU)
+#endif
 
 #if EXTENSION_360_VIDEO
   TExt360AppEncCfg m_ext360;
@@ -45,6 +45,7 @@
 
 #include "TAppEncTop.h"
 #include "TLibEncoder/TEncTemporalFilter.h"
+#include "TLibEncoder/TEncLookahead.h"
 #include "TLibEncoder/AnnexBwrite.h"
 
 #if EXTENSION_360_VIDEO
@@ -172,6 +173,9 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setBipredSearchRange                                 ( m_bipredSearchRange );
   m_cTEncTop.setClipForBiPredMeEnabled                            ( m_bClipForBiPredMeEnabled );
   m_cTEncTop.setFastMEAssumingSmootherMVEnabled                   ( m_bFastMEAssumingSmootherMVEnabled );
+  m_cTEncTop.setPreMotionSearchEnabled                            ( m_bPreMotionSearchEnabled );
+  m_cTEncTop.setUseSubPelPlanes                                   ( m_bUseSubPelPlanes );
+  m_cTEncTop.setUseMotionSearchCache                              ( m_bUseMotionSearchCache );
   m_cTEncTop.setMinSearchWindow                                   ( m_minSearchWindow );
   m_cTEncTop.setRestrictMESampling                                ( m_bRestrictMESampling );
 
@@ -228,6 +232,9 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setUseFastDecisionForMerge                           ( m_useFastDecisionForMerge  );
   m_cTEncTop.setUseCbfFastMode                                    ( m_bUseCbfFastMode  );
   m_cTEncTop.setUseEarlySkipDetection                             ( m_useEarlySkipDetection );
+  m_cTEncTop.setCuSplitClassifier                                 ( m_cuSplitClassifier );
+  m_cTEncTop.setCuSplitThresholdFileName                          ( m_cuSplitThresholdFileName );
+  m_cTEncTop.setCuSplitStatsFileName                              ( m_cuSplitStatsFileName );
   m_cTEncTop.setCrossComponentPredictionEnabledFlag               ( m_crossComponentPredictionEnabledFlag );
   m_cTEncTop.setUseReconBasedCrossCPredictionEstimate             ( m_reconBasedCrossCPredictionEstimate );
   m_cTEncTop.setLog2SaoOffsetScale                                ( CHANNEL_TYPE_LUMA  , m_log2SaoOffsetScale[CHANNEL_TYPE_LUMA]   );
@@ -502,6 +509,8 @@ Void TAppEncTop::xInitLibCfg()
   }
   m_cTEncTop.setLFCrossTileBoundaryFlag                           ( m_bLFCrossTileBoundaryFlag );
   m_cTEncTop.setEntropyCodingSyncEnabledFlag                      ( m_entropyCodingSyncEnabledFlag );
+  m_cTEncTop.setNumThreads                                        ( m_numThreads );
+  m_cTEncTop.setNumParallelPictures                               ( m_numParallelPictures );
   m_cTEncTop.setTMVPModeId                                        ( m_TMVPModeId );
   m_cTEncTop.setUseScalingListId                                  ( m_useScalingListId  );
   m_cTEncTop.setScalingListFileName                               ( m_scalingListFileName );
@@ -564,7 +573,6 @@ Void TAppEncTop::xCreateLib()
 {
   // Video I/O
   m_cTVideoIOYuvInputFile.open( m_inputFileName,     false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth );  // read  mode
-  m_cTVideoIOYuvInputFile.skipFrames(m_FrameSkip, m_inputFileWidth, m_inputFileHeight, m_InputChromaFormatIDC);
 
   if (!m_reconFileName.empty())
   {
@@ -661,35 +669,74 @@ Void TAppEncTop::encode()
   TExt360AppEncTop           ext360(*this, m_cTEncTop.getGOPEncoder()->getExt360Data(), *(m_cTEncTop.getGOPEncoder()), *pcPicYuvOrg);
 #endif
   TEncTemporalFilter temporalFilter;
+  Int numPastFrames   = 0;
+  Int numFutureFrames = 0;
   if (m_gopBasedTemporalFilterEnabled)
   {
-    temporalFilter.init(m_FrameSkip, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth, m_sourceWidth, m_sourceHeight,
-      m_sourcePadding, m_framesToBeEncoded, m_bClipInputVideoToRec709Range, m_inputFileName, m_chromaFormatIDC,
-      m_inputColourSpaceConvert, m_iQP, m_iGOPSize, m_gopBasedTemporalFilterStrengths,
-      m_gopBasedTemporalFilterFutureReference);
+    temporalFilter.init(m_internalBitDepth, m_sourceWidth, m_sourceHeight, m_framesToBeEncoded, m_chromaFormatIDC,
+      m_iQP, m_iGOPSize, m_gopBasedTemporalFilterStrengths, m_gopBasedTemporalFilterFutureReference, m_cTEncTop.getThreadPool());
+    numPastFrames   = temporalFilter.getNumPastFrames();
+    numFutureFrames = temporalFilter.getNumFutureFrames();
   }
+
+  // each source picture is read once into the lookahead, which also keeps the neighbours used by the temporal filter;
+  // the last skipped pictures are still read when the filter of the first pictures encoded refers to them
+  const Int numPrecedingFrames = std::min(Int(m_FrameSkip), numPastFrames);
+  m_cTVideoIOYuvInputFile.skipFrames(m_FrameSkip - numPrecedingFrames, m_inputFileWidth, m_inputFileHeight, m_InputChromaFormatIDC);
+
+  TEncLookahead lookahead;
+  lookahead.create(numPastFrames, numFutureFrames, -numPrecedingFrames, pcPicYuvOrg->getWidth(COMPONENT_Y), pcPicYuvOrg->getHeight(COMPONENT_Y),
+    m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxTotalCUDepth);
+
   while ( !bEos )
   {
     // get buffers
     xGetBuffer(pcPicYuvRec);
 
-    // read input YUV file
-#if EXTENSION_360_VIDEO
-    if (ext360.isEnabled())
-    {
-      ext360.read(m_cTVideoIOYuvInputFile, *pcPicYuvOrg, cPicYuvTrueOrg, ipCSC);
-    }
-    else
+    // read input YUV file, up to the last picture the temporal filter looks ahead to
+    while (lookahead.needsFrame(m_iFrameRcvd))
     {
-      m_cTVideoIOYuvInputFile.read( pcPicYuvOrg, &cPicYuvTrueOrg, ipCSC, m_sourcePadding, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
-    }
+      TComPicYuv *pcPicYuvRead        = lookahead.getPicYuvToRead();
+      TComPicYuv *pcPicYuvTrueOrgRead = lookahead.getPicYuvTrueOrgToRead();
+#if EXTENSION_360_VIDEO
+      if (ext360.isEnabled())
+      {
+        ext360.read(m_cTVideoIOYuvInputFile, *pcPicYuvRead, *pcPicYuvTrueOrgRead, ipCSC);
+      }
+      else
+      {
+        m_cTVideoIOYuvInputFile.read( pcPicYuvRead, pcPicYuvTrueOrgRead, ipCSC, m_sourcePadding, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+      }
 #else
-    m_cTVideoIOYuvInputFile.read( pcPicYuvOrg, &cPicYuvTrueOrg, ipCSC, m_sourcePadding, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+      m_cTVideoIOYuvInputFile.read( pcPicYuvRead, pcPicYuvTrueOrgRead, ipCSC, m_sourcePadding, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
 #endif
+      if (m_cTVideoIOYuvInputFile.isEof())
+      {
+        lookahead.setEndOfInput();
+      }
+      else
+      {
+        lookahead.pushFrame();
+      }
 
-    if (m_gopBasedTemporalFilterEnabled)
+      // temporally skip frames
+      if( m_temporalSubsampleRatio > 1 )
+      {
+        m_cTVideoIOYuvInputFile.skipFrames(m_temporalSubsampleRatio-1, m_inputFileWidth, m_inputFileHeight, m_InputChromaFormatIDC);
+      }
+    }
+
+    // end of file is only detected on a read failure
+    const Bool bEndOfInput = lookahead.getPicYuvOrg(m_iFrameRcvd) == NULL;
+    if (!bEndOfInput)
     {
-      temporalFilter.filter(pcPicYuvOrg, m_iFrameRcvd);
+      lookahead.getPicYuvOrg(m_iFrameRcvd)->copyToPic(pcPicYuvOrg);
+      lookahead.getPicYuvTrueOrg(m_iFrameRcvd)->copyToPic(&cPicYuvTrueOrg);
+
+      if (m_gopBasedTemporalFilterEnabled)
+      {
+        temporalFilter.filter(pcPicYuvOrg, m_iFrameRcvd, lookahead);
+      }
     }
 
     // increase number of received frames
@@ -698,8 +745,8 @@ Void TAppEncTop::encode()
     bEos = (m_isField && (m_iFrameRcvd == (m_framesToBeEncoded >> 1) )) || ( !m_isField && (m_iFrameRcvd == m_framesToBeEncoded) );
 
     Bool flush = 0;
-    // if end of file (which is only detected on a read failure) flush the encoder of any queued pictures
-    if (m_cTVideoIOYuvInputFile.isEof())
+    // if end of file flush the encoder of any queued pictures
+    if (bEndOfInput)
     {
       flush = true;
       bEos = true;
@@ -732,11 +779,6 @@ Void TAppEncTop::encode()
       xWriteOutput(bitstreamFile, iNumEncoded, outputAccessUnits);
       outputAccessUnits.clear();
     }
-    // temporally skip frames
-    if( m_temporalSubsampleRatio > 1 )
-    {
-      m_cTVideoIOYuvInputFile.skipFrames(m_temporalSubsampleRatio-1, m_inputFileWidth, m_inputFileHeight, m_InputChromaFormatIDC);
-    }
   }
 
   m_cTEncTop.printSummary(m_isField);
@@ -749,6 +791,7 @@ Void TAppEncTop::encode()
   // delete used buffers in encoder class
   m_cTEncTop.deletePicBuffer();
   cPicYuvTrueOrg.destroy();
+  lookahead.destroy();
 
   // delete buffers & classes
   xDeleteBuffer();
@@ -112,7 +112,7 @@ Void TAppMctsExtTop::extract()
   AccessUnit outAccessUnit;
   while (!!bitstreamFile)
   {
-    streampos location = bitstreamFile.tellg();
+    streampos location = bytestream.getPosition();
     AnnexBStats stats = AnnexBStats();
     InputNALUnit inNalu;
 
@@ -132,9 +132,7 @@ Void TAppMctsExtTop::extract()
 
       if (bNewPicture)
       {
-        bitstreamFile.clear();
-        bitstreamFile.seekg(location - streamoff(3));
-        bytestream.reset();
+        bytestream.setPosition(location);
       }
     }
 
@@ -53,6 +53,7 @@
 #include "TypeDef.h"
 
 #ifdef _MSC_VER
+#include <intrin.h>
 #if _MSC_VER <= 1500
 inline Int64 abs (Int64 x) { return _abs64(x); };
 #endif
@@ -258,6 +259,19 @@ static const Int MAX_NUM_MODEL_VALUES =                             6; // Maximu
 template <typename T> inline T Clip3 (const T minVal, const T maxVal, const T a) { return std::min<T> (std::max<T> (minVal, a) , maxVal); }  ///< general min/max clip
 template <typename T> inline T ClipBD(const T x, const Int bitDepth)             { return Clip3(T(0), T((1 << bitDepth)-1), x);           }
 
+/// number of leading zero bits of a non-zero 32-bit value
+inline UInt countLeadingZeros(const UInt value)
+{
+  assert(value != 0);
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse(&index, value);
+  return 31 - UInt(index);
+#else
+  return UInt(__builtin_clz(value));
+#endif
+}
+
 template <typename T> inline Void Check3( T minVal, T maxVal, T a)
 {
   if ((a > maxVal) || (a < minVal))
@@ -64,8 +64,8 @@ TComInputBitstream::TComInputBitstream()
 : m_fifo()
 , m_emulationPreventionByteLocation()
 , m_fifo_idx(0)
+, m_cache(0)
 , m_num_held_bits(0)
-, m_held_bits(0)
 , m_numBitsRead(0)
 { }
 
@@ -73,8 +73,8 @@ TComInputBitstream::TComInputBitstream(const TComInputBitstream &src)
 : m_fifo(src.m_fifo)
 , m_emulationPreventionByteLocation(src.m_emulationPreventionByteLocation)
 , m_fifo_idx(src.m_fifo_idx)
+, m_cache(src.m_cache)
 , m_num_held_bits(src.m_num_held_bits)
-, m_held_bits(src.m_held_bits)
 , m_numBitsRead(src.m_numBitsRead)
 { }
 
@@ -85,8 +85,8 @@ TComInputBitstream::TComInputBitstream(const TComInputBitstream &src)
 Void TComInputBitstream::resetToStart()
 {
   m_fifo_idx=0;
+  m_cache=0;
   m_num_held_bits=0;
-  m_held_bits=0;
   m_numBitsRead=0;
 }
 
@@ -228,89 +228,35 @@ Int TComOutputBitstream::countStartCodeEmulations()
 }
 
 /**
- * read uiNumberOfBits from bitstream without updating the bitstream
- * state, storing the result in ruiBits.
- *
- * If reading uiNumberOfBits would overrun the bitstream buffer,
- * the bitstream is effectively padded with sufficient zero-bits to
- * avoid the overrun.
+ * load bytes of the fifo into m_cache, until it holds more than 56 bits
+ * or the fifo is exhausted.
  */
-Void TComInputBitstream::pseudoRead ( UInt uiNumberOfBits, UInt& ruiBits )
-{
-  UInt saved_num_held_bits = m_num_held_bits;
-  UChar saved_held_bits = m_held_bits;
-  UInt saved_fifo_idx = m_fifo_idx;
-
-  UInt num_bits_to_read = min(uiNumberOfBits, getNumBitsLeft());
-  read(num_bits_to_read, ruiBits);
-  ruiBits <<= (uiNumberOfBits - num_bits_to_read);
-
-  m_fifo_idx = saved_fifo_idx;
-  m_held_bits = saved_held_bits;
-  m_num_held_bits = saved_num_held_bits;
-}
-
-
-Void TComInputBitstream::read (UInt uiNumberOfBits, UInt& ruiBits)
+Void TComInputBitstream::xRefill()
 {
-  assert( uiNumberOfBits <= 32 );
+  assert( m_num_held_bits < 32 );
 
-  m_numBitsRead += uiNumberOfBits;
-
-  /* NB, bits are extracted from the MSB of each byte. */
-  UInt retval = 0;
-  if (uiNumberOfBits <= m_num_held_bits)
+  if( m_fifo_idx + 8 <= m_fifo.size() )
   {
-    /* n=1, len(H)=7:   -VHH HHHH, shift_down=6, mask=0xfe
-     * n=3, len(H)=7:   -VVV HHHH, shift_down=4, mask=0xf8
-     */
-    retval = m_held_bits >> (m_num_held_bits - uiNumberOfBits);
-    retval &= ~(0xff << uiNumberOfBits);
-    m_num_held_bits -= uiNumberOfBits;
-    ruiBits = retval;
-    return;
+    /* load eight bytes at once and keep the whole bytes that fit.  The
+     * bits of the next byte that end up below them are the bits that
+     * loading that byte will put there. */
+    const uint8_t *p = &m_fifo[m_fifo_idx];
+    const UInt64 word = ( UInt64(p[0]) << 56 ) | ( UInt64(p[1]) << 48 ) | ( UInt64(p[2]) << 40 ) | ( UInt64(p[3]) << 32 )
+                      | ( UInt64(p[4]) << 24 ) | ( UInt64(p[5]) << 16 ) | ( UInt64(p[6]) <<  8 ) |   UInt64(p[7]);
+    const UInt numBytes = ( 64 - m_num_held_bits ) >> 3;
+
+    m_cache         |= word >> m_num_held_bits;
+    m_fifo_idx      += numBytes;
+    m_num_held_bits += numBytes << 3;
   }
-
-  /* all num_held_bits will go into retval
-   *   => need to mask leftover bits from previous extractions
-   *   => align retval with top of extracted word */
-  /* n=5, len(H)=3: ---- -VVV, mask=0x07, shift_up=5-3=2,
-   * n=9, len(H)=3: ---- -VVV, mask=0x07, shift_up=9-3=6 */
-  uiNumberOfBits -= m_num_held_bits;
-  retval = m_held_bits & ~(0xff << m_num_held_bits);
-  retval <<= uiNumberOfBits;
-
-  /* number of whole bytes that need to be loaded to form retval */
-  /* n=32, len(H)=0, load 4bytes, shift_down=0
-   * n=32, len(H)=1, load 4bytes, shift_down=1
-   * n=31, len(H)=1, load 4bytes, shift_down=1+1
-   * n=8,  len(H)=0, load 1byte,  shift_down=0
-   * n=8,  len(H)=3, load 1byte,  shift_down=3
-   * n=5,  len(H)=1, load 1byte,  shift_down=1+3
-   */
-  UInt aligned_word = 0;
-  UInt num_bytes_to_load = (uiNumberOfBits - 1) >> 3;
-  assert(m_fifo_idx + num_bytes_to_load < m_fifo.size());
-
-  switch (num_bytes_to_load)
+  else
   {
-  case 3: aligned_word  = m_fifo[m_fifo_idx++] << 24;
-  case 2: aligned_word |= m_fifo[m_fifo_idx++] << 16;
-  case 1: aligned_word |= m_fifo[m_fifo_idx++] <<  8;
-  case 0: aligned_word |= m_fifo[m_fifo_idx++];
+    while( m_num_held_bits <= 56 && m_fifo_idx < m_fifo.size() )
+    {
+      m_cache         |= UInt64( m_fifo[m_fifo_idx++] ) << ( 56 - m_num_held_bits );
+      m_num_held_bits += 8;
+    }
   }
-
-  /* resolve remainder bits */
-  UInt next_num_held_bits = (32 - uiNumberOfBits) % 8;
-
-  /* copy required part of aligned_word into retval */
-  retval |= aligned_word >> next_num_held_bits;
-
-  /* store held bits */
-  m_num_held_bits = next_num_held_bits;
-  m_held_bits = aligned_word;
-
-  ruiBits = retval;
 }
 
 /**
@@ -363,8 +309,13 @@ TComInputBitstream *TComInputBitstream::extractSubstream( UInt uiNumBits )
   std::vector<uint8_t> &buf = pResult->getFifo();
   buf.reserve((uiNumBits+7)>>3);
 
-  if (m_num_held_bits == 0)
+  if ((m_num_held_bits & 0x7) == 0)
   {
+    // return the whole bytes of the cache to the fifo
+    m_fifo_idx     -= m_num_held_bits >> 3;
+    m_cache         = 0;
+    m_num_held_bits = 0;
+
     std::size_t currentOutputBufferSize=buf.size();
     const UInt uiNumBytesToReadFromFifo = std::min<UInt>(uiNumBytes, (UInt)m_fifo.size() - m_fifo_idx);
     buf.resize(currentOutputBufferSize+uiNumBytes);
@@ -164,6 +164,9 @@ public:
 /**
  * Model of an input bitstream that extracts bits from a predefined
  * bytestream.
+ *
+ * Bits are taken from a 64-bit cache register, which is refilled with
+ * up to eight bytes of the fifo at once.
  */
 class TComInputBitstream
 {
@@ -171,11 +174,14 @@ protected:
   std::vector<uint8_t> m_fifo; /// FIFO for storage of complete bytes
   std::vector<UInt>    m_emulationPreventionByteLocation;
 
-  UInt m_fifo_idx; /// Read index into m_fifo
+  UInt   m_fifo_idx; /// Read index into m_fifo of the next byte that is not in m_cache
+
+  UInt64 m_cache;         /// bits loaded from m_fifo and not read yet, msb-aligned.
+                          /// the bits below them are zero or the bits that follow in m_fifo
+  UInt   m_num_held_bits; /// number of valid bits in m_cache
+  UInt   m_numBitsRead;
 
-  UInt m_num_held_bits;
-  UChar m_held_bits;
-  UInt  m_numBitsRead;
+  Void xRefill();
 
 public:
   /**
@@ -188,27 +194,101 @@ public:
   Void resetToStart();
 
   // interface for decoding
-  Void        pseudoRead      ( UInt uiNumberOfBits, UInt& ruiBits );
-  Void        read            ( UInt uiNumberOfBits, UInt& ruiBits );
+  Void        pseudoRead      ( UInt uiNumberOfBits, UInt& ruiBits ) { ruiBits = peek( uiNumberOfBits ); }
+  Void        read            ( UInt uiNumberOfBits, UInt& ruiBits )
+  {
+    assert( uiNumberOfBits <= 32 );
+    if( m_num_held_bits < uiNumberOfBits )
+    {
+      xRefill();
+      assert( m_num_held_bits >= uiNumberOfBits );
+    }
+    m_numBitsRead   += uiNumberOfBits;
+    /* NB, bits are extracted from the MSB of m_cache. */
+    ruiBits          = UInt( ( m_cache >> 32 ) >> ( 32 - uiNumberOfBits ) );
+    m_cache        <<= uiNumberOfBits;
+    m_num_held_bits -= uiNumberOfBits;
+  }
+
+  /**
+   * return the next uiNumberOfBits bits without reading them.  Past the
+   * end of the fifo, the bitstream reads as zero bits.
+   */
+  UInt        peek            ( UInt uiNumberOfBits )
+  {
+    assert( uiNumberOfBits <= 32 );
+    if( m_num_held_bits < uiNumberOfBits )
+    {
+      xRefill();
+    }
+    return UInt( ( m_cache >> 32 ) >> ( 32 - uiNumberOfBits ) );
+  }
+
+  /** read uiNumberOfBits bits and discard them */
+  Void        skip            ( UInt uiNumberOfBits )
+  {
+    assert( uiNumberOfBits <= 32 );
+    if( m_num_held_bits < uiNumberOfBits )
+    {
+      xRefill();
+      assert( m_num_held_bits >= uiNumberOfBits );
+    }
+    m_numBitsRead   += uiNumberOfBits;
+    m_cache        <<= uiNumberOfBits;
+    m_num_held_bits -= uiNumberOfBits;
+  }
+
+  /**
+   * read numBytes (at most 4) whole bytes at a byte-aligned position, as
+   * in the initialisation of the arithmetic decoder.  Like readByte(),
+   * this does not count towards getNumBitsRead().
+   */
+  UInt        readBytes       ( UInt numBytes )
+  {
+    assert( numBytes >= 1 && numBytes <= 4 );
+    assert( ( m_num_held_bits & 0x7 ) == 0 );
+    if( m_num_held_bits < 8 * numBytes )
+    {
+      xRefill();
+      assert( m_num_held_bits >= 8 * numBytes );
+    }
+    const UInt bytes = UInt( ( m_cache >> 32 ) >> ( 32 - 8 * numBytes ) );
+    m_cache        <<= 8 * numBytes;
+    m_num_held_bits -= 8 * numBytes;
+    return bytes;
+  }
+
+  /**
+   * return the last numBytes whole bytes that were read at a byte-aligned
+   * position to the bitstream, for a reader that reads ahead.
+   */
+  Void        unreadBytes     ( UInt numBytes )
+  {
+    assert( ( m_num_held_bits & 0x7 ) == 0 );
+    assert( numBytes <= getByteLocation() );
+    m_fifo_idx      = getByteLocation() - numBytes;
+    m_cache         = 0;
+    m_num_held_bits = 0;
+  }
+
   Void        readByte        ( UInt &ruiBits )
   {
-    assert(m_fifo_idx < m_fifo.size());
-    ruiBits = m_fifo[m_fifo_idx++];
+    ruiBits = readBytes( 1 );
   }
 
   Void        peekPreviousByte( UInt &byte )
   {
-    assert(m_fifo_idx > 0);
-    byte = m_fifo[m_fifo_idx - 1];
+    assert( ( m_num_held_bits & 0x7 ) == 0 );
+    assert( getByteLocation() > 0 );
+    byte = m_fifo[ getByteLocation() - 1 ];
   }
 
   UInt        readOutTrailingBits ();
-  UChar getHeldBits  ()          { return m_held_bits;          }
   TComOutputBitstream& operator= (const TComOutputBitstream& src);
-  UInt  getByteLocation              ( )                     { return m_fifo_idx                    ; }
+  UInt  getByteLocation              ( )                     { return m_fifo_idx - ( m_num_held_bits >> 3 ); }
 
   // Peek at bits in word-storage. Used in determining if we have completed reading of current bitstream and therefore slice in LCEC.
-  UInt        peekBits (UInt uiBits) { UInt tmp; pseudoRead(uiBits, tmp); return tmp; }
+  UInt        peekBits (UInt uiBits) { return peek( uiBits ); }
 
   // utility functions
   UInt read(UInt numberOfBits) { UInt tmp; read(numberOfBits, tmp); return tmp; }
@@ -59,20 +59,30 @@ class TComInterpolationFilter
   static const TFilterCoeff m_lumaFilter[LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS][NTAPS_LUMA];     ///< Luma filter taps
   static const TFilterCoeff m_chromaFilter[CHROMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS][NTAPS_CHROMA]; ///< Chroma filter taps
 
+  typedef Void (*FpFilterCopy)(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast);
+  typedef Void (*FpFilter)    (Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, TFilterCoeff const *coeff);
+
+  FpFilterCopy m_filterCopy;
+  FpFilter     m_filterHor[2][2];                             ///< [0 = luma (8 taps), 1 = chroma (4 taps)][isLast]
+  FpFilter     m_filterVer[2][2][2];                          ///< [0 = luma (8 taps), 1 = chroma (4 taps)][isFirst][isLast]
+
   static Void filterCopy(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast);
 
   template<Int N, Bool isVertical, Bool isFirst, Bool isLast>
   static Void filter(Int bitDepth, Pel const *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, TFilterCoeff const *coeff);
 
-  template<Int N>
-  static Void filterHor(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height,               Bool isLast, TFilterCoeff const *coeff);
-  template<Int N>
-  static Void filterVer(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast, TFilterCoeff const *coeff);
+#if ENABLE_SIMD_OPT_INTERPOLATION
+  Void initInterpolationFilterX86();
+  template <X86_VEXT vext> Void _initInterpolationFilterX86();
+#endif
 
 public:
-  TComInterpolationFilter() {}
+  TComInterpolationFilter();
   ~TComInterpolationFilter() {}
 
+  /// (re)selects the filter implementations, e.g. after the SIMD extension has been restricted
+  Void initInterpolationFilter();
+
   Void filterHor(const ComponentID compID, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Int frac,               Bool isLast, const ChromaFormat fmt, const Int bitDepth );
   Void filterVer(const ComponentID compID, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Int frac, Bool isFirst, Bool isLast, const ChromaFormat fmt, const Int bitDepth );
 };
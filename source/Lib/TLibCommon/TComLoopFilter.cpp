@@ -73,12 +73,18 @@ const UChar TComLoopFilter::sm_betaTable[MAX_QP + 1] =
 TComLoopFilter::TComLoopFilter()
 : m_uiNumPartitions(0)
 , m_bLFCrossTileBoundary(true)
+, m_pcThreadPool(NULL)
+, m_pcRowFilters(NULL)
 {
   for( Int edgeDir = 0; edgeDir < NUM_EDGE_DIR; edgeDir++ )
   {
     m_aapucBS       [edgeDir] = NULL;
     m_aapbEdgeFilter[edgeDir] = NULL;
+    m_filterLuma    [edgeDir] = xFilterLumaLines;
   }
+#if ENABLE_SIMD_OPT_DEBLOCKING
+  initLoopFilterX86();
+#endif
 }
 
 TComLoopFilter::~TComLoopFilter()
@@ -91,9 +97,16 @@ TComLoopFilter::~TComLoopFilter()
 Void TComLoopFilter::setCfg( Bool bLFCrossTileBoundary )
 {
   m_bLFCrossTileBoundary = bLFCrossTileBoundary;
+  if ( m_pcRowFilters )
+  {
+    for ( Int i = 0; i < m_pcThreadPool->getNumThreads(); i++ )
+    {
+      m_pcRowFilters[i].setCfg( bLFCrossTileBoundary );
+    }
+  }
 }
 
-Void TComLoopFilter::create( UInt uiMaxCUDepth )
+Void TComLoopFilter::create( UInt uiMaxCUDepth, TComThreadPool* pcThreadPool )
 {
   destroy();
   m_uiNumPartitions = 1 << ( uiMaxCUDepth<<1 );
@@ -102,10 +115,32 @@ Void TComLoopFilter::create( UInt uiMaxCUDepth )
     m_aapucBS       [edgeDir] = new UChar[m_uiNumPartitions];
     m_aapbEdgeFilter[edgeDir] = new Bool [m_uiNumPartitions];
   }
+
+  if ( pcThreadPool && pcThreadPool->getNumThreads() > 1 )
+  {
+    m_pcThreadPool = pcThreadPool;
+    m_pcRowFilters = new TComLoopFilter[pcThreadPool->getNumThreads()];
+    for ( Int i = 0; i < pcThreadPool->getNumThreads(); i++ )
+    {
+      m_pcRowFilters[i].create( uiMaxCUDepth );
+      m_pcRowFilters[i].setCfg( m_bLFCrossTileBoundary );
+    }
+  }
 }
 
 Void TComLoopFilter::destroy()
 {
+  if ( m_pcRowFilters )
+  {
+    for ( Int i = 0; i < m_pcThreadPool->getNumThreads(); i++ )
+    {
+      m_pcRowFilters[i].destroy();
+    }
+    delete [] m_pcRowFilters;
+    m_pcRowFilters = NULL;
+  }
+  m_pcThreadPool = NULL;
+
   for( Int edgeDir = 0; edgeDir < NUM_EDGE_DIR; edgeDir++ )
   {
     if (m_aapucBS[edgeDir] != NULL)
@@ -135,41 +170,88 @@ Void TComLoopFilter::destroy()
  */
 Void TComLoopFilter::loopFilterPic( TComPic* pcPic )
 {
-  // 水平过滤
-  // 首先过滤图像中的垂直边界
-  // 从左边界往右边界处理
-  // 获取一帧中的 CU 个数，对CU作处理
-  for ( UInt ctuRsAddr = 0; ctuRsAddr < pcPic->getNumberOfCtusInFrame(); ctuRsAddr++ )
-  {
-    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
+  const UInt frameHeightInCtus = pcPic->getFrameHeightInCtus();
 
-    ::memset( m_aapucBS       [EDGE_VER], 0, sizeof( UChar ) * m_uiNumPartitions );
-    ::memset( m_aapbEdgeFilter[EDGE_VER], 0, sizeof( Bool  ) * m_uiNumPartitions );
-
-    // CU-based deblocking
-    xDeblockCU( pCtu, 0, 0, EDGE_VER );
+  // The vertical edges of a CTU row only modify samples of that row, and after the vertical pass the horizontal edges
+  // of different CTU rows modify disjoint samples (at most the three bottom lines of the row above for luma, which no
+  // horizontal edge of that row reads), so the rows of each pass can be filtered concurrently.
+  if ( m_pcRowFilters && frameHeightInCtus > 1 )
+  {
+    for ( Int edgeDir = EDGE_VER; edgeDir <= EDGE_HOR; edgeDir++ )
+    {
+      for ( UInt ctuRowIdx = 0; ctuRowIdx < frameHeightInCtus; ctuRowIdx++ )
+      {
+        TComLoopFilter* pcRowFilters = m_pcRowFilters;
+        m_pcThreadPool->addTask( [pcRowFilters, pcPic, ctuRowIdx, edgeDir]( Int threadIdx )
+        {
+          pcRowFilters[threadIdx].xDeblockCtuRow( pcPic, ctuRowIdx, DeblockEdgeDir( edgeDir ) );
+        } );
+      }
+      m_pcThreadPool->waitForAll();
+    }
+    return;
   }
 
+  // 水平过滤
+  // 首先过滤图像中的垂直边界
+  // 从左边界往右边界处理
   // 垂直过滤
   // 然后过滤图像中的水平边界
   // 从最顶部向底部处理
-  for ( UInt ctuRsAddr = 0; ctuRsAddr < pcPic->getNumberOfCtusInFrame(); ctuRsAddr++ )
+  for ( Int edgeDir = EDGE_VER; edgeDir <= EDGE_HOR; edgeDir++ )
   {
-    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
-
-    ::memset( m_aapucBS       [EDGE_HOR], 0, sizeof( UChar ) * m_uiNumPartitions );
-    ::memset( m_aapbEdgeFilter[EDGE_HOR], 0, sizeof( Bool  ) * m_uiNumPartitions );
-
-    // CU-based deblocking
-    xDeblockCU( pCtu, 0, 0, EDGE_HOR );
+    for ( UInt ctuRowIdx = 0; ctuRowIdx < frameHeightInCtus; ctuRowIdx++ )
+    {
+      xDeblockCtuRow( pcPic, ctuRowIdx, DeblockEdgeDir( edgeDir ) );
+    }
   }
 }
 
+/**
+ - call deblocking function for the vertical and then the horizontal edges of the CTUs of one CTU row
+ .
+ The vertical edges of a row only modify samples of that row, and its horizontal edges only modify samples of that
+ row and the bottom of the row above, which are final once the row above has been processed. Filtering the rows in
+ order is therefore bit-exact with loopFilterPic, and a row can be filtered as soon as it and the row below it have
+ been reconstructed (intra prediction of the row below reads the unfiltered bottom samples of this row).
+ \param  pcPic      picture class (TComPic) pointer
+ \param  ctuRowIdx  index of the CTU row
+ */
+Void TComLoopFilter::loopFilterCtuRow( TComPic* pcPic, UInt ctuRowIdx )
+{
+  xDeblockCtuRow( pcPic, ctuRowIdx, EDGE_VER );
+  xDeblockCtuRow( pcPic, ctuRowIdx, EDGE_HOR );
+}
+
 
 // ====================================================================================================================
 // Protected member functions
 // ====================================================================================================================
 
+/**
+ - call deblocking function for the edges of one direction in every CTU of a CTU row
+ .
+ \param  pcPic      picture class (TComPic) pointer
+ \param  ctuRowIdx  index of the CTU row
+ \param  edgeDir    direction of the edges
+ */
+Void TComLoopFilter::xDeblockCtuRow( TComPic* pcPic, UInt ctuRowIdx, DeblockEdgeDir edgeDir )
+{
+  const UInt frameWidthInCtus = pcPic->getFrameWidthInCtus();
+  const UInt firstCtuRsAddr   = ctuRowIdx * frameWidthInCtus;
+
+  for ( UInt ctuRsAddr = firstCtuRsAddr; ctuRsAddr < firstCtuRsAddr + frameWidthInCtus; ctuRsAddr++ )
+  {
+    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
+
+    ::memset( m_aapucBS       [edgeDir], 0, sizeof( UChar ) * m_uiNumPartitions );
+    ::memset( m_aapbEdgeFilter[edgeDir], 0, sizeof( Bool  ) * m_uiNumPartitions );
+
+    // CU-based deblocking
+    xDeblockCU( pCtu, 0, 0, edgeDir );
+  }
+}
+
 /**
  * 对每一个CU进行去块滤波
  * 边界的两边各修正3个像素值
@@ -735,10 +817,7 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* const pcCU, const UInt uiAbsZo
           Bool sw =  xUseStrongFiltering( iOffset, 2*d0, iBeta, iTc, piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+0))
           && xUseStrongFiltering( iOffset, 2*d3, iBeta, iTc, piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+3));
 
-          for ( Int i = 0; i < DEBLOCK_SMALLEST_BLOCK/2; i++)
-          {
-            xPelFilterLuma( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+i), iOffset, iTc, sw, bPartPNoFilter, bPartQNoFilter, iThrCut, bFilterP, bFilterQ, bitDepthLuma);
-          }
+          m_filterLuma[edgeDir]( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4), iOffset, iSrcStep, iTc, sw, bPartPNoFilter, bPartQNoFilter, iThrCut, bFilterP, bFilterQ, bitDepthLuma);
         }
       }
     }
@@ -886,6 +965,29 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* const pcCU, const UInt uiAbs
   }
 }
 
+/**
+ - Luma filtering of the DEBLOCK_SMALLEST_BLOCK/2 lines crossing an edge segment
+ .
+ \param piSrc           pointer to the first sample of the Q side in the first line
+ \param iOffset         offset value for picture data
+ \param iSrcStep        offset between two consecutive lines
+ \param tc              tc value
+ \param sw              decision strong/weak filter
+ \param bPartPNoFilter  indicator to disable filtering on partP
+ \param bPartQNoFilter  indicator to disable filtering on partQ
+ \param iThrCut         threshold value for weak filter decision
+ \param bFilterSecondP  decision weak filter/no filter for partP
+ \param bFilterSecondQ  decision weak filter/no filter for partQ
+ \param bitDepthLuma    luma bit depth
+*/
+Void TComLoopFilter::xFilterLumaLines( Pel* piSrc, Int iOffset, Int iSrcStep, Int tc, Bool sw, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iThrCut, Bool bFilterSecondP, Bool bFilterSecondQ, const Int bitDepthLuma )
+{
+  for ( Int i = 0; i < DEBLOCK_SMALLEST_BLOCK/2; i++, piSrc += iSrcStep )
+  {
+    xPelFilterLuma( piSrc, iOffset, tc, sw, bPartPNoFilter, bPartQNoFilter, iThrCut, bFilterSecondP, bFilterSecondQ, bitDepthLuma );
+  }
+}
+
 /**
  - 滤波操作 Deblocking for the luminance component with strong or weak filter
  * 亮度分量：
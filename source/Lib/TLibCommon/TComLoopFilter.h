@@ -40,6 +40,7 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#include "TComThreadPool.h"
 
 //! \ingroup TLibCommon
 //! \{
@@ -66,9 +67,25 @@ private:
 
   Bool      m_bLFCrossTileBoundary;
 
+  // concurrent filtering of the CTU rows in loopFilterPic
+  TComThreadPool* m_pcThreadPool;
+  TComLoopFilter* m_pcRowFilters;                    ///< filter of each worker thread, with its own Bs and edge flag buffers
+
+  typedef Void (*FpFilterLuma)( Pel* piSrc, Int iOffset, Int iSrcStep, Int tc, Bool sw, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iThrCut, Bool bFilterSecondP, Bool bFilterSecondQ, const Int bitDepthLuma );
+
+  /// luma filtering of the four lines crossing an edge segment, for [EDGE_VER/EDGE_HOR]
+  FpFilterLuma m_filterLuma[NUM_EDGE_DIR];
+
+#if ENABLE_SIMD_OPT_DEBLOCKING
+  Void initLoopFilterX86();
+  template <X86_VEXT vext> Void _initLoopFilterX86();
+#endif
+
 protected:
   /// CU-level deblocking function
   Void xDeblockCU                 ( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, DeblockEdgeDir edgeDir );
+  /// deblocking of the edges of one direction in the CTUs of a CTU row
+  Void xDeblockCtuRow             ( TComPic* pcPic, UInt ctuRowIdx, DeblockEdgeDir edgeDir );
 
   // set / get functions
   Void xSetLoopfilterParam        ( TComDataCU* pcCU, UInt uiAbsZorderIdx );
@@ -114,7 +131,8 @@ protected:
   Void xEdgeFilterLuma            ( TComDataCU* const pcCU, const UInt uiAbsZorderIdx, const UInt uiDepth, const DeblockEdgeDir edgeDir, const Int iEdge );
   Void xEdgeFilterChroma          ( TComDataCU* const pcCU, const UInt uiAbsZorderIdx, const UInt uiDepth, const DeblockEdgeDir edgeDir, const Int iEdge );
 
-  __inline Void xPelFilterLuma( Pel* piSrc, Int iOffset, Int tc, Bool sw, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iThrCut, Bool bFilterSecondP, Bool bFilterSecondQ, const Int bitDepthLuma);
+  static __inline Void xPelFilterLuma( Pel* piSrc, Int iOffset, Int tc, Bool sw, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iThrCut, Bool bFilterSecondP, Bool bFilterSecondQ, const Int bitDepthLuma);
+  static Void xFilterLumaLines( Pel* piSrc, Int iOffset, Int iSrcStep, Int tc, Bool sw, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iThrCut, Bool bFilterSecondP, Bool bFilterSecondQ, const Int bitDepthLuma );
   __inline Void xPelFilterChroma( Pel* piSrc, Int iOffset, Int tc, Bool bPartPNoFilter, Bool bPartQNoFilter, const Int bitDepthChroma);
 
 
@@ -129,7 +147,8 @@ public:
   TComLoopFilter();
   virtual ~TComLoopFilter();
 
-  Void  create                    ( UInt uiMaxCUDepth );
+  /// the CTU rows are filtered concurrently by loopFilterPic when pcThreadPool has several threads
+  Void  create                    ( UInt uiMaxCUDepth, TComThreadPool* pcThreadPool = NULL );
   Void  destroy                   ();
 
   /// set configuration
@@ -137,6 +156,8 @@ public:
 
   /// picture-level deblocking filter
   Void loopFilterPic( TComPic* pcPic );
+  /// CTU-row-level deblocking filter, gives the same result as loopFilterPic when called for the rows in order
+  Void loopFilterCtuRow( TComPic* pcPic, UInt ctuRowIdx );
 
   static Int getBeta( Int qp )
   {
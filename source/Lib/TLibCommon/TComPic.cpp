@@ -37,6 +37,7 @@
 
 #include "TComPic.h"
 #include "SEI.h"
+#include "TComInterpolationFilter.h"
 
 //! \ingroup TLibCommon
 //! \{
@@ -60,6 +61,13 @@ TComPic::TComPic()
   {
     m_apcPicYuv[i]      = NULL;
   }
+  for(UInt i=0; i<4; i++)
+  {
+    for(UInt j=0; j<4; j++)
+    {
+      m_apcPicYuvSubPel[i][j] = NULL;
+    }
+  }
 #if FGS_RDD5_ENABLE
   m_grainCharacteristic = NULL;
   m_grainBuf = NULL;
@@ -233,6 +241,7 @@ Void TComPic::releaseAllReconstructionData()
     delete m_apcPicYuv[PIC_YUV_REC];
     m_apcPicYuv[PIC_YUV_REC] = NULL;
   }
+  destroySubPelPlanes();
   m_picSym.releaseAllReconstructionData();
 }
 #endif
@@ -241,6 +250,8 @@ Void TComPic::destroy()
 {
   m_picSym.destroy();
 
+  destroySubPelPlanes();
+
   for(UInt i=0; i<NUM_PIC_YUV; i++)
   {
     if (m_apcPicYuv[i])
@@ -257,6 +268,72 @@ Void TComPic::destroy()
 #endif
 }
 
+/** Allocate the interpolated luma planes of the reconstruction, with the same size, margins and stride
+ */
+Void TComPic::createSubPelPlanes()
+{
+  const TComSPS &sps = m_picSym.getSPS();
+  for(UInt i=0; i<4; i++)
+  {
+    for(UInt j=0; j<4; j++)
+    {
+      if ( ( i | j ) != 0 && m_apcPicYuvSubPel[i][j] == NULL )
+      {
+        m_apcPicYuvSubPel[i][j] = new TComPicYuv;
+        m_apcPicYuvSubPel[i][j]->createWithoutCUInfo( sps.getPicWidthInLumaSamples(), sps.getPicHeightInLumaSamples(), CHROMA_400, true, sps.getMaxCUWidth(), sps.getMaxCUHeight() );
+        assert( m_apcPicYuvSubPel[i][j]->getStride(COMPONENT_Y) == getPicYuvRec()->getStride(COMPONENT_Y) );
+      }
+    }
+  }
+}
+
+/** Interpolate the planes of one horizontal phase from the reconstruction, whose border must be extended. The
+ *  samples are computed with the same filter stages as the sub-sample refinement of the encoder motion search
+ *  (horizontal to intermediate precision, then vertical), over the part of the margins the filters can reach.
+ * \param iHorFrac horizontal quarter-sample phase
+ */
+Void TComPic::interpolateSubPelPlanes( Int iHorFrac )
+{
+  TComPicYuv* pcRec      = getPicYuvRec();
+  const Int   iStride    = pcRec->getStride(COMPONENT_Y);
+  const Int   iMarginX   = pcRec->getMarginX(COMPONENT_Y);
+  const Int   iMarginY   = pcRec->getMarginY(COMPONENT_Y);
+  const Int   iWidth     = pcRec->getWidth(COMPONENT_Y)  + 2 * iMarginX - ( NTAPS_LUMA - 1 );
+  const Int   iHeight    = pcRec->getHeight(COMPONENT_Y) + 2 * iMarginY;
+  const Int   iOffset    = ( NTAPS_LUMA / 2 - 1 ) - iMarginX - iMarginY * iStride;  // first sample with a complete horizontal filter support
+  const Int   iBitDepth  = m_picSym.getSPS().getBitDepth(CHANNEL_TYPE_LUMA);
+
+  TComInterpolationFilter cIf;
+  std::vector<Pel> cTmp( iStride * iHeight );
+  Pel* piTmp = &cTmp[0] + iMarginY * iStride + iMarginX;
+  cIf.filterHor( COMPONENT_Y, pcRec->getAddr(COMPONENT_Y) + iOffset, iStride, piTmp + iOffset, iStride, iWidth, iHeight, iHorFrac, false, CHROMA_400, iBitDepth );
+
+  const Int iVerOffset = iOffset + ( NTAPS_LUMA / 2 - 1 ) * iStride;
+  for(Int iVerFrac=0; iVerFrac<4; iVerFrac++)
+  {
+    if ( ( iVerFrac | iHorFrac ) != 0 )
+    {
+      cIf.filterVer( COMPONENT_Y, piTmp + iVerOffset, iStride, m_apcPicYuvSubPel[iVerFrac][iHorFrac]->getAddr(COMPONENT_Y) + iVerOffset, iStride, iWidth, iHeight - ( NTAPS_LUMA - 1 ), iVerFrac, false, true, CHROMA_400, iBitDepth );
+    }
+  }
+}
+
+Void TComPic::destroySubPelPlanes()
+{
+  for(UInt i=0; i<4; i++)
+  {
+    for(UInt j=0; j<4; j++)
+    {
+      if (m_apcPicYuvSubPel[i][j])
+      {
+        m_apcPicYuvSubPel[i][j]->destroy();
+        delete m_apcPicYuvSubPel[i][j];
+        m_apcPicYuvSubPel[i][j] = NULL;
+      }
+    }
+  }
+}
+
 Void TComPic::compressMotion()
 {
   TComPicSym* pPicSym = getPicSym();
@@ -81,6 +81,7 @@ private:
   Bool                  m_bIsLongTerm;            //  IS long term picture
   TComPicSym            m_picSym;                 //  Symbol
   TComPicYuv*           m_apcPicYuv[NUM_PIC_YUV];
+  TComPicYuv*           m_apcPicYuvSubPel[4][4];  //  Interpolated luma of the reconstruction [vertical][horizontal quarter-sample phase], [0][0] unused
 
   TComPicYuv*           m_pcPicYuvPred;           //  Prediction
   TComPicYuv*           m_pcPicYuvResi;           //  Residual
@@ -146,6 +147,13 @@ public:
   TComPicYuv*   getPicYuvOrg()        { return  m_apcPicYuv[PIC_YUV_ORG]; }
   TComPicYuv*   getPicYuvRec()        { return  m_apcPicYuv[PIC_YUV_REC]; }
 
+  Void          createSubPelPlanes();
+  Void          interpolateSubPelPlanes( Int iHorFrac );
+  Void          destroySubPelPlanes();
+  Bool          hasSubPelPlanes() const                               { return m_apcPicYuvSubPel[0][1] != NULL; }
+  /// luma of the reconstruction interpolated at a quarter-sample phase; the reconstruction itself for phase (0,0)
+  TComPicYuv*   getPicYuvSubPel( Int iVerFrac, Int iHorFrac )        { return ( iVerFrac | iHorFrac ) ? m_apcPicYuvSubPel[iVerFrac][iHorFrac] : getPicYuvRec(); }
+
 #if FGS_RDD5_ENABLE
   Void createGrainSynthesizer(Bool bFirstPictureInSequence, SEIFilmGrainSynthesizer* pGrainCharacteristics, TComPicYuv* pGrainBuf, const TComSPS* sps);
   SEIFilmGrainSynthesizer *m_grainCharacteristic;
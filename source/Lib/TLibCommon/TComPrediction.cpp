@@ -81,6 +81,11 @@ TComPrediction::TComPrediction()
       m_piYuvExt[ch][buf] = NULL;
     }
   }
+  m_predIntraAngBlock = xPredIntraAngBlock;
+  m_predIntraPlanar   = xPredIntraPlanar;
+#if ENABLE_SIMD_OPT_INTRAPRED
+  initIntraPredictionX86();
+#endif
 }
 
 TComPrediction::~TComPrediction()
@@ -125,6 +130,8 @@ Void TComPrediction::destroy()
 
 Void TComPrediction::initTempBuff(ChromaFormat chromaFormatIDC)
 {
+  m_if.initInterpolationFilter();
+
   // if it has been initialised before, but the chroma format has changed, release the memory and start again.
   if( m_piYuvExt[COMPONENT_Y][PRED_BUF_UNFILTERED] != NULL && m_cYuvPredTemp.getChromaFormat()!=chromaFormatIDC)
   {
@@ -216,6 +223,7 @@ Pel TComPrediction::predIntraGetPredValDC( const Pel* pSrc, Int iSrcStride, UInt
  * \param blkAboveAvailable  boolean indication if the block above is available
  * \param blkLeftAvailable   boolean indication if the block to the left is available
  * \param bEnableEdgeFilters indication whether to enable edge filters
+ * \param bTransposeHorModes indication whether to output the horizontal modes transposed
  *
  * This function derives the prediction samples for the angular mode based on the prediction direction indicated by
  * the prediction mode index. The prediction direction is given by the displacement of the bottom row of the block and
@@ -230,7 +238,8 @@ Void TComPrediction::xPredIntraAng(       Int bitDepth,
                                     const Pel* pSrc,     Int srcStride,
                                           Pel* pTrueDst, Int dstStrideTrue,
                                           UInt uiWidth, UInt uiHeight, ChannelType channelType,
-                                          UInt dirMode, const Bool bEnableEdgeFilters
+                                          UInt dirMode, const Bool bEnableEdgeFilters,
+                                    const Bool bTransposeHorModes
                                   )
 {
   Int width=Int(uiWidth);
@@ -314,65 +323,26 @@ Void TComPrediction::xPredIntraAng(       Int bitDepth,
 
     // swap width/height if we are doing a horizontal mode:
     Pel tempArray[MAX_CU_SIZE*MAX_CU_SIZE];
-    const Int dstStride = bIsModeVer ? dstStrideTrue : MAX_CU_SIZE;
-    Pel *pDst = bIsModeVer ? pTrueDst : tempArray;
+    const Bool bFlip     = !bIsModeVer && !bTransposeHorModes;
+    const Int  dstStride = bFlip ? MAX_CU_SIZE : dstStrideTrue;
+    Pel *pDst = bFlip ? tempArray : pTrueDst;
     if (!bIsModeVer)
     {
       std::swap(width, height);
     }
 
-    if (intraPredAngle == 0)  // pure vertical or pure horizontal
-    {
-      for (Int y=0;y<height;y++)
-      {
-        for (Int x=0;x<width;x++)
-        {
-          pDst[y*dstStride+x] = refMain[x+1];
-        }
-      }
+    m_predIntraAngBlock( refMain, pDst, dstStride, width, height, intraPredAngle );
 
-      if (edgeFilter)
-      {
-        for (Int y=0;y<height;y++)
-        {
-          pDst[y*dstStride] = Clip3 (0, ((1 << bitDepth) - 1), pDst[y*dstStride] + (( refSide[y+1] - refSide[0] ) >> 1) );
-        }
-      }
-    }
-    else
+    if (intraPredAngle == 0 && edgeFilter)  // pure vertical or pure horizontal
     {
-      Pel *pDsty=pDst;
-
-      for (Int y=0, deltaPos=intraPredAngle; y<height; y++, deltaPos+=intraPredAngle, pDsty+=dstStride)
+      for (Int y=0;y<height;y++)
       {
-        const Int deltaInt   = deltaPos >> 5;
-        const Int deltaFract = deltaPos & (32 - 1);
-
-        if (deltaFract)
-        {
-          // Do linear filtering
-          const Pel *pRM=refMain+deltaInt+1;
-          Int lastRefMainPel=*pRM++;
-          for (Int x=0;x<width;pRM++,x++)
-          {
-            Int thisRefMainPel=*pRM;
-            pDsty[x+0] = (Pel) ( ((32-deltaFract)*lastRefMainPel + deltaFract*thisRefMainPel +16) >> 5 );
-            lastRefMainPel=thisRefMainPel;
-          }
-        }
-        else
-        {
-          // Just copy the integer samples
-          for (Int x=0;x<width; x++)
-          {
-            pDsty[x] = refMain[x+deltaInt+1];
-          }
-        }
+        pDst[y*dstStride] = Clip3 (0, ((1 << bitDepth) - 1), pDst[y*dstStride] + (( refSide[y+1] - refSide[0] ) >> 1) );
       }
     }
 
     // Flip the block if this is the horizontal mode
-    if (!bIsModeVer)
+    if (bFlip)
     {
       for (Int y=0; y<height; y++)
       {
@@ -387,10 +357,48 @@ Void TComPrediction::xPredIntraAng(       Int bitDepth,
   }
 }
 
+/** Function for deriving the angular prediction rows of a block, in the vertical orientation.
+ * \param refMain        main reference, refMain[1] being the sample above the first column of the block
+ * \param pDst           pointer to the prediction sample array
+ * \param dstStride      the stride of the prediction sample array
+ * \param width          the width of the block (a multiple of 4)
+ * \param height         the height of the block
+ * \param intraPredAngle displacement of the rows, in 1/32 sample units
+ */
+Void TComPrediction::xPredIntraAngBlock( const Pel* refMain, Pel* pDst, Int dstStride, Int width, Int height, Int intraPredAngle )
+{
+  for (Int y=0, deltaPos=intraPredAngle; y<height; y++, deltaPos+=intraPredAngle, pDst+=dstStride)
+  {
+    const Int deltaInt   = deltaPos >> 5;
+    const Int deltaFract = deltaPos & (32 - 1);
+
+    if (deltaFract)
+    {
+      // Do linear filtering
+      const Pel *pRM=refMain+deltaInt+1;
+      Int lastRefMainPel=*pRM++;
+      for (Int x=0;x<width;pRM++,x++)
+      {
+        Int thisRefMainPel=*pRM;
+        pDst[x+0] = (Pel) ( ((32-deltaFract)*lastRefMainPel + deltaFract*thisRefMainPel +16) >> 5 );
+        lastRefMainPel=thisRefMainPel;
+      }
+    }
+    else
+    {
+      // Just copy the integer samples
+      for (Int x=0;x<width; x++)
+      {
+        pDst[x] = refMain[x+deltaInt+1];
+      }
+    }
+  }
+}
+
 /**
  * 亮度块的帧内预测
  **/
-Void TComPrediction::predIntraAng( const ComponentID compID, UInt uiDirMode, Pel* piOrg /* Will be null for decoding */, UInt uiOrgStride, Pel* piPred, UInt uiStride, TComTU &rTu, const Bool bUseFilteredPredSamples, const Bool bUseLosslessDPCM )
+Void TComPrediction::predIntraAng( const ComponentID compID, UInt uiDirMode, Pel* piOrg /* Will be null for decoding */, UInt uiOrgStride, Pel* piPred, UInt uiStride, TComTU &rTu, const Bool bUseFilteredPredSamples, const Bool bUseLosslessDPCM, const Bool bTransposeHorModes )
 {
   const ChannelType    channelType = toChannelType(compID);
   const TComRectangle &rect        = rTu.getRect(isLuma(compID) ? COMPONENT_Y : COMPONENT_Cb);
@@ -454,7 +462,7 @@ Void TComPrediction::predIntraAng( const ComponentID compID, UInt uiDirMode, Pel
     if ( uiDirMode == PLANAR_IDX )
     {
       // planar预测模式
-      xPredIntraPlanar( ptrSrc+sw+1, sw, pDst, uiStride, iWidth, iHeight );
+      m_predIntraPlanar( ptrSrc+sw+1, sw, pDst, uiStride, iWidth, iHeight );
     }
     else
     {
@@ -469,7 +477,7 @@ Void TComPrediction::predIntraAng( const ComponentID compID, UInt uiDirMode, Pel
 #else
       const Int channelsBitDepthForPrediction = rTu.getCU()->getSlice()->getSPS()->getBitDepth(channelType);
 #endif
-      xPredIntraAng( channelsBitDepthForPrediction, ptrSrc+sw+1, sw, pDst, uiStride, iWidth, iHeight, channelType, uiDirMode, enableEdgeFilters );
+      xPredIntraAng( channelsBitDepthForPrediction, ptrSrc+sw+1, sw, pDst, uiStride, iWidth, iHeight, channelType, uiDirMode, enableEdgeFilters, bTransposeHorModes );
       // 观察是否为DC模式
       if( uiDirMode == DC_IDX )
       {
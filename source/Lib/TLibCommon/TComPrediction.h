@@ -87,8 +87,22 @@ protected:
   Pel*   m_pLumaRecBuffer;       ///< array for downsampled reconstructed luma sample
   Int    m_iLumaRecStride;       ///< stride of #m_pLumaRecBuffer array
 
-  Void xPredIntraAng            ( Int bitDepth, const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, UInt width, UInt height, ChannelType channelType, UInt dirMode, const Bool bEnableEdgeFilters );
-  Void xPredIntraPlanar         ( const Pel* pSrc, Int srcStride, Pel* rpDst, Int dstStride, UInt width, UInt height );
+  Void xPredIntraAng            ( Int bitDepth, const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, UInt width, UInt height, ChannelType channelType, UInt dirMode, const Bool bEnableEdgeFilters, const Bool bTransposeHorModes );
+
+  // angular prediction of a block in the vertical orientation from the main reference (refMain[0] being the corner
+  // sample), the rows being interpolated at the multiples of intraPredAngle/32; planar prediction from the reference
+  // samples around pSrc
+  typedef Void (*FpPredIntraAngBlock)( const Pel* refMain, Pel* pDst, Int dstStride, Int width, Int height, Int intraPredAngle );
+  typedef Void (*FpPredIntraPlanar)  ( const Pel* pSrc, Int srcStride, Pel* rpDst, Int dstStride, UInt width, UInt height );
+  static Void xPredIntraAngBlock( const Pel* refMain, Pel* pDst, Int dstStride, Int width, Int height, Int intraPredAngle );
+  static Void xPredIntraPlanar  ( const Pel* pSrc, Int srcStride, Pel* rpDst, Int dstStride, UInt width, UInt height );
+#if ENABLE_SIMD_OPT_INTRAPRED
+  Void initIntraPredictionX86();
+  template <X86_VEXT vext> Void _initIntraPredictionX86();
+#endif
+
+  FpPredIntraAngBlock m_predIntraAngBlock;
+  FpPredIntraPlanar   m_predIntraPlanar;
 
   // motion compensation functions
   Void xPredInterUni            ( TComDataCU* pcCU,                          UInt uiPartAddr,               Int iWidth, Int iHeight, RefPicList eRefPicList, TComYuv* pcYuvPred, Bool bi=false          );
@@ -117,7 +131,8 @@ public:
   Void getMvPredAMVP              ( TComDataCU* pcCU, UInt uiPartIdx, UInt uiPartAddr, RefPicList eRefPicList, TComMv& rcMvPred );
 
   // Angular Intra
-  Void predIntraAng               ( const ComponentID compID, UInt uiDirMode, Pel *piOrg /* Will be null for decoding */, UInt uiOrgStride, Pel* piPred, UInt uiStride, TComTU &rTu, const Bool bUseFilteredPredSamples, const Bool bUseLosslessDPCM = false );
+  /// with bTransposeHorModes, the horizontal angular modes (2 to 17) are output transposed, i.e. without the final flip
+  Void predIntraAng               ( const ComponentID compID, UInt uiDirMode, Pel *piOrg /* Will be null for decoding */, UInt uiOrgStride, Pel* piPred, UInt uiStride, TComTU &rTu, const Bool bUseFilteredPredSamples, const Bool bUseLosslessDPCM = false, const Bool bTransposeHorModes = false );
 
   Pel  predIntraGetPredValDC      ( const Pel* pSrc, Int iSrcStride, UInt iWidth, UInt iHeight);
 
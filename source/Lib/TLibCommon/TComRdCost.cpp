@@ -167,6 +167,22 @@ Void TComRdCost::init()
   m_afpDistortFunc[DF_HADS64 ] = TComRdCost::xGetHADs;
   m_afpDistortFunc[DF_HADS16N] = TComRdCost::xGetHADs;
 
+  for ( Int i = 0; i < DF_TOTAL_FUNCTIONS; i++ )
+  {
+    m_afpMultiDistortFunc[i] = NULL;
+  }
+  for ( Int i = DF_SAD; i <= DF_SAD16N; i++ )
+  {
+    m_afpMultiDistortFunc[i] = TComRdCost::xGetSADMulti;
+  }
+  m_afpMultiDistortFunc[DF_SAD12] = TComRdCost::xGetSADMulti;
+  m_afpMultiDistortFunc[DF_SAD24] = TComRdCost::xGetSADMulti;
+  m_afpMultiDistortFunc[DF_SAD48] = TComRdCost::xGetSADMulti;
+
+#if ENABLE_SIMD_OPT_DIST
+  initRdCostX86();
+#endif
+
   m_costMode                   = COST_STANDARD_LOSSY;
 
   m_motionLambda               = 0;
@@ -214,21 +230,23 @@ Void TComRdCost::setDistParam( const TComPattern* const pcPatternKey, const Pel*
   // set Block Width / Height
   rcDistParam.iCols    = pcPatternKey->getROIYWidth();
   rcDistParam.iRows    = pcPatternKey->getROIYHeight();
-  rcDistParam.DistFunc = m_afpDistortFunc[DF_SAD + g_aucConvertToBit[ rcDistParam.iCols ] + 1 ];
   rcDistParam.m_maximumDistortionForEarlyExit = std::numeric_limits<Distortion>::max();
 
+  Int eDFunc = DF_SAD + g_aucConvertToBit[ rcDistParam.iCols ] + 1;
   if (rcDistParam.iCols == 12)
   {
-    rcDistParam.DistFunc = m_afpDistortFunc[DF_SAD12];
+    eDFunc = DF_SAD12;
   }
   else if (rcDistParam.iCols == 24)
   {
-    rcDistParam.DistFunc = m_afpDistortFunc[DF_SAD24];
+    eDFunc = DF_SAD24;
   }
   else if (rcDistParam.iCols == 48)
   {
-    rcDistParam.DistFunc = m_afpDistortFunc[DF_SAD48];
+    eDFunc = DF_SAD48;
   }
+  rcDistParam.DistFunc      = m_afpDistortFunc[eDFunc];
+  rcDistParam.MultiDistFunc = m_afpMultiDistortFunc[eDFunc];
 
   // initialize
   rcDistParam.iSubShift  = 0;
@@ -750,6 +768,18 @@ Distortion TComRdCost::xGetSAD16( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+/** SAD of one original block against several candidate blocks, one call of the single block function per candidate
+ */
+Void TComRdCost::xGetSADMulti( const DistParam* pcDtParam, const Pel* const* ppCur, Int iNumCand, Distortion* puiDist )
+{
+  DistParam cDtParam = *pcDtParam;
+  for ( Int i = 0; i < iNumCand; i++ )
+  {
+    cDtParam.pCur = ppCur[i];
+    puiDist[i]    = cDtParam.DistFunc( &cDtParam );
+  }
+}
+
 Distortion TComRdCost::xGetSAD12( DistParam* pcDtParam )
 {
   if ( pcDtParam->bApplyWeight )
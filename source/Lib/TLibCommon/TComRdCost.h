@@ -60,6 +60,13 @@ typedef Distortion (*FpDistFunc)(
     DistParam *); // TODO: can this pointer be replaced with a reference? -
                   // there are no NULL checks on pointer.
 
+// distortion of the same original block against several candidate blocks
+// with the stride of pCur: puiDist[i] is the value DistFunc returns when
+// pCur is ppCur[i] (and the early exit threshold is not reached)
+typedef Void (*FpMultiDistFunc)(const DistParam *pcDtParam,
+                                const Pel *const *ppCur, Int iNumCand,
+                                Distortion *puiDist);
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -75,6 +82,7 @@ public:
   Int iCols;
   Int iStep;
   FpDistFunc DistFunc;
+  FpMultiDistFunc MultiDistFunc; // only set up for integer motion search SAD
   Int bitDepth;
 
   Bool bApplyWeight; // whether weighted prediction is used or not
@@ -94,7 +102,8 @@ public:
 
   DistParam()
       : pOrg(NULL), pCur(NULL), iStrideOrg(0), iStrideCur(0), iRows(0),
-        iCols(0), iStep(1), DistFunc(NULL), bitDepth(0), bApplyWeight(false),
+        iCols(0), iStep(1), DistFunc(NULL), MultiDistFunc(NULL), bitDepth(0),
+        bApplyWeight(false),
         bIsBiPred(false), wpCur(NULL), compIdx(MAX_NUM_COMPONENT),
         m_maximumDistortionForEarlyExit(std::numeric_limits<Distortion>::max()),
         iSubShift(0) {}
@@ -106,6 +115,8 @@ private:
   // for distortion
 
   FpDistFunc m_afpDistortFunc[DF_TOTAL_FUNCTIONS]; // [eDFunc]
+  FpMultiDistFunc
+      m_afpMultiDistortFunc[DF_TOTAL_FUNCTIONS]; // [eDFunc], SAD only
   CostMode m_costMode;
   Double m_distortionWeight[MAX_NUM_COMPONENT]; // only chroma values are used.
   Double m_dLambda;
@@ -150,6 +161,12 @@ public:
 
   // Distortion Functions
   Void init();
+#if ENABLE_SIMD_OPT_DIST
+  Void initRdCostX86();
+  template <X86_VEXT vext> Void _initRdCostX86();
+#endif
+  FpDistFunc getDistFunc(DFunc eDFunc) const { return m_afpDistortFunc[eDFunc]; }
+  FpMultiDistFunc getMultiDistFunc(DFunc eDFunc) const { return m_afpMultiDistortFunc[eDFunc]; }
 
   Void setDistParam(UInt uiBlkWidth, UInt uiBlkHeight, DFunc eDFunc,
                     DistParam &rcDistParam);
@@ -215,6 +232,9 @@ private:
   static Distortion xGetSAD64(DistParam *pcDtParam);
   static Distortion xGetSAD16N(DistParam *pcDtParam);
 
+  static Void xGetSADMulti(const DistParam *pcDtParam, const Pel *const *ppCur,
+                           Int iNumCand, Distortion *puiDist);
+
   static Distortion xGetSAD12(DistParam *pcDtParam);
   static Distortion xGetSAD24(DistParam *pcDtParam);
   static Distortion xGetSAD48(DistParam *pcDtParam);
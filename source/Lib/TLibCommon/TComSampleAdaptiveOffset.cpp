@@ -104,32 +104,25 @@ const SAOBlkParam& SAOBlkParam::operator= (const SAOBlkParam& src)
 TComSampleAdaptiveOffset::TComSampleAdaptiveOffset()
 {
   m_tempPicYuv = NULL;
-  m_lineBufWidth = 0;
-  m_signLineBuf1 = NULL;
-  m_signLineBuf2 = NULL;
+  m_pcThreadPool = NULL;
+  m_edgeOffset = xEdgeOffset;
+  m_edgeStats  = xEdgeStats;
+#if ENABLE_SIMD_OPT_SAO
+  initSampleAdaptiveOffsetX86();
+#endif
 }
 
 
 TComSampleAdaptiveOffset::~TComSampleAdaptiveOffset()
 {
   destroy();
-
-  if (m_signLineBuf1)
-  {
-    delete[] m_signLineBuf1;
-    m_signLineBuf1 = NULL;
-  }
-  if (m_signLineBuf2)
-  {
-    delete[] m_signLineBuf2;
-    m_signLineBuf2 = NULL;
-  }
 }
 
-Void TComSampleAdaptiveOffset::create( Int picWidth, Int picHeight, ChromaFormat format, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth, UInt lumaBitShift, UInt chromaBitShift )
+Void TComSampleAdaptiveOffset::create( Int picWidth, Int picHeight, ChromaFormat format, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth, UInt lumaBitShift, UInt chromaBitShift, TComThreadPool* pcThreadPool )
 {
   destroy();
 
+  m_pcThreadPool    = ( pcThreadPool && pcThreadPool->getNumThreads() > 1 ) ? pcThreadPool : NULL;
   m_picWidth        = picWidth;
   m_picHeight       = picHeight;
   m_chromaFormatIDC = format;
@@ -162,6 +155,7 @@ Void TComSampleAdaptiveOffset::destroy()
     delete m_tempPicYuv;
     m_tempPicYuv = NULL;
   }
+  m_pcThreadPool = NULL;
 }
 
 Void TComSampleAdaptiveOffset::invertQuantOffsets(ComponentID compIdx, Int typeIdc, Int typeAuxInfo, Int* dstOffsets, Int* srcOffsets)
@@ -310,222 +304,115 @@ Void TComSampleAdaptiveOffset::reconstructBlkSAOParams(TComPic* pic, SAOBlkParam
 }
 
 
-Void TComSampleAdaptiveOffset::offsetBlock(const Int channelBitDepth, Int typeIdx, Int* offset
-                                          , Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride,  Int width, Int height
-                                          , Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail)
+/** Edge offset of a block.
+ * The class of each sample is derived from the sign of its differences with the two neighbours at offsets
+ * neighbourA and neighbourB, so that the samples of a block can be processed in any order.
+ */
+Void TComSampleAdaptiveOffset::xEdgeOffset(const Pel* srcBlk, Int srcStride, Pel* resBlk, Int resStride, Int neighbourA, Int neighbourB, Int width, Int height, const Int* offset, Int maxSampleValueIncl)
 {
-  if(m_lineBufWidth != m_maxCUWidth)
+  for (Int y=0; y< height; y++)
   {
-    m_lineBufWidth = m_maxCUWidth;
-
-    if (m_signLineBuf1)
+    for (Int x=0; x< width; x++)
     {
-      delete[] m_signLineBuf1;
-      m_signLineBuf1 = NULL;
+      const Int edgeType = sgn(srcBlk[x] - srcBlk[x+ neighbourA]) + sgn(srcBlk[x] - srcBlk[x+ neighbourB]) + 2;
+      resBlk[x] = Clip3<Int>(0, maxSampleValueIncl, srcBlk[x] + offset[edgeType]);
     }
-    m_signLineBuf1 = new SChar[m_lineBufWidth+1];
+    srcBlk += srcStride;
+    resBlk += resStride;
+  }
+}
 
-    if (m_signLineBuf2)
+/** Edge offset statistics of a block (sum of the original minus source differences and number of samples of each
+ * class), used by the encoder.
+ */
+Void TComSampleAdaptiveOffset::xEdgeStats(const Pel* srcBlk, Int srcStride, const Pel* orgBlk, Int orgStride, Int neighbourA, Int neighbourB, Int width, Int height, Int64* diff, Int64* count)
+{
+  for (Int y=0; y< height; y++)
+  {
+    for (Int x=0; x< width; x++)
     {
-      delete[] m_signLineBuf2;
-      m_signLineBuf2 = NULL;
+      const Int edgeType = sgn(srcBlk[x] - srcBlk[x+ neighbourA]) + sgn(srcBlk[x] - srcBlk[x+ neighbourB]) + 2;
+      diff [edgeType] += (orgBlk[x] - srcBlk[x]);
+      count[edgeType] ++;
     }
-    m_signLineBuf2 = new SChar[m_lineBufWidth+1];
+    srcBlk += srcStride;
+    orgBlk += orgStride;
   }
+}
 
+Void TComSampleAdaptiveOffset::offsetBlock(const Int channelBitDepth, Int typeIdx, Int* offset
+                                          , Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride,  Int width, Int height
+                                          , Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail)
+{
   const Int maxSampleValueIncl = (1<< channelBitDepth )-1;
 
-  Int x,y, startX, startY, endX, endY, edgeType;
+  Int x,y, startX, startY, endX, endY;
   Int firstLineStartX, firstLineEndX, lastLineStartX, lastLineEndX;
-  SChar signLeft, signRight, signDown;
 
   Pel* srcLine = srcBlk;
   Pel* resLine = resBlk;
 
+  // edge offset of the samples [startX, endX) of numLines lines from line y
+  auto edgeOffsetLines = [&](Int neighbourA, Int neighbourB, Int y, Int numLines, Int startX, Int endX)
+  {
+    if (numLines > 0 && endX > startX)
+    {
+      m_edgeOffset(srcBlk + y*srcStride + startX, srcStride, resBlk + y*resStride + startX, resStride, neighbourA, neighbourB, endX - startX, numLines, offset, maxSampleValueIncl);
+    }
+  };
+
   switch(typeIdx)
   {
   case SAO_TYPE_EO_0:
     {
-      offset += 2;
       startX = isLeftAvail ? 0 : 1;
       endX   = isRightAvail ? width : (width -1);
-      for (y=0; y< height; y++)
-      {
-        signLeft = (SChar)sgn(srcLine[startX] - srcLine[startX-1]);
-        for (x=startX; x< endX; x++)
-        {
-          signRight = (SChar)sgn(srcLine[x] - srcLine[x+1]);
-          edgeType =  signRight + signLeft;
-          signLeft  = -signRight;
-
-          resLine[x] = Clip3<Int>(0, maxSampleValueIncl, srcLine[x] + offset[edgeType]);
-        }
-        srcLine  += srcStride;
-        resLine += resStride;
-      }
-
+      edgeOffsetLines(-1, 1, 0, height, startX, endX);
     }
     break;
   case SAO_TYPE_EO_90:
     {
-      offset += 2;
-      SChar *signUpLine = m_signLineBuf1;
-
       startY = isAboveAvail ? 0 : 1;
       endY   = isBelowAvail ? height : height-1;
-      if (!isAboveAvail)
-      {
-        srcLine += srcStride;
-        resLine += resStride;
-      }
-
-      Pel* srcLineAbove= srcLine- srcStride;
-      for (x=0; x< width; x++)
-      {
-        signUpLine[x] = (SChar)sgn(srcLine[x] - srcLineAbove[x]);
-      }
-
-      Pel* srcLineBelow;
-      for (y=startY; y<endY; y++)
-      {
-        srcLineBelow= srcLine+ srcStride;
-
-        for (x=0; x< width; x++)
-        {
-          signDown  = (SChar)sgn(srcLine[x] - srcLineBelow[x]);
-          edgeType = signDown + signUpLine[x];
-          signUpLine[x]= -signDown;
-
-          resLine[x] = Clip3<Int>(0, maxSampleValueIncl, srcLine[x] + offset[edgeType]);
-        }
-        srcLine += srcStride;
-        resLine += resStride;
-      }
-
+      edgeOffsetLines(-srcStride, srcStride, startY, endY - startY, 0, width);
     }
     break;
   case SAO_TYPE_EO_135:
     {
-      offset += 2;
-      SChar *signUpLine, *signDownLine, *signTmpLine;
-
-      signUpLine  = m_signLineBuf1;
-      signDownLine= m_signLineBuf2;
-
       startX = isLeftAvail ? 0 : 1 ;
       endX   = isRightAvail ? width : (width-1);
 
-      //prepare 2nd line's upper sign
-      Pel* srcLineBelow= srcLine+ srcStride;
-      for (x=startX; x< endX+1; x++)
-      {
-        signUpLine[x] = (SChar)sgn(srcLineBelow[x] - srcLine[x- 1]);
-      }
-
       //1st line
-      Pel* srcLineAbove= srcLine- srcStride;
       firstLineStartX = isAboveLeftAvail ? 0 : 1;
       firstLineEndX   = isAboveAvail? endX: 1;
-      for(x= firstLineStartX; x< firstLineEndX; x++)
-      {
-        edgeType  =  sgn(srcLine[x] - srcLineAbove[x- 1]) - signUpLine[x+1];
-
-        resLine[x] = Clip3<Int>(0, maxSampleValueIncl, srcLine[x] + offset[edgeType]);
-      }
-      srcLine  += srcStride;
-      resLine  += resStride;
-
+      edgeOffsetLines(-srcStride-1, srcStride+1, 0, 1, firstLineStartX, firstLineEndX);
 
       //middle lines
-      for (y= 1; y< height-1; y++)
-      {
-        srcLineBelow= srcLine+ srcStride;
-
-        for (x=startX; x<endX; x++)
-        {
-          signDown =  (SChar)sgn(srcLine[x] - srcLineBelow[x+ 1]);
-          edgeType =  signDown + signUpLine[x];
-          resLine[x] = Clip3<Int>(0, maxSampleValueIncl, srcLine[x] + offset[edgeType]);
-
-          signDownLine[x+1] = -signDown;
-        }
-        signDownLine[startX] = (SChar)sgn(srcLineBelow[startX] - srcLine[startX-1]);
-
-        signTmpLine  = signUpLine;
-        signUpLine   = signDownLine;
-        signDownLine = signTmpLine;
-
-        srcLine += srcStride;
-        resLine += resStride;
-      }
+      edgeOffsetLines(-srcStride-1, srcStride+1, 1, height-2, startX, endX);
 
       //last line
-      srcLineBelow= srcLine+ srcStride;
       lastLineStartX = isBelowAvail ? startX : (width -1);
       lastLineEndX   = isBelowRightAvail ? width : (width -1);
-      for(x= lastLineStartX; x< lastLineEndX; x++)
-      {
-        edgeType =  sgn(srcLine[x] - srcLineBelow[x+ 1]) + signUpLine[x];
-        resLine[x] = Clip3<Int>(0, maxSampleValueIncl, srcLine[x] + offset[edgeType]);
-
-      }
+      edgeOffsetLines(-srcStride-1, srcStride+1, height-1, 1, lastLineStartX, lastLineEndX);
     }
     break;
   case SAO_TYPE_EO_45:
     {
-      offset += 2;
-      SChar *signUpLine = m_signLineBuf1+1;
-
       startX = isLeftAvail ? 0 : 1;
       endX   = isRightAvail ? width : (width -1);
 
-      //prepare 2nd line upper sign
-      Pel* srcLineBelow= srcLine+ srcStride;
-      for (x=startX-1; x< endX; x++)
-      {
-        signUpLine[x] = (SChar)sgn(srcLineBelow[x] - srcLine[x+1]);
-      }
-
-
       //first line
-      Pel* srcLineAbove= srcLine- srcStride;
       firstLineStartX = isAboveAvail ? startX : (width -1 );
       firstLineEndX   = isAboveRightAvail ? width : (width-1);
-      for(x= firstLineStartX; x< firstLineEndX; x++)
-      {
-        edgeType = sgn(srcLine[x] - srcLineAbove[x+1]) -signUpLine[x-1];
-        resLine[x] = Clip3<Int>(0, maxSampleValueIncl, srcLine[x] + offset[edgeType]);
-      }
-      srcLine += srcStride;
-      resLine += resStride;
+      edgeOffsetLines(-srcStride+1, srcStride-1, 0, 1, firstLineStartX, firstLineEndX);
 
       //middle lines
-      for (y= 1; y< height-1; y++)
-      {
-        srcLineBelow= srcLine+ srcStride;
-
-        for(x= startX; x< endX; x++)
-        {
-          signDown =  (SChar)sgn(srcLine[x] - srcLineBelow[x-1]);
-          edgeType =  signDown + signUpLine[x];
-          resLine[x] = Clip3<Int>(0, maxSampleValueIncl, srcLine[x] + offset[edgeType]);
-          signUpLine[x-1] = -signDown;
-        }
-        signUpLine[endX-1] = (SChar)sgn(srcLineBelow[endX-1] - srcLine[endX]);
-        srcLine  += srcStride;
-        resLine += resStride;
-      }
+      edgeOffsetLines(-srcStride+1, srcStride-1, 1, height-2, startX, endX);
 
       //last line
-      srcLineBelow= srcLine+ srcStride;
       lastLineStartX = isBelowLeftAvail ? 0 : 1;
       lastLineEndX   = isBelowAvail ? endX : 1;
-      for(x= lastLineStartX; x< lastLineEndX; x++)
-      {
-        edgeType = sgn(srcLine[x] - srcLineBelow[x-1]) + signUpLine[x];
-        resLine[x] = Clip3<Int>(0, maxSampleValueIncl, srcLine[x] + offset[edgeType]);
-
-      }
+      edgeOffsetLines(-srcStride+1, srcStride-1, height-1, 1, lastLineStartX, lastLineEndX);
     }
     break;
   case SAO_TYPE_BO:
@@ -630,13 +517,104 @@ Void TComSampleAdaptiveOffset::SAOProcess(TComPic* pDecPic)
   TComPicYuv* resYuv = pDecPic->getPicYuvRec();
   TComPicYuv* srcYuv = m_tempPicYuv;
   resYuv->copyToPic(srcYuv);
+  offsetCTUs(srcYuv, resYuv, pDecPic->getPicSym()->getSAOBlkParam(), pDecPic);
+}
+
+/** Apply the SAO parameters of every CTU of a picture.
+ * \param srcYuv       samples before SAO
+ * \param resYuv       output samples, distinct from srcYuv
+ * \param saoBlkParams reconstructed SAO parameters of the CTUs
+ * \param pPic         picture (TComPic) pointer
+ *
+ * \note Each CTU only reads srcYuv and only writes its own samples of resYuv, so the CTU rows are processed
+ *       concurrently when a thread pool is available.
+ */
+Void TComSampleAdaptiveOffset::offsetCTUs(TComPicYuv* srcYuv, TComPicYuv* resYuv, SAOBlkParam* saoBlkParams, TComPic* pPic)
+{
+  if (m_pcThreadPool && m_numCTUInHeight > 1)
+  {
+    for(Int ctuRowIdx = 0; ctuRowIdx < m_numCTUInHeight; ctuRowIdx++)
+    {
+      m_pcThreadPool->addTask( [this, ctuRowIdx, srcYuv, resYuv, saoBlkParams, pPic]( Int )
+      {
+        for(Int ctuRsAddr = ctuRowIdx*m_numCTUInWidth; ctuRsAddr < (ctuRowIdx+1)*m_numCTUInWidth; ctuRsAddr++)
+        {
+          offsetCTU(ctuRsAddr, srcYuv, resYuv, saoBlkParams[ctuRsAddr], pPic);
+        }
+      } );
+    }
+    m_pcThreadPool->waitForAll();
+    return;
+  }
+
   for(Int ctuRsAddr= 0; ctuRsAddr < m_numCTUsPic; ctuRsAddr++)
   {
-    offsetCTU(ctuRsAddr, srcYuv, resYuv, (pDecPic->getPicSym()->getSAOBlkParam())[ctuRsAddr], pDecPic);
+    offsetCTU(ctuRsAddr, srcYuv, resYuv, saoBlkParams[ctuRsAddr], pPic);
   } //ctu
 }
 
 
+/** SAO process of one CTU row.
+ * \param pDecPic   picture (TComPic) pointer
+ * \param ctuRowIdx index of the CTU row
+ *
+ * \note Must be called for the rows in order, once the row and the row below it have been deblocked. The deblocked
+ *       samples of the row and the first line of the row below are kept in m_tempPicYuv, which then holds all the
+ *       samples that SAOProcess would read for this row.
+ */
+Void TComSampleAdaptiveOffset::SAOProcessCtuRow(TComPic* pDecPic, Int ctuRowIdx)
+{
+  SAOBlkParam* saoBlkParams = pDecPic->getPicSym()->getSAOBlkParam();
+  const Int firstCtuRsAddr  = ctuRowIdx*m_numCTUInWidth;
+
+  for(Int ctuRsAddr = firstCtuRsAddr; ctuRsAddr < firstCtuRsAddr + m_numCTUInWidth; ctuRsAddr++)
+  {
+    SAOBlkParam* mergeList[NUM_SAO_MERGE_TYPES] = { NULL };
+    getMergeList(pDecPic, ctuRsAddr, saoBlkParams, mergeList);
+
+    reconstructBlkSAOParam(saoBlkParams[ctuRsAddr], mergeList);
+  }
+
+  xCopyDeblockedCtuRow(pDecPic, ctuRowIdx);
+
+  for(Int ctuRsAddr = firstCtuRsAddr; ctuRsAddr < firstCtuRsAddr + m_numCTUInWidth; ctuRsAddr++)
+  {
+    offsetCTU(ctuRsAddr, m_tempPicYuv, pDecPic->getPicYuvRec(), saoBlkParams[ctuRsAddr], pDecPic);
+  }
+}
+
+/** Copy the deblocked samples of a CTU row and the first line of the row below into m_tempPicYuv.
+ * \param pDecPic   picture (TComPic) pointer
+ * \param ctuRowIdx index of the CTU row
+ */
+Void TComSampleAdaptiveOffset::xCopyDeblockedCtuRow(TComPic* pDecPic, Int ctuRowIdx)
+{
+  const TComPicYuv* srcYuv = pDecPic->getPicYuvRec();
+  const Int numberOfComponents = getNumberValidComponents(m_chromaFormatIDC);
+  const Int yPos = ctuRowIdx*m_maxCUHeight;
+
+  for(Int compIdx = 0; compIdx < numberOfComponents; compIdx++)
+  {
+    const ComponentID component = ComponentID(compIdx);
+    const UInt componentScaleX = getComponentScaleX(component, m_chromaFormatIDC);
+    const UInt componentScaleY = getComponentScaleY(component, m_chromaFormatIDC);
+    const Int  srcStride = srcYuv->getStride(component);
+    const Int  dstStride = m_tempPicYuv->getStride(component);
+    const Int  blkYPos   = yPos >> componentScaleY;
+    const Int  blkHeight = std::min((m_maxCUHeight >> componentScaleY) + 1, (m_picHeight >> componentScaleY) - blkYPos);
+    const Int  blkWidth  = m_picWidth >> componentScaleX;
+    const Pel* src = srcYuv->getAddr(component) + blkYPos*srcStride;
+          Pel* dst = m_tempPicYuv->getAddr(component) + blkYPos*dstStride;
+
+    for(Int y = 0; y < blkHeight; y++)
+    {
+      ::memcpy(dst, src, sizeof(Pel)*blkWidth);
+      src += srcStride;
+      dst += dstStride;
+    }
+  }
+}
+
 /** PCM LF disable process.
  * \param pcPic picture (TComPic) pointer
  *
@@ -665,6 +643,26 @@ Void TComSampleAdaptiveOffset::xPCMRestoration(TComPic* pcPic)
   }
 }
 
+/** CTU-row-level PCM restoration.
+ * \param pcPic     picture (TComPic) pointer
+ * \param ctuRowIdx index of the CTU row
+ */
+Void TComSampleAdaptiveOffset::PCMLFDisableProcessCtuRow(TComPic* pcPic, Int ctuRowIdx)
+{
+  const Int firstCtuRsAddr = ctuRowIdx*m_numCTUInWidth;
+
+  for(Int ctuRsAddr = firstCtuRsAddr; ctuRsAddr < firstCtuRsAddr + m_numCTUInWidth; ctuRsAddr++)
+  {
+    TComDataCU* pcCU = pcPic->getCtu(ctuRsAddr);
+    const TComSPS &sps = *(pcCU->getSlice()->getSPS());
+
+    if((sps.getUsePCM() && sps.getPCMFilterDisableFlag()) || pcCU->getSlice()->getPPS()->getTransquantBypassEnabledFlag())
+    {
+      xPCMCURestoration(pcCU, 0, 0);
+    }
+  }
+}
+
 /** PCM CU restoration.
  * \param pcCU            pointer to current CU
  * \param uiAbsZorderIdx  part index
@@ -692,7 +690,7 @@ Void TComSampleAdaptiveOffset::xPCMCURestoration ( TComDataCU* pcCU, UInt uiAbsZ
   }
 
   // restore PCM samples
-  if ((pcCU->getIPCMFlag(uiAbsZorderIdx)&& pcPic->getSlice(0)->getSPS()->getPCMFilterDisableFlag()) || pcCU->isLosslessCoded( uiAbsZorderIdx))
+  if ((pcCU->getIPCMFlag(uiAbsZorderIdx)&& pcCU->getSlice()->getSPS()->getPCMFilterDisableFlag()) || pcCU->isLosslessCoded( uiAbsZorderIdx))
   {
     const UInt numComponents=pcPic->getNumberValidComponents();
     for(UInt comp=0; comp<numComponents; comp++)
@@ -40,6 +40,7 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#include "TComThreadPool.h"
 
 //! \ingroup TLibCommon
 //! \{
@@ -66,10 +67,14 @@ public:
   TComSampleAdaptiveOffset();
   virtual ~TComSampleAdaptiveOffset();
   Void SAOProcess(TComPic* pDecPic);
-  Void create( Int picWidth, Int picHeight, ChromaFormat format, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth, UInt lumaBitShift, UInt chromaBitShift );
+  /// the CTUs are processed concurrently, by CTU rows, when pcThreadPool has several threads
+  Void create( Int picWidth, Int picHeight, ChromaFormat format, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth, UInt lumaBitShift, UInt chromaBitShift, TComThreadPool* pcThreadPool = NULL );
   Void destroy();
   Void reconstructBlkSAOParams(TComPic* pic, SAOBlkParam* saoBlkParams);
   Void PCMLFDisableProcess (TComPic* pcPic);
+  // CTU-row-level equivalents of reconstructBlkSAOParams + SAOProcess and of PCMLFDisableProcess, for the rows in order
+  Void SAOProcessCtuRow(TComPic* pDecPic, Int ctuRowIdx);
+  Void PCMLFDisableProcessCtuRow(TComPic* pcPic, Int ctuRowIdx);
   static Int getMaxOffsetQVal(const Int channelBitDepth) { return (1<<(std::min<Int>(channelBitDepth,MAX_SAO_TRUNCATED_BITDEPTH)-5))-1; } //Table 9-32, inclusive
 
 protected:
@@ -79,9 +84,22 @@ protected:
   Void reconstructBlkSAOParam(SAOBlkParam& recParam, SAOBlkParam* mergeList[NUM_SAO_MERGE_TYPES]);
   Int  getMergeList(TComPic* pic, Int ctuRsAddr, SAOBlkParam* blkParams, SAOBlkParam* mergeList[NUM_SAO_MERGE_TYPES]);
   Void offsetCTU(Int ctuRsAddr, TComPicYuv* srcYuv, TComPicYuv* resYuv, SAOBlkParam& saoblkParam, TComPic* pPic);
+  Void offsetCTUs(TComPicYuv* srcYuv, TComPicYuv* resYuv, SAOBlkParam* saoBlkParams, TComPic* pPic);
+  Void xCopyDeblockedCtuRow(TComPic* pDecPic, Int ctuRowIdx);
   Void xPCMRestoration(TComPic* pcPic);
   Void xPCMCURestoration ( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth );
   Void xPCMSampleRestoration (TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, const ComponentID compID);
+
+  // edge offset class of a sample: sgn(cur - neighbourA) + sgn(cur - neighbourB) + 2, the neighbours being at the
+  // given offsets from the sample; offset, diff and count are indexed by the class
+  typedef Void (*FpEdgeOffset)(const Pel* srcBlk, Int srcStride, Pel* resBlk, Int resStride, Int neighbourA, Int neighbourB, Int width, Int height, const Int* offset, Int maxSampleValueIncl);
+  typedef Void (*FpEdgeStats) (const Pel* srcBlk, Int srcStride, const Pel* orgBlk, Int orgStride, Int neighbourA, Int neighbourB, Int width, Int height, Int64* diff, Int64* count);
+  static Void xEdgeOffset(const Pel* srcBlk, Int srcStride, Pel* resBlk, Int resStride, Int neighbourA, Int neighbourB, Int width, Int height, const Int* offset, Int maxSampleValueIncl);
+  static Void xEdgeStats (const Pel* srcBlk, Int srcStride, const Pel* orgBlk, Int orgStride, Int neighbourA, Int neighbourB, Int width, Int height, Int64* diff, Int64* count);
+#if ENABLE_SIMD_OPT_SAO
+  Void initSampleAdaptiveOffsetX86();
+  template <X86_VEXT vext> Void _initSampleAdaptiveOffsetX86();
+#endif
 protected:
   UInt m_offsetStepLog2[MAX_NUM_COMPONENT]; //offset step
   TComPicYuv*   m_tempPicYuv; //temporary buffer
@@ -93,11 +111,11 @@ protected:
   Int m_numCTUInHeight;
   Int m_numCTUsPic;
 
-
-  Int m_lineBufWidth;
-  SChar* m_signLineBuf1;
-  SChar* m_signLineBuf2;
   ChromaFormat m_chromaFormatIDC;
+  TComThreadPool* m_pcThreadPool;
+
+  FpEdgeOffset m_edgeOffset; ///< edge offset of a block
+  FpEdgeStats  m_edgeStats;  ///< edge offset statistics of a block, gathered by the encoder
 private:
   Bool m_picSAOEnabled[MAX_NUM_COMPONENT];
 };
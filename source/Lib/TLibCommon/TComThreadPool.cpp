@@ -0,0 +1,172 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.cpp
+    \brief    pool of worker threads and CTU row progress tracking
+*/
+
+#include "TComThreadPool.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// TComThreadPool
+// ====================================================================================================================
+
+TComThreadPool::TComThreadPool()
+: m_numPending( 0 )
+, m_terminate ( false )
+{
+}
+
+TComThreadPool::~TComThreadPool()
+{
+  destroy();
+}
+
+Void TComThreadPool::create( Int numThreads )
+{
+  assert( m_threads.empty() );
+  m_terminate = false;
+  for( Int i = 0; i < numThreads; i++ )
+  {
+    m_threads.push_back( std::thread( &TComThreadPool::xWorkerLoop, this, i ) );
+  }
+}
+
+Void TComThreadPool::destroy()
+{
+  if( m_threads.empty() )
+  {
+    return;
+  }
+  waitForAll();
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_terminate = true;
+  }
+  m_taskAvailable.notify_all();
+  for( size_t i = 0; i < m_threads.size(); i++ )
+  {
+    m_threads[i].join();
+  }
+  m_threads.clear();
+}
+
+Void TComThreadPool::addTask( const Task &task )
+{
+  assert( !m_threads.empty() );
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_tasks.push_back( task );
+    m_numPending++;
+  }
+  m_taskAvailable.notify_one();
+}
+
+Void TComThreadPool::waitForAll()
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  while( m_numPending > 0 )
+  {
+    m_allDone.wait( lock );
+  }
+}
+
+Void TComThreadPool::xWorkerLoop( Int threadIdx )
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  for( ;; )
+  {
+    while( m_tasks.empty() && !m_terminate )
+    {
+      m_taskAvailable.wait( lock );
+    }
+    if( m_tasks.empty() )
+    {
+      return;
+    }
+
+    Task task = m_tasks.front();
+    m_tasks.pop_front();
+
+    lock.unlock();
+    task( threadIdx );
+    lock.lock();
+
+    if( --m_numPending == 0 )
+    {
+      m_allDone.notify_all();
+    }
+  }
+}
+
+// ====================================================================================================================
+// TComRowProgress
+// ====================================================================================================================
+
+Void TComRowProgress::reset( Int numRows )
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  m_numDone.assign( numRows, 0 );
+}
+
+Void TComRowProgress::set( Int row, Int numDone )
+{
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_numDone[row] = numDone;
+  }
+  m_changed.notify_all();
+}
+
+Void TComRowProgress::increment( Int row )
+{
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_numDone[row]++;
+  }
+  m_changed.notify_all();
+}
+
+Void TComRowProgress::wait( Int row, Int numDone )
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  while( m_numDone[row] < numDone )
+  {
+    m_changed.wait( lock );
+  }
+}
+
+//! \}
@@ -0,0 +1,115 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.h
+    \brief    pool of worker threads and CTU row progress tracking (header)
+*/
+
+#ifndef __TCOMTHREADPOOL__
+#define __TCOMTHREADPOOL__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CommonDef.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// fixed set of worker threads executing queued tasks in submission order
+class TComThreadPool
+{
+public:
+  /// a task receives the index of the worker thread running it, so that it can select per-thread coding contexts
+  typedef std::function<Void( Int threadIdx )> Task;
+
+  TComThreadPool();
+  ~TComThreadPool();
+
+  Void create      ( Int numThreads );
+  Void destroy     ();
+
+  Int  getNumThreads() const { return Int( m_threads.size() ); }
+
+  /// queue a task; tasks are started in the order they were added
+  Void addTask     ( const Task &task );
+  /// block until every queued task has finished
+  Void waitForAll  ();
+
+private:
+  Void xWorkerLoop ( Int threadIdx );
+
+  std::vector<std::thread> m_threads;
+  std::deque<Task>         m_tasks;
+  std::mutex               m_mutex;
+  std::condition_variable  m_taskAvailable;
+  std::condition_variable  m_allDone;
+  Int                      m_numPending;      ///< queued plus running tasks
+  Bool                     m_terminate;
+};
+
+/// per-row progress counters used to enforce the wavefront dependency between CTU rows
+class TComRowProgress
+{
+public:
+  TComRowProgress() {}
+
+  Void reset       ( Int numRows );
+  /// publish that the first 'numDone' CTUs of the row have been processed
+  Void set         ( Int row, Int numDone );
+  /// publish that one more CTU of the row has been processed, for rows whose CTUs complete out of order
+  Void increment   ( Int row );
+  /// wait until at least 'numDone' CTUs of the row have been processed
+  Void wait        ( Int row, Int numDone );
+
+private:
+  std::vector<Int>         m_numDone;
+  std::mutex               m_mutex;
+  std::condition_variable  m_changed;
+};
+
+//! \}
+
+#endif // __TCOMTHREADPOOL__
@@ -131,6 +131,8 @@ TComTrQuant::TComTrQuant()
   // allocate bit estimation class  (for RDOQ)
   m_pcEstBitsSbac = new estBitsSbacStruct;
   initScalingList();
+
+  initTransformFunctions();
 }
 
 TComTrQuant::~TComTrQuant()
@@ -421,8 +423,10 @@ Void partialButterfly4(TCoeff *src, TCoeff *dst, Int shift, Int line)
 }
 
 // 快速DST算法。FDST和完整矩阵乘法版DST会给出相同结果。
-Void fastForwardDst(TCoeff *block, TCoeff *coeff, Int shift)  // input block, output coeff
+Void fastForwardDst(TCoeff *block, TCoeff *coeff, Int shift, Int line)  // input block, output coeff; line is always 4
 {
+  assert(line == 4);
+
   Int i;
   TCoeff c[4];
   TCoeff rnd_factor = (shift > 0) ? (1<<(shift-1)) : 0;
@@ -447,8 +451,10 @@ Void fastForwardDst(TCoeff *block, TCoeff *coeff, Int shift)  // input block, ou
   }
 }
 
-Void fastInverseDst(TCoeff *tmp, TCoeff *block, Int shift, const TCoeff outputMinimum, const TCoeff outputMaximum)  // input tmp, output block
+Void fastInverseDst(TCoeff *tmp, TCoeff *block, Int shift, Int line, const TCoeff outputMinimum, const TCoeff outputMaximum)  // input tmp, output block; line is always 4
 {
+  assert(line == 4);
+
   Int i;
   TCoeff c[4];
   TCoeff rnd_factor = (shift > 0) ? (1<<(shift-1)) : 0;
@@ -870,7 +876,7 @@ Void partialButterflyInverse32(TCoeff *src, TCoeff *dst, Int shift, Int line, co
 *  \param maxLog2TrDynamicRange [in]
 
 */
-Void xTrMxN(Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange)
+Void TComTrQuant::xTrMxN(Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange)
 {
   const Int TRANSFORM_MATRIX_SHIFT = g_transformMatrixShift[TRANSFORM_FORWARD]; // =6
 
@@ -885,53 +891,13 @@ Void xTrMxN(Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight,
 
   TCoeff tmp[ MAX_TU_SIZE * MAX_TU_SIZE ];
 
-  // 先列变换
-  switch (iWidth)
-  {
-    case 4:
-      {
-        if ((iHeight == 4) && useDST)    // Check for DCT or DST
-        {
-           fastForwardDst( block, tmp, shift_1st );
-        }
-        else
-        {
-          // 把缩放系数 shift_1st 传给矩阵变换
-          partialButterfly4 ( block, tmp, shift_1st, iHeight );
-        }
-      }
-      break;
-
-    case 8:     partialButterfly8 ( block, tmp, shift_1st, iHeight );  break;
-    case 16:    partialButterfly16( block, tmp, shift_1st, iHeight );  break;
-    case 32:    partialButterfly32( block, tmp, shift_1st, iHeight );  break;
-    default:
-      assert(0); exit (1); break;
-  }
+  // the DST is only used for 4x4 blocks
+  const Bool useDST4x4 = useDST && (iWidth == 4) && (iHeight == 4);
 
+  // 先列变换
+  m_forwardTransform[xGetTransformKernelIdx(iWidth,  useDST4x4)]( block, tmp,   shift_1st, iHeight );
   // 再将上一步结果做行变换
-  switch (iHeight)
-  {
-    case 4:
-      {
-        if ((iWidth == 4) && useDST)    // Check for DCT or DST
-        {
-          fastForwardDst( tmp, coeff, shift_2nd );
-        }
-        else
-        {
-          // 把缩放系数 shift_1st 传给矩阵变换
-          partialButterfly4 ( tmp, coeff, shift_2nd, iWidth );
-        }
-      }
-      break;
-
-    case 8:     partialButterfly8 ( tmp, coeff, shift_2nd, iWidth );    break;
-    case 16:    partialButterfly16( tmp, coeff, shift_2nd, iWidth );    break;
-    case 32:    partialButterfly32( tmp, coeff, shift_2nd, iWidth );    break;
-    default:
-      assert(0); exit (1); break;
-  }
+  m_forwardTransform[xGetTransformKernelIdx(iHeight, useDST4x4)]( tmp,   coeff, shift_2nd, iWidth  );
 }
 
 
@@ -944,7 +910,7 @@ Void xTrMxN(Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight,
 *  \param useDST                [in]
 *  \param maxLog2TrDynamicRange [in]
 */
-Void xITrMxN(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange)
+Void TComTrQuant::xITrMxN(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange)
 {
   const Int TRANSFORM_MATRIX_SHIFT = g_transformMatrixShift[TRANSFORM_INVERSE];
 
@@ -958,55 +924,71 @@ Void xITrMxN(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight
 
   TCoeff tmp[MAX_TU_SIZE * MAX_TU_SIZE];
 
-  switch (iHeight)
-  {
-    case 4:
-      {
-        if ((iWidth == 4) && useDST)    // Check for DCT or DST
-        {
-          fastInverseDst( coeff, tmp, shift_1st, clipMinimum, clipMaximum);
-        }
-        else
-        {
-          partialButterflyInverse4 ( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum);
-        }
-      }
-      break;
+  const Bool useDST4x4 = useDST && (iWidth == 4) && (iHeight == 4);
 
-    case  8: partialButterflyInverse8 ( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum); break;
-    case 16: partialButterflyInverse16( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum); break;
-    case 32: partialButterflyInverse32( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum); break;
+  m_inverseTransform[xGetTransformKernelIdx(iHeight, useDST4x4)]( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum );
+  // Clipping here is not in the standard, but is used to protect the "Pel" data type into which the inverse-transformed samples will be copied
+  m_inverseTransform[xGetTransformKernelIdx(iWidth,  useDST4x4)]( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max() );
+}
 
-    default:
-      assert(0); exit (1); break;
-  }
 
-  switch (iWidth)
-  {
-    // Clipping here is not in the standard, but is used to protect the "Pel" data type into which the inverse-transformed samples will be copied
-    case 4:
-      {
-        if ((iHeight == 4) && useDST)    // Check for DCT or DST
-        {
-          fastInverseDst( tmp, block, shift_2nd, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max() );
-        }
-        else
-        {
-          partialButterflyInverse4 ( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max());
-        }
-      }
-      break;
+/** second stage of the inverse transform followed by the reconstruction, C version of TComTrQuant::m_inverseTransformRec
+*  \param src          [in]  output of the first (vertical) inverse transform stage
+*  \param shift        [in]  right shift of the second stage
+*  \param line         [in]  number of rows of the block
+*  \param pResidual    [out] residual, clipped to the Pel range
+*  \param pPred        [in]  prediction
+*  \param pReco        [out] reconstruction, may be equal to pPred
+*  \param bitDepth     [in]  bit depth of the reconstruction
+*/
+template<Void inverseTransform( TCoeff *, TCoeff *, Int, Int, const TCoeff, const TCoeff ), Int N>
+static Void inverseTransformRec(TCoeff *src, Int shift, Int line, Pel *pResidual, UInt uiStride, const Pel *pPred, UInt uiPredStride, Pel *pReco, UInt uiRecoStride, const Int bitDepth)
+{
+  TCoeff block[MAX_TU_SIZE * MAX_TU_SIZE];
 
-    case  8: partialButterflyInverse8 ( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max()); break;
-    case 16: partialButterflyInverse16( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max()); break;
-    case 32: partialButterflyInverse32( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max()); break;
+  inverseTransform( src, block, shift, line, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max() );
 
-    default:
-      assert(0); exit (1); break;
+  for (Int y = 0; y < line; y++)
+  {
+    for (Int x = 0; x < N; x++)
+    {
+      const Pel resi = Pel(block[(y * N) + x]);
+      pResidual[x] = resi;
+      pReco    [x] = Pel(ClipBD<Int>( Int(pPred[x]) + Int(resi), bitDepth ));
+    }
+    pResidual += uiStride;
+    pPred     += uiPredStride;
+    pReco     += uiRecoStride;
   }
 }
 
 
+Void TComTrQuant::initTransformFunctions()
+{
+  m_forwardTransform   [0] = fastForwardDst;
+  m_forwardTransform   [1] = partialButterfly4;
+  m_forwardTransform   [2] = partialButterfly8;
+  m_forwardTransform   [3] = partialButterfly16;
+  m_forwardTransform   [4] = partialButterfly32;
+
+  m_inverseTransform   [0] = fastInverseDst;
+  m_inverseTransform   [1] = partialButterflyInverse4;
+  m_inverseTransform   [2] = partialButterflyInverse8;
+  m_inverseTransform   [3] = partialButterflyInverse16;
+  m_inverseTransform   [4] = partialButterflyInverse32;
+
+  m_inverseTransformRec[0] = inverseTransformRec<fastInverseDst,             4>;
+  m_inverseTransformRec[1] = inverseTransformRec<partialButterflyInverse4,   4>;
+  m_inverseTransformRec[2] = inverseTransformRec<partialButterflyInverse8,   8>;
+  m_inverseTransformRec[3] = inverseTransformRec<partialButterflyInverse16, 16>;
+  m_inverseTransformRec[4] = inverseTransformRec<partialButterflyInverse32, 32>;
+
+#if ENABLE_SIMD_OPT_TRANSFORM
+  initTrQuantX86();
+#endif
+}
+
+
 // To minimize the distortion only. No rate is considered.
 Void TComTrQuant::signBitHidingHDQ( TCoeff* pQCoef, TCoeff* pCoef, TCoeff* deltaU, const TUEntropyCodingParameters &codingParameters, const Int maxLog2TrDynamicRange )
 {
@@ -1464,6 +1446,9 @@ Void TComTrQuant::init(   UInt  uiMaxTrSize,
   m_bUseAdaptQpSelect = bUseAdaptQpSelect;
 #endif
   m_useTransformSkipFast = useTransformSkipFast;
+
+  // reselect the transform kernels, the SIMD extension may have been restricted after construction
+  initTransformFunctions();
 }
 
 /**
@@ -1691,6 +1676,83 @@ Void TComTrQuant::invTransformNxN(      TComTU        &rTu,
   invRdpcmNxN( rTu, compID, pcResidual, uiStride );
 }
 
+/** reconstruction pReco = Clip(pPred + pResidual) of a block; pReco may be equal to pPred
+ */
+static Void addResidualClip(const Pel *pResidual, UInt uiStride, const Pel *pPred, UInt uiPredStride, Pel *pReco, UInt uiRecoStride, UInt uiWidth, UInt uiHeight, const Int bitDepth)
+{
+  for (UInt y = 0; y < uiHeight; y++)
+  {
+    for (UInt x = 0; x < uiWidth; x++)
+    {
+      pReco[x] = Pel(ClipBD<Int>( Int(pPred[x]) + Int(pResidual[x]), bitDepth ));
+    }
+    pResidual += uiStride;
+    pPred     += uiPredStride;
+    pReco     += uiRecoStride;
+  }
+}
+
+Void TComTrQuant::invTransformRecNxN(      TComTU        &rTu,
+                                     const ComponentID    compID,
+                                           Pel          *pcResidual,
+                                     const UInt           uiStride,
+                                           TCoeff       * pcCoeff,
+                                     const QpParam       &cQP,
+                                     const Pel          *pcPred,
+                                     const UInt           uiPredStride,
+                                           Pel          *pcReco,
+                                     const UInt           uiRecoStride
+                                           DEBUG_STRING_FN_DECLAREP(psDebug))
+{
+  TComDataCU* pcCU=rTu.getCU();
+  const UInt uiAbsPartIdx = rTu.GetAbsPartIdxTU();
+  const TComRectangle &rect = rTu.getRect(compID);
+  const UInt uiWidth = rect.width;
+  const UInt uiHeight = rect.height;
+
+  if (uiWidth != uiHeight)
+  {
+    TComTURecurse subTURecurse(rTu, false, TComTU::VERTICAL_SPLIT, true, compID);
+
+    do
+    {
+      const UInt lineOffset = subTURecurse.GetSectionNumber() * subTURecurse.getRect(compID).height;
+
+      invTransformRecNxN(subTURecurse, compID, pcResidual + (lineOffset * uiStride), uiStride, pcCoeff + (lineOffset * subTURecurse.getRect(compID).width), cQP,
+                         pcPred + (lineOffset * uiPredStride), uiPredStride, pcReco + (lineOffset * uiRecoStride), uiRecoStride DEBUG_STRING_PASS_INTO(psDebug));
+    } while (subTURecurse.nextSection(rTu));
+
+    return;
+  }
+
+  const TComSPS &sps  = *(pcCU->getSlice()->getSPS());
+  const Int clipBitDepth = sps.getBitDepth(toChannelType(compID));
+
+  // transquant bypass, transform skip (with RDPCM) and the debug outputs use the separate inverse transform and reconstruction
+  Bool useFusedPath = !pcCU->getCUTransquantBypass(uiAbsPartIdx) && !pcCU->getTransformSkip(uiAbsPartIdx, compID) && !DEBUG_TRANSFORM_AND_QUANTISE;
+#if DEBUG_STRING
+  useFusedPath = useFusedPath && (psDebug == NULL);
+#endif
+
+  if (!useFusedPath)
+  {
+    invTransformNxN(rTu, compID, pcResidual, uiStride, pcCoeff, cQP DEBUG_STRING_PASS_INTO(psDebug));
+    addResidualClip(pcResidual, uiStride, pcPred, uiPredStride, pcReco, uiRecoStride, uiWidth, uiHeight, clipBitDepth);
+    return;
+  }
+
+  xDeQuant(rTu, pcCoeff, m_plTempCoeff, compID, cQP);
+
+#if O0043_BEST_EFFORT_DECODING
+  const Int channelBitDepth = sps.getStreamBitDepth(toChannelType(compID));
+#else
+  const Int channelBitDepth = clipBitDepth;
+#endif
+  xITRec( channelBitDepth, rTu.useDST(compID), m_plTempCoeff, pcResidual, uiStride, pcPred, uiPredStride, pcReco, uiRecoStride, uiWidth, uiHeight, sps.getMaxLog2TrDynamicRange(toChannelType(compID)), clipBitDepth );
+
+  // no inverse RDPCM: it only applies to transform-skipped and transquant-bypassed blocks (see invRdpcmNxN)
+}
+
 Void TComTrQuant::invRecurTransformNxN( const ComponentID compID,
                                         TComYuv *pResidual,
                                         TComTU &rTu)
@@ -1762,6 +1824,87 @@ Void TComTrQuant::invRecurTransformNxN( const ComponentID compID,
   }
 }
 
+Void TComTrQuant::invRecurTransformRecNxN( const ComponentID compID,
+                                           TComYuv *pResidual,
+                                           TComYuv *pReco,
+                                           TComTU &rTu)
+{
+  if (!rTu.ProcessComponentSection(compID))
+  {
+    return;
+  }
+
+  TComDataCU* pcCU = rTu.getCU();
+  UInt absPartIdxTU = rTu.GetAbsPartIdxTU();
+  UInt uiTrMode=rTu.GetTransformDepthRel();
+  if( (pcCU->getCbf(absPartIdxTU, compID, uiTrMode) == 0) && (isLuma(compID) || !pcCU->getSlice()->getPPS()->getPpsRangeExtension().getCrossComponentPredictionEnabledFlag()) )
+  {
+    return;
+  }
+
+  if( uiTrMode == pcCU->getTransformIdx( absPartIdxTU ) )
+  {
+    const TComRectangle &tuRect      = rTu.getRect(compID);
+    const Int            uiStride    = pResidual->getStride( compID );
+          Pel           *pResi       = pResidual->getAddr( compID ) + tuRect.x0 + uiStride*tuRect.y0;
+    const Int            recoStride  = pReco->getStride( compID );
+          Pel           *pRecoTU     = pReco->getAddr( compID ) + tuRect.x0 + recoStride*tuRect.y0;
+          TCoeff        *pcCoeff     = pcCU->getCoeff(compID) + rTu.getCoefficientOffset(compID);
+
+    const QpParam cQP(*pcCU, compID);
+
+    const Bool hasResidual = pcCU->getCbf(absPartIdxTU, compID, uiTrMode) != 0;
+    const Bool useCrossComponentPrediction = isChroma(compID) && (pcCU->getCrossComponentPredictionAlpha(absPartIdxTU, compID) != 0)
+                                          && (pcCU->getCbf(absPartIdxTU, COMPONENT_Y, uiTrMode) != 0);
+
+    DEBUG_STRING_NEW(sTemp)
+#if DEBUG_STRING
+    std::string *psDebug=((DebugOptionList::DebugString_InvTran.getInt()&(pcCU->isIntra(absPartIdxTU)?1:(pcCU->isInter(absPartIdxTU)?2:4)))!=0) ? &sTemp : 0;
+#endif
+
+    if (hasResidual && !useCrossComponentPrediction)
+    {
+      // the prediction is held in pReco, which is updated in place
+      invTransformRecNxN( rTu, compID, pResi, uiStride, pcCoeff, cQP, pRecoTU, recoStride, pRecoTU, recoStride DEBUG_STRING_PASS_INTO(psDebug) );
+    }
+    else
+    {
+      if (hasResidual)
+      {
+        invTransformNxN( rTu, compID, pResi, uiStride, pcCoeff, cQP DEBUG_STRING_PASS_INTO(psDebug) );
+      }
+
+      if (useCrossComponentPrediction)
+      {
+        const Int strideLuma = pResidual->getStride( COMPONENT_Y );
+        const Pel *pResiLuma = pResidual->getAddr( COMPONENT_Y ) + tuRect.x0 + strideLuma*tuRect.y0;
+
+        crossComponentPrediction( rTu, compID, pResiLuma, pResi, pResi, tuRect.width, tuRect.height, strideLuma, uiStride, uiStride, true );
+      }
+
+      if (hasResidual || useCrossComponentPrediction)
+      {
+        addResidualClip( pResi, uiStride, pRecoTU, recoStride, pRecoTU, recoStride, tuRect.width, tuRect.height, pcCU->getSlice()->getSPS()->getBitDepth(toChannelType(compID)) );
+      }
+    }
+
+#if DEBUG_STRING
+    if (psDebug != 0 && hasResidual)
+    {
+      std::cout << (*psDebug);
+    }
+#endif
+  }
+  else
+  {
+    TComTURecurse tuRecurseChild(rTu, false);
+    do
+    {
+      invRecurTransformRecNxN( compID, pResidual, pReco, tuRecurseChild );
+    } while (tuRecurseChild.nextSection(rTu));
+  }
+}
+
 Void TComTrQuant::applyForwardRDPCM( TComTU& rTu, const ComponentID compID, Pel* pcResidual, const UInt uiStride, const QpParam& cQP, TCoeff* pcCoeff, TCoeff &uiAbsSum, const RDPCMMode mode )
 {
   TComDataCU *pcCU=rTu.getCU();
@@ -2030,6 +2173,50 @@ Void TComTrQuant::xIT( const Int channelBitDepth, Bool useDST, TCoeff* plCoef, P
   }
 }
 
+/** Wrapper function between HM interface and core NxN inverse transform (2D), followed by the reconstruction
+ *  \param channelBitDepth bit depth of channel
+ *  \param useDST
+ *  \param plCoef input data (transform coefficients)
+ *  \param pResidual output data (residual)
+ *  \param uiStride stride of residual data
+ *  \param pPred prediction
+ *  \param uiPredStride stride of prediction
+ *  \param pReco output data (reconstruction = Clip(prediction + residual)), may be equal to pPred
+ *  \param uiRecoStride stride of reconstruction
+ *  \param iWidth transform width
+ *  \param iHeight transform height
+ *  \param maxLog2TrDynamicRange
+ *  \param clipBitDepth bit depth of the reconstruction
+ */
+Void TComTrQuant::xITRec( const Int channelBitDepth, Bool useDST, TCoeff* plCoef, Pel* pResidual, UInt uiStride, const Pel* pPred, UInt uiPredStride, Pel* pReco, UInt uiRecoStride, Int iWidth, Int iHeight, const Int maxLog2TrDynamicRange, const Int clipBitDepth )
+{
+#if MATRIX_MULT
+  if( iWidth == iHeight )
+  {
+    xITr(channelBitDepth, plCoef, pResidual, uiStride, (UInt)iWidth, useDST, maxLog2TrDynamicRange);
+    addResidualClip(pResidual, uiStride, pPred, uiPredStride, pReco, uiRecoStride, iWidth, iHeight, clipBitDepth);
+    return;
+  }
+#endif
+
+  const Int TRANSFORM_MATRIX_SHIFT = g_transformMatrixShift[TRANSFORM_INVERSE];
+
+  const Int shift_1st = TRANSFORM_MATRIX_SHIFT + 1; //1 has been added to shift_1st at the expense of shift_2nd
+  const Int shift_2nd = (TRANSFORM_MATRIX_SHIFT + maxLog2TrDynamicRange - 1) - channelBitDepth;
+  const TCoeff clipMinimum = -(1 << maxLog2TrDynamicRange);
+  const TCoeff clipMaximum =  (1 << maxLog2TrDynamicRange) - 1;
+
+  assert(shift_1st >= 0);
+  assert(shift_2nd >= 0);
+
+  TCoeff tmp[MAX_TU_SIZE * MAX_TU_SIZE];
+
+  const Bool useDST4x4 = useDST && (iWidth == 4) && (iHeight == 4);
+
+  m_inverseTransform   [xGetTransformKernelIdx(iHeight, useDST4x4)]( plCoef, tmp, shift_1st, iWidth, clipMinimum, clipMaximum );
+  m_inverseTransformRec[xGetTransformKernelIdx(iWidth,  useDST4x4)]( tmp, shift_2nd, iHeight, pResidual, uiStride, pPred, uiPredStride, pReco, uiRecoStride, clipBitDepth );
+}
+
 /** 
  * 包装了一下 4x4 变换跳过
  * 变换跳过模式不会真的变换，只是对残差作个位移
@@ -2202,16 +2389,21 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
   Double pdCostCoeff [ MAX_TU_SIZE * MAX_TU_SIZE ];
   Double pdCostSig   [ MAX_TU_SIZE * MAX_TU_SIZE ];
   Double pdCostCoeff0[ MAX_TU_SIZE * MAX_TU_SIZE ];
-  memset( pdCostCoeff, 0, sizeof(Double) *  uiMaxNumCoeff );
-  memset( pdCostSig,   0, sizeof(Double) *  uiMaxNumCoeff );
+  Intermediate_Int plLevelDouble [ MAX_TU_SIZE * MAX_TU_SIZE ];
+  UInt             puiMaxAbsLevel[ MAX_TU_SIZE * MAX_TU_SIZE ];
+  // level change statistics, only needed for sign data hiding
+  const Bool bSignDataHiding = pcCU->getSlice()->getPPS()->getSignDataHidingEnabledFlag();
   Int rateIncUp   [ MAX_TU_SIZE * MAX_TU_SIZE ];
   Int rateIncDown [ MAX_TU_SIZE * MAX_TU_SIZE ];
   Int sigRateDelta[ MAX_TU_SIZE * MAX_TU_SIZE ];
   TCoeff deltaU   [ MAX_TU_SIZE * MAX_TU_SIZE ];
-  memset( rateIncUp,    0, sizeof(Int   ) *  uiMaxNumCoeff );
-  memset( rateIncDown,  0, sizeof(Int   ) *  uiMaxNumCoeff );
-  memset( sigRateDelta, 0, sizeof(Int   ) *  uiMaxNumCoeff );
-  memset( deltaU,       0, sizeof(TCoeff) *  uiMaxNumCoeff );
+  if( bSignDataHiding )
+  {
+    memset( rateIncUp,    0, sizeof(Int   ) *  uiMaxNumCoeff );
+    memset( rateIncDown,  0, sizeof(Int   ) *  uiMaxNumCoeff );
+    memset( sigRateDelta, 0, sizeof(Int   ) *  uiMaxNumCoeff );
+    memset( deltaU,       0, sizeof(TCoeff) *  uiMaxNumCoeff );
+  }
 
   const Int iQBits = QUANT_SHIFT + cQP.per + iTransformShift;                   // Right shift of non-RDOQ quantizer;  level = (coeff*uiQ + offset)>>q_bits
   const Double *const pdErrScale = getErrScaleCoeff(scalingListType, (uiLog2TrSize-2), cQP.rem);
@@ -2235,7 +2427,6 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
 
   Double pdCostCoeffGroupSig[ MLS_GRP_NUM ];
   UInt uiSigCoeffGroupFlag[ MLS_GRP_NUM ];
-  Int iCGLastScanPos = -1;
 
   UInt    uiCtxSet            = 0;
   Int     c1                  = 1;
@@ -2250,13 +2441,57 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
   memset( pdCostCoeffGroupSig,   0, sizeof(Double) * MLS_GRP_NUM );
   memset( uiSigCoeffGroupFlag,   0, sizeof(UInt) * MLS_GRP_NUM );
 
-  UInt uiCGNum = uiWidth * uiHeight >> MLS_CG_SIZE;
   Int iScanPos;
   coeffGroupRDStats rdStats;
 
   const UInt significanceMapContextOffset = getSignificanceMapContextOffset(compID);
 
-  for (Int iCGScanPos = uiCGNum-1; iCGScanPos >= 0; iCGScanPos--)
+  //===== quantization =====
+  // All coefficients are quantised first, in the scan order of the level decisions, which then start at the last
+  // significant coefficient. Until there, only the uncoded costs are summed.
+  for (iScanPos = uiMaxNumCoeff-1; iScanPos >= 0; iScanPos--)
+  {
+    UInt    uiBlkPos          = codingParameters.scan[iScanPos];
+
+    const Int    quantisationCoefficient = (enableScalingLists) ? piQCoef   [uiBlkPos] : defaultQuantisationCoefficient;
+    const Double errorScale              = (enableScalingLists) ? pdErrScale[uiBlkPos] : defaultErrorScale;
+
+    const Int64  tmpLevel                = Int64(abs(plSrcCoeff[ uiBlkPos ])) * quantisationCoefficient;
+
+    const Intermediate_Int lLevelDouble  = (Intermediate_Int)min<Int64>(tmpLevel, std::numeric_limits<Intermediate_Int>::max() - (Intermediate_Int(1) << (iQBits - 1)));
+
+#if ADAPTIVE_QP_SELECTION
+    if( m_bUseAdaptQpSelect )
+    {
+      piArlDstCoeff[uiBlkPos]   = (TCoeff)(( lLevelDouble + iAddC) >> iQBitsC );
+    }
+#endif
+    const UInt uiMaxAbsLevel  = std::min<UInt>(UInt(entropyCodingMaximum), UInt((lLevelDouble + (Intermediate_Int(1) << (iQBits - 1))) >> iQBits));
+
+    const Double dErr         = Double( lLevelDouble );
+    pdCostCoeff0[ iScanPos ]  = dErr * dErr * errorScale;
+    plLevelDouble[ iScanPos ] = lLevelDouble;
+    puiMaxAbsLevel[ iScanPos ]= uiMaxAbsLevel;
+    piDstCoeff[ uiBlkPos ]    = uiMaxAbsLevel;
+
+    if ( uiMaxAbsLevel > 0 && iLastScanPos < 0 )
+    {
+      iLastScanPos            = iScanPos;
+      d64BaseCost             = d64BlockUncodedCost;
+    }
+    d64BlockUncodedCost      += pdCostCoeff0[ iScanPos ];
+  }
+
+  if ( iLastScanPos < 0 )
+  {
+    return;
+  }
+
+  //===== coefficient level estimation =====
+  const Int iCGLastScanPos = iLastScanPos >> MLS_CG_SIZE;
+  uiCtxSet                 = getContextSetIndex(compID, iCGLastScanPos, 0);
+
+  for (Int iCGScanPos = iCGLastScanPos; iCGScanPos >= 0; iCGScanPos--)
   {
     UInt uiCGBlkPos = codingParameters.scanCG[ iCGScanPos ];
     UInt uiCGPosY   = uiCGBlkPos / codingParameters.widthInGroups;
@@ -2266,120 +2501,99 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
 
     const Int patternSigCtx = TComTrQuant::calcPatternSigCtx(uiSigCoeffGroupFlag, uiCGPosX, uiCGPosY, codingParameters.widthInGroups, codingParameters.heightInGroups);
 
-    for (Int iScanPosinCG = uiCGSize-1; iScanPosinCG >= 0; iScanPosinCG--)
+    for (Int iScanPosinCG = (iCGScanPos == iCGLastScanPos) ? (iLastScanPos & (uiCGSize-1)) : (uiCGSize-1); iScanPosinCG >= 0; iScanPosinCG--)
     {
       iScanPos = iCGScanPos*uiCGSize + iScanPosinCG;
-      //===== quantization =====
       UInt    uiBlkPos          = codingParameters.scan[iScanPos];
-      // set coeff
-
-      const Int    quantisationCoefficient = (enableScalingLists) ? piQCoef   [uiBlkPos] : defaultQuantisationCoefficient;
-      const Double errorScale              = (enableScalingLists) ? pdErrScale[uiBlkPos] : defaultErrorScale;
 
-      const Int64  tmpLevel                = Int64(abs(plSrcCoeff[ uiBlkPos ])) * quantisationCoefficient;
+      const Double errorScale             = (enableScalingLists) ? pdErrScale[uiBlkPos] : defaultErrorScale;
+      const Intermediate_Int lLevelDouble = plLevelDouble[ iScanPos ];
+      const UInt uiMaxAbsLevel            = puiMaxAbsLevel[ iScanPos ];
 
-      const Intermediate_Int lLevelDouble  = (Intermediate_Int)min<Int64>(tmpLevel, std::numeric_limits<Intermediate_Int>::max() - (Intermediate_Int(1) << (iQBits - 1)));
+      UInt  uiLevel;
+      UInt  uiOneCtx         = (NUM_ONE_FLAG_CTX_PER_SET * uiCtxSet) + c1;
+      UInt  uiAbsCtx         = (NUM_ABS_FLAG_CTX_PER_SET * uiCtxSet) + c2;
+      Int   piLevelRate[2];
 
-#if ADAPTIVE_QP_SELECTION
-      if( m_bUseAdaptQpSelect )
+      if( iScanPos == iLastScanPos )
       {
-        piArlDstCoeff[uiBlkPos]   = (TCoeff)(( lLevelDouble + iAddC) >> iQBitsC );
+        uiLevel              = xGetCodedLevel( pdCostCoeff[ iScanPos ], pdCostCoeff0[ iScanPos ], pdCostSig[ iScanPos ], piLevelRate,
+                                                lLevelDouble, uiMaxAbsLevel, significanceMapContextOffset, uiOneCtx, uiAbsCtx, uiGoRiceParam,
+                                                c1Idx, c2Idx, iQBits, errorScale, 1, extendedPrecision, maxLog2TrDynamicRange
+                                                );
       }
-#endif
-      const UInt uiMaxAbsLevel  = std::min<UInt>(UInt(entropyCodingMaximum), UInt((lLevelDouble + (Intermediate_Int(1) << (iQBits - 1))) >> iQBits));
-
-      const Double dErr         = Double( lLevelDouble );
-      pdCostCoeff0[ iScanPos ]  = dErr * dErr * errorScale;
-      d64BlockUncodedCost      += pdCostCoeff0[ iScanPos ];
-      piDstCoeff[ uiBlkPos ]    = uiMaxAbsLevel;
-
-      if ( uiMaxAbsLevel > 0 && iLastScanPos < 0 )
+      else
       {
-        iLastScanPos            = iScanPos;
-        uiCtxSet                = getContextSetIndex(compID, (iScanPos >> MLS_CG_SIZE), 0);
-        iCGLastScanPos          = iCGScanPos;
-      }
+        UShort uiCtxSig      = significanceMapContextOffset + getSigCtxInc( patternSigCtx, codingParameters, iScanPos, uiLog2BlockWidth, uiLog2BlockHeight, channelType );
 
-      if ( iLastScanPos >= 0 )
-      {
-        //===== coefficient level estimation =====
-        UInt  uiLevel;
-        UInt  uiOneCtx         = (NUM_ONE_FLAG_CTX_PER_SET * uiCtxSet) + c1;
-        UInt  uiAbsCtx         = (NUM_ABS_FLAG_CTX_PER_SET * uiCtxSet) + c2;
+        uiLevel              = xGetCodedLevel( pdCostCoeff[ iScanPos ], pdCostCoeff0[ iScanPos ], pdCostSig[ iScanPos ], piLevelRate,
+                                                lLevelDouble, uiMaxAbsLevel, uiCtxSig, uiOneCtx, uiAbsCtx, uiGoRiceParam,
+                                                c1Idx, c2Idx, iQBits, errorScale, 0, extendedPrecision, maxLog2TrDynamicRange
+                                                );
 
-        if( iScanPos == iLastScanPos )
+        if( bSignDataHiding )
         {
-          uiLevel              = xGetCodedLevel( pdCostCoeff[ iScanPos ], pdCostCoeff0[ iScanPos ], pdCostSig[ iScanPos ],
-                                                  lLevelDouble, uiMaxAbsLevel, significanceMapContextOffset, uiOneCtx, uiAbsCtx, uiGoRiceParam,
-                                                  c1Idx, c2Idx, iQBits, errorScale, 1, extendedPrecision, maxLog2TrDynamicRange
-                                                  );
-        }
-        else
-        {
-          UShort uiCtxSig      = significanceMapContextOffset + getSigCtxInc( patternSigCtx, codingParameters, iScanPos, uiLog2BlockWidth, uiLog2BlockHeight, channelType );
-
-          uiLevel              = xGetCodedLevel( pdCostCoeff[ iScanPos ], pdCostCoeff0[ iScanPos ], pdCostSig[ iScanPos ],
-                                                  lLevelDouble, uiMaxAbsLevel, uiCtxSig, uiOneCtx, uiAbsCtx, uiGoRiceParam,
-                                                  c1Idx, c2Idx, iQBits, errorScale, 0, extendedPrecision, maxLog2TrDynamicRange
-                                                  );
-
           sigRateDelta[ uiBlkPos ] = m_pcEstBitsSbac->significantBits[ uiCtxSig ][ 1 ] - m_pcEstBitsSbac->significantBits[ uiCtxSig ][ 0 ];
         }
+      }
 
+      if( bSignDataHiding )
+      {
         deltaU[ uiBlkPos ]        = TCoeff((lLevelDouble - (Intermediate_Int(uiLevel) << iQBits)) >> (iQBits-8));
 
         if( uiLevel > 0 )
         {
-          Int rateNow = xGetICRate( uiLevel, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange );
-          rateIncUp   [ uiBlkPos ] = xGetICRate( uiLevel+1, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange ) - rateNow;
-          rateIncDown [ uiBlkPos ] = xGetICRate( uiLevel-1, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange ) - rateNow;
+          // the rates of uiMaxAbsLevel and uiMaxAbsLevel-1 (if not 0) are known from the level decision
+          const Int rateNow        = piLevelRate[ uiMaxAbsLevel - uiLevel ];
+          const Int rateUp         = ( uiLevel < uiMaxAbsLevel ) ? piLevelRate[ 0 ]
+                                                                 : xGetICRate( uiLevel+1, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange );
+          const Int rateDown       = ( uiLevel == uiMaxAbsLevel && uiLevel > 1 ) ? piLevelRate[ 1 ]
+                                                                                 : xGetICRate( uiLevel-1, uiOneCtx, uiAbsCtx, uiGoRiceParam, c1Idx, c2Idx, extendedPrecision, maxLog2TrDynamicRange );
+          rateIncUp   [ uiBlkPos ] = rateUp   - rateNow;
+          rateIncDown [ uiBlkPos ] = rateDown - rateNow;
         }
         else // uiLevel == 0
         {
           rateIncUp   [ uiBlkPos ] = m_pcEstBitsSbac->m_greaterOneBits[ uiOneCtx ][ 0 ];
         }
-        piDstCoeff[ uiBlkPos ] = uiLevel;
-        d64BaseCost           += pdCostCoeff [ iScanPos ];
-
-        baseLevel = (c1Idx < C1FLAG_NUMBER) ? (2 + (c2Idx < C2FLAG_NUMBER)) : 1;
-        if( uiLevel >= baseLevel )
-        {
-          if (uiLevel > 3*(1<<uiGoRiceParam))
-          {
-            uiGoRiceParam = bUseGolombRiceParameterAdaptation ? (uiGoRiceParam + 1) : (std::min<UInt>((uiGoRiceParam + 1), 4));
-          }
-        }
-        if ( uiLevel >= 1)
-        {
-          c1Idx ++;
-        }
+      }
+      piDstCoeff[ uiBlkPos ] = uiLevel;
+      d64BaseCost           += pdCostCoeff [ iScanPos ];
 
-        //===== update bin model =====
-        if( uiLevel > 1 )
-        {
-          c1 = 0;
-          c2 += (c2 < 2);
-          c2Idx ++;
-        }
-        else if( (c1 < 3) && (c1 > 0) && uiLevel)
+      baseLevel = (c1Idx < C1FLAG_NUMBER) ? (2 + (c2Idx < C2FLAG_NUMBER)) : 1;
+      if( uiLevel >= baseLevel )
+      {
+        if (uiLevel > 3*(1<<uiGoRiceParam))
         {
-          c1++;
+          uiGoRiceParam = bUseGolombRiceParameterAdaptation ? (uiGoRiceParam + 1) : (std::min<UInt>((uiGoRiceParam + 1), 4));
         }
+      }
+      if ( uiLevel >= 1)
+      {
+        c1Idx ++;
+      }
 
-        //===== context set update =====
-        if( ( iScanPos % uiCGSize == 0 ) && ( iScanPos > 0 ) )
-        {
-          uiCtxSet          = getContextSetIndex(compID, ((iScanPos - 1) >> MLS_CG_SIZE), (c1 == 0)); //(iScanPos - 1) because we do this **before** entering the final group
-          c1                = 1;
-          c2                = 0;
-          c1Idx             = 0;
-          c2Idx             = 0;
-          uiGoRiceParam     = initialGolombRiceParameter;
-        }
+      //===== update bin model =====
+      if( uiLevel > 1 )
+      {
+        c1 = 0;
+        c2 += (c2 < 2);
+        c2Idx ++;
       }
-      else
+      else if( (c1 < 3) && (c1 > 0) && uiLevel)
+      {
+        c1++;
+      }
+
+      //===== context set update =====
+      if( ( iScanPos % uiCGSize == 0 ) && ( iScanPos > 0 ) )
       {
-        d64BaseCost    += pdCostCoeff0[ iScanPos ];
+        uiCtxSet          = getContextSetIndex(compID, ((iScanPos - 1) >> MLS_CG_SIZE), (c1 == 0)); //(iScanPos - 1) because we do this **before** entering the final group
+        c1                = 1;
+        c2                = 0;
+        c1Idx             = 0;
+        c2Idx             = 0;
+        uiGoRiceParam     = initialGolombRiceParameter;
       }
       rdStats.d64SigCost += pdCostSig[ iScanPos ];
       if (iScanPosinCG == 0 )
@@ -2398,82 +2612,74 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
       }
     } //end for (iScanPosinCG)
 
-    if (iCGLastScanPos >= 0)
+    if( iCGScanPos )
     {
-      if( iCGScanPos )
+      if (uiSigCoeffGroupFlag[ uiCGBlkPos ] == 0)
+      {
+        UInt  uiCtxSig = getSigCoeffGroupCtxInc( uiSigCoeffGroupFlag, uiCGPosX, uiCGPosY, codingParameters.widthInGroups, codingParameters.heightInGroups );
+        d64BaseCost += xGetRateSigCoeffGroup(0, uiCtxSig) - rdStats.d64SigCost;;
+        pdCostCoeffGroupSig[ iCGScanPos ] = xGetRateSigCoeffGroup(0, uiCtxSig);
+      }
+      else
       {
-        if (uiSigCoeffGroupFlag[ uiCGBlkPos ] == 0)
+        if (iCGScanPos < iCGLastScanPos) //skip the last coefficient group, which will be handled together with last position below.
         {
+          if ( rdStats.iNNZbeforePos0 == 0 )
+          {
+            d64BaseCost -= rdStats.d64SigCost_0;
+            rdStats.d64SigCost -= rdStats.d64SigCost_0;
+          }
+          // rd-cost if SigCoeffGroupFlag = 0, initialization
+          Double d64CostZeroCG = d64BaseCost;
+
+          // add SigCoeffGroupFlag cost to total cost
           UInt  uiCtxSig = getSigCoeffGroupCtxInc( uiSigCoeffGroupFlag, uiCGPosX, uiCGPosY, codingParameters.widthInGroups, codingParameters.heightInGroups );
-          d64BaseCost += xGetRateSigCoeffGroup(0, uiCtxSig) - rdStats.d64SigCost;;
-          pdCostCoeffGroupSig[ iCGScanPos ] = xGetRateSigCoeffGroup(0, uiCtxSig);
-        }
-        else
-        {
-          if (iCGScanPos < iCGLastScanPos) //skip the last coefficient group, which will be handled together with last position below.
+
+          if (iCGScanPos < iCGLastScanPos)
           {
-            if ( rdStats.iNNZbeforePos0 == 0 )
-            {
-              d64BaseCost -= rdStats.d64SigCost_0;
-              rdStats.d64SigCost -= rdStats.d64SigCost_0;
-            }
-            // rd-cost if SigCoeffGroupFlag = 0, initialization
-            Double d64CostZeroCG = d64BaseCost;
+            d64BaseCost  += xGetRateSigCoeffGroup(1, uiCtxSig);
+            d64CostZeroCG += xGetRateSigCoeffGroup(0, uiCtxSig);
+            pdCostCoeffGroupSig[ iCGScanPos ] = xGetRateSigCoeffGroup(1, uiCtxSig);
+          }
 
-            // add SigCoeffGroupFlag cost to total cost
-            UInt  uiCtxSig = getSigCoeffGroupCtxInc( uiSigCoeffGroupFlag, uiCGPosX, uiCGPosY, codingParameters.widthInGroups, codingParameters.heightInGroups );
+          // try to convert the current coeff group from non-zero to all-zero
+          d64CostZeroCG += rdStats.d64UncodedDist;  // distortion for resetting non-zero levels to zero levels
+          d64CostZeroCG -= rdStats.d64CodedLevelandDist;   // distortion and level cost for keeping all non-zero levels
+          d64CostZeroCG -= rdStats.d64SigCost;     // sig cost for all coeffs, including zero levels and non-zerl levels
 
+          // if we can save cost, change this block to all-zero block
+          if ( d64CostZeroCG < d64BaseCost )
+          {
+            uiSigCoeffGroupFlag[ uiCGBlkPos ] = 0;
+            d64BaseCost = d64CostZeroCG;
             if (iCGScanPos < iCGLastScanPos)
             {
-              d64BaseCost  += xGetRateSigCoeffGroup(1, uiCtxSig);
-              d64CostZeroCG += xGetRateSigCoeffGroup(0, uiCtxSig);
-              pdCostCoeffGroupSig[ iCGScanPos ] = xGetRateSigCoeffGroup(1, uiCtxSig);
+              pdCostCoeffGroupSig[ iCGScanPos ] = xGetRateSigCoeffGroup(0, uiCtxSig);
             }
-
-            // try to convert the current coeff group from non-zero to all-zero
-            d64CostZeroCG += rdStats.d64UncodedDist;  // distortion for resetting non-zero levels to zero levels
-            d64CostZeroCG -= rdStats.d64CodedLevelandDist;   // distortion and level cost for keeping all non-zero levels
-            d64CostZeroCG -= rdStats.d64SigCost;     // sig cost for all coeffs, including zero levels and non-zerl levels
-
-            // if we can save cost, change this block to all-zero block
-            if ( d64CostZeroCG < d64BaseCost )
+            // reset coeffs to 0 in this block
+            for (Int iScanPosinCG = uiCGSize-1; iScanPosinCG >= 0; iScanPosinCG--)
             {
-              uiSigCoeffGroupFlag[ uiCGBlkPos ] = 0;
-              d64BaseCost = d64CostZeroCG;
-              if (iCGScanPos < iCGLastScanPos)
-              {
-                pdCostCoeffGroupSig[ iCGScanPos ] = xGetRateSigCoeffGroup(0, uiCtxSig);
-              }
-              // reset coeffs to 0 in this block
-              for (Int iScanPosinCG = uiCGSize-1; iScanPosinCG >= 0; iScanPosinCG--)
-              {
-                iScanPos      = iCGScanPos*uiCGSize + iScanPosinCG;
-                UInt uiBlkPos = codingParameters.scan[ iScanPos ];
+              iScanPos      = iCGScanPos*uiCGSize + iScanPosinCG;
+              UInt uiBlkPos = codingParameters.scan[ iScanPos ];
 
-                if (piDstCoeff[ uiBlkPos ])
-                {
-                  piDstCoeff [ uiBlkPos ] = 0;
-                  pdCostCoeff[ iScanPos ] = pdCostCoeff0[ iScanPos ];
-                  pdCostSig  [ iScanPos ] = 0;
-                }
+              if (piDstCoeff[ uiBlkPos ])
+              {
+                piDstCoeff [ uiBlkPos ] = 0;
+                pdCostCoeff[ iScanPos ] = pdCostCoeff0[ iScanPos ];
+                pdCostSig  [ iScanPos ] = 0;
               }
-            } // end if ( d64CostAllZeros < d64BaseCost )
-          }
-        } // end if if (uiSigCoeffGroupFlag[ uiCGBlkPos ] == 0)
-      }
-      else
-      {
-        uiSigCoeffGroupFlag[ uiCGBlkPos ] = 1;
-      }
+            }
+          } // end if ( d64CostAllZeros < d64BaseCost )
+        }
+      } // end if if (uiSigCoeffGroupFlag[ uiCGBlkPos ] == 0)
+    }
+    else
+    {
+      uiSigCoeffGroupFlag[ uiCGBlkPos ] = 1;
     }
   } //end for (iCGScanPos)
 
   //===== estimate last position =====
-  if ( iLastScanPos < 0 )
-  {
-    return;
-  }
-
   Double  d64BestCost         = 0;
   Int     ui16CtxCbf          = 0;
   Int     iBestLastIdxP1      = 0;
@@ -2559,7 +2765,7 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
   }
 
 
-  if( pcCU->getSlice()->getPPS()->getSignDataHidingEnabledFlag() && uiAbsSum>=2)
+  if( bSignDataHiding && uiAbsSum>=2)
   {
     const Double inverseQuantScale = Double(g_invQuantScales[cQP.rem]);
     Int64 rdFactor = (Int64)(inverseQuantScale * inverseQuantScale * (1 << (2 * cQP.per))
@@ -2844,6 +3050,7 @@ Int TComTrQuant::getSigCtxInc    (       Int                        patternSigCt
 __inline UInt TComTrQuant::xGetCodedLevel ( Double&          rd64CodedCost,          //< reference to coded cost
                                             Double&          rd64CodedCost0,         //< reference to cost when coefficient is 0
                                             Double&          rd64CodedCostSig,       //< rd64CodedCostSig reference to cost of significant coefficient
+                                            Int*             piLevelRate,            //< rates of uiMaxAbsLevel and uiMaxAbsLevel-1, where evaluated
                                             Intermediate_Int lLevelDouble,           //< reference to unscaled quantized level
                                             UInt             uiMaxAbsLevel,          //< scaled quantized level
                                             UShort           ui16CtxNumSig,          //< current ctxInc for coeff_abs_significant_flag
@@ -2885,7 +3092,9 @@ __inline UInt TComTrQuant::xGetCodedLevel ( Double&          rd64CodedCost,
   for( Int uiAbsLevel  = uiMaxAbsLevel; uiAbsLevel >= uiMinAbsLevel ; uiAbsLevel-- )
   {
     Double dErr         = Double( lLevelDouble  - ( Intermediate_Int(uiAbsLevel) << iQBits ) );
-    Double dCurrCost    = dErr * dErr * errorScale + xGetICost( xGetICRate( uiAbsLevel, ui16CtxNumOne, ui16CtxNumAbs, ui16AbsGoRice, c1Idx, c2Idx, useLimitedPrefixLength, maxLog2TrDynamicRange ) );
+    const Int iRate     = xGetICRate( uiAbsLevel, ui16CtxNumOne, ui16CtxNumAbs, ui16AbsGoRice, c1Idx, c2Idx, useLimitedPrefixLength, maxLog2TrDynamicRange );
+    piLevelRate[ uiMaxAbsLevel - uiAbsLevel ] = iRate;
+    Double dCurrCost    = dErr * dErr * errorScale + xGetICost( iRate );
     dCurrCost          += dCurrCostSig;
 
     if( dCurrCost < rd64CodedCost )
@@ -52,6 +52,7 @@
 // ====================================================================================================================
 
 #define QP_BITS                 15
+#define NUMBER_OF_TRANSFORM_KERNELS 5  ///< 4-point DST and 4/8/16/32-point DCT
 
 // ====================================================================================================================
 // Type definition
@@ -137,8 +138,26 @@ public:
                        const QpParam      & cQP
                              DEBUG_STRING_FN_DECLAREP(psDebug));
 
+  /// inverse transform of one TU followed by the reconstruction pcReco = Clip(pcPred + residual); pcReco may be equal to pcPred.
+  /// The residual is still written to pcResidual (e.g. for the cross-component prediction of the chroma components).
+  /// Must not be used when the cross-component prediction modifies the residual of this component before the reconstruction.
+  Void invTransformRecNxN(      TComTU       & rTu,
+                          const ComponentID    compID,
+                                Pel         *  pcResidual,
+                          const UInt           uiStride,
+                                TCoeff      *  pcCoeff,
+                          const QpParam      & cQP,
+                          const Pel         *  pcPred,
+                          const UInt           uiPredStride,
+                                Pel         *  pcReco,
+                          const UInt           uiRecoStride
+                                DEBUG_STRING_FN_DECLAREP(psDebug));
+
   Void invRecurTransformNxN ( const ComponentID compID, TComYuv *pResidual, TComTU &rTu );
 
+  /// as invRecurTransformNxN, but also adds the residual of each TU to the prediction held in pReco
+  Void invRecurTransformRecNxN ( const ComponentID compID, TComYuv *pResidual, TComYuv *pReco, TComTU &rTu );
+
   Void rdpcmNxN   ( TComTU& rTu, const ComponentID compID, Pel* pcResidual, const UInt uiStride, const QpParam& cQP, TCoeff* pcCoeff, TCoeff &uiAbsSum, RDPCMMode& rdpcmMode );
   Void invRdpcmNxN( TComTU& rTu, const ComponentID compID, Pel* pcResidual, const UInt uiStride );
 
@@ -148,9 +167,11 @@ public:
 
 #if RDOQ_CHROMA_LAMBDA
   Void setLambdas(const Double lambdas[MAX_NUM_COMPONENT]) { for (UInt component = 0; component < MAX_NUM_COMPONENT; component++) m_lambdas[component] = lambdas[component]; }
+  const Double* getLambdas() const { return m_lambdas; }
   Void selectLambda(const ComponentID compIdx) { m_dLambda = m_lambdas[compIdx]; }
 #else
   Void setLambda(Double dLambda) { m_dLambda = dLambda;}
+  Double getLambda() const { return m_dLambda; }
 #endif
   Void setRDOQOffset( UInt uiRDOQOffset ) { m_uiRDOQOffset = uiRDOQOffset; }
 
@@ -232,6 +253,27 @@ protected:
   Double    m_errScaleNoScalingList[SCALING_LIST_SIZE_NUM][SCALING_LIST_NUM][SCALING_LIST_REM_NUM]; ///< array of quantization matrix coefficient 4x4
 
 private:
+  typedef Void (*FpForwardTransform)   ( TCoeff *src, TCoeff *dst, Int shift, Int line );
+  typedef Void (*FpInverseTransform)   ( TCoeff *src, TCoeff *dst, Int shift, Int line, const TCoeff outputMinimum, const TCoeff outputMaximum );
+  typedef Void (*FpInverseTransformRec)( TCoeff *src, Int shift, Int line, Pel *pResidual, UInt uiStride, const Pel *pPred, UInt uiPredStride, Pel *pReco, UInt uiRecoStride, const Int bitDepth );
+
+  /// 1D transform kernels, indexed by xGetTransformKernelIdx(): [0 = 4-point DST, 1..4 = 4/8/16/32-point DCT]
+  FpForwardTransform    m_forwardTransform   [NUMBER_OF_TRANSFORM_KERNELS];
+  FpInverseTransform    m_inverseTransform   [NUMBER_OF_TRANSFORM_KERNELS];
+  /// second (horizontal) inverse transform stage writing the residual (clipped to the Pel range) and the reconstruction
+  FpInverseTransformRec m_inverseTransformRec[NUMBER_OF_TRANSFORM_KERNELS];
+
+  static Int xGetTransformKernelIdx( const Int size, const Bool useDST ) { return useDST ? 0 : ( g_aucConvertToBit[size] + 1 ); }
+
+  Void initTransformFunctions();
+#if ENABLE_SIMD_OPT_TRANSFORM
+  Void initTrQuantX86();
+  template <X86_VEXT vext> Void _initTrQuantX86();
+#endif
+
+  Void xTrMxN ( Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange );
+  Void xITrMxN( Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange );
+
   // forward Transform
   Void xT   ( const Int channelBitDepth, Bool useDST, Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff, Int iWidth, Int iHeight, const Int maxLog2TrDynamicRange );
 
@@ -271,6 +313,7 @@ private:
 __inline UInt              xGetCodedLevel  ( Double&          rd64CodedCost,
                                              Double&          rd64CodedCost0,
                                              Double&          rd64CodedCostSig,
+                                             Int*             piLevelRate,
                                              Intermediate_Int lLevelDouble,
                                              UInt             uiMaxAbsLevel,
                                              UShort           ui16CtxNumSig,
@@ -314,6 +357,9 @@ __inline UInt              xGetCodedLevel  ( Double&          rd64CodedCost,
   // inverse transform
   Void xIT    ( const Int channelBitDepth, Bool useDST, TCoeff* plCoef, Pel* pResidual, UInt uiStride, Int iWidth, Int iHeight, const Int maxLog2TrDynamicRange );
 
+  // inverse transform and reconstruction
+  Void xITRec ( const Int channelBitDepth, Bool useDST, TCoeff* plCoef, Pel* pResidual, UInt uiStride, const Pel* pPred, UInt uiPredStride, Pel* pReco, UInt uiRecoStride, Int iWidth, Int iHeight, const Int maxLog2TrDynamicRange, const Int clipBitDepth );
+
   // inverse skipping transform
   Void xITransformSkip ( TCoeff* plCoef, Pel* pResidual, UInt uiStride, TComTU &rTu, const ComponentID component );
 
@@ -149,6 +149,51 @@
 #define VECTOR_CODING__DISTORTION_CALCULATIONS            0 ///< enable vector coding for distortion calculations   0 (default if SSE not possible) disable SSE vector coding. Should not affect RD costs/decisions. Code back-ported from JEM2.0.
 #endif
 
+// This can be disabled by the makefile
+#ifndef ENABLE_SIMD_OPT
+#define ENABLE_SIMD_OPT                                   1 ///< 1 (default) = SIMD kernels selected at run time according to the CPU (see x86/InitX86.cpp), 0 = C code only. Does not affect RD costs/decisions.
+#endif
+
+#if ENABLE_SIMD_OPT && ( defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( __i386 ) || defined( _M_IX86 ) )
+#define TARGET_SIMD_X86                                   1 ///< x86 vector extensions available for run-time dispatch
+#endif
+
+#if defined( TARGET_SIMD_X86 ) && ( RExt__HIGH_BIT_DEPTH_SUPPORT == 0 )
+#define ENABLE_SIMD_OPT_DIST                              1 ///< SIMD SAD/SSE/Hadamard distortion functions in TComRdCost (16-bit samples only)
+#else
+#define ENABLE_SIMD_OPT_DIST                              0
+#endif
+
+#ifdef TARGET_SIMD_X86
+#define ENABLE_SIMD_OPT_INTERPOLATION                     1 ///< SIMD luma/chroma interpolation filters in TComInterpolationFilter
+#else
+#define ENABLE_SIMD_OPT_INTERPOLATION                     0
+#endif
+
+#if defined( TARGET_SIMD_X86 ) && ( RExt__HIGH_BIT_DEPTH_SUPPORT == 0 )
+#define ENABLE_SIMD_OPT_TRANSFORM                         1 ///< SIMD partial butterfly transforms and fused inverse transform + reconstruction in TComTrQuant (32-bit coefficients only)
+#else
+#define ENABLE_SIMD_OPT_TRANSFORM                         0
+#endif
+
+#if defined( TARGET_SIMD_X86 ) && ( RExt__HIGH_BIT_DEPTH_SUPPORT == 0 )
+#define ENABLE_SIMD_OPT_DEBLOCKING                        1 ///< SIMD luma strong/normal deblocking filters in TComLoopFilter (16-bit samples only)
+#else
+#define ENABLE_SIMD_OPT_DEBLOCKING                        0
+#endif
+
+#if defined( TARGET_SIMD_X86 ) && ( RExt__HIGH_BIT_DEPTH_SUPPORT == 0 )
+#define ENABLE_SIMD_OPT_SAO                               1 ///< SIMD SAO edge offset application and statistics in TComSampleAdaptiveOffset (16-bit samples only)
+#else
+#define ENABLE_SIMD_OPT_SAO                               0
+#endif
+
+#if defined( TARGET_SIMD_X86 ) && ( RExt__HIGH_BIT_DEPTH_SUPPORT == 0 )
+#define ENABLE_SIMD_OPT_INTRAPRED                         1 ///< SIMD angular and planar intra prediction in TComPrediction (16-bit samples only)
+#else
+#define ENABLE_SIMD_OPT_INTRAPRED                         0
+#endif
+
 // ====================================================================================================================
 // Derived macros
 // ====================================================================================================================
@@ -388,6 +433,19 @@ enum RefPicList
 };
 
 // 失真的计算函数
+#ifdef TARGET_SIMD_X86
+/// x86 vector extensions in increasing order of capability
+enum X86_VEXT
+{
+  SCALAR = 0,
+  SSE41,
+  SSE42,
+  AVX,
+  AVX2,
+  AVX512
+};
+#endif
+
 enum DFunc
 {
   DF_DEFAULT         = 0,
@@ -0,0 +1,169 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     CommonDefX86.cpp
+    \brief    detection of the x86 vector extensions available at run time
+*/
+
+#include "CommonDefX86.h"
+
+#ifdef TARGET_SIMD_X86
+
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+//! \ingroup TLibCommon
+//! \{
+
+static const TChar *s_x86ExtensionNames[] = { "SCALAR", "SSE41", "SSE42", "AVX", "AVX2", "AVX512" };
+
+static Void xCpuid( Int regs[4], Int leaf, Int subLeaf )
+{
+#ifdef _MSC_VER
+  __cpuidex( regs, leaf, subLeaf );
+#else
+  __cpuid_count( leaf, subLeaf, regs[0], regs[1], regs[2], regs[3] );
+#endif
+}
+
+static UInt64 xXgetbv( UInt index )
+{
+#ifdef _MSC_VER
+  return _xgetbv( index );
+#else
+  UInt eax, edx;
+  __asm__ __volatile__( "xgetbv" : "=a"( eax ), "=d"( edx ) : "c"( index ) );
+  return ( UInt64( edx ) << 32 ) | eax;
+#endif
+}
+
+static X86_VEXT xDetectX86Extension()
+{
+  Int regs[4];
+
+  xCpuid( regs, 0, 0 );
+  const Int maxLeaf = regs[0];
+  if( maxLeaf < 1 )
+  {
+    return SCALAR;
+  }
+
+  xCpuid( regs, 1, 0 );
+  const Bool sse41   = ( regs[2] & ( 1 << 19 ) ) != 0;
+  const Bool sse42   = ( regs[2] & ( 1 << 20 ) ) != 0;
+  const Bool osxsave = ( regs[2] & ( 1 << 27 ) ) != 0;
+  const Bool avx     = ( regs[2] & ( 1 << 28 ) ) != 0;
+
+  if( !sse41 )
+  {
+    return SCALAR;
+  }
+  if( !sse42 )
+  {
+    return SSE41;
+  }
+
+  // the YMM/ZMM register state must also be enabled by the operating system
+  const UInt64 xcr0 = osxsave ? xXgetbv( 0 ) : 0;
+  if( !avx || ( xcr0 & 0x06 ) != 0x06 )
+  {
+    return SSE42;
+  }
+
+  Bool avx2 = false, avx512 = false;
+  if( maxLeaf >= 7 )
+  {
+    xCpuid( regs, 7, 0 );
+    avx2   = ( regs[1] & ( 1 <<  5 ) ) != 0;
+    avx512 = ( regs[1] & ( 1 << 16 ) ) != 0    // AVX512F
+          && ( regs[1] & ( 1 << 30 ) ) != 0    // AVX512BW
+          && ( regs[1] & ( 1u << 31 ) ) != 0   // AVX512VL
+          && ( xcr0 & 0xe6 ) == 0xe6;
+  }
+
+  return avx512 ? AVX512 : ( avx2 ? AVX2 : AVX );
+}
+
+const TChar* getX86ExtensionName( X86_VEXT vext )
+{
+  return s_x86ExtensionNames[vext];
+}
+
+X86_VEXT read_x86_extension_flags( const std::string &forcedExtension )
+{
+  static const X86_VEXT s_detected  = xDetectX86Extension();
+  static X86_VEXT       s_extension = s_detected;
+
+  if( !forcedExtension.empty() )
+  {
+    Int forced = -1;
+    for( Int i = SCALAR; i <= AVX512; i++ )
+    {
+      if( forcedExtension == s_x86ExtensionNames[i] )
+      {
+        forced = i;
+      }
+    }
+    if( forced < 0 )
+    {
+      fprintf( stderr, "\nUnknown SIMD extension '%s' (use SCALAR, SSE41, SSE42, AVX, AVX2 or AVX512)\n", forcedExtension.c_str() );
+      exit( EXIT_FAILURE );
+    }
+    if( forced > s_detected )
+    {
+      fprintf( stderr, "\nWarning: SIMD extension %s is not supported by this CPU, using %s\n", forcedExtension.c_str(), s_x86ExtensionNames[s_detected] );
+      s_extension = s_detected;
+    }
+    else
+    {
+      s_extension = X86_VEXT( forced );
+    }
+  }
+
+  return s_extension;
+}
+
+const TChar* read_x86_extension( const std::string &forcedExtension )
+{
+  return getX86ExtensionName( read_x86_extension_flags( forcedExtension ) );
+}
+
+//! \}
+
+#endif // TARGET_SIMD_X86
@@ -0,0 +1,82 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     CommonDefX86.h
+    \brief    common definitions for the x86 SIMD kernels (header)
+*/
+
+#ifndef __COMMONDEFX86__
+#define __COMMONDEFX86__
+
+#include "../CommonDef.h"
+
+#ifdef TARGET_SIMD_X86
+
+#include <string>
+
+//! \ingroup TLibCommon
+//! \{
+
+// Each kernel source under x86/<ext>/ is compiled with the matching compiler flags and the
+// USE_<EXT> definition (see TLibCommon/CMakeLists.txt), which selects SIMDX86 below.
+#if defined( USE_AVX512 )
+#define SIMDX86 AVX512
+#include <immintrin.h>
+#elif defined( USE_AVX2 )
+#define SIMDX86 AVX2
+#include <immintrin.h>
+#elif defined( USE_AVX )
+#define SIMDX86 AVX
+#include <immintrin.h>
+#elif defined( USE_SSE42 )
+#define SIMDX86 SSE42
+#include <nmmintrin.h>
+#elif defined( USE_SSE41 )
+#define SIMDX86 SSE41
+#include <smmintrin.h>
+#endif
+
+/** Returns the selected vector extension, by default the best one supported by the CPU and the operating system.
+ *  The first call performs the detection. A non-empty forcedExtension (e.g. "SSE41" or "SCALAR") changes the
+ *  selection for all later calls; calls without argument return the current selection. A forced extension the
+ *  CPU does not support selects the detected one, and an unknown name exits.
+ */
+X86_VEXT    read_x86_extension_flags( const std::string &forcedExtension = std::string() );
+const TChar* read_x86_extension     ( const std::string &forcedExtension = std::string() );
+const TChar* getX86ExtensionName    ( X86_VEXT vext );
+
+//! \}
+
+#endif // TARGET_SIMD_X86
+
+#endif // __COMMONDEFX86__
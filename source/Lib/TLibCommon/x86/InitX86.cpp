@@ -0,0 +1,185 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     InitX86.cpp
+    \brief    run-time selection of the x86 SIMD functions
+*/
+
+#include "CommonDefX86.h"
+#include "../TComRdCost.h"
+#include "../TComInterpolationFilter.h"
+#include "../TComTrQuant.h"
+#include "../TComLoopFilter.h"
+#include "../TComSampleAdaptiveOffset.h"
+#include "../TComPrediction.h"
+
+#ifdef TARGET_SIMD_X86
+
+//! \ingroup TLibCommon
+//! \{
+
+#if ENABLE_SIMD_OPT_DIST
+Void TComRdCost::initRdCostX86()
+{
+  switch( read_x86_extension_flags() )
+  {
+  case AVX512:
+    _initRdCostX86<AVX512>();
+    break;
+  case AVX2:
+    _initRdCostX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initRdCostX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_INTERPOLATION
+Void TComInterpolationFilter::initInterpolationFilterX86()
+{
+  switch( read_x86_extension_flags() )
+  {
+  case AVX512:
+    _initInterpolationFilterX86<AVX512>();
+    break;
+  case AVX2:
+    _initInterpolationFilterX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initInterpolationFilterX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_TRANSFORM
+Void TComTrQuant::initTrQuantX86()
+{
+  switch( read_x86_extension_flags() )
+  {
+  case AVX512:
+    _initTrQuantX86<AVX512>();
+    break;
+  case AVX2:
+    _initTrQuantX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initTrQuantX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_DEBLOCKING
+Void TComLoopFilter::initLoopFilterX86()
+{
+  switch( read_x86_extension_flags() )
+  {
+  case AVX512:
+    _initLoopFilterX86<AVX512>();
+    break;
+  case AVX2:
+    _initLoopFilterX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initLoopFilterX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_SAO
+Void TComSampleAdaptiveOffset::initSampleAdaptiveOffsetX86()
+{
+  switch( read_x86_extension_flags() )
+  {
+  case AVX512:
+    _initSampleAdaptiveOffsetX86<AVX512>();
+    break;
+  case AVX2:
+    _initSampleAdaptiveOffsetX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initSampleAdaptiveOffsetX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_INTRAPRED
+Void TComPrediction::initIntraPredictionX86()
+{
+  switch( read_x86_extension_flags() )
+  {
+  case AVX512:
+    _initIntraPredictionX86<AVX512>();
+    break;
+  case AVX2:
+    _initIntraPredictionX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initIntraPredictionX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+//! \}
+
+#endif // TARGET_SIMD_X86
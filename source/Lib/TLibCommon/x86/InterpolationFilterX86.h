@@ -0,0 +1,486 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     InterpolationFilterX86.h
+    \brief    SIMD luma/chroma interpolation filters of TComInterpolationFilter
+    \details  This file is included by the per-extension sources in x86/<ext>/, each of them compiled
+              with the corresponding compiler flags. All functions produce exactly the same samples
+              as the C functions in TComInterpolationFilter.cpp, for both 16-bit and 32-bit Pel.
+*/
+
+#include "CommonDefX86.h"
+#include "../TComInterpolationFilter.h"
+
+#include <cstring>
+
+#if ENABLE_SIMD_OPT_INTERPOLATION
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Vector kernels
+// ====================================================================================================================
+
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+// 32-bit samples: one product per tap, accumulated with wrap-around as the Int sum of the C code
+
+typedef __m128i FilterCoeffX86;
+
+static inline FilterCoeffX86 simdFilterCoeff( const TFilterCoeff *coeff, Int k )
+{
+  return _mm_set1_epi32( coeff[k] );
+}
+
+template<Int N>
+static inline __m128i simdFilter4( const Pel *src, Int cStride, const FilterCoeffX86 *coeff, const __m128i &offset, const __m128i &shift )
+{
+  __m128i sum = offset;
+  for( Int k = 0; k < N; k++ )
+  {
+    sum = _mm_add_epi32( sum, _mm_mullo_epi32( _mm_loadu_si128( ( const __m128i* )( src + k * cStride ) ), coeff[k] ) );
+  }
+  return _mm_sra_epi32( sum, shift );
+}
+
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+template<Int N>
+static inline __m256i simdFilter8( const Pel *src, Int cStride, const FilterCoeffX86 *coeff, const __m128i &offset, const __m128i &shift )
+{
+  __m256i sum = _mm256_broadcastsi128_si256( offset );
+  for( Int k = 0; k < N; k++ )
+  {
+    sum = _mm256_add_epi32( sum, _mm256_mullo_epi32( _mm256_loadu_si256( ( const __m256i* )( src + k * cStride ) ), _mm256_broadcastsi128_si256( coeff[k] ) ) );
+  }
+  return _mm256_sra_epi32( sum, shift );
+}
+#endif
+
+#ifdef USE_AVX512
+template<Int N>
+static inline __m512i simdFilter16( const Pel *src, Int cStride, const FilterCoeffX86 *coeff, const __m128i &offset, const __m128i &shift )
+{
+  __m512i sum = _mm512_maskz_broadcast_i32x4( 0xffff, offset );
+  for( Int k = 0; k < N; k++ )
+  {
+    sum = _mm512_add_epi32( sum, _mm512_mullo_epi32( _mm512_loadu_si512( ( const __m512i* )( src + k * cStride ) ), _mm512_maskz_broadcast_i32x4( 0xffff, coeff[k] ) ) );
+  }
+  return _mm512_maskz_sra_epi32( 0xffff, sum, shift );
+}
+#endif
+
+template<X86_VEXT vext, Int N, Bool isLast>
+static inline Int simdFilterRow( const Pel *src, Int cStride, Pel *dst, Int width, const FilterCoeffX86 *coeff, const __m128i &offset, const __m128i &shift, Pel maxVal )
+{
+  Int col = 0;
+
+#ifdef USE_AVX512
+  if( vext >= AVX512 )
+  {
+    const __m512i vmax = _mm512_set1_epi32( maxVal );
+    for( ; col + 16 <= width; col += 16 )
+    {
+      __m512i val = simdFilter16<N>( src + col, cStride, coeff, offset, shift );
+      if( isLast )
+      {
+        val = _mm512_min_epi32( _mm512_max_epi32( val, _mm512_setzero_si512() ), vmax );
+      }
+      _mm512_storeu_si512( ( __m512i* )( dst + col ), val );
+    }
+  }
+#endif
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+  if( vext >= AVX2 )
+  {
+    const __m256i vmax = _mm256_set1_epi32( maxVal );
+    for( ; col + 8 <= width; col += 8 )
+    {
+      __m256i val = simdFilter8<N>( src + col, cStride, coeff, offset, shift );
+      if( isLast )
+      {
+        val = _mm256_min_epi32( _mm256_max_epi32( val, _mm256_setzero_si256() ), vmax );
+      }
+      _mm256_storeu_si256( ( __m256i* )( dst + col ), val );
+    }
+  }
+#endif
+
+  const __m128i vmax = _mm_set1_epi32( maxVal );
+  for( ; col + 4 <= width; col += 4 )
+  {
+    __m128i val = simdFilter4<N>( src + col, cStride, coeff, offset, shift );
+    if( isLast )
+    {
+      val = _mm_min_epi32( _mm_max_epi32( val, _mm_setzero_si128() ), vmax );
+    }
+    _mm_storeu_si128( ( __m128i* )( dst + col ), val );
+  }
+
+  return col;
+}
+
+#else
+// 16-bit samples: pairs of taps are applied with one multiply-add on interleaved samples. With an internal bit depth
+// of at most 12 bits every result fits into 16 bits, so the saturating pack gives the same value as the C code.
+
+typedef __m128i FilterCoeffX86;
+
+/// taps k and k+1 as pairs of 16-bit values in each 32-bit lane
+static inline FilterCoeffX86 simdFilterCoeff( const TFilterCoeff *coeff, Int k )
+{
+  return _mm_set1_epi32( Int( UInt( UShort( coeff[k] ) ) | ( UInt( UShort( coeff[k + 1] ) ) << 16 ) ) );
+}
+
+template<Int N>
+static inline __m128i simdFilter4( const Pel *src, Int cStride, const FilterCoeffX86 *coeff, const __m128i &offset, const __m128i &shift )
+{
+  __m128i sum = offset;
+  for( Int k = 0; k < N; k += 2 )
+  {
+    const __m128i a = _mm_loadl_epi64( ( const __m128i* )( src +   k       * cStride ) );
+    const __m128i b = _mm_loadl_epi64( ( const __m128i* )( src + ( k + 1 ) * cStride ) );
+    sum = _mm_add_epi32( sum, _mm_madd_epi16( _mm_unpacklo_epi16( a, b ), coeff[k >> 1] ) );
+  }
+  sum = _mm_sra_epi32( sum, shift );
+  return _mm_packs_epi32( sum, sum );
+}
+
+template<Int N>
+static inline __m128i simdFilter8( const Pel *src, Int cStride, const FilterCoeffX86 *coeff, const __m128i &offset, const __m128i &shift )
+{
+  __m128i lo = offset;
+  __m128i hi = offset;
+  for( Int k = 0; k < N; k += 2 )
+  {
+    const __m128i a = _mm_loadu_si128( ( const __m128i* )( src +   k       * cStride ) );
+    const __m128i b = _mm_loadu_si128( ( const __m128i* )( src + ( k + 1 ) * cStride ) );
+    lo = _mm_add_epi32( lo, _mm_madd_epi16( _mm_unpacklo_epi16( a, b ), coeff[k >> 1] ) );
+    hi = _mm_add_epi32( hi, _mm_madd_epi16( _mm_unpackhi_epi16( a, b ), coeff[k >> 1] ) );
+  }
+  return _mm_packs_epi32( _mm_sra_epi32( lo, shift ), _mm_sra_epi32( hi, shift ) );
+}
+
+// unpack and pack work within 128-bit lanes, so the wider versions keep the samples in order
+// (AVX-512: masked forms, the unmasked ones trigger -Wmaybe-uninitialized in some GCC versions)
+
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+template<Int N>
+static inline __m256i simdFilter16( const Pel *src, Int cStride, const FilterCoeffX86 *coeff, const __m128i &offset, const __m128i &shift )
+{
+  __m256i lo = _mm256_broadcastsi128_si256( offset );
+  __m256i hi = lo;
+  for( Int k = 0; k < N; k += 2 )
+  {
+    const __m256i c = _mm256_broadcastsi128_si256( coeff[k >> 1] );
+    const __m256i a = _mm256_loadu_si256( ( const __m256i* )( src +   k       * cStride ) );
+    const __m256i b = _mm256_loadu_si256( ( const __m256i* )( src + ( k + 1 ) * cStride ) );
+    lo = _mm256_add_epi32( lo, _mm256_madd_epi16( _mm256_unpacklo_epi16( a, b ), c ) );
+    hi = _mm256_add_epi32( hi, _mm256_madd_epi16( _mm256_unpackhi_epi16( a, b ), c ) );
+  }
+  return _mm256_packs_epi32( _mm256_sra_epi32( lo, shift ), _mm256_sra_epi32( hi, shift ) );
+}
+#endif
+
+#ifdef USE_AVX512
+template<Int N>
+static inline __m512i simdFilter32( const Pel *src, Int cStride, const FilterCoeffX86 *coeff, const __m128i &offset, const __m128i &shift )
+{
+  __m512i lo = _mm512_maskz_broadcast_i32x4( 0xffff, offset );
+  __m512i hi = lo;
+  for( Int k = 0; k < N; k += 2 )
+  {
+    const __m512i c = _mm512_maskz_broadcast_i32x4( 0xffff, coeff[k >> 1] );
+    const __m512i a = _mm512_loadu_si512( ( const __m512i* )( src +   k       * cStride ) );
+    const __m512i b = _mm512_loadu_si512( ( const __m512i* )( src + ( k + 1 ) * cStride ) );
+    lo = _mm512_add_epi32( lo, _mm512_madd_epi16( _mm512_unpacklo_epi16( a, b ), c ) );
+    hi = _mm512_add_epi32( hi, _mm512_madd_epi16( _mm512_unpackhi_epi16( a, b ), c ) );
+  }
+  return _mm512_packs_epi32( _mm512_maskz_sra_epi32( 0xffff, lo, shift ), _mm512_maskz_sra_epi32( 0xffff, hi, shift ) );
+}
+#endif
+
+template<X86_VEXT vext, Int N, Bool isLast>
+static inline Int simdFilterRow( const Pel *src, Int cStride, Pel *dst, Int width, const FilterCoeffX86 *coeff, const __m128i &offset, const __m128i &shift, Pel maxVal )
+{
+  Int col = 0;
+
+#ifdef USE_AVX512
+  if( vext >= AVX512 )
+  {
+    const __m512i vmax = _mm512_set1_epi16( maxVal );
+    for( ; col + 32 <= width; col += 32 )
+    {
+      __m512i val = simdFilter32<N>( src + col, cStride, coeff, offset, shift );
+      if( isLast )
+      {
+        val = _mm512_min_epi16( _mm512_max_epi16( val, _mm512_setzero_si512() ), vmax );
+      }
+      _mm512_storeu_si512( ( __m512i* )( dst + col ), val );
+    }
+  }
+#endif
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+  if( vext >= AVX2 )
+  {
+    const __m256i vmax = _mm256_set1_epi16( maxVal );
+    for( ; col + 16 <= width; col += 16 )
+    {
+      __m256i val = simdFilter16<N>( src + col, cStride, coeff, offset, shift );
+      if( isLast )
+      {
+        val = _mm256_min_epi16( _mm256_max_epi16( val, _mm256_setzero_si256() ), vmax );
+      }
+      _mm256_storeu_si256( ( __m256i* )( dst + col ), val );
+    }
+  }
+#endif
+
+  const __m128i vmax = _mm_set1_epi16( maxVal );
+  for( ; col + 8 <= width; col += 8 )
+  {
+    __m128i val = simdFilter8<N>( src + col, cStride, coeff, offset, shift );
+    if( isLast )
+    {
+      val = _mm_min_epi16( _mm_max_epi16( val, _mm_setzero_si128() ), vmax );
+    }
+    _mm_storeu_si128( ( __m128i* )( dst + col ), val );
+  }
+  if( col + 4 <= width )
+  {
+    __m128i val = simdFilter4<N>( src + col, cStride, coeff, offset, shift );
+    if( isLast )
+    {
+      val = _mm_min_epi16( _mm_max_epi16( val, _mm_setzero_si128() ), vmax );
+    }
+    _mm_storel_epi64( ( __m128i* )( dst + col ), val );
+    col += 4;
+  }
+
+  return col;
+}
+#endif // RExt__HIGH_BIT_DEPTH_SUPPORT
+
+// ====================================================================================================================
+// Filters
+// ====================================================================================================================
+
+/// SIMD version of TComInterpolationFilter::filter(); the columns left over by the vector kernels (width 2 and 6 chroma blocks) use the C code
+template<X86_VEXT vext, Int N, Bool isVertical, Bool isFirst, Bool isLast>
+static Void simdFilter( Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, TFilterCoeff const *coeff )
+{
+  const Int cStride = ( isVertical ) ? srcStride : 1;
+  src -= ( N/2 - 1 ) * cStride;
+
+  Int       offset;
+  Pel       maxVal;
+  const Int headRoom = std::max<Int>( 2, ( IF_INTERNAL_PREC - bitDepth ) );
+  Int       shift    = IF_FILTER_PREC;
+
+  if( isLast )
+  {
+    shift += ( isFirst ) ? 0 : headRoom;
+    offset = 1 << ( shift - 1 );
+    offset += ( isFirst ) ? 0 : IF_INTERNAL_OFFS << IF_FILTER_PREC;
+    maxVal = ( 1 << bitDepth ) - 1;
+  }
+  else
+  {
+    shift -= ( isFirst ) ? headRoom : 0;
+    offset = ( isFirst ) ? -IF_INTERNAL_OFFS << shift : 0;
+    maxVal = 0;
+  }
+
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+  FilterCoeffX86 vcoeff[N];
+  for( Int k = 0; k < N; k++ )
+  {
+    vcoeff[k] = simdFilterCoeff( coeff, k );
+  }
+#else
+  assert( bitDepth <= 12 );
+  FilterCoeffX86 vcoeff[N/2];
+  for( Int k = 0; k < N; k += 2 )
+  {
+    vcoeff[k >> 1] = simdFilterCoeff( coeff, k );
+  }
+#endif
+  const __m128i voffset = _mm_set1_epi32( offset );
+  const __m128i vshift  = _mm_cvtsi32_si128( shift );
+
+  for( Int row = 0; row < height; row++ )
+  {
+    for( Int col = simdFilterRow<vext, N, isLast>( src, cStride, dst, width, vcoeff, voffset, vshift, maxVal ); col < width; col++ )
+    {
+      Int sum = 0;
+      for( Int k = 0; k < N; k++ )
+      {
+        sum += src[col + k * cStride] * coeff[k];
+      }
+
+      Pel val = ( sum + offset ) >> shift;
+      if( isLast )
+      {
+        val = ( val < 0 ) ? 0 : val;
+        val = ( val > maxVal ) ? maxVal : val;
+      }
+      dst[col] = val;
+    }
+
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+/// SIMD version of TComInterpolationFilter::filterCopy()
+template<X86_VEXT vext>
+static Void simdFilterCopy( Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast )
+{
+  if( isFirst == isLast )
+  {
+    for( Int row = 0; row < height; row++ )
+    {
+      memcpy( dst, src, width * sizeof( Pel ) );
+      src += srcStride;
+      dst += dstStride;
+    }
+    return;
+  }
+
+  const Int     shift  = std::max<Int>( 2, ( IF_INTERNAL_PREC - bitDepth ) );
+  const __m128i vshift = _mm_cvtsi32_si128( shift );
+
+  if( isFirst )
+  {
+    for( Int row = 0; row < height; row++ )
+    {
+      Int col = 0;
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+      const __m128i voffset = _mm_set1_epi32( IF_INTERNAL_OFFS );
+      for( ; col + 4 <= width; col += 4 )
+      {
+        const __m128i val = _mm_sll_epi32( _mm_loadu_si128( ( const __m128i* )( src + col ) ), vshift );
+        _mm_storeu_si128( ( __m128i* )( dst + col ), _mm_sub_epi32( val, voffset ) );
+      }
+#else
+      const __m128i voffset = _mm_set1_epi16( IF_INTERNAL_OFFS );
+      for( ; col + 8 <= width; col += 8 )
+      {
+        const __m128i val = _mm_sll_epi16( _mm_loadu_si128( ( const __m128i* )( src + col ) ), vshift );
+        _mm_storeu_si128( ( __m128i* )( dst + col ), _mm_sub_epi16( val, voffset ) );
+      }
+      for( ; col + 4 <= width; col += 4 )
+      {
+        const __m128i val = _mm_sll_epi16( _mm_loadl_epi64( ( const __m128i* )( src + col ) ), vshift );
+        _mm_storel_epi64( ( __m128i* )( dst + col ), _mm_sub_epi16( val, voffset ) );
+      }
+#endif
+      for( ; col < width; col++ )
+      {
+        Pel val = leftShift_round( src[col], shift );
+        dst[col] = val - ( Pel ) IF_INTERNAL_OFFS;
+      }
+
+      src += srcStride;
+      dst += dstStride;
+    }
+  }
+  else
+  {
+    const Pel     maxVal  = ( 1 << bitDepth ) - 1;
+    const __m128i voffset = _mm_set1_epi32( IF_INTERNAL_OFFS + ( 1 << ( shift - 1 ) ) );
+
+    for( Int row = 0; row < height; row++ )
+    {
+      Int col = 0;
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+      const __m128i vmax = _mm_set1_epi32( maxVal );
+      for( ; col + 4 <= width; col += 4 )
+      {
+        __m128i val = _mm_loadu_si128( ( const __m128i* )( src + col ) );
+        val = _mm_sra_epi32( _mm_add_epi32( val, voffset ), vshift );
+        _mm_storeu_si128( ( __m128i* )( dst + col ), _mm_min_epi32( _mm_max_epi32( val, _mm_setzero_si128() ), vmax ) );
+      }
+#else
+      const __m128i vmax = _mm_set1_epi16( maxVal );
+      for( ; col + 8 <= width; col += 8 )
+      {
+        const __m128i val = _mm_loadu_si128( ( const __m128i* )( src + col ) );
+        const __m128i lo  = _mm_sra_epi32( _mm_add_epi32( _mm_cvtepi16_epi32( val ),                      voffset ), vshift );
+        const __m128i hi  = _mm_sra_epi32( _mm_add_epi32( _mm_cvtepi16_epi32( _mm_unpackhi_epi64( val, val ) ), voffset ), vshift );
+        _mm_storeu_si128( ( __m128i* )( dst + col ), _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( lo, hi ), _mm_setzero_si128() ), vmax ) );
+      }
+#endif
+      for( ; col < width; col++ )
+      {
+        Pel val = src[col];
+        val = rightShift_round( ( val + IF_INTERNAL_OFFS ), shift );
+        val = ( val < 0 ) ? 0 : val;
+        val = ( val > maxVal ) ? maxVal : val;
+        dst[col] = val;
+      }
+
+      src += srcStride;
+      dst += dstStride;
+    }
+  }
+}
+
+// ====================================================================================================================
+// Initialisation
+// ====================================================================================================================
+
+template<X86_VEXT vext>
+Void TComInterpolationFilter::_initInterpolationFilterX86()
+{
+  m_filterCopy         = simdFilterCopy<vext>;
+
+  m_filterHor[0][0]    = simdFilter<vext, NTAPS_LUMA,   false, true,  false>;
+  m_filterHor[0][1]    = simdFilter<vext, NTAPS_LUMA,   false, true,  true >;
+  m_filterHor[1][0]    = simdFilter<vext, NTAPS_CHROMA, false, true,  false>;
+  m_filterHor[1][1]    = simdFilter<vext, NTAPS_CHROMA, false, true,  true >;
+
+  m_filterVer[0][0][0] = simdFilter<vext, NTAPS_LUMA,   true,  false, false>;
+  m_filterVer[0][0][1] = simdFilter<vext, NTAPS_LUMA,   true,  false, true >;
+  m_filterVer[0][1][0] = simdFilter<vext, NTAPS_LUMA,   true,  true,  false>;
+  m_filterVer[0][1][1] = simdFilter<vext, NTAPS_LUMA,   true,  true,  true >;
+  m_filterVer[1][0][0] = simdFilter<vext, NTAPS_CHROMA, true,  false, false>;
+  m_filterVer[1][0][1] = simdFilter<vext, NTAPS_CHROMA, true,  false, true >;
+  m_filterVer[1][1][0] = simdFilter<vext, NTAPS_CHROMA, true,  true,  false>;
+  m_filterVer[1][1][1] = simdFilter<vext, NTAPS_CHROMA, true,  true,  true >;
+}
+
+template Void TComInterpolationFilter::_initInterpolationFilterX86<SIMDX86>();
+
+//! \}
+
+#endif // ENABLE_SIMD_OPT_INTERPOLATION
@@ -0,0 +1,171 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     IntraPredictionX86.h
+    \brief    SIMD angular and planar intra prediction of TComPrediction
+    \details  This file is included by the per-extension sources in x86/<ext>/, each of them compiled
+              with the corresponding compiler flags. The angular rows interleave each reference sample
+              with its right neighbour so that the two-tap interpolation is a single multiply-add per
+              pair; the planar samples are computed in 32 bits from the row and column gradients.
+*/
+
+#include "CommonDefX86.h"
+#include "../TComPrediction.h"
+
+#if ENABLE_SIMD_OPT_INTRAPRED
+
+//! \ingroup TLibCommon
+//! \{
+
+/// ((32 - deltaFract) * a + deltaFract * b + 16) >> 5 of four interleaved (a, b) pairs, the weights being paired in the same way
+static inline __m128i interpolateAngX86( const __m128i &ab, const __m128i &weights )
+{
+  return _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( ab, weights ), _mm_set1_epi32( 16 ) ), 5 );
+}
+
+template<X86_VEXT vext>
+static Void simdPredIntraAngBlock( const Pel* refMain, Pel* pDst, Int dstStride, Int width, Int height, Int intraPredAngle )
+{
+  for( Int y = 0, deltaPos = intraPredAngle; y < height; y++, deltaPos += intraPredAngle, pDst += dstStride )
+  {
+    const Int  deltaInt   = deltaPos >> 5;
+    const Int  deltaFract = deltaPos & ( 32 - 1 );
+    const Pel* pRM        = refMain + deltaInt + 1;
+
+    if( deltaFract == 0 )
+    {
+      // Just copy the integer samples
+      if( width == 4 )
+      {
+        _mm_storel_epi64( ( __m128i* ) pDst, _mm_loadl_epi64( ( const __m128i* ) pRM ) );
+      }
+      else
+      {
+        for( Int x = 0; x < width; x += 8 )
+        {
+          _mm_storeu_si128( ( __m128i* )( pDst + x ), _mm_loadu_si128( ( const __m128i* )( pRM + x ) ) );
+        }
+      }
+      continue;
+    }
+
+    const Int weightPair = ( deltaFract << 16 ) | ( 32 - deltaFract );
+
+    if( width == 4 )
+    {
+      const __m128i a = _mm_loadl_epi64( ( const __m128i* ) pRM );
+      const __m128i b = _mm_loadl_epi64( ( const __m128i* )( pRM + 1 ) );
+      const __m128i v = interpolateAngX86( _mm_unpacklo_epi16( a, b ), _mm_set1_epi32( weightPair ) );
+      _mm_storel_epi64( ( __m128i* ) pDst, _mm_packs_epi32( v, v ) );
+      continue;
+    }
+
+    Int x = 0;
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+    if( vext >= AVX2 )
+    {
+      const __m256i weights = _mm256_set1_epi32( weightPair );
+      const __m256i offset  = _mm256_set1_epi32( 16 );
+      for( ; x + 16 <= width; x += 16 )
+      {
+        const __m256i a  = _mm256_loadu_si256( ( const __m256i* )( pRM + x ) );
+        const __m256i b  = _mm256_loadu_si256( ( const __m256i* )( pRM + x + 1 ) );
+        const __m256i lo = _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( _mm256_unpacklo_epi16( a, b ), weights ), offset ), 5 );
+        const __m256i hi = _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( _mm256_unpackhi_epi16( a, b ), weights ), offset ), 5 );
+        _mm256_storeu_si256( ( __m256i* )( pDst + x ), _mm256_packs_epi32( lo, hi ) );
+      }
+    }
+#endif
+    const __m128i weights = _mm_set1_epi32( weightPair );
+    for( ; x < width; x += 8 )
+    {
+      const __m128i a = _mm_loadu_si128( ( const __m128i* )( pRM + x ) );
+      const __m128i b = _mm_loadu_si128( ( const __m128i* )( pRM + x + 1 ) );
+      _mm_storeu_si128( ( __m128i* )( pDst + x ), _mm_packs_epi32( interpolateAngX86( _mm_unpacklo_epi16( a, b ), weights ), interpolateAngX86( _mm_unpackhi_epi16( a, b ), weights ) ) );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+static Void simdPredIntraPlanar( const Pel* pSrc, Int srcStride, Pel* rpDst, Int dstStride, UInt width, UInt height )
+{
+  assert( width <= height && ( width & 3 ) == 0 );
+
+  Int topRow   [MAX_CU_SIZE];
+  Int bottomRow[MAX_CU_SIZE];
+  const UInt shift1Dhor = g_aucConvertToBit[ width ] + 2;
+  const UInt shift1Dver = g_aucConvertToBit[ height ] + 2;
+  const Int  bottomLeft = pSrc[Int(height)*srcStride-1];
+  const Int  topRight   = pSrc[Int(width)-srcStride];
+
+  for( Int k = 0; k < width; k++ )
+  {
+    bottomRow[k] = bottomLeft - pSrc[k-srcStride];
+    topRow   [k] = pSrc[k-srcStride] << shift1Dver;
+  }
+
+  const __m128i shift  = _mm_cvtsi32_si128( shift1Dhor + 1 );
+  const __m128i xPlus1 = _mm_setr_epi32( 1, 2, 3, 4 );
+
+  for( Int y = 0; y < height; y++, rpDst += dstStride )
+  {
+    const Int     left        = pSrc[y*srcStride-1];
+    const Int     right       = topRight - left;
+    const __m128i rightStep   = _mm_mullo_epi32( xPlus1, _mm_set1_epi32( right ) );
+    Int           horPredBase = ( left << shift1Dhor ) + width;
+
+    for( Int x = 0; x < width; x += 4, horPredBase += 4 * right )
+    {
+      // the vertical term of the row is accumulated in topRow, as in the scalar code
+      __m128i vertPred = _mm_add_epi32( _mm_loadu_si128( ( const __m128i* )( topRow + x ) ), _mm_loadu_si128( ( const __m128i* )( bottomRow + x ) ) );
+      _mm_storeu_si128( ( __m128i* )( topRow + x ), vertPred );
+
+      const __m128i horPred = _mm_add_epi32( _mm_set1_epi32( horPredBase ), rightStep );
+      const __m128i val     = _mm_sra_epi32( _mm_add_epi32( horPred, vertPred ), shift );
+      _mm_storel_epi64( ( __m128i* )( rpDst + x ), _mm_packs_epi32( val, val ) );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+Void TComPrediction::_initIntraPredictionX86()
+{
+  m_predIntraAngBlock = simdPredIntraAngBlock<vext>;
+  m_predIntraPlanar   = simdPredIntraPlanar<vext>;
+}
+
+template Void TComPrediction::_initIntraPredictionX86<SIMDX86>();
+
+//! \}
+
+#endif // ENABLE_SIMD_OPT_INTRAPRED
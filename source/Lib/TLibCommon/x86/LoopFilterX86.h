@@ -0,0 +1,222 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     LoopFilterX86.h
+    \brief    SIMD luma strong/normal deblocking filters of TComLoopFilter
+    \details  This file is included by the per-extension sources in x86/<ext>/, each of them compiled
+              with the corresponding compiler flags. The four lines crossing an edge segment are filtered
+              in parallel, one line per 32-bit lane, with the arithmetic of TComLoopFilter::xPelFilterLuma,
+              so the results are exactly those of the C function. The on/off and strong/normal decisions
+              are made per segment by TComLoopFilter::xEdgeFilterLuma as before.
+*/
+
+#include "CommonDefX86.h"
+#include "../TComLoopFilter.h"
+
+#if ENABLE_SIMD_OPT_DEBLOCKING
+
+//! \ingroup TLibCommon
+//! \{
+
+static inline __m128i clip3X86( const __m128i &minVal, const __m128i &maxVal, const __m128i &v )
+{
+  return _mm_min_epi32( _mm_max_epi32( v, minVal ), maxVal );
+}
+
+/** Luma filtering of the four lines crossing a 4-sample edge segment
+ *  m[0..7] hold the samples p3..p0, q0..q3 of the four lines; for EDGE_HOR they are four consecutive samples of eight
+ *  picture lines, for EDGE_VER eight consecutive samples of four picture lines which are transposed.
+ */
+template<X86_VEXT vext, DeblockEdgeDir edgeDir>
+static Void simdFilterLumaLines( Pel* piSrc, Int iOffset, Int iSrcStep, Int tc, Bool sw, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iThrCut, Bool bFilterSecondP, Bool bFilterSecondQ, const Int bitDepthLuma )
+{
+  __m128i m[8];
+
+  if( edgeDir == EDGE_HOR )
+  {
+    for( Int k = 0; k < 8; k++ )
+    {
+      m[k] = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* )( piSrc + ( k - 4 ) * iOffset ) ) );
+    }
+  }
+  else
+  {
+    const __m128i l0 = _mm_loadu_si128( ( const __m128i* )( piSrc                - 4 ) );
+    const __m128i l1 = _mm_loadu_si128( ( const __m128i* )( piSrc +     iSrcStep - 4 ) );
+    const __m128i l2 = _mm_loadu_si128( ( const __m128i* )( piSrc + 2 * iSrcStep - 4 ) );
+    const __m128i l3 = _mm_loadu_si128( ( const __m128i* )( piSrc + 3 * iSrcStep - 4 ) );
+
+    const __m128i t0 = _mm_unpacklo_epi16( l0, l1 );
+    const __m128i t1 = _mm_unpacklo_epi16( l2, l3 );
+    const __m128i t2 = _mm_unpackhi_epi16( l0, l1 );
+    const __m128i t3 = _mm_unpackhi_epi16( l2, l3 );
+    const __m128i c01 = _mm_unpacklo_epi32( t0, t1 );
+    const __m128i c23 = _mm_unpackhi_epi32( t0, t1 );
+    const __m128i c45 = _mm_unpacklo_epi32( t2, t3 );
+    const __m128i c67 = _mm_unpackhi_epi32( t2, t3 );
+
+    m[0] = _mm_cvtepi16_epi32( c01 );
+    m[1] = _mm_cvtepi16_epi32( _mm_srli_si128( c01, 8 ) );
+    m[2] = _mm_cvtepi16_epi32( c23 );
+    m[3] = _mm_cvtepi16_epi32( _mm_srli_si128( c23, 8 ) );
+    m[4] = _mm_cvtepi16_epi32( c45 );
+    m[5] = _mm_cvtepi16_epi32( _mm_srli_si128( c45, 8 ) );
+    m[6] = _mm_cvtepi16_epi32( c67 );
+    m[7] = _mm_cvtepi16_epi32( _mm_srli_si128( c67, 8 ) );
+  }
+
+  __m128i r[8];
+  for( Int k = 0; k < 8; k++ )
+  {
+    r[k] = m[k];
+  }
+
+  if( sw )
+  {
+    const __m128i tc2  = _mm_set1_epi32( 2 * tc );
+    const __m128i four = _mm_set1_epi32( 4 );
+    const __m128i two  = _mm_set1_epi32( 2 );
+    const __m128i s34  = _mm_add_epi32( m[3], m[4] );
+    const __m128i s234 = _mm_add_epi32( s34, m[2] );
+    const __m128i s345 = _mm_add_epi32( s34, m[5] );
+
+    // ( m1 + 2*m2 + 2*m3 + 2*m4 + m5 + 4 ) >> 3
+    __m128i v = _mm_add_epi32( _mm_add_epi32( m[1], m[5] ), _mm_slli_epi32( s234, 1 ) );
+    r[3] = clip3X86( _mm_sub_epi32( m[3], tc2 ), _mm_add_epi32( m[3], tc2 ), _mm_srai_epi32( _mm_add_epi32( v, four ), 3 ) );
+    // ( m1 + m2 + m3 + m4 + 2 ) >> 2
+    r[2] = clip3X86( _mm_sub_epi32( m[2], tc2 ), _mm_add_epi32( m[2], tc2 ), _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( s234, m[1] ), two ), 2 ) );
+    // ( 2*m0 + 3*m1 + m2 + m3 + m4 + 4 ) >> 3
+    v = _mm_add_epi32( _mm_add_epi32( _mm_slli_epi32( _mm_add_epi32( m[0], m[1] ), 1 ), m[1] ), _mm_add_epi32( s234, four ) );
+    r[1] = clip3X86( _mm_sub_epi32( m[1], tc2 ), _mm_add_epi32( m[1], tc2 ), _mm_srai_epi32( v, 3 ) );
+    // ( m2 + 2*m3 + 2*m4 + 2*m5 + m6 + 4 ) >> 3
+    v = _mm_add_epi32( _mm_add_epi32( m[2], m[6] ), _mm_slli_epi32( s345, 1 ) );
+    r[4] = clip3X86( _mm_sub_epi32( m[4], tc2 ), _mm_add_epi32( m[4], tc2 ), _mm_srai_epi32( _mm_add_epi32( v, four ), 3 ) );
+    // ( m3 + m4 + m5 + m6 + 2 ) >> 2
+    r[5] = clip3X86( _mm_sub_epi32( m[5], tc2 ), _mm_add_epi32( m[5], tc2 ), _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( s345, m[6] ), two ), 2 ) );
+    // ( m3 + m4 + m5 + 3*m6 + 2*m7 + 4 ) >> 3
+    v = _mm_add_epi32( _mm_add_epi32( _mm_slli_epi32( _mm_add_epi32( m[6], m[7] ), 1 ), m[6] ), _mm_add_epi32( s345, four ) );
+    r[6] = clip3X86( _mm_sub_epi32( m[6], tc2 ), _mm_add_epi32( m[6], tc2 ), _mm_srai_epi32( v, 3 ) );
+  }
+  else
+  {
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128i maxVal = _mm_set1_epi32( ( 1 << bitDepthLuma ) - 1 );
+    const __m128i tcP    = _mm_set1_epi32(  tc );
+    const __m128i tcN    = _mm_set1_epi32( -tc );
+
+    // delta = ( 9*( m4 - m3 ) - 3*( m5 - m2 ) + 8 ) >> 4
+    const __m128i d43 = _mm_sub_epi32( m[4], m[3] );
+    const __m128i d52 = _mm_sub_epi32( m[5], m[2] );
+    __m128i delta = _mm_sub_epi32( _mm_add_epi32( _mm_slli_epi32( d43, 3 ), d43 ), _mm_add_epi32( _mm_slli_epi32( d52, 1 ), d52 ) );
+    delta = _mm_srai_epi32( _mm_add_epi32( delta, _mm_set1_epi32( 8 ) ), 4 );
+
+    const __m128i filtered = _mm_cmplt_epi32( _mm_abs_epi32( delta ), _mm_set1_epi32( iThrCut ) );
+
+    delta = clip3X86( tcN, tcP, delta );
+    r[3] = _mm_blendv_epi8( m[3], clip3X86( zero, maxVal, _mm_add_epi32( m[3], delta ) ), filtered );
+    r[4] = _mm_blendv_epi8( m[4], clip3X86( zero, maxVal, _mm_sub_epi32( m[4], delta ) ), filtered );
+
+    const __m128i tc2P = _mm_set1_epi32(  ( tc >> 1 ) );
+    const __m128i tc2N = _mm_set1_epi32( -( tc >> 1 ) );
+    const __m128i one  = _mm_set1_epi32( 1 );
+    if( bFilterSecondP )
+    {
+      // delta1 = Clip3( -tc2, tc2, ( ( ( m1 + m3 + 1 ) >> 1 ) - m2 + delta ) >> 1 )
+      __m128i delta1 = _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( m[1], m[3] ), one ), 1 );
+      delta1 = clip3X86( tc2N, tc2P, _mm_srai_epi32( _mm_add_epi32( _mm_sub_epi32( delta1, m[2] ), delta ), 1 ) );
+      r[2] = _mm_blendv_epi8( m[2], clip3X86( zero, maxVal, _mm_add_epi32( m[2], delta1 ) ), filtered );
+    }
+    if( bFilterSecondQ )
+    {
+      // delta2 = Clip3( -tc2, tc2, ( ( ( m6 + m4 + 1 ) >> 1 ) - m5 - delta ) >> 1 )
+      __m128i delta2 = _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( m[6], m[4] ), one ), 1 );
+      delta2 = clip3X86( tc2N, tc2P, _mm_srai_epi32( _mm_sub_epi32( _mm_sub_epi32( delta2, m[5] ), delta ), 1 ) );
+      r[5] = _mm_blendv_epi8( m[5], clip3X86( zero, maxVal, _mm_add_epi32( m[5], delta2 ) ), filtered );
+    }
+  }
+
+  if( bPartPNoFilter )
+  {
+    r[1] = m[1];
+    r[2] = m[2];
+    r[3] = m[3];
+  }
+  if( bPartQNoFilter )
+  {
+    r[4] = m[4];
+    r[5] = m[5];
+    r[6] = m[6];
+  }
+
+  if( edgeDir == EDGE_HOR )
+  {
+    for( Int k = 1; k < 7; k++ )
+    {
+      _mm_storel_epi64( ( __m128i* )( piSrc + ( k - 4 ) * iOffset ), _mm_packs_epi32( r[k], r[k] ) );
+    }
+  }
+  else
+  {
+    const __m128i c01 = _mm_packs_epi32( r[0], r[1] );
+    const __m128i c23 = _mm_packs_epi32( r[2], r[3] );
+    const __m128i c45 = _mm_packs_epi32( r[4], r[5] );
+    const __m128i c67 = _mm_packs_epi32( r[6], r[7] );
+
+    const __m128i a = _mm_unpacklo_epi16( c01, c23 );
+    const __m128i b = _mm_unpackhi_epi16( c01, c23 );
+    const __m128i c = _mm_unpacklo_epi16( c45, c67 );
+    const __m128i d = _mm_unpackhi_epi16( c45, c67 );
+    const __m128i e = _mm_unpacklo_epi16( a, b );
+    const __m128i f = _mm_unpackhi_epi16( a, b );
+    const __m128i g = _mm_unpacklo_epi16( c, d );
+    const __m128i h = _mm_unpackhi_epi16( c, d );
+
+    _mm_storeu_si128( ( __m128i* )( piSrc                - 4 ), _mm_unpacklo_epi64( e, g ) );
+    _mm_storeu_si128( ( __m128i* )( piSrc +     iSrcStep - 4 ), _mm_unpackhi_epi64( e, g ) );
+    _mm_storeu_si128( ( __m128i* )( piSrc + 2 * iSrcStep - 4 ), _mm_unpacklo_epi64( f, h ) );
+    _mm_storeu_si128( ( __m128i* )( piSrc + 3 * iSrcStep - 4 ), _mm_unpackhi_epi64( f, h ) );
+  }
+}
+
+template<X86_VEXT vext>
+Void TComLoopFilter::_initLoopFilterX86()
+{
+  m_filterLuma[EDGE_VER] = simdFilterLumaLines<vext, EDGE_VER>;
+  m_filterLuma[EDGE_HOR] = simdFilterLumaLines<vext, EDGE_HOR>;
+}
+
+template Void TComLoopFilter::_initLoopFilterX86<SIMDX86>();
+
+//! \}
+
+#endif // ENABLE_SIMD_OPT_DEBLOCKING
@@ -0,0 +1,678 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     RdCostX86.h
+    \brief    SIMD SAD, SSE and Hadamard distortion functions of TComRdCost
+    \details  This file is included by the per-extension sources in x86/<ext>/, each of them compiled
+              with the corresponding compiler flags. All functions return exactly the same values
+              as the C functions in TComRdCost.cpp.
+*/
+
+#include "CommonDefX86.h"
+#include "../TComRdCost.h"
+
+#if ENABLE_SIMD_OPT_DIST
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Row helpers (Pel is 16-bit, internal bit depth is at most 12 bits)
+// ====================================================================================================================
+
+static inline UInt simdHorizontalSum32( __m128i sum )
+{
+  sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+  sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+  return UInt( _mm_cvtsi128_si32( sum ) );
+}
+
+static inline UInt64 simdHorizontalSum64( __m128i sum )
+{
+  UInt64 lo, hi;
+  _mm_storel_epi64( ( __m128i* )&lo, sum );
+  _mm_storel_epi64( ( __m128i* )&hi, _mm_unpackhi_epi64( sum, sum ) );
+  return lo + hi;
+}
+
+/// sum of absolute differences of the first (iWidth & ~3) samples of a row, as four 32-bit partial sums
+template<X86_VEXT vext>
+static inline __m128i simdSADRow( const Pel* piOrg, const Pel* piCur, const Int iWidth )
+{
+  __m128i sum = _mm_setzero_si128();
+  Int     n   = 0;
+
+#ifdef USE_AVX512
+  if( vext >= AVX512 && iWidth >= 32 )
+  {
+    const __m512i one    = _mm512_set1_epi16( 1 );
+    __m512i       sum512 = _mm512_setzero_si512();
+    for( ; n + 32 <= iWidth; n += 32 )
+    {
+      const __m512i diff = _mm512_sub_epi16( _mm512_loadu_si512( ( const __m512i* )( piOrg + n ) ), _mm512_loadu_si512( ( const __m512i* )( piCur + n ) ) );
+      sum512 = _mm512_add_epi32( sum512, _mm512_madd_epi16( _mm512_abs_epi16( diff ), one ) );
+    }
+    // (masked extracts: the unmasked forms trigger -Wmaybe-uninitialized in some GCC versions)
+    const __m256i sum256 = _mm256_add_epi32( _mm512_maskz_extracti64x4_epi64( 0xf, sum512, 0 ), _mm512_maskz_extracti64x4_epi64( 0xf, sum512, 1 ) );
+    sum = _mm_add_epi32( _mm256_castsi256_si128( sum256 ), _mm256_extracti128_si256( sum256, 1 ) );
+  }
+#endif
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+  if( vext >= AVX2 && iWidth - n >= 16 )
+  {
+    const __m256i one    = _mm256_set1_epi16( 1 );
+    __m256i       sum256 = _mm256_setzero_si256();
+    for( ; n + 16 <= iWidth; n += 16 )
+    {
+      const __m256i diff = _mm256_sub_epi16( _mm256_loadu_si256( ( const __m256i* )( piOrg + n ) ), _mm256_loadu_si256( ( const __m256i* )( piCur + n ) ) );
+      sum256 = _mm256_add_epi32( sum256, _mm256_madd_epi16( _mm256_abs_epi16( diff ), one ) );
+    }
+    sum = _mm_add_epi32( sum, _mm_add_epi32( _mm256_castsi256_si128( sum256 ), _mm256_extracti128_si256( sum256, 1 ) ) );
+  }
+#endif
+
+  const __m128i one = _mm_set1_epi16( 1 );
+  for( ; n + 8 <= iWidth; n += 8 )
+  {
+    const __m128i diff = _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* )( piOrg + n ) ), _mm_loadu_si128( ( const __m128i* )( piCur + n ) ) );
+    sum = _mm_add_epi32( sum, _mm_madd_epi16( _mm_abs_epi16( diff ), one ) );
+  }
+  if( n + 4 <= iWidth )
+  {
+    const __m128i diff = _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* )( piOrg + n ) ), _mm_loadl_epi64( ( const __m128i* )( piCur + n ) ) );
+    sum = _mm_add_epi32( sum, _mm_madd_epi16( _mm_abs_epi16( diff ), one ) );
+  }
+  return sum;
+}
+
+/// sum of squared differences of the first (iWidth & ~3) samples of a row, as four 32-bit partial sums
+template<X86_VEXT vext>
+static inline __m128i simdSSERow( const Pel* piOrg, const Pel* piCur, const Int iWidth )
+{
+  __m128i sum = _mm_setzero_si128();
+  Int     n   = 0;
+
+#ifdef USE_AVX512
+  if( vext >= AVX512 && iWidth >= 32 )
+  {
+    __m512i sum512 = _mm512_setzero_si512();
+    for( ; n + 32 <= iWidth; n += 32 )
+    {
+      const __m512i diff = _mm512_sub_epi16( _mm512_loadu_si512( ( const __m512i* )( piOrg + n ) ), _mm512_loadu_si512( ( const __m512i* )( piCur + n ) ) );
+      sum512 = _mm512_add_epi32( sum512, _mm512_madd_epi16( diff, diff ) );
+    }
+    const __m256i sum256 = _mm256_add_epi32( _mm512_maskz_extracti64x4_epi64( 0xf, sum512, 0 ), _mm512_maskz_extracti64x4_epi64( 0xf, sum512, 1 ) );
+    sum = _mm_add_epi32( _mm256_castsi256_si128( sum256 ), _mm256_extracti128_si256( sum256, 1 ) );
+  }
+#endif
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+  if( vext >= AVX2 && iWidth - n >= 16 )
+  {
+    __m256i sum256 = _mm256_setzero_si256();
+    for( ; n + 16 <= iWidth; n += 16 )
+    {
+      const __m256i diff = _mm256_sub_epi16( _mm256_loadu_si256( ( const __m256i* )( piOrg + n ) ), _mm256_loadu_si256( ( const __m256i* )( piCur + n ) ) );
+      sum256 = _mm256_add_epi32( sum256, _mm256_madd_epi16( diff, diff ) );
+    }
+    sum = _mm_add_epi32( sum, _mm_add_epi32( _mm256_castsi256_si128( sum256 ), _mm256_extracti128_si256( sum256, 1 ) ) );
+  }
+#endif
+
+  for( ; n + 8 <= iWidth; n += 8 )
+  {
+    const __m128i diff = _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* )( piOrg + n ) ), _mm_loadu_si128( ( const __m128i* )( piCur + n ) ) );
+    sum = _mm_add_epi32( sum, _mm_madd_epi16( diff, diff ) );
+  }
+  if( n + 4 <= iWidth )
+  {
+    const __m128i diff = _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* )( piOrg + n ) ), _mm_loadl_epi64( ( const __m128i* )( piCur + n ) ) );
+    sum = _mm_add_epi32( sum, _mm_madd_epi16( diff, diff ) );
+  }
+  return sum;
+}
+
+// ====================================================================================================================
+// SAD
+// ====================================================================================================================
+
+/// general size SAD, with the early termination of TComRdCost::xGetSAD
+template<X86_VEXT vext>
+static Distortion xGetSAD_SIMD( DistParam* pcDtParam )
+{
+  if( pcDtParam->bApplyWeight )
+  {
+    return TComRdCostWeightPrediction::xGetSADw( pcDtParam );
+  }
+  const Pel* piOrg           = pcDtParam->pOrg;
+  const Pel* piCur           = pcDtParam->pCur;
+  const Int  iCols           = pcDtParam->iCols;
+  const Int  iColsSimd       = iCols & ~3;
+  const Int  iStrideCur      = pcDtParam->iStrideCur;
+  const Int  iStrideOrg      = pcDtParam->iStrideOrg;
+  const UInt distortionShift = DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 );
+
+  Distortion uiSum = 0;
+
+  for( Int iRows = pcDtParam->iRows; iRows != 0; iRows-- )
+  {
+    uiSum += simdHorizontalSum32( simdSADRow<vext>( piOrg, piCur, iColsSimd ) );
+    for( Int n = iColsSimd; n < iCols; n++ )
+    {
+      uiSum += abs( piOrg[n] - piCur[n] );
+    }
+    if( pcDtParam->m_maximumDistortionForEarlyExit < ( uiSum >> distortionShift ) )
+    {
+      return ( uiSum >> distortionShift );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  return ( uiSum >> distortionShift );
+}
+
+/// SAD of blocks with iWidth columns, with vertical subsampling
+template<X86_VEXT vext, Int iWidth>
+static Distortion xGetSAD_NxN_SIMD( DistParam* pcDtParam )
+{
+  if( pcDtParam->bApplyWeight )
+  {
+    return TComRdCostWeightPrediction::xGetSADw( pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  Int        iRows      = pcDtParam->iRows;
+  const Int  iSubShift  = pcDtParam->iSubShift;
+  const Int  iSubStep   = ( 1 << iSubShift );
+  const Int  iStrideCur = pcDtParam->iStrideCur * iSubStep;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg * iSubStep;
+
+  // a 32-bit lane collects at most 2 * 64 * 64 / 4 absolute differences of 12-bit samples: no overflow
+  __m128i sum = _mm_setzero_si128();
+  for( ; iRows != 0; iRows -= iSubStep )
+  {
+    sum    = _mm_add_epi32( sum, simdSADRow<vext>( piOrg, piCur, iWidth ) );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  Distortion uiSum = simdHorizontalSum32( sum );
+  uiSum <<= iSubShift;
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
+}
+
+/// SAD of a row of iWidth samples against the rows of four candidate blocks, added to one 32-bit partial sum vector
+/// per candidate: each original sample vector is loaded once for all candidates
+template<X86_VEXT vext, Int iWidth>
+static inline Void simdSADRowMulti4( const Pel* piOrg, const Pel* const* piCur, const Int iOffset, __m128i* sum )
+{
+  Int n = 0;
+
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+  if( vext >= AVX2 && iWidth >= 16 )
+  {
+    const __m256i one = _mm256_set1_epi16( 1 );
+    __m256i sum256[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+    for( ; n + 16 <= iWidth; n += 16 )
+    {
+      const __m256i org = _mm256_loadu_si256( ( const __m256i* )( piOrg + n ) );
+      for( Int k = 0; k < 4; k++ )
+      {
+        const __m256i diff = _mm256_sub_epi16( org, _mm256_loadu_si256( ( const __m256i* )( piCur[k] + iOffset + n ) ) );
+        sum256[k] = _mm256_add_epi32( sum256[k], _mm256_madd_epi16( _mm256_abs_epi16( diff ), one ) );
+      }
+    }
+    for( Int k = 0; k < 4; k++ )
+    {
+      sum[k] = _mm_add_epi32( sum[k], _mm_add_epi32( _mm256_castsi256_si128( sum256[k] ), _mm256_extracti128_si256( sum256[k], 1 ) ) );
+    }
+  }
+#endif
+
+  const __m128i one = _mm_set1_epi16( 1 );
+  for( ; n + 8 <= iWidth; n += 8 )
+  {
+    const __m128i org = _mm_loadu_si128( ( const __m128i* )( piOrg + n ) );
+    for( Int k = 0; k < 4; k++ )
+    {
+      const __m128i diff = _mm_sub_epi16( org, _mm_loadu_si128( ( const __m128i* )( piCur[k] + iOffset + n ) ) );
+      sum[k] = _mm_add_epi32( sum[k], _mm_madd_epi16( _mm_abs_epi16( diff ), one ) );
+    }
+  }
+  if( n + 4 <= iWidth )
+  {
+    const __m128i org = _mm_loadl_epi64( ( const __m128i* )( piOrg + n ) );
+    for( Int k = 0; k < 4; k++ )
+    {
+      const __m128i diff = _mm_sub_epi16( org, _mm_loadl_epi64( ( const __m128i* )( piCur[k] + iOffset + n ) ) );
+      sum[k] = _mm_add_epi32( sum[k], _mm_madd_epi16( _mm_abs_epi16( diff ), one ) );
+    }
+  }
+}
+
+/// SAD of blocks with iWidth columns against several candidate blocks, with vertical subsampling, four candidates
+/// at a time. Each value equals the one of xGetSAD_NxN_SIMD for the candidate.
+template<X86_VEXT vext, Int iWidth>
+static Void xGetSADMulti_NxN_SIMD( const DistParam* pcDtParam, const Pel* const* ppCur, Int iNumCand, Distortion* puiDist )
+{
+  if( pcDtParam->bApplyWeight )
+  {
+    DistParam cDtParam = *pcDtParam;
+    for( Int i = 0; i < iNumCand; i++ )
+    {
+      cDtParam.pCur = ppCur[i];
+      puiDist[i]    = TComRdCostWeightPrediction::xGetSADw( &cDtParam );
+    }
+    return;
+  }
+  const Int  iSubShift       = pcDtParam->iSubShift;
+  const Int  iSubStep        = ( 1 << iSubShift );
+  const Int  iStrideCur      = pcDtParam->iStrideCur * iSubStep;
+  const Int  iStrideOrg      = pcDtParam->iStrideOrg * iSubStep;
+  const UInt distortionShift = DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 );
+
+  for( Int i = 0; i < iNumCand; i += 4 )
+  {
+    const Int  iNum     = std::min( 4, iNumCand - i );
+    // a partial group repeats its last candidate, whose result is not stored
+    const Pel* piCur[4] = { ppCur[i], ppCur[i + std::min( 1, iNum - 1 )], ppCur[i + std::min( 2, iNum - 1 )], ppCur[i + iNum - 1] };
+    __m128i    sum[4]   = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+
+    const Pel* piOrg    = pcDtParam->pOrg;
+    Int        iOffset  = 0;
+    for( Int iRows = pcDtParam->iRows; iRows != 0; iRows -= iSubStep )
+    {
+      simdSADRowMulti4<vext, iWidth>( piOrg, piCur, iOffset, sum );
+      piOrg   += iStrideOrg;
+      iOffset += iStrideCur;
+    }
+    for( Int k = 0; k < iNum; k++ )
+    {
+      Distortion uiSum = simdHorizontalSum32( sum[k] );
+      uiSum <<= iSubShift;
+      puiDist[i + k] = ( uiSum >> distortionShift );
+    }
+  }
+}
+
+// ====================================================================================================================
+// SSE
+// ====================================================================================================================
+
+static inline __m128i simdAccumulateSSE( __m128i sum64, const __m128i rowSum32 )
+{
+  // the squared differences of one row (at most 64 samples of 12 bits) fit into an unsigned 32-bit lane
+  sum64 = _mm_add_epi64( sum64, _mm_cvtepu32_epi64( rowSum32 ) );
+  return  _mm_add_epi64( sum64, _mm_cvtepu32_epi64( _mm_unpackhi_epi64( rowSum32, rowSum32 ) ) );
+}
+
+/// SSE of blocks with iWidth columns (any width if iWidth is 0)
+template<X86_VEXT vext, Int iWidth>
+static Distortion xGetSSE_NxN_SIMD( DistParam* pcDtParam )
+{
+  if( pcDtParam->bApplyWeight )
+  {
+    assert( iWidth == 0 || pcDtParam->iCols == iWidth );
+    return TComRdCostWeightPrediction::xGetSSEw( pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iCols      = iWidth ? iWidth : pcDtParam->iCols;
+  const Int  iColsSimd  = iCols & ~3;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg;
+  const Int  iStrideCur = pcDtParam->iStrideCur;
+
+  Distortion uiSum = 0;
+  __m128i    sum   = _mm_setzero_si128();
+
+  for( Int iRows = pcDtParam->iRows; iRows != 0; iRows-- )
+  {
+    sum = simdAccumulateSSE( sum, simdSSERow<vext>( piOrg, piCur, iColsSimd ) );
+    for( Int n = iColsSimd; n < iCols; n++ )
+    {
+      const Intermediate_Int iTemp = piOrg[n] - piCur[n];
+      uiSum += Distortion( iTemp * iTemp );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  return uiSum + simdHorizontalSum64( sum );
+}
+
+// ====================================================================================================================
+// Hadamard
+// ====================================================================================================================
+
+static inline Void simdButterfly( __m128i &a, __m128i &b, Bool b32 )
+{
+  const __m128i sum = b32 ? _mm_add_epi32( a, b ) : _mm_add_epi16( a, b );
+  b = b32 ? _mm_sub_epi32( a, b ) : _mm_sub_epi16( a, b );
+  a = sum;
+}
+
+/// 8-point Hadamard transform across the eight vectors (element-wise), in the butterfly order of xCalcHADs8x8
+static inline Void simdHAD8( __m128i *m, Bool b32 )
+{
+  for( Int k = 0; k < 4; k++ )
+  {
+    simdButterfly( m[k], m[k + 4], b32 );
+  }
+  simdButterfly( m[0], m[2], b32 );  simdButterfly( m[1], m[3], b32 );
+  simdButterfly( m[4], m[6], b32 );  simdButterfly( m[5], m[7], b32 );
+  simdButterfly( m[0], m[1], b32 );  simdButterfly( m[2], m[3], b32 );
+  simdButterfly( m[4], m[5], b32 );  simdButterfly( m[6], m[7], b32 );
+}
+
+static inline Void simdTranspose8x8_16b( __m128i *m )
+{
+  const __m128i a0 = _mm_unpacklo_epi16( m[0], m[1] ), a1 = _mm_unpackhi_epi16( m[0], m[1] );
+  const __m128i a2 = _mm_unpacklo_epi16( m[2], m[3] ), a3 = _mm_unpackhi_epi16( m[2], m[3] );
+  const __m128i a4 = _mm_unpacklo_epi16( m[4], m[5] ), a5 = _mm_unpackhi_epi16( m[4], m[5] );
+  const __m128i a6 = _mm_unpacklo_epi16( m[6], m[7] ), a7 = _mm_unpackhi_epi16( m[6], m[7] );
+
+  const __m128i b0 = _mm_unpacklo_epi32( a0, a2 ), b1 = _mm_unpackhi_epi32( a0, a2 );
+  const __m128i b2 = _mm_unpacklo_epi32( a1, a3 ), b3 = _mm_unpackhi_epi32( a1, a3 );
+  const __m128i b4 = _mm_unpacklo_epi32( a4, a6 ), b5 = _mm_unpackhi_epi32( a4, a6 );
+  const __m128i b6 = _mm_unpacklo_epi32( a5, a7 ), b7 = _mm_unpackhi_epi32( a5, a7 );
+
+  m[0] = _mm_unpacklo_epi64( b0, b4 );  m[1] = _mm_unpackhi_epi64( b0, b4 );
+  m[2] = _mm_unpacklo_epi64( b1, b5 );  m[3] = _mm_unpackhi_epi64( b1, b5 );
+  m[4] = _mm_unpacklo_epi64( b2, b6 );  m[5] = _mm_unpackhi_epi64( b2, b6 );
+  m[6] = _mm_unpacklo_epi64( b3, b7 );  m[7] = _mm_unpackhi_epi64( b3, b7 );
+}
+
+static inline Void simdTranspose4x4_32b( __m128i &a, __m128i &b, __m128i &c, __m128i &d )
+{
+  const __m128i t0 = _mm_unpacklo_epi32( a, b ), t1 = _mm_unpackhi_epi32( a, b );
+  const __m128i t2 = _mm_unpacklo_epi32( c, d ), t3 = _mm_unpackhi_epi32( c, d );
+  a = _mm_unpacklo_epi64( t0, t2 );  b = _mm_unpackhi_epi64( t0, t2 );
+  c = _mm_unpacklo_epi64( t1, t3 );  d = _mm_unpackhi_epi64( t1, t3 );
+}
+
+/// 8x8 Hadamard SATD; equal to TComRdCost::xCalcHADs8x8 (the Hadamard coefficients are the same up to order and sign)
+template<X86_VEXT vext>
+static inline Distortion simdHADs8x8( const Pel* piOrg, const Pel* piCur, const Int iStrideOrg, const Int iStrideCur, const Int bitDepth )
+{
+  __m128i m[8];
+  for( Int k = 0; k < 8; k++ )
+  {
+    m[k] = _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* )( piOrg + k * iStrideOrg ) ), _mm_loadu_si128( ( const __m128i* )( piCur + k * iStrideCur ) ) );
+  }
+
+  __m128i lo[8], hi[8];
+
+  if( bitDepth <= 10 )
+  {
+    // vertical in 16 bits: the differences are bounded by 2 * ( 2^10 - 1 ) (bi-prediction target of
+    // TComYuv::removeHighFreq), so the coefficients stay below 2^15
+    simdHAD8( m, false );
+    simdTranspose8x8_16b( m );
+
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+    if( vext >= AVX2 )
+    {
+      // horizontal in 32 bits, one transposed row per register
+      __m256i n[8];
+      for( Int k = 0; k < 8; k++ )
+      {
+        n[k] = _mm256_cvtepi16_epi32( m[k] );
+      }
+      for( Int k = 0; k < 4; k++ )
+      {
+        const __m256i a = n[k];
+        n[k]     = _mm256_add_epi32( a, n[k + 4] );
+        n[k + 4] = _mm256_sub_epi32( a, n[k + 4] );
+      }
+      for( Int k = 0; k < 8; k += 4 )
+      {
+        for( Int j = k; j < k + 2; j++ )
+        {
+          const __m256i a = n[j];
+          n[j]     = _mm256_add_epi32( a, n[j + 2] );
+          n[j + 2] = _mm256_sub_epi32( a, n[j + 2] );
+        }
+      }
+      __m256i sum = _mm256_setzero_si256();
+      for( Int k = 0; k < 8; k += 2 )
+      {
+        sum = _mm256_add_epi32( sum, _mm256_abs_epi32( _mm256_add_epi32( n[k], n[k + 1] ) ) );
+        sum = _mm256_add_epi32( sum, _mm256_abs_epi32( _mm256_sub_epi32( n[k], n[k + 1] ) ) );
+      }
+      const UInt sad = simdHorizontalSum32( _mm_add_epi32( _mm256_castsi256_si128( sum ), _mm256_extracti128_si256( sum, 1 ) ) );
+      return ( sad + 2 ) >> 2;
+    }
+#endif
+
+    // horizontal in 32 bits, each transposed row split into two registers
+    for( Int k = 0; k < 8; k++ )
+    {
+      lo[k] = _mm_cvtepi16_epi32( m[k] );
+      hi[k] = _mm_cvtepi16_epi32( _mm_unpackhi_epi64( m[k], m[k] ) );
+    }
+  }
+  else
+  {
+    // vertical in 32 bits
+    for( Int k = 0; k < 8; k++ )
+    {
+      lo[k] = _mm_cvtepi16_epi32( m[k] );
+      hi[k] = _mm_cvtepi16_epi32( _mm_unpackhi_epi64( m[k], m[k] ) );
+    }
+    simdHAD8( lo, true );
+    simdHAD8( hi, true );
+
+    // transpose as four 4x4 blocks: [lo0-3 lo4-7; hi0-3 hi4-7] -> [lo0-3 hi0-3; lo4-7 hi4-7]
+    simdTranspose4x4_32b( lo[0], lo[1], lo[2], lo[3] );
+    simdTranspose4x4_32b( lo[4], lo[5], lo[6], lo[7] );
+    simdTranspose4x4_32b( hi[0], hi[1], hi[2], hi[3] );
+    simdTranspose4x4_32b( hi[4], hi[5], hi[6], hi[7] );
+    for( Int k = 0; k < 4; k++ )
+    {
+      std::swap( lo[k + 4], hi[k] );
+    }
+  }
+
+  simdHAD8( lo, true );
+  simdHAD8( hi, true );
+
+  __m128i sum = _mm_setzero_si128();
+  for( Int k = 0; k < 8; k++ )
+  {
+    sum = _mm_add_epi32( sum, _mm_add_epi32( _mm_abs_epi32( lo[k] ), _mm_abs_epi32( hi[k] ) ) );
+  }
+  const UInt sad = simdHorizontalSum32( sum );
+  return ( sad + 2 ) >> 2;
+}
+
+/// 4x4 Hadamard SATD; equal to TComRdCost::xCalcHADs4x4
+static inline Distortion simdHADs4x4( const Pel* piOrg, const Pel* piCur, const Int iStrideOrg, const Int iStrideCur )
+{
+  __m128i m[4];
+  for( Int k = 0; k < 4; k++ )
+  {
+    m[k] = _mm_cvtepi16_epi32( _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* )( piOrg + k * iStrideOrg ) ), _mm_loadl_epi64( ( const __m128i* )( piCur + k * iStrideCur ) ) ) );
+  }
+
+  simdButterfly( m[0], m[2], true );  simdButterfly( m[1], m[3], true );
+  simdButterfly( m[0], m[1], true );  simdButterfly( m[2], m[3], true );
+
+  simdTranspose4x4_32b( m[0], m[1], m[2], m[3] );
+
+  simdButterfly( m[0], m[2], true );  simdButterfly( m[1], m[3], true );
+  simdButterfly( m[0], m[1], true );  simdButterfly( m[2], m[3], true );
+
+  const __m128i sum = _mm_add_epi32( _mm_add_epi32( _mm_abs_epi32( m[0] ), _mm_abs_epi32( m[1] ) ),
+                                     _mm_add_epi32( _mm_abs_epi32( m[2] ), _mm_abs_epi32( m[3] ) ) );
+  const UInt satd = simdHorizontalSum32( sum );
+  return ( satd + 1 ) >> 1;
+}
+
+static inline Distortion xCalcHADs2x2( const Pel* piOrg, const Pel* piCur, const Int iStrideOrg, const Int iStrideCur )
+{
+  const TCoeff diff0 = piOrg[0             ] - piCur[0             ];
+  const TCoeff diff1 = piOrg[1             ] - piCur[1             ];
+  const TCoeff diff2 = piOrg[iStrideOrg    ] - piCur[iStrideCur    ];
+  const TCoeff diff3 = piOrg[iStrideOrg + 1] - piCur[iStrideCur + 1];
+  const TCoeff m0    = diff0 + diff2;
+  const TCoeff m1    = diff1 + diff3;
+  const TCoeff m2    = diff0 - diff2;
+  const TCoeff m3    = diff1 - diff3;
+
+  return abs( m0 + m1 ) + abs( m0 - m1 ) + abs( m2 + m3 ) + abs( m2 - m3 );
+}
+
+template<X86_VEXT vext>
+static Distortion xGetHADs_SIMD( DistParam* pcDtParam )
+{
+  if( pcDtParam->bApplyWeight )
+  {
+    return TComRdCostWeightPrediction::xGetHADsw( pcDtParam );
+  }
+  const Pel* piOrg      = pcDtParam->pOrg;
+  const Pel* piCur      = pcDtParam->pCur;
+  const Int  iRows      = pcDtParam->iRows;
+  const Int  iCols      = pcDtParam->iCols;
+  const Int  iStrideCur = pcDtParam->iStrideCur;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg;
+
+  assert( pcDtParam->iStep == 1 );
+
+  Distortion uiSum = 0;
+
+  if( ( iRows % 8 == 0 ) && ( iCols % 8 == 0 ) )
+  {
+    for( Int y = 0; y < iRows; y += 8 )
+    {
+      for( Int x = 0; x < iCols; x += 8 )
+      {
+        uiSum += simdHADs8x8<vext>( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur, pcDtParam->bitDepth );
+      }
+      piOrg += iStrideOrg << 3;
+      piCur += iStrideCur << 3;
+    }
+  }
+  else if( ( iRows % 4 == 0 ) && ( iCols % 4 == 0 ) )
+  {
+    for( Int y = 0; y < iRows; y += 4 )
+    {
+      for( Int x = 0; x < iCols; x += 4 )
+      {
+        uiSum += simdHADs4x4( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+      }
+      piOrg += iStrideOrg << 2;
+      piCur += iStrideCur << 2;
+    }
+  }
+  else if( ( iRows % 2 == 0 ) && ( iCols % 2 == 0 ) )
+  {
+    for( Int y = 0; y < iRows; y += 2 )
+    {
+      for( Int x = 0; x < iCols; x += 2 )
+      {
+        uiSum += xCalcHADs2x2( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+      }
+      piOrg += iStrideOrg << 1;
+      piCur += iStrideCur << 1;
+    }
+  }
+  else
+  {
+    assert( false );
+  }
+
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
+}
+
+// ====================================================================================================================
+// Initialisation
+// ====================================================================================================================
+
+template<X86_VEXT vext>
+Void TComRdCost::_initRdCostX86()
+{
+#if FULL_NBIT
+  m_afpDistortFunc[DF_SSE    ] = xGetSSE_NxN_SIMD<vext,  0>;
+  m_afpDistortFunc[DF_SSE4   ] = xGetSSE_NxN_SIMD<vext,  4>;
+  m_afpDistortFunc[DF_SSE8   ] = xGetSSE_NxN_SIMD<vext,  8>;
+  m_afpDistortFunc[DF_SSE16  ] = xGetSSE_NxN_SIMD<vext, 16>;
+  m_afpDistortFunc[DF_SSE32  ] = xGetSSE_NxN_SIMD<vext, 32>;
+  m_afpDistortFunc[DF_SSE64  ] = xGetSSE_NxN_SIMD<vext, 64>;
+  m_afpDistortFunc[DF_SSE16N ] = xGetSSE_NxN_SIMD<vext,  0>;
+#endif
+
+  m_afpDistortFunc[DF_SAD    ] = xGetSAD_SIMD<vext>;
+  m_afpDistortFunc[DF_SAD4   ] = xGetSAD_NxN_SIMD<vext,  4>;
+  m_afpDistortFunc[DF_SAD8   ] = xGetSAD_NxN_SIMD<vext,  8>;
+  m_afpDistortFunc[DF_SAD16  ] = xGetSAD_NxN_SIMD<vext, 16>;
+  m_afpDistortFunc[DF_SAD32  ] = xGetSAD_NxN_SIMD<vext, 32>;
+  m_afpDistortFunc[DF_SAD64  ] = xGetSAD_NxN_SIMD<vext, 64>;
+
+  m_afpDistortFunc[DF_SADS   ] = xGetSAD_SIMD<vext>;
+  m_afpDistortFunc[DF_SADS4  ] = xGetSAD_NxN_SIMD<vext,  4>;
+  m_afpDistortFunc[DF_SADS8  ] = xGetSAD_NxN_SIMD<vext,  8>;
+  m_afpDistortFunc[DF_SADS16 ] = xGetSAD_NxN_SIMD<vext, 16>;
+  m_afpDistortFunc[DF_SADS32 ] = xGetSAD_NxN_SIMD<vext, 32>;
+  m_afpDistortFunc[DF_SADS64 ] = xGetSAD_NxN_SIMD<vext, 64>;
+
+  m_afpDistortFunc[DF_SAD12  ] = xGetSAD_NxN_SIMD<vext, 12>;
+  m_afpDistortFunc[DF_SAD24  ] = xGetSAD_NxN_SIMD<vext, 24>;
+  m_afpDistortFunc[DF_SAD48  ] = xGetSAD_NxN_SIMD<vext, 48>;
+
+  m_afpDistortFunc[DF_SADS12 ] = xGetSAD_NxN_SIMD<vext, 12>;
+  m_afpDistortFunc[DF_SADS24 ] = xGetSAD_NxN_SIMD<vext, 24>;
+  m_afpDistortFunc[DF_SADS48 ] = xGetSAD_NxN_SIMD<vext, 48>;
+
+  m_afpMultiDistortFunc[DF_SAD4 ] = xGetSADMulti_NxN_SIMD<vext,  4>;
+  m_afpMultiDistortFunc[DF_SAD8 ] = xGetSADMulti_NxN_SIMD<vext,  8>;
+  m_afpMultiDistortFunc[DF_SAD16] = xGetSADMulti_NxN_SIMD<vext, 16>;
+  m_afpMultiDistortFunc[DF_SAD32] = xGetSADMulti_NxN_SIMD<vext, 32>;
+  m_afpMultiDistortFunc[DF_SAD64] = xGetSADMulti_NxN_SIMD<vext, 64>;
+  m_afpMultiDistortFunc[DF_SAD12] = xGetSADMulti_NxN_SIMD<vext, 12>;
+  m_afpMultiDistortFunc[DF_SAD24] = xGetSADMulti_NxN_SIMD<vext, 24>;
+  m_afpMultiDistortFunc[DF_SAD48] = xGetSADMulti_NxN_SIMD<vext, 48>;
+
+  m_afpDistortFunc[DF_HADS   ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS4  ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS8  ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS16 ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS32 ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS64 ] = xGetHADs_SIMD<vext>;
+  m_afpDistortFunc[DF_HADS16N] = xGetHADs_SIMD<vext>;
+}
+
+template Void TComRdCost::_initRdCostX86<SIMDX86>();
+
+//! \}
+
+#endif // ENABLE_SIMD_OPT_DIST
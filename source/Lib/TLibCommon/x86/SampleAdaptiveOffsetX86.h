@@ -0,0 +1,169 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     SampleAdaptiveOffsetX86.h
+    \brief    SIMD SAO edge offset application and statistics of TComSampleAdaptiveOffset
+    \details  This file is included by the per-extension sources in x86/<ext>/, each of them compiled
+              with the corresponding compiler flags. Eight samples are classified at a time from the
+              signs of their differences with the two neighbours; the offsets of the five classes are
+              looked up with a byte shuffle, and the statistics are accumulated per class with masks.
+*/
+
+#include "CommonDefX86.h"
+#include "../TComSampleAdaptiveOffset.h"
+
+#if ENABLE_SIMD_OPT_SAO
+
+//! \ingroup TLibCommon
+//! \{
+
+/// edge offset class minus 2 of eight samples: sgn(cur - neighbourA) + sgn(cur - neighbourB)
+static inline __m128i edgeClassX86( const __m128i &cur, const __m128i &neighbourA, const __m128i &neighbourB )
+{
+  const __m128i signA = _mm_sub_epi16( _mm_cmpgt_epi16( neighbourA, cur ), _mm_cmpgt_epi16( cur, neighbourA ) );
+  const __m128i signB = _mm_sub_epi16( _mm_cmpgt_epi16( neighbourB, cur ), _mm_cmpgt_epi16( cur, neighbourB ) );
+  return _mm_add_epi16( signA, signB );
+}
+
+static inline Int edgeClass( const Pel* src, Int neighbourA, Int neighbourB )
+{
+  return sgn( src[0] - src[neighbourA] ) + sgn( src[0] - src[neighbourB] ) + 2;
+}
+
+template<X86_VEXT vext>
+static Void simdEdgeOffset( const Pel* srcBlk, Int srcStride, Pel* resBlk, Int resStride, Int neighbourA, Int neighbourB, Int width, Int height, const Int* offset, Int maxSampleValueIncl )
+{
+  // bytes 2*c and 2*c+1 of the table hold the 16-bit offset of class c
+  const __m128i table  = _mm_setr_epi16( offset[0], offset[1], offset[2], offset[3], offset[4], 0, 0, 0 );
+  const __m128i idxMul = _mm_set1_epi16( 0x0202 );
+  const __m128i idxAdd = _mm_set1_epi16( 0x0504 );  // 2 * 0x0202 + 0x0100, the classes being offset by -2
+  const __m128i zero   = _mm_setzero_si128();
+  const __m128i maxVal = _mm_set1_epi16( maxSampleValueIncl );
+
+  for( Int y = 0; y < height; y++ )
+  {
+    if( width < 8 )
+    {
+      for( Int x = 0; x < width; x++ )
+      {
+        resBlk[x] = Clip3<Int>( 0, maxSampleValueIncl, srcBlk[x] + offset[edgeClass( srcBlk + x, neighbourA, neighbourB )] );
+      }
+    }
+    else
+    {
+      for( Int x = 0; x < width; x += 8 )
+      {
+            // the last vector overlaps the previous one, which is harmless since the source is not modified
+        const Int      pos = std::min( x, width - 8 );
+        const __m128i  cur = _mm_loadu_si128( ( const __m128i* )( srcBlk + pos ) );
+        const __m128i  cls = edgeClassX86( cur, _mm_loadu_si128( ( const __m128i* )( srcBlk + pos + neighbourA ) ),
+                                                _mm_loadu_si128( ( const __m128i* )( srcBlk + pos + neighbourB ) ) );
+        const __m128i  off = _mm_shuffle_epi8( table, _mm_add_epi16( _mm_mullo_epi16( cls, idxMul ), idxAdd ) );
+        const __m128i  res = _mm_min_epi16( _mm_max_epi16( _mm_add_epi16( cur, off ), zero ), maxVal );
+        _mm_storeu_si128( ( __m128i* )( resBlk + pos ), res );
+      }
+    }
+    srcBlk += srcStride;
+    resBlk += resStride;
+  }
+}
+
+/// \note The per-class sums are kept in 16-bit (counts) and 32-bit (differences) lanes, which is sufficient for the
+///       blocks of at most MAX_CU_SIZE x MAX_CU_SIZE samples of a CTU.
+template<X86_VEXT vext>
+static Void simdEdgeStats( const Pel* srcBlk, Int srcStride, const Pel* orgBlk, Int orgStride, Int neighbourA, Int neighbourB, Int width, Int height, Int64* diff, Int64* count )
+{
+  const Int numClasses = 5;
+  const __m128i one    = _mm_set1_epi16( 1 );
+  __m128i diffSum [numClasses];
+  __m128i countSum[numClasses];
+  for( Int c = 0; c < numClasses; c++ )
+  {
+    diffSum [c] = _mm_setzero_si128();
+    countSum[c] = _mm_setzero_si128();
+  }
+
+  const Int widthVec = width & ~7;
+  for( Int y = 0; y < height; y++ )
+  {
+    for( Int x = 0; x < widthVec; x += 8 )
+    {
+      const __m128i cur = _mm_loadu_si128( ( const __m128i* )( srcBlk + x ) );
+      const __m128i cls = edgeClassX86( cur, _mm_loadu_si128( ( const __m128i* )( srcBlk + x + neighbourA ) ),
+                                             _mm_loadu_si128( ( const __m128i* )( srcBlk + x + neighbourB ) ) );
+      const __m128i dif = _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* )( orgBlk + x ) ), cur );
+
+      for( Int c = 0; c < numClasses; c++ )
+      {
+        const __m128i mask = _mm_cmpeq_epi16( cls, _mm_set1_epi16( c - 2 ) );
+        countSum[c] = _mm_sub_epi16( countSum[c], mask );
+        diffSum [c] = _mm_add_epi32( diffSum[c], _mm_madd_epi16( _mm_and_si128( mask, dif ), one ) );
+      }
+    }
+    for( Int x = widthVec; x < width; x++ )
+    {
+      const Int c = edgeClass( srcBlk + x, neighbourA, neighbourB );
+      diff [c] += ( orgBlk[x] - srcBlk[x] );
+      count[c] ++;
+    }
+    srcBlk += srcStride;
+    orgBlk += orgStride;
+  }
+
+  if( widthVec > 0 )
+  {
+    for( Int c = 0; c < numClasses; c++ )
+    {
+      __m128i d = _mm_add_epi32( diffSum[c], _mm_shuffle_epi32( diffSum[c], 0x4e ) );
+      d = _mm_add_epi32( d, _mm_shuffle_epi32( d, 0xb1 ) );
+      __m128i n = _mm_madd_epi16( countSum[c], one );
+      n = _mm_add_epi32( n, _mm_shuffle_epi32( n, 0x4e ) );
+      n = _mm_add_epi32( n, _mm_shuffle_epi32( n, 0xb1 ) );
+      diff [c] += _mm_cvtsi128_si32( d );
+      count[c] += _mm_cvtsi128_si32( n );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+Void TComSampleAdaptiveOffset::_initSampleAdaptiveOffsetX86()
+{
+  m_edgeOffset = simdEdgeOffset<vext>;
+  m_edgeStats  = simdEdgeStats<vext>;
+}
+
+template Void TComSampleAdaptiveOffset::_initSampleAdaptiveOffsetX86<SIMDX86>();
+
+//! \}
+
+#endif // ENABLE_SIMD_OPT_SAO
@@ -0,0 +1,502 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TrQuantX86.h
+    \brief    SIMD partial butterfly transforms and fused inverse transform + reconstruction of TComTrQuant
+    \details  This file is included by the per-extension sources in x86/<ext>/, each of them compiled
+              with the corresponding compiler flags. The kernels process four (SSE4.1), eight (AVX2) or
+              sixteen (AVX-512) transform lines in parallel with 32-bit arithmetic; since the butterflies
+              only use additions, subtractions and multiplications before the rounding shift, the results
+              are exactly those of the C functions in TComTrQuant.cpp.
+*/
+
+#include "CommonDefX86.h"
+#include "../TComTrQuant.h"
+#include "../TComRom.h"
+
+#if ENABLE_SIMD_OPT_TRANSFORM
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Vectors of L transform lines, made of 128-bit lanes of four consecutive lines
+// ====================================================================================================================
+
+template<Int L> struct TrVecX86;
+
+template<> struct TrVecX86<4>
+{
+  typedef __m128i T;
+
+  static inline T    set1 ( Int v )                     { return _mm_set1_epi32( v ); }
+  static inline T    add  ( T a, T b )                  { return _mm_add_epi32( a, b ); }
+  static inline T    sub  ( T a, T b )                  { return _mm_sub_epi32( a, b ); }
+  static inline T    mul  ( T a, T b )                  { return _mm_mullo_epi32( a, b ); }
+  static inline T    sra  ( T a, __m128i shift )        { return _mm_sra_epi32( a, shift ); }
+  static inline T    min  ( T a, T b )                  { return _mm_min_epi32( a, b ); }
+  static inline T    max  ( T a, T b )                  { return _mm_max_epi32( a, b ); }
+  static inline T    lo32 ( T a, T b )                  { return _mm_unpacklo_epi32( a, b ); }
+  static inline T    hi32 ( T a, T b )                  { return _mm_unpackhi_epi32( a, b ); }
+  static inline T    lo64 ( T a, T b )                  { return _mm_unpacklo_epi64( a, b ); }
+  static inline T    hi64 ( T a, T b )                  { return _mm_unpackhi_epi64( a, b ); }
+  static inline T    load ( const TCoeff *p )           { return _mm_loadu_si128( ( const __m128i* )p ); }
+  static inline Void store( TCoeff *p, T v )            { _mm_storeu_si128( ( __m128i* )p, v ); }
+  static inline T    fromLanes( const __m128i *lanes )  { return lanes[0]; }
+  static inline Void toLanes  ( T v, __m128i *lanes )   { lanes[0] = v; }
+};
+
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+template<> struct TrVecX86<8>
+{
+  typedef __m256i T;
+
+  static inline T    set1 ( Int v )                     { return _mm256_set1_epi32( v ); }
+  static inline T    add  ( T a, T b )                  { return _mm256_add_epi32( a, b ); }
+  static inline T    sub  ( T a, T b )                  { return _mm256_sub_epi32( a, b ); }
+  static inline T    mul  ( T a, T b )                  { return _mm256_mullo_epi32( a, b ); }
+  static inline T    sra  ( T a, __m128i shift )        { return _mm256_sra_epi32( a, shift ); }
+  static inline T    min  ( T a, T b )                  { return _mm256_min_epi32( a, b ); }
+  static inline T    max  ( T a, T b )                  { return _mm256_max_epi32( a, b ); }
+  static inline T    lo32 ( T a, T b )                  { return _mm256_unpacklo_epi32( a, b ); }
+  static inline T    hi32 ( T a, T b )                  { return _mm256_unpackhi_epi32( a, b ); }
+  static inline T    lo64 ( T a, T b )                  { return _mm256_unpacklo_epi64( a, b ); }
+  static inline T    hi64 ( T a, T b )                  { return _mm256_unpackhi_epi64( a, b ); }
+  static inline T    load ( const TCoeff *p )           { return _mm256_loadu_si256( ( const __m256i* )p ); }
+  static inline Void store( TCoeff *p, T v )            { _mm256_storeu_si256( ( __m256i* )p, v ); }
+  static inline T    fromLanes( const __m128i *lanes )  { return _mm256_set_m128i( lanes[1], lanes[0] ); }
+  static inline Void toLanes  ( T v, __m128i *lanes )
+  {
+    lanes[0] = _mm256_castsi256_si128( v );
+    lanes[1] = _mm256_extracti128_si256( v, 1 );
+  }
+};
+#endif
+
+#ifdef USE_AVX512
+template<> struct TrVecX86<16>
+{
+  typedef __m512i T;
+
+  // (masked forms: the unmasked ones trigger -Wmaybe-uninitialized in some GCC versions)
+  static inline T    set1 ( Int v )                     { return _mm512_set1_epi32( v ); }
+  static inline T    add  ( T a, T b )                  { return _mm512_add_epi32( a, b ); }
+  static inline T    sub  ( T a, T b )                  { return _mm512_sub_epi32( a, b ); }
+  static inline T    mul  ( T a, T b )                  { return _mm512_mullo_epi32( a, b ); }
+  static inline T    sra  ( T a, __m128i shift )        { return _mm512_maskz_sra_epi32( 0xffff, a, shift ); }
+  static inline T    min  ( T a, T b )                  { return _mm512_maskz_min_epi32( 0xffff, a, b ); }
+  static inline T    max  ( T a, T b )                  { return _mm512_maskz_max_epi32( 0xffff, a, b ); }
+  static inline T    lo32 ( T a, T b )                  { return _mm512_maskz_unpacklo_epi32( 0xffff, a, b ); }
+  static inline T    hi32 ( T a, T b )                  { return _mm512_maskz_unpackhi_epi32( 0xffff, a, b ); }
+  static inline T    lo64 ( T a, T b )                  { return _mm512_maskz_unpacklo_epi64( 0xff, a, b ); }
+  static inline T    hi64 ( T a, T b )                  { return _mm512_maskz_unpackhi_epi64( 0xff, a, b ); }
+  static inline T    load ( const TCoeff *p )           { return _mm512_loadu_si512( ( const __m512i* )p ); }
+  static inline Void store( TCoeff *p, T v )            { _mm512_storeu_si512( ( __m512i* )p, v ); }
+  static inline T    fromLanes( const __m128i *lanes )
+  {
+    const __m512i lo = _mm512_maskz_broadcast_i64x4( 0x0f, _mm256_set_m128i( lanes[1], lanes[0] ) );
+    return _mm512_mask_broadcast_i64x4( lo, 0xf0, _mm256_set_m128i( lanes[3], lanes[2] ) );
+  }
+  static inline Void toLanes  ( T v, __m128i *lanes )
+  {
+    lanes[0] = _mm512_maskz_extracti32x4_epi32( 0xf, v, 0 );
+    lanes[1] = _mm512_maskz_extracti32x4_epi32( 0xf, v, 1 );
+    lanes[2] = _mm512_maskz_extracti32x4_epi32( 0xf, v, 2 );
+    lanes[3] = _mm512_maskz_extracti32x4_epi32( 0xf, v, 3 );
+  }
+};
+#endif
+
+/// 4x4 transposition inside each 128-bit lane
+template<typename V>
+static inline Void simdTranspose4( const typename V::T *in, typename V::T *out )
+{
+  const typename V::T t0 = V::lo32( in[0], in[1] );
+  const typename V::T t1 = V::lo32( in[2], in[3] );
+  const typename V::T t2 = V::hi32( in[0], in[1] );
+  const typename V::T t3 = V::hi32( in[2], in[3] );
+
+  out[0] = V::lo64( t0, t1 );
+  out[1] = V::hi64( t0, t1 );
+  out[2] = V::lo64( t2, t3 );
+  out[3] = V::hi64( t2, t3 );
+}
+
+/// reads the four values p[l * stride + (0..3)] of each of the lines l of a vector, as four vectors (one per value)
+template<Int L>
+static inline Void simdLoadTransposed( const TCoeff *p, const Int stride, typename TrVecX86<L>::T *out )
+{
+  typedef TrVecX86<L> V;
+
+  typename V::T rows[4];
+  for( Int r = 0; r < 4; r++ )
+  {
+    __m128i lanes[L / 4];
+    for( Int q = 0; q < L / 4; q++ )
+    {
+      lanes[q] = _mm_loadu_si128( ( const __m128i* )( p + ( 4 * q + r ) * stride ) );
+    }
+    rows[r] = V::fromLanes( lanes );
+  }
+  simdTranspose4<V>( rows, out );
+}
+
+/// transposes four vectors (one per value) and returns the four values of each line l as lanes[l]
+template<Int L>
+static inline Void simdToLines( const typename TrVecX86<L>::T *in, __m128i *lines )
+{
+  typedef TrVecX86<L> V;
+
+  typename V::T rows[4];
+  simdTranspose4<V>( in, rows );
+  for( Int r = 0; r < 4; r++ )
+  {
+    __m128i lanes[L / 4];
+    V::toLanes( rows[r], lanes );
+    for( Int q = 0; q < L / 4; q++ )
+    {
+      lines[4 * q + r] = lanes[q];
+    }
+  }
+}
+
+static inline const TMatrixCoeff *simdTransformMatrix( const Int N, const Bool isDST, const Int direction )
+{
+  return isDST ? g_as_DST_MAT_4[direction][0] : N == 4 ? g_aiT4[direction][0] : N == 8 ? g_aiT8[direction][0] : N == 16 ? g_aiT16[direction][0] : g_aiT32[direction][0];
+}
+
+// ====================================================================================================================
+// 1D transforms of L lines (same even/odd decomposition as the C functions)
+// ====================================================================================================================
+
+/// forward transform: y[r] = sum_k T[r][k] * x[k]; x is overwritten
+template<typename V, Int N, Bool isDST>
+static inline Void simdForwardCore( typename V::T *x, typename V::T *y, const TMatrixCoeff *mat )
+{
+  if( isDST )
+  {
+    for( Int r = 0; r < 4; r++ )
+    {
+      typename V::T acc = V::mul( x[0], V::set1( mat[r * 4] ) );
+      for( Int c = 1; c < 4; c++ )
+      {
+        acc = V::add( acc, V::mul( x[c], V::set1( mat[r * 4 + c] ) ) );
+      }
+      y[r] = acc;
+    }
+    return;
+  }
+
+  // at each level, the odd rows of the remaining size M are computed from the differences O
+  // and the even part E (stored back in x[0 .. M/2-1]) is passed to the next level
+  for( Int M = N; M >= 4; M >>= 1 )
+  {
+    const Int step = N / M;
+    typename V::T o[N / 2];
+    for( Int k = 0; k < M / 2; k++ )
+    {
+      o[k] = V::sub( x[k], x[M - 1 - k] );
+      x[k] = V::add( x[k], x[M - 1 - k] );
+    }
+    for( Int i = 0; i < M / 2; i++ )
+    {
+      const Int r = step * ( 2 * i + 1 );
+      typename V::T acc = V::mul( o[0], V::set1( mat[r * N] ) );
+      for( Int k = 1; k < M / 2; k++ )
+      {
+        acc = V::add( acc, V::mul( o[k], V::set1( mat[r * N + k] ) ) );
+      }
+      y[r] = acc;
+    }
+  }
+  y[0]     = V::add( V::mul( x[0], V::set1( mat[0] ) ),               V::mul( x[1], V::set1( mat[1] ) ) );
+  y[N / 2] = V::add( V::mul( x[0], V::set1( mat[( N / 2 ) * N] ) ), V::mul( x[1], V::set1( mat[( N / 2 ) * N + 1] ) ) );
+}
+
+/// inverse transform: x[k] = sum_r T[r][k] * c[r]
+template<typename V, Int N, Bool isDST>
+static inline Void simdInverseCore( const typename V::T *c, typename V::T *x, const TMatrixCoeff *mat )
+{
+  if( isDST )
+  {
+    for( Int k = 0; k < 4; k++ )
+    {
+      typename V::T acc = V::mul( c[0], V::set1( mat[k] ) );
+      for( Int r = 1; r < 4; r++ )
+      {
+        acc = V::add( acc, V::mul( c[r], V::set1( mat[r * 4 + k] ) ) );
+      }
+      x[k] = acc;
+    }
+    return;
+  }
+
+  // even part of size 2 from the rows 0 and N/2, then at each level M the odd part O from the
+  // rows N/M * (2i+1) is combined with the even part of size M/2: x[k] = E[k] + O[k], x[M-1-k] = E[k] - O[k]
+  x[0] = V::add( V::mul( c[0], V::set1( mat[0] ) ), V::mul( c[N / 2], V::set1( mat[( N / 2 ) * N] ) ) );
+  x[1] = V::add( V::mul( c[0], V::set1( mat[1] ) ), V::mul( c[N / 2], V::set1( mat[( N / 2 ) * N + 1] ) ) );
+  for( Int M = 4; M <= N; M <<= 1 )
+  {
+    const Int step = N / M;
+    for( Int k = 0; k < M / 2; k++ )
+    {
+      typename V::T o = V::mul( c[step], V::set1( mat[step * N + k] ) );
+      for( Int i = 1; i < M / 2; i++ )
+      {
+        const Int r = step * ( 2 * i + 1 );
+        o = V::add( o, V::mul( c[r], V::set1( mat[r * N + k] ) ) );
+      }
+      const typename V::T e = x[k];
+      x[M - 1 - k] = V::sub( e, o );
+      x[k]         = V::add( e, o );
+    }
+  }
+}
+
+template<Int L, Int N, Bool isDST>
+static inline Void simdForwardLines( const TCoeff *src, TCoeff *dst, const Int shift, const Int line )
+{
+  typedef TrVecX86<L> V;
+
+  const TMatrixCoeff  *mat    = simdTransformMatrix( N, isDST, TRANSFORM_FORWARD );
+  const typename V::T  add    = V::set1( ( shift > 0 ) ? ( 1 << ( shift - 1 ) ) : 0 );
+  const __m128i        vshift = _mm_cvtsi32_si128( shift );
+
+  for( Int j = 0; j < line; j += L )
+  {
+    typename V::T x[N], y[N];
+    for( Int n = 0; n < N; n += 4 )
+    {
+      simdLoadTransposed<L>( src + j * N + n, N, x + n );
+    }
+
+    simdForwardCore<V, N, isDST>( x, y, mat );
+
+    for( Int r = 0; r < N; r++ )
+    {
+      V::store( dst + r * line + j, V::sra( V::add( y[r], add ), vshift ) );
+    }
+  }
+}
+
+template<Int L, Int N, Bool isDST>
+static inline Void simdInverseLines( const TCoeff *src, TCoeff *dst, const Int shift, const Int line, const TCoeff outputMinimum, const TCoeff outputMaximum )
+{
+  typedef TrVecX86<L> V;
+
+  const TMatrixCoeff  *mat    = simdTransformMatrix( N, isDST, TRANSFORM_INVERSE );
+  const typename V::T  add    = V::set1( ( shift > 0 ) ? ( 1 << ( shift - 1 ) ) : 0 );
+  const typename V::T  vmin   = V::set1( outputMinimum );
+  const typename V::T  vmax   = V::set1( outputMaximum );
+  const __m128i        vshift = _mm_cvtsi32_si128( shift );
+
+  for( Int j = 0; j < line; j += L )
+  {
+    typename V::T c[N], x[N];
+    for( Int k = 0; k < N; k++ )
+    {
+      c[k] = V::load( src + k * line + j );
+    }
+
+    simdInverseCore<V, N, isDST>( c, x, mat );
+
+    for( Int n = 0; n < N; n++ )
+    {
+      x[n] = V::min( V::max( V::sra( V::add( x[n], add ), vshift ), vmin ), vmax );
+    }
+    for( Int n = 0; n < N; n += 4 )
+    {
+      __m128i lines[L];
+      simdToLines<L>( x + n, lines );
+      for( Int l = 0; l < L; l++ )
+      {
+        _mm_storeu_si128( ( __m128i* )( dst + ( j + l ) * N + n ), lines[l] );
+      }
+    }
+  }
+}
+
+/// reconstruction of four or eight samples from the 16-bit residual (the saturating add is exact, as the result is clipped anyway)
+static inline __m128i simdReconstruct( const __m128i resi, const __m128i pred, const __m128i maxVal )
+{
+  return _mm_min_epi16( _mm_max_epi16( _mm_adds_epi16( pred, resi ), _mm_setzero_si128() ), maxVal );
+}
+
+template<Int L, Int N, Bool isDST>
+static inline Void simdInverseRecLines( const TCoeff *src, const Int shift, const Int line, Pel *pResidual, const UInt uiStride, const Pel *pPred, const UInt uiPredStride, Pel *pReco, const UInt uiRecoStride, const Int bitDepth )
+{
+  typedef TrVecX86<L> V;
+
+  const TMatrixCoeff  *mat    = simdTransformMatrix( N, isDST, TRANSFORM_INVERSE );
+  const typename V::T  add    = V::set1( ( shift > 0 ) ? ( 1 << ( shift - 1 ) ) : 0 );
+  const __m128i        vshift = _mm_cvtsi32_si128( shift );
+  const __m128i        maxVal = _mm_set1_epi16( ( 1 << bitDepth ) - 1 );
+
+  for( Int j = 0; j < line; j += L )
+  {
+    typename V::T c[N], x[N];
+    for( Int k = 0; k < N; k++ )
+    {
+      c[k] = V::load( src + k * line + j );
+    }
+
+    simdInverseCore<V, N, isDST>( c, x, mat );
+
+    // the clipping to the Pel range of the C code is done by the saturating packs
+    for( Int n = 0; n < N; n++ )
+    {
+      x[n] = V::sra( V::add( x[n], add ), vshift );
+    }
+
+    if( N == 4 )
+    {
+      __m128i lines[L];
+      simdToLines<L>( x, lines );
+      for( Int l = 0; l < L; l++ )
+      {
+        const __m128i resi = _mm_packs_epi32( lines[l], lines[l] );
+        const __m128i pred = _mm_loadl_epi64( ( const __m128i* )( pPred + ( j + l ) * uiPredStride ) );
+        _mm_storel_epi64( ( __m128i* )( pResidual + ( j + l ) * uiStride ),     resi );
+        _mm_storel_epi64( ( __m128i* )( pReco     + ( j + l ) * uiRecoStride ), simdReconstruct( resi, pred, maxVal ) );
+      }
+    }
+    else
+    {
+      for( Int n = 0; n < N; n += 8 )
+      {
+        __m128i linesLo[L], linesHi[L];
+        simdToLines<L>( x + n,     linesLo );
+        simdToLines<L>( x + n + 4, linesHi );
+        for( Int l = 0; l < L; l++ )
+        {
+          const __m128i resi = _mm_packs_epi32( linesLo[l], linesHi[l] );
+          const __m128i pred = _mm_loadu_si128( ( const __m128i* )( pPred + ( j + l ) * uiPredStride + n ) );
+          _mm_storeu_si128( ( __m128i* )( pResidual + ( j + l ) * uiStride + n ),     resi );
+          _mm_storeu_si128( ( __m128i* )( pReco     + ( j + l ) * uiRecoStride + n ), simdReconstruct( resi, pred, maxVal ) );
+        }
+      }
+    }
+  }
+}
+
+// ====================================================================================================================
+// Kernels with the TComTrQuant function pointer signatures: the widest vectors dividing the number of lines are used
+// ====================================================================================================================
+
+template<X86_VEXT vext, Int N, Bool isDST>
+static Void simdForwardTransform( TCoeff *src, TCoeff *dst, Int shift, Int line )
+{
+#ifdef USE_AVX512
+  if( vext >= AVX512 && ( line & 15 ) == 0 )
+  {
+    simdForwardLines<16, N, isDST>( src, dst, shift, line );
+    return;
+  }
+#endif
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+  if( vext >= AVX2 && ( line & 7 ) == 0 )
+  {
+    simdForwardLines<8, N, isDST>( src, dst, shift, line );
+    return;
+  }
+#endif
+  simdForwardLines<4, N, isDST>( src, dst, shift, line );
+}
+
+template<X86_VEXT vext, Int N, Bool isDST>
+static Void simdInverseTransform( TCoeff *src, TCoeff *dst, Int shift, Int line, const TCoeff outputMinimum, const TCoeff outputMaximum )
+{
+#ifdef USE_AVX512
+  if( vext >= AVX512 && ( line & 15 ) == 0 )
+  {
+    simdInverseLines<16, N, isDST>( src, dst, shift, line, outputMinimum, outputMaximum );
+    return;
+  }
+#endif
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+  if( vext >= AVX2 && ( line & 7 ) == 0 )
+  {
+    simdInverseLines<8, N, isDST>( src, dst, shift, line, outputMinimum, outputMaximum );
+    return;
+  }
+#endif
+  simdInverseLines<4, N, isDST>( src, dst, shift, line, outputMinimum, outputMaximum );
+}
+
+template<X86_VEXT vext, Int N, Bool isDST>
+static Void simdInverseTransformRec( TCoeff *src, Int shift, Int line, Pel *pResidual, UInt uiStride, const Pel *pPred, UInt uiPredStride, Pel *pReco, UInt uiRecoStride, const Int bitDepth )
+{
+#ifdef USE_AVX512
+  if( vext >= AVX512 && ( line & 15 ) == 0 )
+  {
+    simdInverseRecLines<16, N, isDST>( src, shift, line, pResidual, uiStride, pPred, uiPredStride, pReco, uiRecoStride, bitDepth );
+    return;
+  }
+#endif
+#if defined( USE_AVX2 ) || defined( USE_AVX512 )
+  if( vext >= AVX2 && ( line & 7 ) == 0 )
+  {
+    simdInverseRecLines<8, N, isDST>( src, shift, line, pResidual, uiStride, pPred, uiPredStride, pReco, uiRecoStride, bitDepth );
+    return;
+  }
+#endif
+  simdInverseRecLines<4, N, isDST>( src, shift, line, pResidual, uiStride, pPred, uiPredStride, pReco, uiRecoStride, bitDepth );
+}
+
+template<X86_VEXT vext>
+Void TComTrQuant::_initTrQuantX86()
+{
+  m_forwardTransform   [0] = simdForwardTransform   <vext,  4, true >;
+  m_forwardTransform   [1] = simdForwardTransform   <vext,  4, false>;
+  m_forwardTransform   [2] = simdForwardTransform   <vext,  8, false>;
+  m_forwardTransform   [3] = simdForwardTransform   <vext, 16, false>;
+  m_forwardTransform   [4] = simdForwardTransform   <vext, 32, false>;
+
+  m_inverseTransform   [0] = simdInverseTransform   <vext,  4, true >;
+  m_inverseTransform   [1] = simdInverseTransform   <vext,  4, false>;
+  m_inverseTransform   [2] = simdInverseTransform   <vext,  8, false>;
+  m_inverseTransform   [3] = simdInverseTransform   <vext, 16, false>;
+  m_inverseTransform   [4] = simdInverseTransform   <vext, 32, false>;
+
+  m_inverseTransformRec[0] = simdInverseTransformRec<vext,  4, true >;
+  m_inverseTransformRec[1] = simdInverseTransformRec<vext,  4, false>;
+  m_inverseTransformRec[2] = simdInverseTransformRec<vext,  8, false>;
+  m_inverseTransformRec[3] = simdInverseTransformRec<vext, 16, false>;
+  m_inverseTransformRec[4] = simdInverseTransformRec<vext, 32, false>;
+}
+
+template Void TComTrQuant::_initTrQuantX86<SIMDX86>();
+
+//! \}
+
+#endif // ENABLE_SIMD_OPT_TRANSFORM
@@ -39,6 +39,7 @@
 
 #include <stdint.h>
 #include <cassert>
+#include <cstring>
 #include <vector>
 #include "AnnexBread.h"
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
@@ -50,6 +51,111 @@ using namespace std;
 //! \ingroup TLibDecoder
 //! \{
 
+Void InputByteStream::setPosition(streampos pos)
+{
+  m_Input.clear();
+  if (m_End > 0 && pos >= m_BufferStart && pos <= m_BufferStart + streamoff(m_End))
+  {
+    m_Pos = size_t(pos - m_BufferStart);
+  }
+  else
+  {
+    m_Input.rdbuf()->pubseekpos(pos, ios_base::in);
+    reset();
+  }
+}
+
+/**
+ * Make at least n bytes available from m_Pos, keeping the bytes from m_Pos on
+ * at the start of m_Buffer.  Returns false if the stream ends before.
+ */
+Bool InputByteStream::xFill(size_t n)
+{
+  if (m_End == 0)
+  {
+    m_Pos = 0;
+    m_BufferStart = m_Input.rdbuf()->pubseekoff(0, ios_base::cur, ios_base::in);
+  }
+  else if (m_Pos > 0)
+  {
+    memmove(&m_Buffer[0], &m_Buffer[0] + m_Pos, m_End - m_Pos);
+    m_BufferStart += streamoff(m_Pos);
+    m_End -= m_Pos;
+    m_Pos  = 0;
+  }
+
+  if (m_Buffer.size() < std::max(n, m_End + BLOCK_SIZE))
+  {
+    m_Buffer.resize(std::max(n, m_End + BLOCK_SIZE));
+  }
+  while (m_End < n)
+  {
+    const streamsize numRead = m_Input.rdbuf()->sgetn(reinterpret_cast<char*>(&m_Buffer[0] + m_End), streamsize(m_Buffer.size() - m_End));
+    if (numRead <= 0)
+    {
+      return false;
+    }
+    m_End += size_t(numRead);
+  }
+  return true;
+}
+
+/**
+ * Mark the end of the stream in the state of the istream, which throws
+ * std::ios_base::failure as a read beyond the end of the istream would.
+ */
+Void InputByteStream::xSetEof()
+{
+  m_Input.setstate(istream::eofbit | istream::failbit);
+}
+
+Void InputByteStream::readToStartCode(const uint8_t*& data, size_t& size)
+{
+  size_t scanned = 0; // number of bytes from m_Pos at which no sequence can start
+  for (;;)
+  {
+    const uint8_t* const start = &m_Buffer[0] + m_Pos;
+    const uint8_t* const end   = &m_Buffer[0] + m_End;
+    const uint8_t*       p     = start + scanned;
+
+    /* every sequence begins with two zero bytes: jump between zero bytes
+     * with memchr, which is vectorised in C libraries */
+    while (end - p >= 3)
+    {
+      const uint8_t* zero = static_cast<const uint8_t*>(memchr(p, 0, end - p - 2));
+      if (!zero)
+      {
+        p = end - 2;
+        break;
+      }
+      if (zero[1] != 0)
+      {
+        p = zero + 2;
+      }
+      else if (zero[2] > 2)
+      {
+        p = zero + 3;
+      }
+      else
+      {
+        data   = start;
+        size   = zero - start;
+        m_Pos += size;
+        return;
+      }
+    }
+    scanned = p - start;
+
+    if (!xFill(m_End - m_Pos + 1))
+    {
+      data  = &m_Buffer[0] + m_Pos;
+      size  = m_End - m_Pos;
+      m_Pos = m_End;
+      return;
+    }
+  }
+}
+
 /**
  * Parse an AVC AnnexB Bytestream bs to extract a single nalUnit
  * while accumulating bytestream statistics into stats.
@@ -130,19 +236,14 @@ _byteStreamNALUnit(
    * bytes. This sequence of bytes is nal_unit( NumBytesInNALunit ) and is
    * decoded using the NAL unit decoding process
    */
-  /* NB, (unsigned)x > 2 implies n!=0 && n!=1 */
+  const uint8_t* body;
+  size_t bodySize;
+  bs.readToStartCode(body, bodySize);
+  nalUnit.insert(nalUnit.end(), body, body + bodySize);
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   TComCodingStatistics::SStat &bodyStats=TComCodingStatistics::GetStatisticEP(STATS__NAL_UNIT_TOTAL_BODY);
+  bodyStats.bits+=8*Int64(bodySize); bodyStats.count+=Int64(bodySize);
 #endif
-  while (bs.eofBeforeNBytes(24/8) || bs.peekBytes(24/8) > 2)
-  {
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-    uint8_t thebyte=bs.readByte();bodyStats.bits+=8;bodyStats.count++;
-    nalUnit.push_back(thebyte);
-#else
-    nalUnit.push_back(bs.readByte());
-#endif
-  }
 
   /* 5. When the current position in the byte stream is:
    *  - not at the end of the byte stream (as determined by unspecified means)
@@ -42,6 +42,7 @@
 #define __ANNEXBREAD__
 
 #include <stdint.h>
+#include <cassert>
 #include <istream>
 #include <vector>
 
@@ -58,14 +59,21 @@ public:
    * istream.
    *
    * NB, it isn't safe to access istream while in use by a
-   * InputByteStream.
+   * InputByteStream.  Bytes are taken from the stream buffer of
+   * istream in large blocks, so the position of istream is ahead of
+   * the reader: use getPosition() and setPosition() instead of
+   * tellg() and seekg().
    *
-   * Side-effects: the exception mask of istream is set to eofbit
+   * Side-effects: the exception mask of istream is set to eofbit, and
+   * eofbit and failbit of istream are set once the reader has reached
+   * the end of the stream.
    */
   InputByteStream(std::istream& istream)
-  : m_NumFutureBytes(0)
-  , m_FutureBytes(0)
-  , m_Input(istream)
+  : m_Input(istream)
+  , m_Buffer(BLOCK_SIZE)
+  , m_Pos(0)
+  , m_End(0)
+  , m_BufferStart(0)
   {
     istream.exceptions(std::istream::eofbit | std::istream::badbit);
   }
@@ -76,10 +84,24 @@ public:
    */
   Void reset()
   {
-    m_NumFutureBytes = 0;
-    m_FutureBytes = 0;
+    m_Pos = 0;
+    m_End = 0;
   }
 
+  /**
+   * return the position in the stream of the next byte to be read
+   */
+  std::streampos getPosition() const
+  {
+    return m_BufferStart + std::streamoff(m_Pos);
+  }
+
+  /**
+   * continue reading at position pos of the stream, clearing a
+   * previous end of stream
+   */
+  Void setPosition(std::streampos pos);
+
   /**
    * returns true if an EOF will be encountered within the next
    * n bytes.
@@ -87,25 +109,22 @@ public:
   Bool eofBeforeNBytes(UInt n)
   {
     assert(n <= 4);
-    if (m_NumFutureBytes >= n)
+    if (m_End - m_Pos >= n)
+    {
+      return false;
+    }
+    if (xFill(n))
     {
       return false;
     }
-
-    n -= m_NumFutureBytes;
     try
     {
-      for (UInt i = 0; i < n; i++)
-      {
-        m_FutureBytes = (m_FutureBytes << 8) | m_Input.get();
-        m_NumFutureBytes++;
-      }
+      xSetEof();
     }
     catch (...)
     {
-      return true;
     }
-    return false;
+    return true;
   }
 
   /**
@@ -123,7 +142,12 @@ public:
   uint32_t peekBytes(UInt n)
   {
     eofBeforeNBytes(n);
-    return m_FutureBytes >> 8*(m_NumFutureBytes - n);
+    uint32_t val = 0;
+    for (UInt i = 0; i < n; i++)
+    {
+      val = (val << 8) | (m_Pos + i < m_End ? m_Buffer[m_Pos + i] : 0);
+    }
+    return val;
   }
 
   /**
@@ -134,15 +158,11 @@ public:
    */
   uint8_t readByte()
   {
-    if (!m_NumFutureBytes)
+    if (m_Pos == m_End && !xFill(1))
     {
-      uint8_t byte = m_Input.get();
-      return byte;
+      xSetEof();
     }
-    m_NumFutureBytes--;
-    uint8_t wanted_byte = m_FutureBytes >> 8*m_NumFutureBytes;
-    m_FutureBytes &= ~(0xff << 8*m_NumFutureBytes);
-    return wanted_byte;
+    return m_Buffer[m_Pos++];
   }
 
   /**
@@ -160,14 +180,25 @@ public:
     return val;
   }
 
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-  UInt GetNumBufferedBytes() const { return m_NumFutureBytes; }
-#endif
+  /**
+   * consume the bytes up to the next byte-aligned three-byte sequence
+   * 0x000000, 0x000001 or 0x000002, or up to the end of the stream.
+   * The bytes are returned in place as [data, data+size), which stays
+   * valid until the next call to the InputByteStream.
+   */
+  Void readToStartCode(const uint8_t*& data, size_t& size);
 
 private:
-  UInt m_NumFutureBytes; /* number of valid bytes in m_FutureBytes */
-  uint32_t m_FutureBytes; /* bytes that have been peeked */
+  static const size_t BLOCK_SIZE = 1 << 20; ///< minimum number of bytes taken from the stream buffer at once
+
+  Bool xFill(size_t n);
+  Void xSetEof();
+
   std::istream& m_Input; /* Input stream to read from */
+  std::vector<uint8_t> m_Buffer; /* bytes read from the stream buffer of m_Input */
+  size_t m_Pos; /* index in m_Buffer of the next byte to be read */
+  size_t m_End; /* number of valid bytes in m_Buffer */
+  std::streampos m_BufferStart; /* position in the stream of m_Buffer[0] */
 };
 
 /**
@@ -40,6 +40,7 @@
 #include <vector>
 #include <algorithm>
 #include <ostream>
+#include <cstring>
 
 #include "NALread.h"
 #include "TLibCommon/NAL.h"
@@ -58,30 +59,49 @@ using namespace std;
 static Void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf, TComInputBitstream *bitstream, Bool isVclNalUnit)
 {
   UInt zeroCount = 0;
-  vector<uint8_t>::iterator it_read, it_write;
+  uint8_t* const buf = nalUnitBuf.empty() ? NULL : &nalUnitBuf[0];
+  const size_t   end = nalUnitBuf.size();
+  size_t pos   = 0; // read position, the location of emulation prevention bytes in the payload
+  size_t write = 0;
 
-  UInt pos = 0;
   bitstream->clearEmulationPreventionByteLocation();
-  for (it_read = it_write = nalUnitBuf.begin(); it_read != nalUnitBuf.end(); it_read++, it_write++, pos++)
+  while (pos < end)
   {
-    assert(zeroCount < 2 || *it_read >= 0x03);
-    if (zeroCount == 2 && *it_read == 0x03)
+    if (zeroCount == 0)
     {
-      bitstream->pushEmulationPreventionByteLocation( pos );
+      /* an emulation prevention byte can only follow two zero bytes: move
+       * the bytes up to the next zero byte in bulk */
+      const uint8_t* zero = static_cast<const uint8_t*>(memchr(buf + pos, 0, end - pos));
+      const size_t   num  = zero ? size_t(zero - (buf + pos)) : end - pos;
+      if (write != pos)
+      {
+        memmove(buf + write, buf + pos, num);
+      }
+      pos   += num;
+      write += num;
+      if (!zero)
+      {
+        break;
+      }
+    }
+
+    assert(zeroCount < 2 || buf[pos] >= 0x03);
+    if (zeroCount == 2 && buf[pos] == 0x03)
+    {
+      bitstream->pushEmulationPreventionByteLocation( UInt(pos) );
       pos++;
-      it_read++;
       zeroCount = 0;
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
       TComCodingStatistics::IncrementStatisticEP(STATS__EMULATION_PREVENTION_3_BYTES, 8, 0);
 #endif
-      if (it_read == nalUnitBuf.end())
+      if (pos == end)
       {
         break;
       }
-      assert(*it_read <= 0x03);
+      assert(buf[pos] <= 0x03);
     }
-    zeroCount = (*it_read == 0x00) ? zeroCount+1 : 0;
-    *it_write = *it_read;
+    zeroCount = (buf[pos] == 0x00) ? zeroCount+1 : 0;
+    buf[write++] = buf[pos++];
   }
   assert(zeroCount == 0);
 
@@ -90,9 +110,9 @@ static Void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf, TComInputBitstream
     // Remove cabac_zero_word from payload if present
     Int n = 0;
 
-    while (it_write[-1] == 0x00)
+    while (write > 0 && buf[write-1] == 0x00)
     {
-      it_write--;
+      write--;
       n++;
     }
 
@@ -102,7 +122,7 @@ static Void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf, TComInputBitstream
     }
   }
 
-  nalUnitBuf.resize(it_write - nalUnitBuf.begin());
+  nalUnitBuf.resize(write);
 }
 
 #if ENC_DEC_TRACE && DEC_NUH_TRACE
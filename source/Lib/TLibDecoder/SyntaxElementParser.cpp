@@ -160,33 +160,27 @@ Void SyntaxElementParser::xReadUvlc( UInt& rValue)
 {
   UInt uiVal = 0;
   UInt uiCode = 0;
-  UInt uiLength;
-  m_pcBitstream->read( 1, uiCode );
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-  UInt totalLen=1;
-#endif
+  // the prefix length is the number of leading zero bits, at most 31 in a valid code
+  const UInt uiLength = countLeadingZeros( m_pcBitstream->peek( 32 ) | 1 );
 
-  if( 0 == uiCode )
+  if( uiLength < 16 )
   {
-    uiLength = 0;
-
-    while( ! ( uiCode & 1 ))
-    {
-      m_pcBitstream->read( 1, uiCode );
-      uiLength++;
-    }
-
+    // the whole code word, which is the value plus one
+    m_pcBitstream->read( 2 * uiLength + 1, uiCode );
+    uiVal = uiCode - 1;
+  }
+  else
+  {
+    m_pcBitstream->skip( uiLength );
+    m_pcBitstream->read( 1, uiCode );
+    assert( uiCode == 1 );
     m_pcBitstream->read( uiLength, uiVal );
-
-    uiVal += (1 << uiLength)-1;
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-    totalLen+=uiLength+uiLength;
-#endif
+    uiVal += ( 1u << uiLength ) - 1;
   }
 
   rValue = uiVal;
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
-  TComCodingStatistics::IncrementStatisticEP(pSymbolName, Int(totalLen), rValue);
+  TComCodingStatistics::IncrementStatisticEP(pSymbolName, Int(2 * uiLength + 1), rValue);
 #endif
 
 #if ENC_DEC_TRACE
@@ -203,34 +197,25 @@ Void SyntaxElementParser::xReadSvlc( Int& rValue)
 #endif
 {
   UInt uiBits = 0;
-  m_pcBitstream->read( 1, uiBits );
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-  UInt totalLen=1;
-#endif
-  if( 0 == uiBits )
-  {
-    UInt uiLength = 0;
-
-    while( ! ( uiBits & 1 ))
-    {
-      m_pcBitstream->read( 1, uiBits );
-      uiLength++;
-    }
-
-    m_pcBitstream->read( uiLength, uiBits );
+  // the prefix length is the number of leading zero bits, at most 31 in a valid code
+  const UInt uiLength = countLeadingZeros( m_pcBitstream->peek( 32 ) | 1 );
 
-    uiBits += (1 << uiLength);
-    rValue = ( uiBits & 1) ? -(Int)(uiBits>>1) : (Int)(uiBits>>1);
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-    totalLen+=uiLength+uiLength;
-#endif
+  if( uiLength < 16 )
+  {
+    // the whole code word, which is the code number plus one
+    m_pcBitstream->read( 2 * uiLength + 1, uiBits );
   }
   else
   {
-    rValue = 0;
+    m_pcBitstream->skip( uiLength );
+    m_pcBitstream->read( 1, uiBits );
+    assert( uiBits == 1 );
+    m_pcBitstream->read( uiLength, uiBits );
+    uiBits += ( 1u << uiLength );
   }
+  rValue = ( uiBits & 1) ? -(Int)(uiBits>>1) : (Int)(uiBits>>1);
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
-  TComCodingStatistics::IncrementStatisticEP(pSymbolName, Int(totalLen), rValue);
+  TComCodingStatistics::IncrementStatisticEP(pSymbolName, Int(2 * uiLength + 1), rValue);
 #endif
 
 #if ENC_DEC_TRACE
@@ -44,6 +44,9 @@
 //! \ingroup TLibDecoder
 //! \{
 
+//! position of the lsb of the offset in m_uiValue
+static const Int CABAC_VALUE_SHIFT = 64 - 1 - 9;
+
 TDecBinCABAC::TDecBinCABAC()
 : m_pcTComBitstream( 0 )
 {
@@ -72,10 +75,10 @@ TDecBinCABAC::start()
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   TComCodingStatistics::UpdateCABACStat(STATS__CABAC_INITIALISATION, 512, 510, 0);
 #endif
-  m_uiRange    = 510;
-  m_bitsNeeded = -8;
-  m_uiValue    = (m_pcTComBitstream->readByte() << 8);
-  m_uiValue   |= m_pcTComBitstream->readByte();
+  m_uiRange         = 510;
+  m_uiValue         = 0;
+  m_numBufferedBits = -9;
+  xReadBytes();
 }
 
 Void
@@ -83,9 +86,11 @@ TDecBinCABAC::finish()
 {
   UInt lastByte;
 
+  // the bytes read ahead have been returned to the bitstream by decodeBinTrm()
+  assert( m_numBufferedBits >= 0 && m_numBufferedBits < 8 );
   m_pcTComBitstream->peekPreviousByte( lastByte );
   // Check for proper stop/alignment pattern
-  assert( ((lastByte << (8 + m_bitsNeeded)) & 0xff) == 0x80 );
+  assert( ((lastByte << (7 - m_numBufferedBits)) & 0xff) == 0x80 );
 }
 
 /**
@@ -97,11 +102,31 @@ Void
 TDecBinCABAC::copyState( const TDecBinIf* pcTDecBinIf )
 {
   const TDecBinCABAC* pcTDecBinCABAC = pcTDecBinIf->getTDecBinCABAC();
-  m_uiRange   = pcTDecBinCABAC->m_uiRange;
-  m_uiValue   = pcTDecBinCABAC->m_uiValue;
-  m_bitsNeeded= pcTDecBinCABAC->m_bitsNeeded;
+  m_uiRange         = pcTDecBinCABAC->m_uiRange;
+  m_uiValue         = pcTDecBinCABAC->m_uiValue;
+  m_numBufferedBits = pcTDecBinCABAC->m_numBufferedBits;
 }
 
+/**
+ - Read whole bytes into m_uiValue below the bits held, as many as fit and are left in the bitstream.
+ .
+ The offset is compared against the range in the 9 bits below the msb of m_uiValue, so that it can be doubled without
+ overflow. The next bit of the bitstream goes just below the m_numBufferedBits bits that follow the offset, which
+ leaves room for up to 6 or 7 bytes when the offset runs short of bits.
+ */
+Void
+TDecBinCABAC::xReadBytes()
+{
+  Int numBytes = std::min<Int>( ( CABAC_VALUE_SHIFT - m_numBufferedBits ) >> 3, m_pcTComBitstream->getNumBitsLeft() >> 3 );
+
+  while ( numBytes > 0 )
+  {
+    const Int numBytesToRead = std::min( numBytes, 4 );
+    m_numBufferedBits += numBytesToRead << 3;
+    m_uiValue         |= UInt64( m_pcTComBitstream->readBytes( numBytesToRead ) ) << ( CABAC_VALUE_SHIFT - m_numBufferedBits );
+    numBytes          -= numBytesToRead;
+  }
+}
 
 
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
@@ -116,7 +141,7 @@ Void TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel )
 
   UInt uiLPS = TComCABACTables::sm_aucLPSTable[ rcCtxModel.getState() ][ ( m_uiRange >> 6 ) - 4 ];
   m_uiRange -= uiLPS;
-  UInt scaledRange = m_uiRange << 7;
+  const UInt64 scaledRange = UInt64( m_uiRange ) << CABAC_VALUE_SHIFT;
 
   if( m_uiValue < scaledRange )
   {
@@ -127,15 +152,14 @@ Void TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel )
 #endif
     rcCtxModel.updateMPS();
 
-    if ( scaledRange < ( 256 << 7 ) )
+    if ( m_uiRange < 256 )
     {
-      m_uiRange = scaledRange >> 6;
+      m_uiRange += m_uiRange;
       m_uiValue += m_uiValue;
 
-      if ( ++m_bitsNeeded == 0 )
+      if ( --m_numBufferedBits < 0 )
       {
-        m_bitsNeeded = -8;
-        m_uiValue += m_pcTComBitstream->readByte();
+        xReadBytes();
       }
     }
   }
@@ -151,12 +175,11 @@ Void TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel )
     m_uiRange   = uiLPS << numBits;
     rcCtxModel.updateLPS();
 
-    m_bitsNeeded += numBits;
+    m_numBufferedBits -= numBits;
 
-    if ( m_bitsNeeded >= 0 )
+    if ( m_numBufferedBits < 0 )
     {
-      m_uiValue += m_pcTComBitstream->readByte() << m_bitsNeeded;
-      m_bitsNeeded -= 8;
+      xReadBytes();
     }
   }
 
@@ -198,14 +221,13 @@ Void TDecBinCABAC::decodeBinEP( UInt& ruiBin )
 
   m_uiValue += m_uiValue;
 
-  if ( ++m_bitsNeeded >= 0 )
+  if ( --m_numBufferedBits < 0 )
   {
-    m_bitsNeeded = -8;
-    m_uiValue += m_pcTComBitstream->readByte();
+    xReadBytes();
   }
 
   ruiBin = 0;
-  UInt scaledRange = m_uiRange << 7;
+  const UInt64 scaledRange = UInt64( m_uiRange ) << CABAC_VALUE_SHIFT;
   if ( m_uiValue >= scaledRange )
   {
     ruiBin = 1;
@@ -232,42 +254,21 @@ Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins )
     return;
   }
 
-  UInt bins = 0;
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-  Int origNumBins=numBins;
-#endif
-  while ( numBins > 8 )
-  {
-    m_uiValue = ( m_uiValue << 8 ) + ( m_pcTComBitstream->readByte() << ( 8 + m_bitsNeeded ) );
-
-    UInt scaledRange = m_uiRange << 15;
-    for ( Int i = 0; i < 8; i++ )
-    {
-      bins += bins;
-      scaledRange >>= 1;
-      if ( m_uiValue >= scaledRange )
-      {
-        bins++;
-        m_uiValue -= scaledRange;
-      }
-    }
-    numBins -= 8;
-  }
-
-  m_bitsNeeded += numBins;
-  m_uiValue <<= numBins;
+  assert( numBins >= 0 && numBins <= 32 );
 
-  if ( m_bitsNeeded >= 0 )
+  // a single read makes enough bits available for all bins
+  if ( m_numBufferedBits < numBins )
   {
-    m_uiValue += m_pcTComBitstream->readByte() << m_bitsNeeded;
-    m_bitsNeeded -= 8;
+    xReadBytes();
   }
+  m_numBufferedBits -= numBins;
 
-  UInt scaledRange = m_uiRange << ( numBins + 7 );
+  UInt bins = 0;
+  const UInt64 scaledRange = UInt64( m_uiRange ) << CABAC_VALUE_SHIFT;
   for ( Int i = 0; i < numBins; i++ )
   {
-    bins += bins;
-    scaledRange >>= 1;
+    bins      += bins;
+    m_uiValue += m_uiValue;
     if ( m_uiValue >= scaledRange )
     {
       bins++;
@@ -277,7 +278,61 @@ Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins )
 
   ruiBin = bins;
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
-  TComCodingStatistics::IncrementStatisticEP(whichStat, origNumBins, Int(ruiBin));
+  TComCodingStatistics::IncrementStatisticEP(whichStat, numBins, Int(ruiBin));
+#endif
+}
+
+/**
+ - Decode bypass bins until a bin equal to 0 has been decoded, or maxNumBins bins.
+ .
+ \param ruiNumOnes number of decoded bins equal to 1
+ \param maxNumBins maximum number of bins to decode
+ */
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeUnaryBinsEP( UInt& ruiNumOnes, UInt maxNumBins, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeUnaryBinsEP( UInt& ruiNumOnes, UInt maxNumBins )
+#endif
+{
+  const UInt64 scaledRange = UInt64( m_uiRange ) << CABAC_VALUE_SHIFT;
+  UInt numOnes = 0;
+  Bool bZero   = false;
+
+  while ( !bZero && numOnes < maxNumBins )
+  {
+    if ( m_numBufferedBits <= 0 )
+    {
+      xReadBytes();
+    }
+
+    // decode the bins for which bits have been read without checking for more
+    const UInt numBins = std::min<UInt>( std::max( m_numBufferedBits, 1 ), maxNumBins - numOnes );
+    UInt i = 0;
+    for ( ; i < numBins; i++ )
+    {
+      m_uiValue += m_uiValue;
+      if ( m_uiValue < scaledRange )
+      {
+        bZero = true;
+        i++;
+        break;
+      }
+      m_uiValue -= scaledRange;
+      numOnes++;
+    }
+    m_numBufferedBits -= i;
+  }
+
+  ruiNumOnes = numOnes;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  for ( UInt i = 0; i < numOnes; i++ )
+  {
+    TComCodingStatistics::IncrementStatisticEP(whichStat, 1, 1);
+  }
+  if ( bZero )
+  {
+    TComCodingStatistics::IncrementStatisticEP(whichStat, 1, 0);
+  }
 #endif
 }
 
@@ -295,40 +350,29 @@ Void TDecBinCABAC::decodeAlignedBinsEP( UInt& ruiBins, Int numBins, const class
 Void TDecBinCABAC::decodeAlignedBinsEP( UInt& ruiBins, Int numBins )
 #endif
 {
-  Int binsRemaining = numBins;
-  ruiBins = 0;
-
   assert(m_uiRange == 256); //aligned decode only works when range = 256
+  assert( numBins >= 0 && numBins <= 32 );
 
-  while (binsRemaining > 0)
+  if ( m_numBufferedBits < numBins )
   {
-    const UInt binsToRead = std::min<UInt>(binsRemaining, 8); //read bytes if able to take advantage of the system's byte-read function
-    const UInt binMask    = (1 << binsToRead) - 1;
-
-    //The MSB of m_uiValue is known to be 0 because range is 256. Therefore:
-    // > The comparison against the symbol range of 128 is simply a test on the next-most-significant bit
-    // > "Subtracting" the symbol range if the decoded bin is 1 simply involves clearing that bit.
-    //
-    //As a result, the required bins are simply the <binsToRead> next-most-significant bits of m_uiValue
-    //(m_uiValue is stored MSB-aligned in a 16-bit buffer - hence the shift of 15)
-    //
-    //   m_uiValue = |0|V|V|V|V|V|V|V|V|B|B|B|B|B|B|B|        (V = usable bit, B = potential buffered bit (buffer refills when m_bitsNeeded >= 0))
-    //
-    const UInt newBins = (m_uiValue >> (15 - binsToRead)) & binMask;
-
-    ruiBins   = (ruiBins   << binsToRead) | newBins;
-    m_uiValue = (m_uiValue << binsToRead) & 0x7FFF;
-
-    binsRemaining -= binsToRead;
-    m_bitsNeeded  += binsToRead;
-
-    if (m_bitsNeeded >= 0)
-    {
-      m_uiValue    |= m_pcTComBitstream->readByte() << m_bitsNeeded;
-      m_bitsNeeded -= 8;
-    }
+    xReadBytes();
   }
 
+  //The MSB of the offset is known to be 0 because range is 256. Therefore:
+  // > The comparison against the symbol range of 128 is simply a test on the next-most-significant bit
+  // > "Subtracting" the symbol range if the decoded bin is 1 simply involves clearing that bit.
+  //
+  //As a result, the required bins are simply the <numBins> bits of m_uiValue that follow the MSB of the offset
+  //(the offset is stored in the 9 bits below the MSB of m_uiValue - hence the shift of CABAC_VALUE_SHIFT + 8)
+  //
+  //   m_uiValue = |0|0|V|V|V|V|V|V|V|V|B|B|B|...|B|0|...|0|   (V = usable bit, B = m_numBufferedBits bits read ahead)
+  //
+  const UInt64 offsetMask = ( UInt64( 1 ) << ( CABAC_VALUE_SHIFT + 8 ) ) - 1;
+
+  ruiBins            = UInt( m_uiValue >> ( CABAC_VALUE_SHIFT + 8 - numBins ) );
+  m_uiValue          = ( m_uiValue << numBins ) & offsetMask;
+  m_numBufferedBits -= numBins;
+
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   TComCodingStatistics::IncrementStatisticEP(whichStat, numBins, Int(ruiBins));
 #endif
@@ -338,13 +382,19 @@ Void
 TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
 {
   m_uiRange -= 2;
-  UInt scaledRange = m_uiRange << 7;
+  const UInt64 scaledRange = UInt64( m_uiRange ) << CABAC_VALUE_SHIFT;
   if( m_uiValue >= scaledRange )
   {
     ruiBin = 1;
+
+    // the arithmetic code ends here, so return the whole bytes read ahead to the bitstream, which continues with
+    // the byte following the last byte read by a decoder that reads a byte at a time
+    assert( m_numBufferedBits >= 0 );
+    m_pcTComBitstream->unreadBytes( m_numBufferedBits >> 3 );
+    m_numBufferedBits &= 0x7;
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
     TComCodingStatistics::UpdateCABACStat(STATS__CABAC_TRM_BITS, m_uiRange+2, 2, ruiBin);
-    TComCodingStatistics::IncrementStatisticEP(STATS__BYTE_ALIGNMENT_BITS, -m_bitsNeeded, 0);
+    TComCodingStatistics::IncrementStatisticEP(STATS__BYTE_ALIGNMENT_BITS, m_numBufferedBits + 1, 0);
 #endif
   }
   else
@@ -353,15 +403,14 @@ TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
     TComCodingStatistics::UpdateCABACStat(STATS__CABAC_TRM_BITS, m_uiRange+2, m_uiRange, ruiBin);
 #endif
-    if ( scaledRange < ( 256 << 7 ) )
+    if ( m_uiRange < 256 )
     {
-      m_uiRange = scaledRange >> 6;
+      m_uiRange += m_uiRange;
       m_uiValue += m_uiValue;
 
-      if ( ++m_bitsNeeded == 0 )
+      if ( --m_numBufferedBits < 0 )
       {
-        m_bitsNeeded = -8;
-        m_uiValue += m_pcTComBitstream->readByte();
+        xReadBytes();
       }
     }
   }
@@ -61,11 +61,13 @@ public:
   Void  decodeBinEP        ( UInt& ruiBin                          , const class TComCodingStatisticsClassType &whichStat );
   Void  decodeBinsEP       ( UInt& ruiBin, Int numBins             , const class TComCodingStatisticsClassType &whichStat );
   Void  decodeAlignedBinsEP( UInt& ruiBins, Int numBins            , const class TComCodingStatisticsClassType &whichStat );
+  Void  decodeUnaryBinsEP  ( UInt& ruiNumOnes, UInt maxNumBins     , const class TComCodingStatisticsClassType &whichStat );
 #else
   Void  decodeBin         ( UInt& ruiBin, ContextModel& rcCtxModel );
   Void  decodeBinEP       ( UInt& ruiBin                           );
   Void  decodeBinsEP      ( UInt& ruiBin, Int numBins              );
   Void  decodeAlignedBinsEP( UInt& ruiBins, Int numBins             );
+  Void  decodeUnaryBinsEP ( UInt& ruiNumOnes, UInt maxNumBins      );
 #endif
 
   Void  align             ();
@@ -79,10 +81,12 @@ public:
   const TDecBinCABAC* getTDecBinCABAC() const { return this; }
 
 private:
+  Void  xReadBytes        ();
+
   TComInputBitstream* m_pcTComBitstream;
   UInt                m_uiRange;
-  UInt                m_uiValue;
-  Int                 m_bitsNeeded;
+  UInt64              m_uiValue;         ///< offset in the 9 bits below the msb, followed by the bits read ahead
+  Int                 m_numBufferedBits; ///< number of bits read ahead of the offset
 };
 
 //! \}
@@ -460,15 +460,7 @@ Void TDecCu::xReconInter( TComDataCU* pcCU, UInt uiDepth )
   }
 #endif
 
-  // clip for only non-zero cbp case
-  if  ( pcCU->getQtRootCbf( 0) )
-  {
-    m_ppcYuvReco[uiDepth]->addClip( m_ppcYuvReco[uiDepth], m_ppcYuvResi[uiDepth], 0, pcCU->getWidth( 0 ), pcCU->getSlice()->getSPS()->getBitDepths() );
-  }
-  else
-  {
-    m_ppcYuvReco[uiDepth]->copyPartToPartYuv( m_ppcYuvReco[uiDepth],0, pcCU->getWidth( 0 ),pcCU->getHeight( 0 ));
-  }
+  // the residual has been added to the prediction TU by TU in xDecodeInterTexture
 #if DEBUG_STRING
   if (DebugOptionList::DebugString_Reco.getInt()&debugPredModeMask)
   {
@@ -553,6 +545,9 @@ TDecCu::xIntraRecBlk(       TComYuv*    pcRecoYuv,
 
   const QpParam cQP(*pcCU, compID);
 
+  const Bool useCrossComponentPrediction = isChroma(compID) && (pcCU->getCrossComponentPredictionAlpha(uiAbsPartIdx, compID) != 0);
+        Pel* piReco                      = pcRecoYuv->getAddr( compID, uiAbsPartIdx );
+        Bool bReconstructed              = false;
 
   DEBUG_STRING_NEW(sDebug);
 #if DEBUG_STRING
@@ -562,7 +557,18 @@ TDecCu::xIntraRecBlk(       TComYuv*    pcRecoYuv,
 
   if (pcCU->getCbf(uiAbsPartIdx, compID, rTu.GetTransformDepthRel()) != 0)
   {
-    m_pcTrQuant->invTransformNxN( rTu, compID, piResi, uiStride, pcCoeff, cQP DEBUG_STRING_PASS_INTO(psDebug) );
+#if !DEBUG_STRING && !O0043_BEST_EFFORT_DECODING
+    if (!useCrossComponentPrediction)
+    {
+      // inverse transform, addition of the prediction and clipping in one pass
+      m_pcTrQuant->invTransformRecNxN( rTu, compID, piResi, uiStride, pcCoeff, cQP, piPred, uiStride, piReco, uiStride );
+      bReconstructed = true;
+    }
+    else
+#endif
+    {
+      m_pcTrQuant->invTransformNxN( rTu, compID, piResi, uiStride, pcCoeff, cQP DEBUG_STRING_PASS_INTO(psDebug) );
+    }
   }
   else
   {
@@ -585,15 +591,25 @@ TDecCu::xIntraRecBlk(       TComYuv*    pcRecoYuv,
   //===== reconstruction =====
   const UInt uiRecIPredStride  = pcCU->getPic()->getPicYuvRec()->getStride(compID);
 
-  const Bool useCrossComponentPrediction = isChroma(compID) && (pcCU->getCrossComponentPredictionAlpha(uiAbsPartIdx, compID) != 0);
   const Pel* pResiLuma  = pcResiYuv->getAddr( COMPONENT_Y, uiAbsPartIdx );
   const Int  strideLuma = pcResiYuv->getStride( COMPONENT_Y );
 
         Pel* pPred      = piPred;
         Pel* pResi      = piResi;
-        Pel* pReco      = pcRecoYuv->getAddr( compID, uiAbsPartIdx );
+        Pel* pReco      = piReco;
         Pel* pRecIPred  = pcCU->getPic()->getPicYuvRec()->getAddr( compID, pcCU->getCtuRsAddr(), pcCU->getZorderIdxInCtu() + uiAbsPartIdx );
 
+  if (bReconstructed)
+  {
+    for( UInt uiY = 0; uiY < uiHeight; uiY++ )
+    {
+      ::memcpy( pRecIPred, pReco, uiWidth * sizeof( Pel ) );
+      pReco     += uiStride;
+      pRecIPred += uiRecIPredStride;
+    }
+    return;
+  }
+
 
 #if DEBUG_STRING
   const Bool bDebugPred=((DebugOptionList::DebugString_Pred.getInt()&debugPredModeMask) && DEBUG_STRING_CHANNEL_CONDITION(compID));
@@ -767,7 +783,7 @@ Void TDecCu::xDecodeInterTexture ( TComDataCU* pcCU, UInt uiDepth )
     const ComponentID compID=ComponentID(ch);
     DEBUG_STRING_OUTPUT(std::cout, debug_reorder_data_inter_token[compID])
 
-    m_pcTrQuant->invRecurTransformNxN ( compID, m_ppcYuvResi[uiDepth], tuRecur );
+    m_pcTrQuant->invRecurTransformRecNxN ( compID, m_ppcYuvResi[uiDepth], m_ppcYuvReco[uiDepth], tuRecur );
   }
 
   DEBUG_STRING_OUTPUT(std::cout, debug_reorder_data_inter_token[MAX_NUM_COMPONENT])
@@ -54,6 +54,9 @@ static Void calcAndPrintHashStatus(TComPicYuv& pic, const SEIDecodedPictureHash*
 
 TDecGop::TDecGop()
  : m_numberOfChecksumErrorsDetected(0)
+ , m_pipelinedFiltering(false)
+ , m_pcFilterPic(NULL)
+ , m_numHashTasks(0)
 {
   m_dDecTime = 0;
 }
@@ -65,12 +68,25 @@ TDecGop::~TDecGop()
 
 Void TDecGop::create()
 {
-
+  if (m_pipelinedFiltering)
+  {
+    m_cFilterThread.create(1);
+    m_cHashThread.create(1);
+    m_hashProgress.reset(1);
+    m_numHashTasks = 0;
+  }
 }
 
 
 Void TDecGop::destroy()
 {
+  if (m_pcFilterPic)
+  {
+    xFinishFilterPicture();
+  }
+  waitForAllPictureHashes();
+  m_cFilterThread.destroy();
+  m_cHashThread.destroy();
 }
 
 Void TDecGop::init( TDecEntropy*            pcEntropyDecoder,
@@ -139,16 +155,24 @@ Void TDecGop::filterPicture(TComPic* pcPic)
   //-- For time output for each slice
   clock_t iBeforeTime = clock();
 
-  // deblocking filter
-  Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
-  m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
-  m_pcLoopFilter->loopFilterPic( pcPic );
-
-  if( pcSlice->getSPS()->getUseSAO() )
+  if (pcPic == m_pcFilterPic)
+  {
+    // the rows have been filtered while the picture was reconstructed
+    xFinishFilterPicture();
+  }
+  else
   {
-    m_pcSAO->reconstructBlkSAOParams(pcPic, pcPic->getPicSym()->getSAOBlkParam());
-    m_pcSAO->SAOProcess(pcPic);
-    m_pcSAO->PCMLFDisableProcess(pcPic);
+    // deblocking filter
+    Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
+    m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
+    m_pcLoopFilter->loopFilterPic( pcPic );
+
+    if( pcSlice->getSPS()->getUseSAO() )
+    {
+      m_pcSAO->reconstructBlkSAOParams(pcPic, pcPic->getPicSym()->getSAOBlkParam());
+      m_pcSAO->SAOProcess(pcPic);
+      m_pcSAO->PCMLFDisableProcess(pcPic);
+    }
   }
 
   pcPic->compressMotion();
@@ -159,41 +183,173 @@ Void TDecGop::filterPicture(TComPic* pcPic)
   }
 
   //-- For time output for each slice
-  printf("POC %4d TId: %1d ( %c-SLICE, QP%3d ) ", pcSlice->getPOC(),
-                                                  pcSlice->getTLayer(),
-                                                  c,
-                                                  pcSlice->getSliceQp() );
+  // the status line is assembled first, so that the hash check can complete it on m_cHashThread
+  TChar buf[128];
+  snprintf(buf, sizeof(buf), "POC %4d TId: %1d ( %c-SLICE, QP%3d ) ", pcSlice->getPOC(),
+                                                                   pcSlice->getTLayer(),
+                                                                   c,
+                                                                   pcSlice->getSliceQp() );
+  std::string status(buf);
 
   m_dDecTime += (Double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
-  printf ("[DT %6.3f] ", m_dDecTime );
+  snprintf(buf, sizeof(buf), "[DT %6.3f] ", m_dDecTime );
+  status += buf;
   m_dDecTime  = 0;
 
   for (Int iRefList = 0; iRefList < 2; iRefList++)
   {
-    printf ("[L%d ", iRefList);
+    snprintf(buf, sizeof(buf), "[L%d ", iRefList);
+    status += buf;
     for (Int iRefIndex = 0; iRefIndex < pcSlice->getNumRefIdx(RefPicList(iRefList)); iRefIndex++)
     {
-      printf ("%d ", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex));
+      snprintf(buf, sizeof(buf), "%d ", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex));
+      status += buf;
     }
-    printf ("] ");
+    status += "] ";
   }
   if (m_decodedPictureHashSEIEnabled)
   {
     SEIMessages pictureHashes = getSeisByType(pcPic->getSEIs(), SEI::DECODED_PICTURE_HASH );
-    const SEIDecodedPictureHash *hash = ( pictureHashes.size() > 0 ) ? (SEIDecodedPictureHash*) *(pictureHashes.begin()) : NULL;
+    const Bool hasHash = pictureHashes.size() > 0;
+    SEIDecodedPictureHash hash;
+    hash.method = HASHTYPE_NONE;
+    if (hasHash)
+    {
+      hash = *((SEIDecodedPictureHash*) *(pictureHashes.begin()));
+    }
     if (pictureHashes.size() > 1)
     {
-      printf ("Warning: Got multiple decoded picture hash SEI messages. Using first.");
+      status += "Warning: Got multiple decoded picture hash SEI messages. Using first.";
     }
-    calcAndPrintHashStatus(*(pcPic->getPicYuvRec()), hash, pcSlice->getSPS()->getBitDepths(), m_numberOfChecksumErrorsDetected);
-  }
+    const BitDepths bitDepths = pcSlice->getSPS()->getBitDepths();
 
-  printf("\n");
+    if (m_cHashThread.getNumThreads() > 0)
+    {
+      // the picture is not modified until it is output or its buffer is reused, see waitForPictureHash
+      const Int hashTaskIdx = m_numHashTasks++;
+      m_hashTaskOfPic[pcPic] = hashTaskIdx;
+      m_cHashThread.addTask( [=]( Int )
+      {
+        printf("%s", status.c_str());
+        calcAndPrintHashStatus(*(pcPic->getPicYuvRec()), hasHash ? &hash : NULL, bitDepths, m_numberOfChecksumErrorsDetected);
+        printf("\n");
+        m_hashProgress.set( 0, hashTaskIdx + 1 );
+      } );
+    }
+    else
+    {
+      printf("%s", status.c_str());
+      calcAndPrintHashStatus(*(pcPic->getPicYuvRec()), hasHash ? &hash : NULL, bitDepths, m_numberOfChecksumErrorsDetected);
+      printf("\n");
+    }
+  }
+  else
+  {
+    printf("%s\n", status.c_str());
+  }
 
   pcPic->setOutputMark(pcPic->getSlice(0)->getPicOutputFlag() ? true : false);
   pcPic->setReconMark(true);
 }
 
+/** Start the in-loop filtering of a picture whose first slice is about to be decoded.
+ * The filter thread deblocks each CTU row, and applies SAO to the row above it, as soon as the reconstruction has
+ * passed the row below; filterPicture then only waits for the last rows.
+ * \param pcPic picture about to be decoded
+ */
+Void TDecGop::startFilterPicture(TComPic* pcPic)
+{
+  if (!m_pipelinedFiltering)
+  {
+    return;
+  }
+  if (m_pcFilterPic)
+  {
+    // the previous picture was never passed to filterPicture
+    xFinishFilterPicture();
+  }
+
+  const TComSlice* pcSlice = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  const Bool       bUseSAO = pcSlice->getSPS()->getUseSAO();
+  m_pcLoopFilter->setCfg(pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag());
+
+  m_ctuRowProgress.reset(pcPic->getFrameHeightInCtus());
+  m_pcSliceDecoder->setCtuRowProgress(&m_ctuRowProgress);
+  m_pcFilterPic = pcPic;
+
+  m_cFilterThread.addTask( [=]( Int )
+  {
+    xFilterCtuRows(pcPic, bUseSAO);
+  } );
+}
+
+/** Wait until the decoded picture hash of a picture has been checked, before its buffer is reused or destroyed.
+ * \param pcPic picture
+ */
+Void TDecGop::waitForPictureHash(TComPic* pcPic)
+{
+  std::map<TComPic*, Int>::iterator it = m_hashTaskOfPic.find(pcPic);
+  if (it != m_hashTaskOfPic.end())
+  {
+    m_hashProgress.wait(0, it->second + 1);
+    m_hashTaskOfPic.erase(it);
+  }
+}
+
+Void TDecGop::waitForAllPictureHashes()
+{
+  m_cHashThread.waitForAll();
+  m_hashTaskOfPic.clear();
+}
+
+/** Filter task of startFilterPicture.
+ * \param pcPic   picture being decoded
+ * \param bUseSAO SAO (and PCM / lossless sample restoration) is enabled in the SPS
+ */
+Void TDecGop::xFilterCtuRows(TComPic* pcPic, Bool bUseSAO)
+{
+  const Int frameWidthInCtus  = pcPic->getFrameWidthInCtus();
+  const Int frameHeightInCtus = pcPic->getFrameHeightInCtus();
+
+  for (Int ctuRowIdx = 0; ctuRowIdx < frameHeightInCtus; ctuRowIdx++)
+  {
+    // with tiles, the rows are not completed in order
+    m_ctuRowProgress.wait(ctuRowIdx, frameWidthInCtus);
+    if (ctuRowIdx + 1 < frameHeightInCtus)
+    {
+      m_ctuRowProgress.wait(ctuRowIdx + 1, frameWidthInCtus);
+    }
+
+    m_pcLoopFilter->loopFilterCtuRow(pcPic, ctuRowIdx);
+
+    // the row above is final once this row has been deblocked
+    if (bUseSAO && ctuRowIdx > 0)
+    {
+      m_pcSAO->SAOProcessCtuRow(pcPic, ctuRowIdx - 1);
+      m_pcSAO->PCMLFDisableProcessCtuRow(pcPic, ctuRowIdx - 1);
+    }
+  }
+  if (bUseSAO)
+  {
+    m_pcSAO->SAOProcessCtuRow(pcPic, frameHeightInCtus - 1);
+    m_pcSAO->PCMLFDisableProcessCtuRow(pcPic, frameHeightInCtus - 1);
+  }
+}
+
+/** Wait for the filter task of m_pcFilterPic. Rows of slices that were lost are never completed by the
+ * reconstruction, so they are released first, and are then filtered as filterPicture would have done.
+ */
+Void TDecGop::xFinishFilterPicture()
+{
+  for (Int ctuRowIdx = 0; ctuRowIdx < m_pcFilterPic->getFrameHeightInCtus(); ctuRowIdx++)
+  {
+    m_ctuRowProgress.set(ctuRowIdx, MAX_INT);
+  }
+  m_cFilterThread.waitForAll();
+  m_pcSliceDecoder->setCtuRowProgress(NULL);
+  m_pcFilterPic = NULL;
+}
+
 /**
  * Calculate and print hash for pic, compare to picture_digest SEI if
  * present in seis.  seis may be NULL.  Hash is printed to stdout, in
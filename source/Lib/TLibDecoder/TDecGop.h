@@ -49,6 +49,9 @@
 #include "TLibCommon/TComPic.h"
 #include "TLibCommon/TComLoopFilter.h"
 #include "TLibCommon/TComSampleAdaptiveOffset.h"
+#include "TLibCommon/TComThreadPool.h"
+
+#include <map>
 
 #include "TDecEntropy.h"
 #include "TDecSlice.h"
@@ -81,6 +84,16 @@ private:
   Int                   m_decodedPictureHashSEIEnabled;  ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
   UInt                  m_numberOfChecksumErrorsDetected;
 
+  // pipelined in-loop filtering
+  Bool                  m_pipelinedFiltering;
+  TComThreadPool        m_cFilterThread;                 ///< runs deblocking and SAO a few CTU rows behind the reconstruction
+  TComRowProgress       m_ctuRowProgress;                ///< number of reconstructed CTUs in each CTU row of m_pcFilterPic
+  TComPic*              m_pcFilterPic;                   ///< picture currently followed by m_cFilterThread, NULL when idle
+  TComThreadPool        m_cHashThread;                   ///< checks the decoded picture hash while the next picture is decoded
+  TComRowProgress       m_hashProgress;                  ///< number of finished hash tasks
+  Int                   m_numHashTasks;
+  std::map<TComPic*, Int> m_hashTaskOfPic;               ///< index of the hash task queued for each picture
+
 public:
   TDecGop();
   virtual ~TDecGop();
@@ -98,9 +111,17 @@ public:
   Void  decompressSlice(TComInputBitstream* pcBitstream, TComPic* pcPic );
   Void  filterPicture  (TComPic* pcPic );
 
+  Void  startFilterPicture      ( TComPic* pcPic );
+  Void  waitForPictureHash      ( TComPic* pcPic );
+  Void  waitForAllPictureHashes ();
+
   Void setDecodedPictureHashSEIEnabled(Int enabled) { m_decodedPictureHashSEIEnabled = enabled; }
+  Void setPipelinedFiltering(Bool b) { m_pipelinedFiltering = b; }
   UInt getNumberOfChecksumErrorsDetected() const { return m_numberOfChecksumErrorsDetected; }
 
+private:
+  Void  xFilterCtuRows          ( TComPic* pcPic, Bool bUseSAO );
+  Void  xFinishFilterPicture    ();
 };
 
 //! \}
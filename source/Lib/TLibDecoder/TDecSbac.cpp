@@ -310,25 +310,13 @@ Void TDecSbac::xReadCoefRemainExGolomb ( UInt &rSymbol, UInt &rParam, const Bool
   {
     const UInt longestPossiblePrefix = (32 - (COEF_REMAIN_BIN_REDUCTION + maxLog2TrDynamicRange)) + COEF_REMAIN_BIN_REDUCTION;
 
-    do
-    {
-      prefix++;
-      m_pcTDecBinIf->decodeBinEP( codeWord RExt__DECODER_DEBUG_BIT_STATISTICS_PASS_OPT_ARG(whichStat) );
-    } while((codeWord != 0) && (prefix < longestPossiblePrefix));
+    m_pcTDecBinIf->decodeUnaryBinsEP( prefix, longestPossiblePrefix RExt__DECODER_DEBUG_BIT_STATISTICS_PASS_OPT_ARG(whichStat) );
   }
   else
   {
-    do
-    {
-      prefix++;
-      m_pcTDecBinIf->decodeBinEP( codeWord RExt__DECODER_DEBUG_BIT_STATISTICS_PASS_OPT_ARG(whichStat) );
-    } while( codeWord);
+    m_pcTDecBinIf->decodeUnaryBinsEP( prefix, std::numeric_limits<UInt>::max() RExt__DECODER_DEBUG_BIT_STATISTICS_PASS_OPT_ARG(whichStat) );
   }
 
-  codeWord  = 1 - codeWord;
-  prefix -= codeWord;
-  codeWord=0;
-
   if (prefix < COEF_REMAIN_BIN_REDUCTION )
   {
     m_pcTDecBinIf->decodeBinsEP(codeWord,rParam RExt__DECODER_DEBUG_BIT_STATISTICS_PASS_OPT_ARG(whichStat));
@@ -46,11 +46,17 @@
 //////////////////////////////////////////////////////////////////////
 
 TDecSlice::TDecSlice()
+: m_pcThreadPool                  ( NULL )
+, m_pcSliceWorkers                ( NULL )
+, m_pcSubstreamSyncContextStates  ( NULL )
+, m_numSubstreamSyncContextStates ( 0 )
+, m_pcCtuRowProgress              ( NULL )
 {
 }
 
 TDecSlice::~TDecSlice()
 {
+  destroy();
 }
 
 Void TDecSlice::create()
@@ -59,13 +65,19 @@ Void TDecSlice::create()
 
 Void TDecSlice::destroy()
 {
+  delete [] m_pcSubstreamSyncContextStates;
+  m_pcSubstreamSyncContextStates  = NULL;
+  m_numSubstreamSyncContextStates = 0;
 }
 
-Void TDecSlice::init(TDecEntropy* pcEntropyDecoder, TDecCu* pcCuDecoder, TDecConformanceCheck *pDecConformanceCheck)
+Void TDecSlice::init(TDecEntropy* pcEntropyDecoder, TDecCu* pcCuDecoder, TDecConformanceCheck *pDecConformanceCheck,
+                     TComThreadPool* pcThreadPool, TDecSliceWorker* pcSliceWorkers)
 {
   m_pcEntropyDecoder     = pcEntropyDecoder;
   m_pcCuDecoder          = pcCuDecoder;
   m_pDecConformanceCheck = pDecConformanceCheck;
+  m_pcThreadPool         = pcThreadPool;
+  m_pcSliceWorkers       = pcSliceWorkers;
 }
 
 Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcPic, TDecSbac* pcSbacDecoder)
@@ -121,6 +133,14 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
     }
   }
 
+  // decode the tiles and WPP rows concurrently when possible; the result is identical to the loop below
+  std::vector<UInt> substreamStartCtuTsAddr;
+  if ( xCanDecompressSubstreamsInParallel( pcPic, substreamStartCtuTsAddr ) )
+  {
+    xDecompressSubstreamsInParallel( ppcSubstreams, pcPic, pcSbacDecoder, substreamStartCtuTsAddr );
+    return;
+  }
+
   // for every CTU in the slice segment...
 
   Bool isLastCtuOfSliceSegment = false;
@@ -227,6 +247,11 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
     g_bJustDoIt = g_bEncDecTraceDisable;
 #endif
 
+    if ( m_pcCtuRowProgress )
+    {
+      m_pcCtuRowProgress->increment( ctuYPosInCtus );
+    }
+
     //Store probabilities of second CTU in line into buffer
     if ( ctuXPosInCtus == tileXPosInCtus+1 && wavefrontsEnabled)
     {
@@ -270,4 +295,252 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
 
 }
 
+/** Check whether the substreams (WPP CTU rows and tiles) of the current slice segment can be decoded on the worker
+ * threads, and if so find the first CTU of each of them. The end of the last substream is only known once the
+ * end_of_slice_segment_flag has been parsed, so the list is terminated with the furthest CTU it can reach.
+ * Trace and bit statistics builds write to global state for every bin and keep the sequential loop.
+ */
+Bool TDecSlice::xCanDecompressSubstreamsInParallel( TComPic* pcPic, std::vector<UInt> &substreamStartCtuTsAddr )
+{
+#if ENC_DEC_TRACE || RExt__DECODER_DEBUG_BIT_STATISTICS
+  return false;
+#else
+  TComSlice* const  pcSlice           = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  const TComPicSym* pcPicSym          = pcPic->getPicSym();
+  const UInt        numSubstreams     = pcSlice->getNumberOfSubstreamSizes() + 1;
+  const UInt        startCtuTsAddr    = pcSlice->getSliceSegmentCurStartCtuTsAddr();
+  const UInt        numCtusInFrame    = pcPic->getNumberOfCtusInFrame();
+  const UInt        frameWidthInCtus  = pcPicSym->getFrameWidthInCtus();
+  const Bool        wavefrontsEnabled = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag();
+
+  if ( m_pcThreadPool == NULL || m_pcThreadPool->getNumThreads() < 2 || numSubstreams < 2 )
+  {
+    return false;
+  }
+
+  for ( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < numCtusInFrame && substreamStartCtuTsAddr.size() <= numSubstreams; ctuTsAddr++ )
+  {
+    const UInt ctuRsAddr            = pcPicSym->getCtuTsToRsAddrMap(ctuTsAddr);
+    const UInt firstCtuRsAddrOfTile = pcPicSym->getTComTile(pcPicSym->getTileIdxMap(ctuRsAddr))->getFirstCtuRsAddr();
+    if ( ctuTsAddr == startCtuTsAddr || ctuRsAddr == firstCtuRsAddrOfTile ||
+         ( wavefrontsEnabled && ctuRsAddr % frameWidthInCtus == firstCtuRsAddrOfTile % frameWidthInCtus ) )
+    {
+      substreamStartCtuTsAddr.push_back( ctuTsAddr );
+    }
+  }
+
+  if ( substreamStartCtuTsAddr.size() < numSubstreams )
+  {
+    // more entry points than substreams in the rest of the picture: leave the error to the sequential loop
+    substreamStartCtuTsAddr.clear();
+    return false;
+  }
+  if ( substreamStartCtuTsAddr.size() == numSubstreams )
+  {
+    substreamStartCtuTsAddr.push_back( numCtusInFrame );
+  }
+  return true;
+#endif
+}
+
+/** Decode the substreams of a slice segment on the worker threads.
+ * The first substream continues with the decoding engines set up by decompressSlice, the other ones use the engines
+ * of the worker thread they run on. Tiles are independent; a CTU of a WPP row starts once the CTU above-right of it
+ * has been reconstructed, which is also when the contexts it synchronises with become available.
+ */
+Void TDecSlice::xDecompressSubstreamsInParallel( TComInputBitstream** ppcSubstreams, TComPic* pcPic, TDecSbac* pcSbacDecoder, const std::vector<UInt> &substreamStartCtuTsAddr )
+{
+  TComSlice* const  pcSlice           = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  const UInt        numSubstreams     = UInt( substreamStartCtuTsAddr.size() ) - 1;
+  const UInt        startCtuTsAddr    = substreamStartCtuTsAddr[0];
+  const UInt        boundingCtuTsAddr = substreamStartCtuTsAddr[numSubstreams];
+
+  if ( numSubstreams > m_numSubstreamSyncContextStates )
+  {
+    delete [] m_pcSubstreamSyncContextStates;
+    m_pcSubstreamSyncContextStates  = new TDecSbac[numSubstreams];
+    m_numSubstreamSyncContextStates = numSubstreams;
+  }
+
+  // the CTUs are initialised up front, as a substream looks at the address and slice of the CTUs of its
+  // neighbouring substreams (to find out they are unavailable) while those may still be being decoded
+  for ( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ctuTsAddr++ )
+  {
+    const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
+    pcPic->getCtu( ctuRsAddr )->initCtu( pcPic, ctuRsAddr );
+  }
+
+  m_substreamProgress.reset( numSubstreams );
+  UInt endCtuTsAddr = boundingCtuTsAddr;
+
+  // substreams are started in order, so a substream only ever waits for one that is already running
+  for ( UInt substreamIdx = 0; substreamIdx < numSubstreams; substreamIdx++ )
+  {
+    const UInt substreamStart = substreamStartCtuTsAddr[substreamIdx];
+    const UInt substreamEnd   = substreamStartCtuTsAddr[substreamIdx + 1];
+    TComInputBitstream* pcSubstream = ppcSubstreams[substreamIdx];
+    m_pcThreadPool->addTask( [=, &endCtuTsAddr]( Int threadIdx )
+    {
+      if ( substreamIdx == 0 )
+      {
+        xDecompressSubstream( pcSubstream, pcPic, substreamIdx, substreamStart, substreamEnd, numSubstreams == 1,
+                              m_pcEntropyDecoder, pcSbacDecoder, m_pcCuDecoder, &endCtuTsAddr );
+      }
+      else
+      {
+        TDecSliceWorker* pcWorker = &m_pcSliceWorkers[threadIdx];
+        pcWorker->getEntropyDecoder()->setEntropyDecoder( pcWorker->getSbacDecoder() );
+        pcWorker->getEntropyDecoder()->setBitstream     ( pcSubstream );
+        pcWorker->getEntropyDecoder()->resetEntropy     ( pcSlice );
+        xDecompressSubstream( pcSubstream, pcPic, substreamIdx, substreamStart, substreamEnd, substreamIdx + 1 == numSubstreams,
+                              pcWorker->getEntropyDecoder(), pcWorker->getSbacDecoder(), pcWorker->getCuDecoder(), &endCtuTsAddr );
+      }
+    } );
+  }
+  m_pcThreadPool->waitForAll();
+
+  if(!pcSlice->getDependentSliceSegmentFlag())
+  {
+    pcSlice->setSliceCurEndCtuTsAddr( endCtuTsAddr );
+  }
+  pcSlice->setSliceSegmentCurEndCtuTsAddr( endCtuTsAddr );
+
+  // a following dependent slice segment continues from the contexts stored in the last row of this one
+  if ( pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() && endCtuTsAddr >= substreamStartCtuTsAddr[numSubstreams - 1] + 2 )
+  {
+    m_entropyCodingSyncContextState.loadContexts( &m_pcSubstreamSyncContextStates[numSubstreams - 1] );
+  }
+}
+
+/** Parse and reconstruct the CTUs of one substream of the slice segment with the given decoding engines.
+ * This follows the per-CTU steps of the sequential loop in decompressSlice; the entropy decoder has already been
+ * reset on the substream. The last substream runs up to the end of the slice segment, whose address is returned.
+ */
+Void TDecSlice::xDecompressSubstream( TComInputBitstream* pcSubstream, TComPic* pcPic, const UInt substreamIdx, const UInt substreamStartCtuTsAddr, const UInt substreamEndCtuTsAddr,
+                                      const Bool bLastSubstream, TDecEntropy* pcEntropyDecoder, TDecSbac* pcSbacDecoder, TDecCu* pcCuDecoder, UInt* pEndCtuTsAddr )
+{
+  TComSlice* const  pcSlice           = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  TComPicSym* const pcPicSym          = pcPic->getPicSym();
+  const UInt        frameWidthInCtus  = pcPicSym->getFrameWidthInCtus();
+  const Bool        wavefrontsEnabled = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag();
+
+  Bool isLastCtuOfSliceSegment = false;
+  for( UInt ctuTsAddr = substreamStartCtuTsAddr; !isLastCtuOfSliceSegment && ctuTsAddr < substreamEndCtuTsAddr; ctuTsAddr++ )
+  {
+    const UInt ctuRsAddr = pcPicSym->getCtuTsToRsAddrMap(ctuTsAddr);
+    const TComTile &currentTile = *(pcPicSym->getTComTile(pcPicSym->getTileIdxMap(ctuRsAddr)));
+    const UInt firstCtuRsAddrOfTile = currentTile.getFirstCtuRsAddr();
+    const UInt tileXPosInCtus = firstCtuRsAddrOfTile % frameWidthInCtus;
+    const UInt tileYPosInCtus = firstCtuRsAddrOfTile / frameWidthInCtus;
+    const UInt ctuXPosInCtus  = ctuRsAddr % frameWidthInCtus;
+    const UInt ctuYPosInCtus  = ctuRsAddr / frameWidthInCtus;
+    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr ); // already initialised by xDecompressSubstreamsInParallel
+
+    // a WPP row waits for the CTU above-right of the current one (or the last CTU of the row above)
+    if ( wavefrontsEnabled && substreamIdx > 0 && substreamStartCtuTsAddr != pcPicSym->getCtuRsToTsAddrMap(firstCtuRsAddrOfTile) )
+    {
+      m_substreamProgress.wait( substreamIdx - 1, std::min( ctuXPosInCtus + 2, tileXPosInCtus + currentTile.getTileWidthInCtus() ) );
+    }
+
+    // synchronize cabac probabilities with upper-right CTU if it's available and at the start of a line.
+    if (ctuRsAddr != firstCtuRsAddrOfTile && ctuXPosInCtus == tileXPosInCtus && wavefrontsEnabled)
+    {
+      TComDataCU *pCtuUp = pCtu->getCtuAbove();
+      if ( pCtuUp && ((ctuRsAddr%frameWidthInCtus+1) < frameWidthInCtus)  )
+      {
+        TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
+        if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
+        {
+          // Top-right is available, so use it.
+          pcSbacDecoder->loadContexts( substreamIdx > 0 ? &m_pcSubstreamSyncContextStates[substreamIdx - 1] : &m_entropyCodingSyncContextState );
+        }
+      }
+    }
+
+#if DECODER_PARTIAL_CONFORMANCE_CHECK != 0
+    const UInt numRemainingBitsPriorToCtu=pcSubstream->getNumBitsLeft();
+#endif
+
+    if ( pcSlice->getSPS()->getUseSAO() )
+    {
+      SAOBlkParam& saoblkParam = (pcPicSym->getSAOBlkParam())[ctuRsAddr];
+      Bool bIsSAOSliceEnabled = false;
+      Bool sliceEnabled[MAX_NUM_COMPONENT];
+      for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
+      {
+        ComponentID compId=ComponentID(comp);
+        sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < pcPic->getNumberValidComponents());
+        if (sliceEnabled[compId])
+        {
+          bIsSAOSliceEnabled=true;
+        }
+        saoblkParam[compId].modeIdc = SAO_MODE_OFF;
+      }
+      if (bIsSAOSliceEnabled)
+      {
+        const Bool leftMergeAvail  = ctuXPosInCtus > 0 && pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-1);
+        const Bool aboveMergeAvail = ctuYPosInCtus > 0 && pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-frameWidthInCtus);
+
+        pcSbacDecoder->parseSAOBlkParam( saoblkParam, sliceEnabled, leftMergeAvail, aboveMergeAvail, pcSlice->getSPS()->getBitDepths());
+      }
+    }
+
+    pcCuDecoder->decodeCtu     ( pCtu, isLastCtuOfSliceSegment );
+
+#if DECODER_PARTIAL_CONFORMANCE_CHECK != 0
+    const UInt numRemainingBitsPostCtu=pcSubstream->getNumBitsLeft();
+    if (TDecConformanceCheck::doChecking() && m_pDecConformanceCheck)
+    {
+      m_pDecConformanceCheck->checkCtuDecoding(numRemainingBitsPriorToCtu-numRemainingBitsPostCtu);
+    }
+#endif
+
+    pcCuDecoder->decompressCtu ( pCtu );
+
+    //Store probabilities of second CTU in line into buffer
+    if ( ctuXPosInCtus == tileXPosInCtus+1 && wavefrontsEnabled)
+    {
+      m_pcSubstreamSyncContextStates[substreamIdx].loadContexts( pcSbacDecoder );
+    }
+
+    m_substreamProgress.set( substreamIdx, ctuXPosInCtus + 1 );
+    if ( m_pcCtuRowProgress )
+    {
+      m_pcCtuRowProgress->increment( ctuYPosInCtus );
+    }
+
+    if (isLastCtuOfSliceSegment)
+    {
+      assert( bLastSubstream );
+#if DECODER_CHECK_SUBSTREAM_AND_SLICE_TRAILING_BYTES
+      pcSbacDecoder->parseRemainingBytes(false);
+#endif
+      *pEndCtuTsAddr = ctuTsAddr+1;
+    }
+    else if (  ctuXPosInCtus + 1 == tileXPosInCtus + currentTile.getTileWidthInCtus() &&
+             ( ctuYPosInCtus + 1 == tileYPosInCtus + currentTile.getTileHeightInCtus() || wavefrontsEnabled)
+            )
+    {
+      // The sub-stream/stream should be terminated after this CTU.
+      // (end of slice-segment, end of tile, end of wavefront-CTU-row)
+      UInt binVal;
+      pcSbacDecoder->parseTerminatingBit( binVal );
+      assert( binVal );
+#if DECODER_CHECK_SUBSTREAM_AND_SLICE_TRAILING_BYTES
+      pcSbacDecoder->parseRemainingBytes(true);
+#endif
+    }
+  }
+
+  assert( isLastCtuOfSliceSegment == bLastSubstream );
+
+  // release any row still waiting for this one, also when the substream ended early on a corrupt bitstream
+  m_substreamProgress.set( substreamIdx, MAX_INT );
+
+  if ( bLastSubstream && pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag() )
+  {
+    m_lastSliceSegmentEndContextState.loadContexts( pcSbacDecoder );//ctx end of dep.slice
+  }
+}
+
 //! \}
@@ -45,10 +45,12 @@
 #include "TLibCommon/CommonDef.h"
 #include "TLibCommon/TComBitStream.h"
 #include "TLibCommon/TComPic.h"
+#include "TLibCommon/TComThreadPool.h"
 #include "TDecEntropy.h"
 #include "TDecCu.h"
 #include "TDecSbac.h"
 #include "TDecBinCoderCABAC.h"
+#include "TDecSliceWorker.h"
 
 //! \ingroup TLibDecoder
 //! \{
@@ -70,15 +72,33 @@ private:
 
   TDecSbac        m_lastSliceSegmentEndContextState;    ///< context storage for state at the end of the previous slice-segment (used for dependent slices only).
   TDecSbac        m_entropyCodingSyncContextState;      ///< context storate for state of contexts at the wavefront/WPP/entropy-coding-sync second CTU of tile-row
+
+  // parallel substream decoding
+  TComThreadPool*   m_pcThreadPool;
+  TDecSliceWorker*  m_pcSliceWorkers;                   ///< decoding engines of each worker thread
+  TDecSbac*         m_pcSubstreamSyncContextStates;     ///< per substream copy of m_entropyCodingSyncContextState, used when substreams are decoded in parallel
+  UInt              m_numSubstreamSyncContextStates;
+  TComRowProgress   m_substreamProgress;                ///< horizontal position reached by each substream of the slice segment
+  TComRowProgress*  m_pcCtuRowProgress;                 ///< number of reconstructed CTUs in each CTU row of the picture, followed by the in-loop filters
+
 public:
   TDecSlice();
   virtual ~TDecSlice();
 
-  Void  init              ( TDecEntropy* pcEntropyDecoder, TDecCu* pcMbDecoder, TDecConformanceCheck *pDecConformanceCheck );
+  Void  init              ( TDecEntropy* pcEntropyDecoder, TDecCu* pcMbDecoder, TDecConformanceCheck *pDecConformanceCheck,
+                            TComThreadPool* pcThreadPool = NULL, TDecSliceWorker* pcSliceWorkers = NULL );
   Void  create            ();
   Void  destroy           ();
 
   Void  decompressSlice   ( TComInputBitstream** ppcSubstreams,   TComPic* pcPic, TDecSbac* pcSbacDecoder );
+
+  Void  setCtuRowProgress ( TComRowProgress* pcCtuRowProgress ) { m_pcCtuRowProgress = pcCtuRowProgress; }
+
+private:
+  Bool  xCanDecompressSubstreamsInParallel ( TComPic* pcPic, std::vector<UInt> &substreamStartCtuTsAddr );
+  Void  xDecompressSubstreamsInParallel    ( TComInputBitstream** ppcSubstreams, TComPic* pcPic, TDecSbac* pcSbacDecoder, const std::vector<UInt> &substreamStartCtuTsAddr );
+  Void  xDecompressSubstream               ( TComInputBitstream* pcSubstream, TComPic* pcPic, const UInt substreamIdx, const UInt substreamStartCtuTsAddr, const UInt substreamEndCtuTsAddr,
+                                             const Bool bLastSubstream, TDecEntropy* pcEntropyDecoder, TDecSbac* pcSbacDecoder, TDecCu* pcCuDecoder, UInt* pEndCtuTsAddr );
 };
 
 //! \}
@@ -63,6 +63,9 @@ TDecTop::TDecTop()
   , m_seiReader()
   , m_cLoopFilter()
   , m_cSAO()
+  , m_numThreads(1)
+  , m_cThreadPool()
+  , m_pcSliceWorkers(NULL)
   , m_pcPic(NULL)
   , m_prevPOC(MAX_INT)
   , m_prevTid0POC(0)
@@ -119,6 +122,12 @@ Void TDecTop::create()
   m_cGopDecoder.create();
   m_apcSlicePilot = new TComSlice;
   m_uiSliceIdx = 0;
+
+  if ( m_numThreads > 1 )
+  {
+    m_pcSliceWorkers = new TDecSliceWorker[m_numThreads];
+    m_cThreadPool.create( m_numThreads );
+  }
 }
 
 Void TDecTop::destroy()
@@ -129,6 +138,10 @@ Void TDecTop::destroy()
   m_apcSlicePilot = NULL;
 
   m_cSliceDecoder.destroy();
+
+  m_cThreadPool.destroy();
+  delete [] m_pcSliceWorkers;
+  m_pcSliceWorkers = NULL;
 }
 
 Void TDecTop::init()
@@ -136,16 +149,22 @@ Void TDecTop::init()
   // initialize ROM
   initROM();
   m_cGopDecoder.init( &m_cEntropyDecoder, &m_cSbacDecoder, &m_cBinCABAC, &m_cCavlcDecoder, &m_cSliceDecoder, &m_cLoopFilter, &m_cSAO);
-  m_cSliceDecoder.init( &m_cEntropyDecoder, &m_cCuDecoder, &m_conformanceCheck );
+  m_cSliceDecoder.init( &m_cEntropyDecoder, &m_cCuDecoder, &m_conformanceCheck, &m_cThreadPool, m_pcSliceWorkers );
 #if MCTS_ENC_CHECK
   m_cEntropyDecoder.init(&m_cPrediction, &m_conformanceCheck );
 #else
   m_cEntropyDecoder.init(&m_cPrediction);
 #endif
+  for ( Int i = 0; i < m_cThreadPool.getNumThreads(); i++ )
+  {
+    m_pcSliceWorkers[i].init( &m_conformanceCheck );
+  }
 }
 
 Void TDecTop::deletePicBuffer ( )
 {
+  m_cGopDecoder.waitForAllPictureHashes();
+
   TComList<TComPic*>::iterator  iterPic   = m_cListPic.begin();
   Int iSize = Int( m_cListPic.size() );
 
@@ -221,6 +240,7 @@ Void TDecTop::xGetNewPicBuffer ( const TComSPS &sps, const TComPPS &pps, TComPic
     rpcPic = new TComPic();
     m_cListPic.pushBack( rpcPic );
   }
+  m_cGopDecoder.waitForPictureHash( rpcPic );
   rpcPic->destroy();
 #if REDUCED_ENCODER_MEMORY
 #if SHUTTER_INTERVAL_SEI_PROCESSING
@@ -255,6 +275,10 @@ Void TDecTop::executeLoopFilters(Int& poc, TComList<TComPic*>*& rpcListPic)
   poc                 = pcPic->getSlice(m_uiSliceIdx-1)->getPOC();
   rpcListPic          = &m_cListPic;
   m_cCuDecoder.destroy();
+  for ( Int i = 0; i < m_cThreadPool.getNumThreads(); i++ )
+  {
+    m_pcSliceWorkers[i].destroy();
+  }
   m_bFirstSliceInPicture  = true;
 
   return;
@@ -384,8 +408,8 @@ Void TDecTop::xActivateParameterSets()
     sps=pSlice->getSPS();
 
     // Initialise the various objects for the new set of settings
-    m_cSAO.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), sps->getMaxCUWidth(), sps->getMaxCUHeight(), sps->getMaxTotalCUDepth(), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_LUMA), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_CHROMA) );
-    m_cLoopFilter.create( sps->getMaxTotalCUDepth() );
+    m_cSAO.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), sps->getMaxCUWidth(), sps->getMaxCUHeight(), sps->getMaxTotalCUDepth(), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_LUMA), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_CHROMA), &m_cThreadPool );
+    m_cLoopFilter.create( sps->getMaxTotalCUDepth(), &m_cThreadPool );
     m_cPrediction.initTempBuff(sps->getChromaFormatIdc());
 
 
@@ -423,6 +447,10 @@ Void TDecTop::xActivateParameterSets()
       m_cCuDecoder.init(&m_cEntropyDecoder, &m_cTrQuant, &m_cPrediction);
   #endif
       m_cTrQuant.init     ( sps->getMaxTrSize() );
+      for ( Int i = 0; i < m_cThreadPool.getNumThreads(); i++ )
+      {
+        m_pcSliceWorkers[i].create( *sps );
+      }
 
       m_cSliceDecoder.create();
     }
@@ -762,6 +790,32 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
   }
 
   m_pcPic->setCurrSliceIdx(m_uiSliceIdx);
+  xSetScalingList( m_cTrQuant, pcSlice );
+  if ( pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() || pcSlice->getPPS()->getNumTileColumnsMinus1() > 0 || pcSlice->getPPS()->getNumTileRowsMinus1() > 0 )
+  {
+    // the worker threads may decode some of the substreams of this slice segment
+    for ( Int i = 0; i < m_cThreadPool.getNumThreads(); i++ )
+    {
+      xSetScalingList( *m_pcSliceWorkers[i].getTrQuant(), pcSlice );
+    }
+  }
+
+  if (m_bFirstSliceInPicture)
+  {
+    m_cGopDecoder.startFilterPicture(m_pcPic);
+  }
+
+  //  Decode a picture
+  m_cGopDecoder.decompressSlice(&(nalu.getBitstream()), m_pcPic);
+
+  m_bFirstSliceInPicture = false;
+  m_uiSliceIdx++;
+
+  return false;
+}
+
+Void TDecTop::xSetScalingList( TComTrQuant &trQuant, const TComSlice *pcSlice )
+{
   if(pcSlice->getSPS()->getScalingListFlag())
   {
     TComScalingList scalingList;
@@ -777,8 +831,8 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     {
       scalingList.setDefaultScalingList();
     }
-    m_cTrQuant.setScalingListDec(scalingList);
-    m_cTrQuant.setUseScalingList(true);
+    trQuant.setScalingListDec(scalingList);
+    trQuant.setUseScalingList(true);
   }
   else
   {
@@ -787,17 +841,9 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
         pcSlice->getSPS()->getMaxLog2TrDynamicRange(CHANNEL_TYPE_LUMA),
         pcSlice->getSPS()->getMaxLog2TrDynamicRange(CHANNEL_TYPE_CHROMA)
     };
-    m_cTrQuant.setFlatScalingList(maxLog2TrDynamicRange, pcSlice->getSPS()->getBitDepths());
-    m_cTrQuant.setUseScalingList(false);
+    trQuant.setFlatScalingList(maxLog2TrDynamicRange, pcSlice->getSPS()->getBitDepths());
+    trQuant.setUseScalingList(false);
   }
-
-  //  Decode a picture
-  m_cGopDecoder.decompressSlice(&(nalu.getBitstream()), m_pcPic);
-
-  m_bFirstSliceInPicture = false;
-  m_uiSliceIdx++;
-
-  return false;
 }
 
 Void TDecTop::xDecodeVPS(const std::vector<UChar> &naluData)
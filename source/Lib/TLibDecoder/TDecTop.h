@@ -45,8 +45,10 @@
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/TComPrediction.h"
 #include "TLibCommon/SEI.h"
+#include "TLibCommon/TComThreadPool.h"
 
 #include "TDecGop.h"
+#include "TDecSliceWorker.h"
 #include "TDecEntropy.h"
 #include "TDecSbac.h"
 #include "TDecCAVLC.h"
@@ -92,6 +94,9 @@ private:
   TComLoopFilter          m_cLoopFilter;
   TComSampleAdaptiveOffset m_cSAO;
   TDecConformanceCheck    m_conformanceCheck;
+  Int                     m_numThreads;        ///< number of worker threads for parallel substream decoding
+  TComThreadPool          m_cThreadPool;       ///< worker threads for parallel substream decoding
+  TDecSliceWorker*        m_pcSliceWorkers;    ///< decoding engines used by each worker thread
 
   Bool isSkipPictureForBLA(Int& iPOCLastDisplay);
   Bool isRandomAccessSkipPicture(Int& iSkipFrame,  Int& iPOCLastDisplay);
@@ -135,6 +140,12 @@ public:
   Void  destroy ();
 
   Void setDecodedPictureHashSEIEnabled(Int enabled) { m_cGopDecoder.setDecodedPictureHashSEIEnabled(enabled); }
+  /// set before create(); the WPP rows and tiles of a slice segment are decoded in parallel when greater than 1
+  Void  setNumThreads (Int i)                { m_numThreads = i; }
+  /// set before create(); deblocking and SAO then follow the reconstruction on a separate thread, and the decoded picture hash is checked while the next picture is decoded
+  Void  setPipelinedFiltering (Bool b)       { m_cGopDecoder.setPipelinedFiltering(b); }
+  /// with pipelined filtering, the hash of a returned picture may still be checked: call before destroying pictures of the list
+  Void  waitForPictureHashes ()              { m_cGopDecoder.waitForAllPictureHashes(); }
 #if MCTS_ENC_CHECK
   Void setTMctsCheckEnabled(Bool enabled) { m_tmctsCheckEnabled = enabled; }
 
@@ -183,6 +194,7 @@ protected:
   Void      xDecodeVPS(const std::vector<UChar> &naluData);
   Void      xDecodeSPS(const std::vector<UChar> &naluData);
   Void      xDecodePPS(const std::vector<UChar> &naluData);
+  Void      xSetScalingList( TComTrQuant &trQuant, const TComSlice *pcSlice );
   Void      xUpdatePreviousTid0POC( TComSlice *pSlice ) { if ((pSlice->getTLayer()==0) && (pSlice->isReferenceNalu() && (pSlice->getNalUnitType()!=NAL_UNIT_CODED_SLICE_RASL_R)&& (pSlice->getNalUnitType()!=NAL_UNIT_CODED_SLICE_RADL_R))) { m_prevTid0POC=pSlice->getPOC(); } }
 #if MCTS_EXTRACTION
 public:
@@ -34,6 +34,7 @@
 #include <vector>
 #include <algorithm>
 #include <ostream>
+#include <cstring>
 
 #include "TLibCommon/NAL.h"
 #include "TLibCommon/TComBitStream.h"
@@ -90,9 +91,27 @@ Void write(ostream& out, OutputNALUnit& nalu)
   outputBuffer.resize(rbsp.size()*2+1); //there can never be enough emulation_prevention_three_bytes to require this much space
   std::size_t outputAmount = 0;
   Int         zeroCount    = 0;
-  for (vector<uint8_t>::iterator it = rbsp.begin(); it != rbsp.end(); it++)
+  const uint8_t* const data = rbsp.empty() ? NULL : &rbsp[0];
+  const std::size_t    end  = rbsp.size();
+  std::size_t          pos  = 0;
+  while (pos < end)
   {
-    const uint8_t v=(*it);
+    if (zeroCount == 0)
+    {
+      /* an emulation_prevention_three_byte can only follow two zero bytes:
+       * copy the bytes up to the next zero byte in bulk */
+      const uint8_t*    zero = static_cast<const uint8_t*>(memchr(data + pos, 0, end - pos));
+      const std::size_t num  = zero ? std::size_t(zero - (data + pos)) : end - pos;
+      memcpy(&outputBuffer[outputAmount], data + pos, num);
+      outputAmount += num;
+      pos          += num;
+      if (!zero)
+      {
+        break;
+      }
+    }
+
+    const uint8_t v=data[pos++];
     if (zeroCount==2 && v<=3)
     {
       outputBuffer[outputAmount++]=emulation_prevention_three_byte[0];
@@ -70,7 +70,7 @@ Void TEncBinCABAC::start()
 {
   m_uiLow            = 0;
   m_uiRange          = 510;
-  m_bitsLeft         = 23;
+  m_bitsLeft         = 32;
   m_numBufferedBytes = 0;
   m_bufferedByte     = 0xff;
 #if FAST_BIT_EST
@@ -80,7 +80,10 @@ Void TEncBinCABAC::start()
 
 Void TEncBinCABAC::finish()
 {
-  if ( m_uiLow >> ( 32 - m_bitsLeft ) )
+  // bits of m_uiLow above the 9 bits of the range, below the carry
+  const Int numBits = 32 - m_bitsLeft;
+
+  if ( m_uiLow >> ( numBits + 9 ) )
   {
     //assert( m_numBufferedBytes > 0 );
     //assert( m_bufferedByte != 0xff );
@@ -90,7 +93,7 @@ Void TEncBinCABAC::finish()
       m_pcTComBitIf->write( 0x00, 8 );
       m_numBufferedBytes--;
     }
-    m_uiLow -= 1 << ( 32 - m_bitsLeft );
+    m_uiLow -= UInt64( 1 ) << ( numBits + 9 );
   }
   else
   {
@@ -104,7 +107,7 @@ Void TEncBinCABAC::finish()
       m_numBufferedBytes--;
     }
   }
-  m_pcTComBitIf->write( m_uiLow >> 8, 24 - m_bitsLeft );
+  m_pcTComBitIf->write( UInt( m_uiLow >> 8 ), numBits + 1 );
 }
 
 Void TEncBinCABAC::flush()
@@ -161,7 +164,7 @@ Void TEncBinCABAC::copyState( const TEncBinIf* pcTEncBinIf )
 Void TEncBinCABAC::resetBits()
 {
   m_uiLow            = 0;
-  m_bitsLeft         = 23;
+  m_bitsLeft         = 32;
   m_numBufferedBytes = 0;
   m_bufferedByte     = 0xff;
   if ( m_binCountIncrement )
@@ -175,7 +178,7 @@ Void TEncBinCABAC::resetBits()
 
 UInt TEncBinCABAC::getNumWrittenBits()
 {
-  return m_pcTComBitIf->getNumberOfWrittenBits() + 8 * m_numBufferedBytes + 23 - m_bitsLeft;
+  return m_pcTComBitIf->getNumberOfWrittenBits() + 8 * m_numBufferedBytes + 32 - m_bitsLeft;
 }
 
 /**
@@ -313,14 +316,14 @@ Void TEncBinCABAC::encodeBinsEP( UInt binValues, Int numBins )
     return;
   }
 
-  while ( numBins > 8 )
+  while ( numBins > 16 )
   {
-    numBins -= 8;
+    numBins -= 16;
     UInt pattern = binValues >> numBins;
-    m_uiLow <<= 8;
+    m_uiLow <<= 16;
     m_uiLow += m_uiRange * pattern;
     binValues -= pattern << numBins;
-    m_bitsLeft -= 8;
+    m_bitsLeft -= 16;
 
     testAndWriteOut();
   }
@@ -345,7 +348,7 @@ Void TEncBinCABAC::encodeAlignedBinsEP( UInt binValues, Int numBins )
 
   while (binsRemaining > 0)
   {
-    const UInt binsToCode = std::min<UInt>(binsRemaining, 8); //code bytes if able to take advantage of the system's byte-write function
+    const UInt binsToCode = std::min<UInt>(binsRemaining, 16); //at most as many bins as m_uiLow takes between two checks
     const UInt binMask    = (1 << binsToCode) - 1;
 
     const UInt newBins = (binValues >> (binsRemaining - binsToCode)) & binMask;
@@ -365,7 +368,7 @@ Void TEncBinCABAC::encodeAlignedBinsEP( UInt binValues, Int numBins )
     //
     //  this can be generalised for multiple bins, producing the following expression:
     //
-    m_uiLow = (m_uiLow << binsToCode) + (newBins << 8); //range is known to be 256
+    m_uiLow = (m_uiLow << binsToCode) + (UInt64(newBins) << 8); //range is known to be 256
 
     binsRemaining -= binsToCode;
     m_bitsLeft    -= binsToCode;
@@ -406,47 +409,89 @@ Void TEncBinCABAC::encodeBinTrm( UInt binValue )
 
 Void TEncBinCABAC::testAndWriteOut()
 {
-  if ( m_bitsLeft < 12 )
+  if ( m_bitsLeft <= 0 )
   {
     writeOut();
   }
 }
 
 /**
- * \brief Move bits from register into bitstream
+ * \brief Move the whole bytes above the range from register into bitstream
+ *
+ * The last byte that is not 0xff and the 0xff bytes following it are held back in m_bufferedByte and
+ * m_numBufferedBytes, since a carry out of m_uiLow still changes them. All other bytes are final and written at once.
  */
 Void TEncBinCABAC::writeOut()
 {
-  UInt leadByte = m_uiLow >> (24 - m_bitsLeft);
-  m_bitsLeft += 8;
-  m_uiLow &= 0xffffffffu >> m_bitsLeft;
-
-  if ( leadByte == 0xff )
+  // the bytes lie above the 9 bits of the range and the bits that do not make up a byte
+  const Int    numBits   = 32 - m_bitsLeft;
+  const Int    numBytes  = numBits >> 3;
+  const Int    shift     = ( numBits & 7 ) + 9;
+  const UInt64 leadBytes = m_uiLow >> shift;
+  const UInt   carry     = UInt( leadBytes >> ( numBytes << 3 ) );
+  m_uiLow    &= ( UInt64( 1 ) << shift ) - 1;
+  m_bitsLeft += numBytes << 3;
+
+  Int numTrailingFF = 0;
+  while ( numTrailingFF < numBytes && ( ( leadBytes >> ( numTrailingFF << 3 ) ) & 0xff ) == 0xff )
   {
-    m_numBufferedBytes++;
+    numTrailingFF++;
   }
-  else
+
+  if ( numTrailingFF == numBytes )
   {
-    if ( m_numBufferedBytes > 0 )
+    if ( carry )
     {
-      UInt carry = leadByte >> 8;
-      UInt byte = m_bufferedByte + carry;
-      m_bufferedByte = leadByte & 0xff;
-      m_pcTComBitIf->write( byte, 8 );
-
-      byte = ( 0xff + carry ) & 0xff;
+      m_pcTComBitIf->write( m_bufferedByte + 1, 8 );
       while ( m_numBufferedBytes > 1 )
       {
-        m_pcTComBitIf->write( byte, 8 );
+        m_pcTComBitIf->write( 0x00, 8 );
         m_numBufferedBytes--;
       }
+      m_bufferedByte     = 0xff;
+      m_numBufferedBytes = numBytes;
     }
     else
     {
-      m_numBufferedBytes = 1;
-      m_bufferedByte = leadByte;
+      m_numBufferedBytes += numBytes;
     }
+    return;
   }
+
+  // the bytes before the last byte that is not 0xff
+  const Int numFinalBytes = numBytes - numTrailingFF - 1;
+  UInt64    finalBytes    = ( leadBytes >> ( ( numTrailingFF + 1 ) << 3 ) ) & ( ( UInt64( 1 ) << ( numFinalBytes << 3 ) ) - 1 );
+  Int       numBytesToWrite = numFinalBytes;
+
+  if ( m_numBufferedBytes == 1 )
+  {
+    finalBytes |= UInt64( m_bufferedByte + carry ) << ( numFinalBytes << 3 );
+    numBytesToWrite++;
+  }
+  else if ( m_numBufferedBytes > 1 )
+  {
+    m_pcTComBitIf->write( m_bufferedByte + carry, 8 );
+
+    const UInt byte = ( 0xff + carry ) & 0xff;
+    while ( m_numBufferedBytes > 1 )
+    {
+      m_pcTComBitIf->write( byte, 8 );
+      m_numBufferedBytes--;
+    }
+  }
+
+  if ( numBytesToWrite > 4 )
+  {
+    m_pcTComBitIf->write( UInt( finalBytes >> 32 ), ( numBytesToWrite - 4 ) << 3 );
+    numBytesToWrite = 4;
+  }
+  if ( numBytesToWrite > 0 )
+  {
+    m_pcTComBitIf->write( UInt( finalBytes & 0xffffffffu ), numBytesToWrite << 3 );
+  }
+
+  m_bufferedByte     = UInt( leadBytes >> ( numTrailingFF << 3 ) ) & 0xff;
+  m_numBufferedBytes = numTrailingFF + 1;
 }
 
 //! \}
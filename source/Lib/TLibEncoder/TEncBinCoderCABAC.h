@@ -93,11 +93,11 @@ private:
   Void writeOut();
 
   TComBitIf*          m_pcTComBitIf;
-  UInt                m_uiLow;
+  UInt64              m_uiLow;
   UInt                m_uiRange;
   UInt                m_bufferedByte;
   Int                 m_numBufferedBytes;
-  Int                 m_bitsLeft;
+  Int                 m_bitsLeft;          ///< number of bits m_uiLow takes before whole bytes are written out
   UInt                m_uiBinsCoded;
   Int                 m_binCountIncrement;
 #if FAST_BIT_EST
@@ -223,6 +223,9 @@ protected:
   Int       m_bipredSearchRange;
   Bool      m_bClipForBiPredMeEnabled;
   Bool      m_bFastMEAssumingSmootherMVEnabled;
+  Bool      m_bPreMotionSearchEnabled;
+  Bool      m_bUseSubPelPlanes;
+  Bool      m_bUseMotionSearchCache;
   Int       m_minSearchWindow;
   Bool      m_bRestrictMESampling;
 
@@ -260,6 +263,9 @@ protected:
   Bool      m_useFastDecisionForMerge;
   Bool      m_bUseCbfFastMode;
   Bool      m_useEarlySkipDetection;
+  Int       m_cuSplitClassifier;
+  std::string m_cuSplitThresholdFileName;
+  std::string m_cuSplitStatsFileName;
   Bool      m_crossComponentPredictionEnabledFlag;
   Bool      m_reconBasedCrossCPredictionEstimate;
   UInt      m_log2SaoOffsetScale[MAX_NUM_CHANNEL_TYPE];
@@ -311,6 +317,8 @@ protected:
   std::vector<Int> m_tileRowHeight;
 
   Bool      m_entropyCodingSyncEnabledFlag;
+  Int       m_numThreads;                                     ///< number of worker threads for parallel CTU compression
+  Int       m_numParallelPictures;                            ///< maximum number of independent pictures compressed concurrently
 
   HashType  m_decodedPictureHashSEIType;
   Bool      m_bufferingPeriodSEIEnabled;
@@ -553,6 +561,8 @@ public:
   TEncCfg()
   : m_tileColumnWidth()
   , m_tileRowHeight()
+  , m_numThreads(1)
+  , m_numParallelPictures(1)
   {
     m_PCMBitDepth[CHANNEL_TYPE_LUMA]=8;
     m_PCMBitDepth[CHANNEL_TYPE_CHROMA]=8;
@@ -629,6 +639,9 @@ public:
   Void      setMaxCUWidth                   ( UInt  u )      { m_maxCUWidth  = u; }
   Void      setMaxCUHeight                  ( UInt  u )      { m_maxCUHeight = u; }
   Void      setMaxTotalCUDepth              ( UInt  u )      { m_maxTotalCUDepth = u; }
+  UInt      getMaxCUWidth                   () const         { return m_maxCUWidth; }
+  UInt      getMaxCUHeight                  () const         { return m_maxCUHeight; }
+  UInt      getMaxTotalCUDepth              () const         { return m_maxTotalCUDepth; }
   Void      setLog2DiffMaxMinCodingBlockSize( UInt  u )      { m_log2DiffMaxMinCodingBlockSize = u; }
 
   //======== Transform =============
@@ -653,6 +666,9 @@ public:
   Void      setBipredSearchRange            ( Int   i )      { m_bipredSearchRange = i; }
   Void      setClipForBiPredMeEnabled       ( Bool  b )      { m_bClipForBiPredMeEnabled = b; }
   Void      setFastMEAssumingSmootherMVEnabled ( Bool b )    { m_bFastMEAssumingSmootherMVEnabled = b; }
+  Void      setPreMotionSearchEnabled       ( Bool  b )      { m_bPreMotionSearchEnabled = b; }
+  Void      setUseSubPelPlanes              ( Bool  b )      { m_bUseSubPelPlanes = b; }
+  Void      setUseMotionSearchCache         ( Bool  b )      { m_bUseMotionSearchCache = b; }
   Void      setMinSearchWindow              ( Int   i )      { m_minSearchWindow = i; }
   Void      setRestrictMESampling           ( Bool  b )      { m_bRestrictMESampling = b; }
 
@@ -757,8 +773,12 @@ public:
   Bool      getDisableIntraPUsInInterSlices    () const { return m_bDisableIntraPUsInInterSlices; }
   MESearchMethod getMotionEstimationSearchMethod ( ) const { return m_motionEstimationSearchMethod; }
   Int       getSearchRange                     () const { return m_iSearchRange; }
+  Int       getBipredSearchRange               () const { return m_bipredSearchRange; }
   Bool      getClipForBiPredMeEnabled          () const { return m_bClipForBiPredMeEnabled; }
   Bool      getFastMEAssumingSmootherMVEnabled () const { return m_bFastMEAssumingSmootherMVEnabled; }
+  Bool      getPreMotionSearchEnabled          () const { return m_bPreMotionSearchEnabled; }
+  Bool      getUseSubPelPlanes                 () const { return m_bUseSubPelPlanes; }
+  Bool      getUseMotionSearchCache            () const { return m_bUseMotionSearchCache; }
   Int       getMinSearchWindow                 () const { return m_minSearchWindow; }
   Bool      getRestrictMESampling              () const { return m_bRestrictMESampling; }
 
@@ -781,6 +801,9 @@ public:
   Void      setUseFastDecisionForMerge      ( Bool  b )     { m_useFastDecisionForMerge = b; }
   Void      setUseCbfFastMode               ( Bool  b )     { m_bUseCbfFastMode = b; }
   Void      setUseEarlySkipDetection        ( Bool  b )     { m_useEarlySkipDetection = b; }
+  Void      setCuSplitClassifier            ( Int   i )     { m_cuSplitClassifier = i; }
+  Void      setCuSplitThresholdFileName     ( const std::string &s ) { m_cuSplitThresholdFileName = s; }
+  Void      setCuSplitStatsFileName         ( const std::string &s ) { m_cuSplitStatsFileName = s; }
   Void      setUseConstrainedIntraPred      ( Bool  b )     { m_bUseConstrainedIntraPred = b; }
   Void      setFastUDIUseMPMEnabled         ( Bool  b )     { m_bFastUDIUseMPMEnabled = b; }
   Void      setFastMEForGenBLowDelayEnabled ( Bool  b )     { m_bFastMEForGenBLowDelayEnabled = b; }
@@ -806,6 +829,9 @@ public:
   Bool      getUseFastDecisionForMerge      ()      { return m_useFastDecisionForMerge; }
   Bool      getUseCbfFastMode               ()      { return m_bUseCbfFastMode; }
   Bool      getUseEarlySkipDetection        ()      { return m_useEarlySkipDetection; }
+  Int       getCuSplitClassifier            () const { return m_cuSplitClassifier; }
+  const std::string& getCuSplitThresholdFileName() const { return m_cuSplitThresholdFileName; }
+  const std::string& getCuSplitStatsFileName() const { return m_cuSplitStatsFileName; }
   Bool      getUseConstrainedIntraPred      ()      { return m_bUseConstrainedIntraPred; }
   Bool      getFastUDIUseMPMEnabled         ()      { return m_bFastUDIUseMPMEnabled; }
   Bool      getFastMEForGenBLowDelayEnabled ()      { return m_bFastMEForGenBLowDelayEnabled; }
@@ -888,6 +914,10 @@ public:
   Void  xCheckGSParameters();
   Void  setEntropyCodingSyncEnabledFlag(Bool b)                      { m_entropyCodingSyncEnabledFlag = b; }
   Bool  getEntropyCodingSyncEnabledFlag() const                      { return m_entropyCodingSyncEnabledFlag; }
+  Void  setNumThreads(Int i)                                         { m_numThreads = i; }
+  Int   getNumThreads() const                                        { return m_numThreads; }
+  Void  setNumParallelPictures(Int i)                                { m_numParallelPictures = i; }
+  Int   getNumParallelPictures() const                               { return m_numParallelPictures; }
   Void  setDecodedPictureHashSEIType(HashType m)                     { m_decodedPictureHashSEIType = m; }
   HashType getDecodedPictureHashSEIType() const                      { return m_decodedPictureHashSEIType; }
   Void  setBufferingPeriodSEIEnabled(Bool b)                         { m_bufferingPeriodSEIEnabled = b; }
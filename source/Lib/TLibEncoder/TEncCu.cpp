@@ -205,18 +205,29 @@ Void TEncCu::destroy()
  */
 Void TEncCu::init( TEncTop* pcEncTop )
 {
-  m_pcEncCfg           = pcEncTop;
-  m_pcPredSearch       = pcEncTop->getPredSearch();
-  m_pcTrQuant          = pcEncTop->getTrQuant();
-  m_pcRdCost           = pcEncTop->getRdCost();
+  init( pcEncTop, pcEncTop->getPredSearch(), pcEncTop->getTrQuant(), pcEncTop->getRdCost(),
+        pcEncTop->getEntropyCoder(), pcEncTop->getBinCABAC(), pcEncTop->getRDSbacCoder(),
+        pcEncTop->getRDGoOnSbacCoder(), pcEncTop->getRateCtrl() );
+  m_pcSplitClassifier = pcEncTop->getCuSplitClassifier();
+}
+
+Void TEncCu::init( TEncCfg* pcEncCfg, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost,
+                   TEncEntropy* pcEntropyCoder, TEncBinCABAC* pcBinCABAC, TEncSbac*** pppcRDSbacCoder,
+                   TEncSbac* pcRDGoOnSbacCoder, TEncRateCtrl* pcRateCtrl )
+{
+  m_pcEncCfg           = pcEncCfg;
+  m_pcPredSearch       = pcPredSearch;
+  m_pcTrQuant          = pcTrQuant;
+  m_pcRdCost           = pcRdCost;
 
-  m_pcEntropyCoder     = pcEncTop->getEntropyCoder();
-  m_pcBinCABAC         = pcEncTop->getBinCABAC();
+  m_pcEntropyCoder     = pcEntropyCoder;
+  m_pcBinCABAC         = pcBinCABAC;
 
-  m_pppcRDSbacCoder    = pcEncTop->getRDSbacCoder();
-  m_pcRDGoOnSbacCoder  = pcEncTop->getRDGoOnSbacCoder();
+  m_pppcRDSbacCoder    = pppcRDSbacCoder;
+  m_pcRDGoOnSbacCoder  = pcRDGoOnSbacCoder;
 
-  m_pcRateCtrl         = pcEncTop->getRateCtrl();
+  m_pcRateCtrl         = pcRateCtrl;
+  m_pcSplitClassifier  = NULL;
   m_lumaQPOffset       = 0;
   initLumaDeltaQpLUT();
 #if JVET_V0078
@@ -237,6 +248,7 @@ Void TEncCu::compressCtu( TComDataCU* pCtu )
   m_ppcBestCU[0]->initCtu( pCtu->getPic(), pCtu->getCtuRsAddr() );
   m_ppcTempCU[0]->initCtu( pCtu->getPic(), pCtu->getCtuRsAddr() );
   m_bEncodeDQP         = false;
+  m_pcPredSearch->resetMotionCache();
 
   // analysis of CU
   DEBUG_STRING_NEW(sDebug)
@@ -637,7 +649,20 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
 
   const Bool bBoundary = !( uiRPelX < sps.getPicWidthInLumaSamples() && uiBPelY < sps.getPicHeightInLumaSamples() );
 
-  if ( !bBoundary )
+  // early split: the modes of this depth are not tested. Only allowed where the split is tested below, which the
+  // first pass of the fast delta QP search does not do for CUs of at most fastDeltaQPCuMaxSize.
+  const Bool bUseSplitClassifier = m_pcSplitClassifier != NULL && !bBoundary && uiDepth < sps.getLog2DiffMaxMinCodingBlockSize()
+                                && ( m_pcSplitClassifier->isEarlyTerminateEnabled() || m_pcSplitClassifier->isCollectingStats() );
+  CuSplitFeatures splitFeatures;
+  Bool bEarlySplit = false;
+  if ( bUseSplitClassifier )
+  {
+    xGetSplitFeatures( rpcBestCU, uiDepth, splitFeatures );
+    bEarlySplit = m_pcSplitClassifier->isEarlySplitEnabled() && ( !getFastDeltaQp() || uiWidth > fastDeltaQPCuMaxSize )
+               && m_pcSplitClassifier->predictSplit( splitFeatures );
+  }
+
+  if ( !bBoundary && !bEarlySplit )
   {
     for (Int iQP=iMinQP; iQP<=iMaxQP; iQP++)
     {
@@ -966,9 +991,20 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
     iMaxQP = iMinQP; // If all TUs are forced into using transquant bypass, do not loop here.
   }
 
+  // early termination: the split is not tested
+  Bool bEarlyTerminate = false;
+  if ( bUseSplitClassifier && !bEarlySplit && rpcBestCU->getTotalCost()!=MAX_DOUBLE )
+  {
+    splitFeatures.satd    = xGetBestModeSatd( rpcBestCU, uiDepth );
+    splitFeatures.skipped = rpcBestCU->isSkipped(0);
+    bEarlyTerminate = m_pcSplitClassifier->isEarlyTerminateEnabled() && m_pcSplitClassifier->predictNoSplit( splitFeatures );
+  }
+
   const Bool bSubBranch = bBoundary || !( m_pcEncCfg->getUseEarlyCU() && rpcBestCU->getTotalCost()!=MAX_DOUBLE && rpcBestCU->isSkipped(0) );
+  const Bool bTestSplit = bSubBranch && !bEarlyTerminate && uiDepth < sps.getLog2DiffMaxMinCodingBlockSize() && (!getFastDeltaQp() || uiWidth > fastDeltaQPCuMaxSize || bBoundary);
+  const Bool bAddSplitStats = bUseSplitClassifier && !bEarlySplit && bTestSplit && rpcBestCU->getTotalCost()!=MAX_DOUBLE && m_pcSplitClassifier->isCollectingStats();
 
-  if( bSubBranch && uiDepth < sps.getLog2DiffMaxMinCodingBlockSize() && (!getFastDeltaQp() || uiWidth > fastDeltaQPCuMaxSize || bBoundary))
+  if( bTestSplit )
   {
     // further split
     Double splitTotalCost = 0;
@@ -1131,6 +1167,11 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
 
   DEBUG_STRING_APPEND(sDebug_, sDebug);
 
+  if ( bAddSplitStats )
+  {
+    m_pcSplitClassifier->addStats( splitFeatures, rpcBestCU->getDepth(0) > uiDepth );
+  }
+
   rpcBestCU->copyToPic(uiDepth);                                                     // Copy Best data to Picture for next partition prediction.
 
   xCopyYuv2Pic( rpcBestCU->getPic(), rpcBestCU->getCtuRsAddr(), rpcBestCU->getZorderIdxInCtu(), uiDepth, uiDepth );   // Copy Yuv data to picture Yuv
@@ -1847,6 +1888,86 @@ Void TEncCu::xCheckDQP( TComDataCU* pcCU )
   }
 }
 
+/** Compute the features of a CU available before its modes are tested: the luma variance of the original samples and
+ *  the sizes of the neighbouring CUs
+ * \param pcCU     CU data structure
+ * \param uiDepth  depth of the CU
+ * \param features features to be filled in
+ */
+Void TEncCu::xGetSplitFeatures( TComDataCU* pcCU, UInt uiDepth, CuSplitFeatures &features )
+{
+  const TComYuv* pcOrgYuv = m_ppcOrigYuv[uiDepth];
+  const Pel*     piOrg    = pcOrgYuv->getAddr( COMPONENT_Y );
+  const Int      iStride  = pcOrgYuv->getStride( COMPONENT_Y );
+  const Int      iWidth   = pcCU->getWidth( 0 );
+  const Int      iHeight  = pcCU->getHeight( 0 );
+
+  Int64 iSum   = 0;
+  Int64 iSumSq = 0;
+  for( Int y = 0; y < iHeight; y++, piOrg += iStride )
+  {
+    for( Int x = 0; x < iWidth; x++ )
+    {
+      iSum   += piOrg[x];
+      iSumSq += piOrg[x] * piOrg[x];
+    }
+  }
+  const Double dNumSamples = Double( iWidth * iHeight );
+  const Double dVariance   = ( Double( iSumSq ) - Double( iSum ) * Double( iSum ) / dNumSamples ) / dNumSamples;
+
+  features.log2CuSize = g_aucConvertToBit[iWidth] + 2;
+  features.intraSlice = pcCU->getSlice()->isIntra();
+  features.variance   = dVariance / m_pcRdCost->getLambda();
+  features.satd       = 0;
+  features.skipped    = false;
+
+  // left, above, above-left and above-right CUs
+  const UInt        uiAbsPartIdx   = pcCU->getZorderIdxInCtu();
+  const UInt        uiNumPartsW    = iWidth / pcCU->getPic()->getMinCUWidth();
+  const UInt        uiAbsPartIdxTR = g_auiRasterToZscan[ g_auiZscanToRaster[uiAbsPartIdx] + uiNumPartsW - 1 ];
+  UInt              auiPartIdx[4];
+  const TComDataCU* apcNeighbour[4] =
+  {
+    pcCU->getPULeft      ( auiPartIdx[0], uiAbsPartIdx ),
+    pcCU->getPUAbove     ( auiPartIdx[1], uiAbsPartIdx ),
+    pcCU->getPUAboveLeft ( auiPartIdx[2], uiAbsPartIdx ),
+    pcCU->getPUAboveRight( auiPartIdx[3], uiAbsPartIdxTR )
+  };
+
+  features.numNeighbours        = 0;
+  features.minNeighbourLog2Size = MAX_INT;
+  features.maxNeighbourLog2Size = -1;
+  for( Int i = 0; i < 4; i++ )
+  {
+    if( apcNeighbour[i] != NULL )
+    {
+      const Int iNeighbourLog2Size = g_aucConvertToBit[ apcNeighbour[i]->getWidth( auiPartIdx[i] ) ] + 2;
+      features.numNeighbours++;
+      features.minNeighbourLog2Size = std::min( features.minNeighbourLog2Size, iNeighbourLog2Size );
+      features.maxNeighbourLog2Size = std::max( features.maxNeighbourLog2Size, iNeighbourLog2Size );
+    }
+  }
+}
+
+/** Compute the luma Hadamard SATD per sample of the prediction error of the best mode of a CU, divided by sqrt(lambda)
+ * \param pcCU     CU data structure holding the best mode
+ * \param uiDepth  depth of the CU
+ * \returns the normalised SATD
+ */
+Double TEncCu::xGetBestModeSatd( TComDataCU* pcCU, UInt uiDepth )
+{
+  const TComYuv*   pcOrgYuv  = m_ppcOrigYuv[uiDepth];
+  const TComYuv*   pcPredYuv = m_ppcPredYuvBest[uiDepth];
+  const UInt       uiWidth   = pcCU->getWidth( 0 );
+  const UInt       uiHeight  = pcCU->getHeight( 0 );
+  const Distortion uiSatd    = m_pcRdCost->getDistPart( pcCU->getSlice()->getSPS()->getBitDepth( CHANNEL_TYPE_LUMA ),
+                                                        pcPredYuv->getAddr( COMPONENT_Y ), pcPredYuv->getStride( COMPONENT_Y ),
+                                                        pcOrgYuv->getAddr( COMPONENT_Y ), pcOrgYuv->getStride( COMPONENT_Y ),
+                                                        uiWidth, uiHeight, COMPONENT_Y, DF_HADS );
+
+  return Double( uiSatd ) / ( Double( uiWidth * uiHeight ) * m_pcRdCost->getSqrtLambda() );
+}
+
 Void TEncCu::xCopyAMVPInfo (AMVPInfo* pSrc, AMVPInfo* pDst)
 {
   pDst->iN = pSrc->iN;
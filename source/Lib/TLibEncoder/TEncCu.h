@@ -49,6 +49,7 @@
 #include "TEncEntropy.h"
 #include "TEncSearch.h"
 #include "TEncRateCtrl.h"
+#include "TEncCuSplitClassifier.h"
 //! \ingroup TLibEncoder
 //! \{
 
@@ -115,13 +116,19 @@ private:
   TEncSbac***             m_pppcRDSbacCoder;
   TEncSbac*               m_pcRDGoOnSbacCoder;
   TEncRateCtrl*           m_pcRateCtrl;
+  TEncCuSplitClassifier*  m_pcSplitClassifier;
 
 public:
   /// copy parameters from encoder class
   Void  init                ( TEncTop* pcEncTop );
+  /// use an explicit set of coding engines (e.g. those of a slice worker thread)
+  Void  init                ( TEncCfg* pcEncCfg, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost,
+                              TEncEntropy* pcEntropyCoder, TEncBinCABAC* pcBinCABAC, TEncSbac*** pppcRDSbacCoder,
+                              TEncSbac* pcRDGoOnSbacCoder, TEncRateCtrl* pcRateCtrl );
 
   Void       setSliceEncoder( TEncSlice* pSliceEncoder ) { m_pcSliceEncoder = pSliceEncoder; }
   TEncSlice* getSliceEncoder() { return m_pcSliceEncoder; }
+  Void       setSplitClassifier( TEncCuSplitClassifier* pcSplitClassifier ) { m_pcSplitClassifier = pcSplitClassifier; }
   Void       initLumaDeltaQpLUT();
   Int        calculateLumaDQP( TComDataCU *pCU, const UInt absPartIdx, const TComYuv * pOrgYuv );
 #if JVET_V0078
@@ -172,6 +179,9 @@ protected:
 
   Void  xCheckDQP           ( TComDataCU*  pcCU );
 
+  Void  xGetSplitFeatures   ( TComDataCU* pcCU, UInt uiDepth, CuSplitFeatures &features );
+  Double xGetBestModeSatd   ( TComDataCU* pcCU, UInt uiDepth );
+
   Void  xCheckIntraPCM      ( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU                      );
   Void  xCopyAMVPInfo       ( AMVPInfo* pSrc, AMVPInfo* pDst );
   Void  xCopyYuv2Pic        (TComPic* rpcPic, UInt uiCUAddr, UInt uiAbsPartIdx, UInt uiDepth, UInt uiSrcDepth );
@@ -0,0 +1,188 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncCuSplitClassifier.cpp
+    \brief    early CU split and early CU split termination decisions
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include "TEncCuSplitClassifier.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Tables
+// ====================================================================================================================
+
+/// built-in thresholds for 8x8 to 64x64 CUs, derived with tools/cu_split_thresholds.py (default precisions) from the
+/// statistics of a few test sequences at QP 22-37 with 64x64 CTUs; MAX_DOUBLE and -1 disable the early split and the
+/// early termination
+static const Double g_defaultSplitVariance[CU_SPLIT_CLASSIFIER_NUM_SLICE_CLASSES][CU_SPLIT_CLASSIFIER_NUM_CU_SIZES] =
+{
+  { MAX_DOUBLE,    0.04867,      21.37,       1.92 }, // intra
+  { MAX_DOUBLE,       2.07, MAX_DOUBLE, MAX_DOUBLE }, // inter
+};
+
+static const Double g_defaultTerminateSatd[CU_SPLIT_CLASSIFIER_NUM_SLICE_CLASSES][CU_SPLIT_CLASSIFIER_NUM_CU_SIZES] =
+{
+  { -1, 0.4254,    -1,     -1 }, // intra
+  { -1,  1.159, 0.228, 0.1556 }, // inter
+};
+
+static const TChar* g_sliceClassName[CU_SPLIT_CLASSIFIER_NUM_SLICE_CLASSES] = { "intra", "inter" };
+
+// ====================================================================================================================
+// Constructor / destructor / initialization
+// ====================================================================================================================
+
+TEncCuSplitClassifier::TEncCuSplitClassifier()
+: m_level( 0 )
+{
+  for( Int c = 0; c < CU_SPLIT_CLASSIFIER_NUM_SLICE_CLASSES; c++ )
+  {
+    for( Int s = 0; s < CU_SPLIT_CLASSIFIER_NUM_CU_SIZES; s++ )
+    {
+      m_splitVariance[c][s] = g_defaultSplitVariance[c][s];
+      m_terminateSatd[c][s] = g_defaultTerminateSatd[c][s];
+    }
+  }
+}
+
+TEncCuSplitClassifier::~TEncCuSplitClassifier()
+{
+  destroy();
+}
+
+Bool TEncCuSplitClassifier::init( Int level, const std::string &thresholdFileName, const std::string &statsFileName )
+{
+  m_level = level;
+
+  if( !thresholdFileName.empty() && !xReadThresholds( thresholdFileName ) )
+  {
+    return false;
+  }
+
+  if( !statsFileName.empty() )
+  {
+    m_statsFile.open( statsFileName.c_str() );
+    if( !m_statsFile.is_open() )
+    {
+      fprintf( stderr, "Error: cannot open CU split statistics file %s for writing\n", statsFileName.c_str() );
+      return false;
+    }
+    m_statsFile << "# slice log2Size variance satd skipped neighbours minNeighbourLog2Size maxNeighbourLog2Size split\n";
+  }
+  return true;
+}
+
+Void TEncCuSplitClassifier::destroy()
+{
+  if( m_statsFile.is_open() )
+  {
+    m_statsFile.close();
+  }
+}
+
+/** Reads the thresholds from a text file, one line per slice class and CU size:
+ *  "<intra|inter> <log2 CU size> <split variance> <terminate satd>", "none" disabling a decision.
+ *  The sizes that are not listed keep the built-in thresholds; lines starting with '#' are ignored.
+ */
+Bool TEncCuSplitClassifier::xReadThresholds( const std::string &fileName )
+{
+  std::ifstream file( fileName.c_str() );
+  if( !file.is_open() )
+  {
+    fprintf( stderr, "Error: cannot open CU split threshold file %s for reading\n", fileName.c_str() );
+    return false;
+  }
+
+  std::string line;
+  for( Int lineNum = 1; std::getline( file, line ); lineNum++ )
+  {
+    std::istringstream iss( line );
+    std::string sliceClass, splitVariance, terminateSatd;
+    Int log2CuSize;
+    if( line.empty() || line[0] == '#' )
+    {
+      continue;
+    }
+    if( !( iss >> sliceClass >> log2CuSize >> splitVariance >> terminateSatd )
+        || log2CuSize < CU_SPLIT_CLASSIFIER_MIN_LOG2_CU_SIZE || log2CuSize > MAX_CU_DEPTH
+        || ( sliceClass != g_sliceClassName[0] && sliceClass != g_sliceClassName[1] ) )
+    {
+      fprintf( stderr, "Error: invalid line %d in CU split threshold file %s\n", lineNum, fileName.c_str() );
+      return false;
+    }
+    const Int c = sliceClass == g_sliceClassName[0] ? 0 : 1;
+    const Int s = log2CuSize - CU_SPLIT_CLASSIFIER_MIN_LOG2_CU_SIZE;
+    m_splitVariance[c][s] = splitVariance == "none" ? MAX_DOUBLE : atof( splitVariance.c_str() );
+    m_terminateSatd[c][s] = terminateSatd == "none" ? -1         : atof( terminateSatd.c_str() );
+  }
+  return true;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** The modes of a textured CU are skipped when all its neighbours are smaller.
+ */
+Bool TEncCuSplitClassifier::predictSplit( const CuSplitFeatures &features ) const
+{
+  return features.numNeighbours >= 2
+      && features.maxNeighbourLog2Size < Int( features.log2CuSize )
+      && features.variance >= m_splitVariance[features.intraSlice ? 0 : 1][features.log2CuSize - CU_SPLIT_CLASSIFIER_MIN_LOG2_CU_SIZE];
+}
+
+/** The split of a CU is skipped when its best mode predicts it well and none of its neighbours is smaller.
+ */
+Bool TEncCuSplitClassifier::predictNoSplit( const CuSplitFeatures &features ) const
+{
+  return features.numNeighbours >= 1
+      && features.minNeighbourLog2Size >= Int( features.log2CuSize )
+      && features.satd <= m_terminateSatd[features.intraSlice ? 0 : 1][features.log2CuSize - CU_SPLIT_CLASSIFIER_MIN_LOG2_CU_SIZE];
+}
+
+Void TEncCuSplitClassifier::addStats( const CuSplitFeatures &features, Bool split )
+{
+  std::unique_lock<std::mutex> lock( m_statsMutex );
+  m_statsFile << g_sliceClassName[features.intraSlice ? 0 : 1] << " " << features.log2CuSize << " " << features.variance << " "
+              << features.satd << " " << Int( features.skipped ) << " " << features.numNeighbours << " "
+              << features.minNeighbourLog2Size << " " << features.maxNeighbourLog2Size << " " << Int( split ) << "\n";
+}
+
+//! \}
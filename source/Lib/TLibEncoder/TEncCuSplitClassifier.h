@@ -0,0 +1,115 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncCuSplitClassifier.h
+    \brief    early CU split and early CU split termination decisions (header)
+*/
+
+#ifndef __TENCCUSPLITCLASSIFIER__
+#define __TENCCUSPLITCLASSIFIER__
+
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include "TLibCommon/CommonDef.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+static const Int CU_SPLIT_CLASSIFIER_NUM_SLICE_CLASSES = 2; ///< intra slices and inter slices have separate thresholds
+static const Int CU_SPLIT_CLASSIFIER_MIN_LOG2_CU_SIZE = 3; ///< 8x8, the smallest CU
+static const Int CU_SPLIT_CLASSIFIER_NUM_CU_SIZES     = MAX_CU_DEPTH - CU_SPLIT_CLASSIFIER_MIN_LOG2_CU_SIZE + 1; ///< 8x8 to 64x64
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// features of a CU, normalised by the lambda of the CU so that the thresholds hold across QPs and bit depths;
+/// sizes rather than depths are used so that they also hold across CTU sizes
+struct CuSplitFeatures
+{
+  UInt   log2CuSize;
+  Bool   intraSlice;
+  Double variance;             ///< luma variance of the original samples divided by lambda
+  Double satd;                 ///< luma Hadamard SATD per sample of the prediction error of the best mode at this depth, divided by sqrt(lambda)
+  Bool   skipped;              ///< the best mode at this depth is skip
+  Int    numNeighbours;        ///< number of available CUs among the left, above, above-left and above-right ones
+  Int    minNeighbourLog2Size; ///< log2 size of the smallest available neighbouring CU
+  Int    maxNeighbourLog2Size; ///< log2 size of the largest available neighbouring CU
+};
+
+/** Early CU split and early termination of the CU split from thresholds on cheap CU features.
+ *  Before the modes of a CU are tested, predictSplit() tells whether they can be skipped and the CU split directly;
+ *  after they are tested, predictNoSplit() tells whether the split can be skipped. The thresholds are built in, or
+ *  read from a file derived offline from the statistics written by addStats(). Other predictors can be substituted by
+ *  overriding the two decisions.
+ */
+class TEncCuSplitClassifier
+{
+public:
+  TEncCuSplitClassifier();
+  virtual ~TEncCuSplitClassifier();
+
+  /// level 0 disables the decisions, 1 enables the early termination and 2 also the early split;
+  /// returns false if the threshold file or the statistics file cannot be opened
+  Bool init( Int level, const std::string &thresholdFileName, const std::string &statsFileName );
+  Void destroy();
+
+  Bool isEarlySplitEnabled     () const { return m_level >= 2; }
+  Bool isEarlyTerminateEnabled () const { return m_level >= 1; }
+  Bool isCollectingStats       () const { return m_statsFile.is_open(); }
+
+  virtual Bool predictSplit   ( const CuSplitFeatures &features ) const;
+  virtual Bool predictNoSplit ( const CuSplitFeatures &features ) const;
+
+  /// appends the features of a CU whose modes and split have both been tested, with the decision taken
+  Void addStats( const CuSplitFeatures &features, Bool split );
+
+protected:
+  Bool xReadThresholds( const std::string &fileName );
+
+  Int           m_level;
+  Double        m_splitVariance [CU_SPLIT_CLASSIFIER_NUM_SLICE_CLASSES][CU_SPLIT_CLASSIFIER_NUM_CU_SIZES]; ///< minimum variance for an early split
+  Double        m_terminateSatd [CU_SPLIT_CLASSIFIER_NUM_SLICE_CLASSES][CU_SPLIT_CLASSIFIER_NUM_CU_SIZES]; ///< maximum SATD for an early termination
+  std::ofstream m_statsFile;
+  std::mutex    m_statsMutex;
+};
+
+//! \}
+
+#endif // __TENCCUSPLITCLASSIFIER__
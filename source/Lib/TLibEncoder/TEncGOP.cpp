@@ -1249,18 +1249,18 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
   xInitGOP( iPOCLast, iNumPicRcvd, isField );
 
   m_iNumPicCoded = 0;
-  SEIMessages leadingSeiMessages;
-  SEIMessages nestedSeiMessages;
-  SEIMessages duInfoSeiMessages;
-  SEIMessages trailingSeiMessages;
-  std::deque<DUData> duData;
-  SEIDecodingUnitInfo decodingUnitInfoSEI;
 
   EfficientFieldIRAPMapping effFieldIRAPMap;
   if (m_pcCfg->getEfficientFieldIRAPEnabled())
   {
     effFieldIRAPMap.initialize(isField, m_iGopSize, iPOCLast, iNumPicRcvd, m_iLastIDR, this, m_pcCfg);
   }
+  const Int IRAPGOPid = m_pcCfg->getEfficientFieldIRAPEnabled() ? effFieldIRAPMap.GetIRAPGOPid() : 0;
+
+  // consecutive pictures that do not reference each other are set up one after the other and then compressed
+  // together; the loop filters and the entropy coding of the pictures stay in coding order
+  std::vector<PendingPicture> pendingPictures;
+  const UInt maxNumPendingPictures = xCanCompressPicturesInParallel( isField ) ? UInt( m_pcCfg->getNumParallelPictures() ) : 1;
 
   // reset flag indicating whether pictures have been encoded
   // 将 GOP 里面的图片设置为未编码
@@ -1277,10 +1277,6 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       iGOPid=effFieldIRAPMap.adjustGOPid(iGOPid);
     }
 
-    //-- For time output for each slice
-    clock_t iBeforeTime = clock();
-
-
     /////////////////////////////////////////////////////////////////////////////////////////////////// Initial to start encoding
     Int iTimeOffset;
     Int pocCurr;
@@ -1310,6 +1306,14 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       continue;
     }
 
+    if ( !pendingPictures.empty() && xReferencesPendingPicture( pocCurr, iGOPid, pendingPictures ) )
+    {
+      xEncodePendingPictures( pendingPictures, rcListPic, pcBitstreamRedirect, isField, isTff, IRAPGOPid, ip_conversion, snr_conversion, outputLogCtrl );
+    }
+
+    //-- For time output for each slice
+    clock_t iBeforeTime = clock();
+
     if( getNalUnitType(pocCurr, m_iLastIDR, isField) == NAL_UNIT_CODED_SLICE_IDR_W_RADL || getNalUnitType(pocCurr, m_iLastIDR, isField) == NAL_UNIT_CODED_SLICE_IDR_N_LP )
     {
       m_iLastIDR = pocCurr;
@@ -1330,10 +1334,11 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     //  Slice 数据初始化
     pcPic->clearSliceBuffer();
     pcPic->allocateNewSlice();
-    m_pcSliceEncoder->setSliceIdx(0);
+    TEncSlice* pcSliceEncoder = m_pcEncTop->getPictureSliceEncoder( Int( pendingPictures.size() ) );
+    pcSliceEncoder->setSliceIdx(0);
     pcPic->setCurrSliceIdx(0);
 
-    m_pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, pocCurr, iGOPid, pcSlice, isField );
+    pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, pocCurr, iGOPid, pcSlice, isField );
 
     pcSlice->setLastIDR(m_iLastIDR);
     pcSlice->setSliceIdx(0);
@@ -1493,6 +1498,22 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     // 设置参考图像列表
     // 经过上面的一系列处理图像参考集之后，rcListPic 最终放在参考帧
     pcSlice->setRefPicList ( rcListPic );
+#ifndef NDEBUG
+    for ( std::size_t i = 0; i < pendingPictures.size(); i++ )
+    {
+      for ( Int iRefList = 0; iRefList < NUM_REF_PIC_LIST_01; iRefList++ )
+      {
+        for ( Int iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx( RefPicList( iRefList ) ); iRefIdx++ )
+        {
+          assert( pcSlice->getRefPic( RefPicList( iRefList ), iRefIdx ) != pendingPictures[i].pcPic );
+        }
+      }
+    }
+#endif
+    if ( m_pcCfg->getUseSubPelPlanes() )
+    {
+      xPrepareSubPelPlanes( pcSlice );
+    }
 
     //  Slice info. refinement
     if ( (pcSlice->getSliceType() == B_SLICE) && (pcSlice->getNumRefIdx(REF_PIC_LIST_1) == 0) )
@@ -1501,15 +1522,14 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     }
 
 
+    Bool bResetEncoderDecisions = false;
     if (pcSlice->getPOC() > m_RASPOCforResetEncoder && m_pcCfg->getResetEncoderStateAfterIRAP())
     {
       // need to reset encoder decisions.
       m_pcSliceEncoder->resetEncoderDecisions();
 
-      if (pcSlice->getSPS()->getUseSAO())
-      {
-        m_pcSAO->resetEncoderDecisions();
-      }
+      // the reset is repeated when the picture is written, after the decisions of the preceding pictures
+      bResetEncoderDecisions = true;
       m_RASPOCforResetEncoder=MAX_INT;
     }
     if (pcSlice->isIRAP())
@@ -1517,6 +1537,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       m_RASPOCforResetEncoder = pcSlice->getPOC();
     }
 
+    // the table selected after the last picture written so far; the one signalled is selected in xWritePicture
     pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
 #if MCTS_EXTRACTION
     SliceType  encCABACTableIdx = pcSlice->getEncCABACTableIdx();
@@ -1588,7 +1609,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     // set adaptive search range for non-intra-slices
     if (m_pcCfg->getUseASR() && pcSlice->getSliceType()!=I_SLICE)
     {
-      m_pcSliceEncoder->setSearchRange(pcSlice);
+      pcSliceEncoder->setSearchRange(pcSlice);
     }
 
     Bool bGPBcheck=false;
@@ -1619,10 +1640,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
 
 
     Double lambda            = 0.0;
-    Int actualHeadBits       = 0;
-    Int actualTotalBits      = 0;
     Int estimatedBits        = 0;
-    Int tmpBitsBeforeWriting = 0;
     // [==== 码率控制初始化begin ====]
     // 如果启用码率控制，
     if ( m_pcCfg->getUseRateCtrl() ) // TODO: does this work with multiple slices and slice-segments?
@@ -1668,7 +1686,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       }
       else if ( frameLevel == 0 )   // intra case, but use the model
       {
-        m_pcSliceEncoder->calCostSliceI(pcPic); // TODO: This only analyses the first slice segment - what about the others?
+        pcSliceEncoder->calCostSliceI(pcPic); // TODO: This only analyses the first slice segment - what about the others?
 
         if ( m_pcCfg->getIntraPeriod() != 1 )   // do not refine allocated bits for all intra case
         {
@@ -1715,385 +1733,608 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       sliceQP = Clip3( -pcSlice->getSPS()->getQpBDOffset(CHANNEL_TYPE_LUMA), MAX_QP, sliceQP );
       m_pcRateCtrl->getRCPic()->setPicEstQP( sliceQP );
 
-      m_pcSliceEncoder->resetQP( pcPic, sliceQP, lambda );
+      pcSliceEncoder->resetQP( pcPic, sliceQP, lambda );
     }
 
     // [===== 码率控制初始化 end ====]
 
-    UInt uiNumSliceSegments = 1;
+    pendingPictures.push_back( PendingPicture() );
+    PendingPicture &picture        = pendingPictures.back();
+    picture.iGOPid                 = iGOPid;
+    picture.pcPic                  = pcPic;
+    picture.pcPicYuvRecOut         = pcPicYuvRecOut;
+    picture.pcAccessUnit           = &accessUnit;
+    picture.iBeforeTime            = iBeforeTime;
+    picture.pcSliceEncoder         = pcSliceEncoder;
+    picture.uiNumSliceSegments     = 1;
+    picture.bResetEncoderDecisions = bResetEncoderDecisions;
+    picture.bReferenced            = pcPic->getSlice(0)->isReferenced();
+    picture.lambda                 = lambda;
+    picture.estimatedBits          = estimatedBits;
 
-    // Allocate some coders, now the number of tiles are known.
-    const Int numSubstreamsColumns = (pcSlice->getPPS()->getNumTileColumnsMinus1() + 1);
-    const Int numSubstreamRows     = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() ? pcPic->getFrameHeightInCtus() : (pcSlice->getPPS()->getNumTileRowsMinus1() + 1);
-    const Int numSubstreams        = numSubstreamRows * numSubstreamsColumns;
-    std::vector<TComOutputBitstream> substreamsOut(numSubstreams);
+    if ( pendingPictures.size() == maxNumPendingPictures )
+    {
+      xEncodePendingPictures( pendingPictures, rcListPic, pcBitstreamRedirect, isField, isTff, IRAPGOPid, ip_conversion, snr_conversion, outputLogCtrl );
+    }
 
-    // now compress (trial encode) the various slice segments (slices, and dependent slices)
+    if (m_pcCfg->getEfficientFieldIRAPEnabled())
     {
-      const UInt numberOfCtusInFrame=pcPic->getPicSym()->getNumberOfCtusInFrame();
-      pcSlice->setSliceCurStartCtuTsAddr( 0 );
-      pcSlice->setSliceSegmentCurStartCtuTsAddr( 0 );
+      iGOPid=effFieldIRAPMap.restoreGOPid(iGOPid);
+    }
+  } // iGOPid-loop
 
-      // [===== compressSlice 遍历各种模式的组合，选取最优的模式组合以及参数，同时得到变换系数 bgein =====]
-      for(UInt nextCtuTsAddr = 0; nextCtuTsAddr < numberOfCtusInFrame; )
-      {
-        m_pcSliceEncoder->precompressSlice( pcPic );
-        m_pcSliceEncoder->compressSlice   ( pcPic, false, false );
+  if ( !pendingPictures.empty() )
+  {
+    xEncodePendingPictures( pendingPictures, rcListPic, pcBitstreamRedirect, isField, isTff, IRAPGOPid, ip_conversion, snr_conversion, outputLogCtrl );
+  }
 
-        const UInt curSliceSegmentEnd = pcSlice->getSliceSegmentCurEndCtuTsAddr();
-        if (curSliceSegmentEnd < numberOfCtusInFrame)
-        {
-          const Bool bNextSegmentIsDependentSlice=curSliceSegmentEnd<pcSlice->getSliceCurEndCtuTsAddr();
-          const UInt sliceBits=pcSlice->getSliceBits();
-          pcPic->allocateNewSlice();
-          // prepare for next slice
-          pcPic->setCurrSliceIdx                    ( uiNumSliceSegments );
-          m_pcSliceEncoder->setSliceIdx             ( uiNumSliceSegments   );
-          pcSlice = pcPic->getSlice                 ( uiNumSliceSegments   );
-          assert(pcSlice->getPPS()!=0);
-          pcSlice->copySliceInfo                    ( pcPic->getSlice(uiNumSliceSegments-1)  );
-          pcSlice->setSliceIdx                      ( uiNumSliceSegments   );
-          if (bNextSegmentIsDependentSlice)
-          {
-            pcSlice->setSliceBits(sliceBits);
-          }
-          else
-          {
-            pcSlice->setSliceCurStartCtuTsAddr      ( curSliceSegmentEnd );
-            pcSlice->setSliceBits(0);
-          }
-          pcSlice->setDependentSliceSegmentFlag(bNextSegmentIsDependentSlice);
-          pcSlice->setSliceSegmentCurStartCtuTsAddr ( curSliceSegmentEnd );
-          // TODO: optimise cabac_init during compress slice to improve multi-slice operation
-          // pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
-          uiNumSliceSegments ++;
-        }
-        nextCtuTsAddr = curSliceSegmentEnd;
-      }
-      // [== compressSlice 遍历各种模式的组合，选取最优的模式组合以及参数，同时得到变换系数 end ==]
-    }
+  delete pcBitstreamRedirect;
 
-    duData.clear();
-    pcSlice = pcPic->getSlice(0);
+  assert ( (m_iNumPicCoded == iNumPicRcvd) );
+}
 
-    // SAO parameter estimation using non-deblocked pixels for CTU bottom and right boundary areas
-    if( pcSlice->getSPS()->getUseSAO() && m_pcCfg->getSaoCtuBoundary() )
+/** Check whether consecutive pictures of the GOP may be compressed concurrently. Tools that carry state from one
+ * picture to the next outside of the slice encoders (rate control, adaptive QP selection) and field coding compress
+ * one picture at a time.
+ */
+Bool TEncGOP::xCanCompressPicturesInParallel( Bool isField ) const
+{
+  if ( m_pcCfg->getNumParallelPictures() < 2 || isField )
+  {
+    return false;
+  }
+  if ( m_pcCfg->getUseRateCtrl() )
+  {
+    return false;
+  }
+#if ADAPTIVE_QP_SELECTION
+  if ( m_pcCfg->getUseAdaptQpSelect() )
+  {
+    return false;
+  }
+#endif
+  return true;
+}
+
+/** Check whether the picture pocCurr of GOP entry iGOPid may use one of the pending pictures for reference.
+ * The pictures of the reference picture set of the GOP entry that are used by the current picture are a superset
+ * of the pictures the slices of the picture will reference.
+ */
+Bool TEncGOP::xReferencesPendingPicture( Int pocCurr, Int iGOPid, const std::vector<PendingPicture> &pendingPictures ) const
+{
+  const GOPEntry &entry = m_pcCfg->getGOPEntry( m_pcEncTop->getReferencePictureSetIdxForSOP( pocCurr, iGOPid ) );
+
+  for ( Int i = 0; i < entry.m_numRefPics; i++ )
+  {
+    if ( !entry.m_usedByCurrPic[i] )
     {
-      m_pcSAO->getPreDBFStatistics(pcPic);
+      continue;
     }
-
-    //-- Loop filter
-    Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
-    // 设置环路滤波器是否跨越边界
-    m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
-    if ( m_pcCfg->getDeblockingFilterMetric() )
+    for ( std::size_t j = 0; j < pendingPictures.size(); j++ )
     {
-      if ( m_pcCfg->getDeblockingFilterMetric()==2 )
-      {
-        applyDeblockingFilterParameterSelection(pcPic, uiNumSliceSegments, iGOPid);
-      }
-      else
+      if ( pendingPictures[j].pcPic->getPOC() == pocCurr + entry.m_referencePics[i] )
       {
-        applyDeblockingFilterMetric(pcPic, uiNumSliceSegments);
+        return true;
       }
     }
-    // 【！！重要】
-    // inloop 滤波
-    // 完成去块滤波和SAO
-    m_pcLoopFilter->loopFilterPic( pcPic );
+  }
+  return false;
+}
 
-    /////////////////////////////////////////////////////////////////////////////////////////////////// File writing
-    // Set entropy coder
-    // 设置 CAVLC 熵编码器
-    // 帧或者条带中的数据使用CABAC编码
-    // 参数集用 CAVLC 熵编码
-    m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
+/** Compress the pending pictures and write them in coding order.
+ * The pictures are independent of each other, so each is compressed by a task of the thread pool with the coding
+ * engines of its own slice encoder; the tiles and WPP rows of such a picture are then compressed sequentially.
+ */
+Void TEncGOP::xEncodePendingPictures( std::vector<PendingPicture> &pendingPictures, TComList<TComPic*>& rcListPic, TComOutputBitstream* pcBitstreamRedirect,
+                                      Bool isField, Bool isTff, Int IRAPGOPid, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl )
+{
+  TComThreadPool* pcThreadPool = m_pcEncTop->getThreadPool();
 
-    // write various parameter sets
-    //bool writePS = m_bSeqFirst || (m_pcCfg->getReWriteParamSetsFlag() && (pcPic->getSlice(0)->getSliceType() == I_SLICE));
-    bool writePS = m_bSeqFirst || (m_pcCfg->getReWriteParamSetsFlag() && (pcSlice->isIRAP()));
-    if (writePS)
+  if ( pendingPictures.size() == 1 || pcThreadPool->getNumThreads() < 2 )
+  {
+    for ( std::size_t i = 0; i < pendingPictures.size(); i++ )
     {
-      m_pcEncTop->setParamSetChanged(pcSlice->getSPS()->getSPSId(), pcSlice->getPPS()->getPPSId());
+      xCompressPicture( pendingPictures[i] );
     }
-    actualTotalBits += xWriteParameterSets(accessUnit, pcSlice, writePS);
-
-    if (writePS)
+  }
+  else
+  {
+    for ( std::size_t i = 0; i < pendingPictures.size(); i++ )
     {
-      // create prefix SEI messages at the beginning of the sequence
-      assert(leadingSeiMessages.empty());
-#if MCTS_EXTRACTION
-      xCreateIRAPLeadingSEIMessages(leadingSeiMessages, m_pcEncTop->getVPS(),  pcSlice->getSPS(), pcSlice->getPPS());
-#else
-      xCreateIRAPLeadingSEIMessages(leadingSeiMessages, pcSlice->getSPS(), pcSlice->getPPS());
-#endif
-
-      m_bSeqFirst = false;
+      PendingPicture *pPicture = &pendingPictures[i];
+      pPicture->pcSliceEncoder->setSubstreamsInParallelAllowed( false );
+      pcThreadPool->addTask( [this, pPicture]( Int )
+      {
+        xCompressPicture( *pPicture );
+      } );
     }
-    if (m_pcCfg->getAccessUnitDelimiter())
+    pcThreadPool->waitForAll();
+
+    for ( std::size_t i = 0; i < pendingPictures.size(); i++ )
     {
-      xWriteAccessUnitDelimiter(accessUnit, pcSlice);
+      pendingPictures[i].pcSliceEncoder->setSubstreamsInParallelAllowed( true );
     }
+  }
 
-    // reset presence of BP SEI indication
-    m_bufferingPeriodSEIPresentInAU = false;
-    // create prefix SEI associated with a picture
-    xCreatePerPictureSEIMessages(iGOPid, leadingSeiMessages, nestedSeiMessages, pcSlice);
-
-    /* use the main bitstream buffer for storing the marshalled picture */
-    m_pcEntropyCoder->setBitstream(NULL);
+  for ( std::size_t i = 0; i < pendingPictures.size(); i++ )
+  {
+    xWritePicture( pendingPictures[i], rcListPic, pcBitstreamRedirect, isField, isTff, IRAPGOPid, ip_conversion, snr_conversion, outputLogCtrl );
+  }
+  pendingPictures.clear();
 
-    pcSlice = pcPic->getSlice(0);
+  if ( m_pcCfg->getUseSubPelPlanes() )
+  {
+    xReleaseSubPelPlanes( rcListPic );
+  }
+}
 
-    if (pcSlice->getSPS()->getUseSAO())
+/** Interpolate the quarter-sample planes of the reference pictures of a slice that do not have them yet. The
+ * reference lists must be set, which also extends the picture borders. Each reference and horizontal phase is
+ * one task of the thread pool.
+ */
+Void TEncGOP::xPrepareSubPelPlanes( TComSlice* pcSlice )
+{
+  std::vector<TComPic*> cPics;
+  for ( Int iRefList = 0; iRefList < NUM_REF_PIC_LIST_01; iRefList++ )
+  {
+    for ( Int iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx( RefPicList( iRefList ) ); iRefIdx++ )
     {
-      Bool sliceEnabled[MAX_NUM_COMPONENT];
-      TComBitCounter tempBitCounter;
-      tempBitCounter.resetBits();
-      m_pcEncTop->getRDGoOnSbacCoder()->setBitstream(&tempBitCounter);
-      m_pcSAO->initRDOCabacCoder(m_pcEncTop->getRDGoOnSbacCoder(), pcSlice);
-      m_pcSAO->SAOProcess(pcPic, sliceEnabled, pcPic->getSlice(0)->getLambdas(),
-                          m_pcCfg->getTestSAODisableAtPictureLevel(),
-                          m_pcCfg->getSaoEncodingRate(),
-                          m_pcCfg->getSaoEncodingRateChroma(),
-                          m_pcCfg->getSaoCtuBoundary());
-      m_pcSAO->PCMLFDisableProcess(pcPic);
-      m_pcEncTop->getRDGoOnSbacCoder()->setBitstream(NULL);
-
-      //assign SAO slice header
-      for(Int s=0; s< uiNumSliceSegments; s++)
+      TComPic* pcRefPic = pcSlice->getRefPic( RefPicList( iRefList ), iRefIdx );
+      if ( !pcRefPic->hasSubPelPlanes() && std::find( cPics.begin(), cPics.end(), pcRefPic ) == cPics.end() )
       {
-        pcPic->getSlice(s)->setSaoEnabledFlag(CHANNEL_TYPE_LUMA, sliceEnabled[COMPONENT_Y]);
-        assert(sliceEnabled[COMPONENT_Cb] == sliceEnabled[COMPONENT_Cr]);
-        pcPic->getSlice(s)->setSaoEnabledFlag(CHANNEL_TYPE_CHROMA, sliceEnabled[COMPONENT_Cb]);
+        pcRefPic->createSubPelPlanes();
+        cPics.push_back( pcRefPic );
       }
     }
+  }
 
-    // pcSlice is currently slice 0.
-    std::size_t binCountsInNalUnits   = 0; // For implementation of cabac_zero_word stuffing (section 7.4.3.10)
-    std::size_t numBytesInVclNalUnits = 0; // For implementation of cabac_zero_word stuffing (section 7.4.3.10)
-
-    // 对帧的每一个slice编码，先选出最优参数，完成预测，变换，量化，环路滤波，最后encodeSlice 熵编码
-    for( UInt sliceSegmentStartCtuTsAddr = 0, sliceIdxCount=0; sliceSegmentStartCtuTsAddr < pcPic->getPicSym()->getNumberOfCtusInFrame(); sliceIdxCount++, sliceSegmentStartCtuTsAddr=pcSlice->getSliceSegmentCurEndCtuTsAddr() )
+  TComThreadPool* pcThreadPool = m_pcEncTop->getThreadPool();
+  for ( std::size_t i = 0; i < cPics.size(); i++ )
+  {
+    for ( Int iHorFrac = 0; iHorFrac < 4; iHorFrac++ )
     {
-      pcSlice = pcPic->getSlice(sliceIdxCount);
-      if(sliceIdxCount > 0 && pcSlice->getSliceType()!= I_SLICE)
+      TComPic* pcRefPic = cPics[i];
+      if ( pcThreadPool == NULL || pcThreadPool->getNumThreads() < 2 )
       {
-        pcSlice->checkColRefIdx(sliceIdxCount, pcPic);
+        pcRefPic->interpolateSubPelPlanes( iHorFrac );
       }
-      pcPic->setCurrSliceIdx(sliceIdxCount);
-      m_pcSliceEncoder->setSliceIdx(sliceIdxCount);
-
-      pcSlice->setRPS(pcPic->getSlice(0)->getRPS());
-      pcSlice->setRPSidx(pcPic->getSlice(0)->getRPSidx());
-
-      for ( UInt ui = 0 ; ui < numSubstreams; ui++ )
+      else
       {
-        substreamsOut[ui].clear();
+        pcThreadPool->addTask( [pcRefPic, iHorFrac]( Int )
+        {
+          pcRefPic->interpolateSubPelPlanes( iHorFrac );
+        } );
       }
+    }
+  }
+  if ( pcThreadPool != NULL && pcThreadPool->getNumThreads() >= 2 )
+  {
+    pcThreadPool->waitForAll();
+  }
+}
 
-      m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
-      m_pcEntropyCoder->resetEntropy      ( pcSlice );
-      /* start slice NALunit */
-      OutputNALUnit nalu( pcSlice->getNalUnitType(), pcSlice->getTLayer() );
-      m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+/** Free the quarter-sample planes of the pictures that are no longer used for reference
+ */
+Void TEncGOP::xReleaseSubPelPlanes( TComList<TComPic*>& rcListPic )
+{
+  for ( TComList<TComPic*>::iterator it = rcListPic.begin(); it != rcListPic.end(); it++ )
+  {
+    if ( (*it)->hasSubPelPlanes() && !(*it)->getSlice(0)->isReferenced() )
+    {
+      (*it)->destroySubPelPlanes();
+    }
+  }
+}
+
+/** Compress (trial encode) the slice segments of a picture set up by compressGOP, using the slice encoder assigned
+ * to it. Several pictures may be compressed concurrently by xEncodePendingPictures.
+ */
+Void TEncGOP::xCompressPicture( PendingPicture &picture )
+{
+  TComPic*   pcPic              = picture.pcPic;
+  TEncSlice* pcSliceEncoder     = picture.pcSliceEncoder;
+  TComSlice* pcSlice            = pcPic->getSlice(0);
+  UInt       uiNumSliceSegments = 1;
 
-      pcSlice->setNoRaslOutputFlag(false);
-      if (pcSlice->isIRAP())
+  // estimate the start candidates of the motion search on the downsampled pictures
+  if ( m_pcCfg->getPreMotionSearchEnabled() && !pcSlice->isIntra() )
+  {
+    m_pcEncTop->getPreanalyzer()->xPreMotionSearch( dynamic_cast<TEncPic*>( pcPic ) );
+  }
+
+  // now compress (trial encode) the various slice segments (slices, and dependent slices)
+  {
+    const UInt numberOfCtusInFrame=pcPic->getPicSym()->getNumberOfCtusInFrame();
+    pcSlice->setSliceCurStartCtuTsAddr( 0 );
+    pcSlice->setSliceSegmentCurStartCtuTsAddr( 0 );
+
+    // [===== compressSlice 遍历各种模式的组合，选取最优的模式组合以及参数，同时得到变换系数 bgein =====]
+    for(UInt nextCtuTsAddr = 0; nextCtuTsAddr < numberOfCtusInFrame; )
+    {
+      pcSliceEncoder->precompressSlice( pcPic );
+      pcSliceEncoder->compressSlice   ( pcPic, false, false );
+
+      const UInt curSliceSegmentEnd = pcSlice->getSliceSegmentCurEndCtuTsAddr();
+      if (curSliceSegmentEnd < numberOfCtusInFrame)
       {
-        if (pcSlice->getNalUnitType() >= NAL_UNIT_CODED_SLICE_BLA_W_LP && pcSlice->getNalUnitType() <= NAL_UNIT_CODED_SLICE_IDR_N_LP)
+        const Bool bNextSegmentIsDependentSlice=curSliceSegmentEnd<pcSlice->getSliceCurEndCtuTsAddr();
+        const UInt sliceBits=pcSlice->getSliceBits();
+        pcPic->allocateNewSlice();
+        // prepare for next slice
+        pcPic->setCurrSliceIdx                    ( uiNumSliceSegments );
+        pcSliceEncoder->setSliceIdx               ( uiNumSliceSegments   );
+        pcSlice = pcPic->getSlice                 ( uiNumSliceSegments   );
+        assert(pcSlice->getPPS()!=0);
+        pcSlice->copySliceInfo                    ( pcPic->getSlice(uiNumSliceSegments-1)  );
+        pcSlice->setSliceIdx                      ( uiNumSliceSegments   );
+        if (bNextSegmentIsDependentSlice)
         {
-          pcSlice->setNoRaslOutputFlag(true);
+          pcSlice->setSliceBits(sliceBits);
         }
-        //the inference for NoOutputPriorPicsFlag
-        // KJS: This cannot happen at the encoder
-        if (!m_bFirst && pcSlice->isIRAP() && pcSlice->getNoRaslOutputFlag())
+        else
         {
-          if (pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA)
-          {
-            pcSlice->setNoOutputPriorPicsFlag(true);
-          }
+          pcSlice->setSliceCurStartCtuTsAddr      ( curSliceSegmentEnd );
+          pcSlice->setSliceBits(0);
         }
+        pcSlice->setDependentSliceSegmentFlag(bNextSegmentIsDependentSlice);
+        pcSlice->setSliceSegmentCurStartCtuTsAddr ( curSliceSegmentEnd );
+        // TODO: optimise cabac_init during compress slice to improve multi-slice operation
+        // pcSlice->setEncCABACTableIdx(pcSliceEncoder->getEncCABACTableIdx());
+        uiNumSliceSegments ++;
       }
+      nextCtuTsAddr = curSliceSegmentEnd;
+    }
+    // [== compressSlice 遍历各种模式的组合，选取最优的模式组合以及参数，同时得到变换系数 end ==]
+  }
+
+  picture.uiNumSliceSegments = uiNumSliceSegments;
+}
+
+/** Loop filter a compressed picture and write its access unit: parameter sets, SEI messages and the slice data.
+ * Pictures are written in coding order.
+ */
+Void TEncGOP::xWritePicture( PendingPicture &picture, TComList<TComPic*>& rcListPic, TComOutputBitstream* pcBitstreamRedirect,
+                             Bool isField, Bool isTff, Int IRAPGOPid, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl )
+{
+  TComPic*           pcPic                = picture.pcPic;
+  TComSlice*         pcSlice              = pcPic->getSlice(0);
+  AccessUnit&        accessUnit           = *picture.pcAccessUnit;
+  const Int          iGOPid               = picture.iGOPid;
+  const UInt         uiNumSliceSegments   = picture.uiNumSliceSegments;
+  Int                actualHeadBits       = 0;
+  Int                actualTotalBits      = 0;
+  Int                tmpBitsBeforeWriting = 0;
+  SEIMessages        leadingSeiMessages;
+  SEIMessages        nestedSeiMessages;
+  SEIMessages        duInfoSeiMessages;
+  SEIMessages        trailingSeiMessages;
+  std::deque<DUData> duData;
+
+  // Allocate some coders, now the number of tiles are known.
+  const Int numSubstreamsColumns = (pcSlice->getPPS()->getNumTileColumnsMinus1() + 1);
+  const Int numSubstreamRows     = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() ? pcPic->getFrameHeightInCtus() : (pcSlice->getPPS()->getNumTileRowsMinus1() + 1);
+  const Int numSubstreams        = numSubstreamRows * numSubstreamsColumns;
+  std::vector<TComOutputBitstream> substreamsOut(numSubstreams);
+
+  if (picture.bResetEncoderDecisions)
+  {
+    m_pcSliceEncoder->resetEncoderDecisions();
+    if (pcSlice->getSPS()->getUseSAO())
+    {
+      m_pcSAO->resetEncoderDecisions();
+    }
+  }
+
+  // SAO parameter estimation using non-deblocked pixels for CTU bottom and right boundary areas
+  if( pcSlice->getSPS()->getUseSAO() && m_pcCfg->getSaoCtuBoundary() )
+  {
+    m_pcSAO->getPreDBFStatistics(pcPic);
+  }
+
+  //-- Loop filter
+  Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
+  // 设置环路滤波器是否跨越边界
+  m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
+  if ( m_pcCfg->getDeblockingFilterMetric() )
+  {
+    if ( m_pcCfg->getDeblockingFilterMetric()==2 )
+    {
+      applyDeblockingFilterParameterSelection(pcPic, uiNumSliceSegments, iGOPid);
+    }
+    else
+    {
+      applyDeblockingFilterMetric(pcPic, uiNumSliceSegments);
+    }
+  }
+  // 【！！重要】
+  // inloop 滤波
+  // 完成去块滤波和SAO
+  m_pcLoopFilter->loopFilterPic( pcPic );
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////// File writing
+  // Set entropy coder
+  // 设置 CAVLC 熵编码器
+  // 帧或者条带中的数据使用CABAC编码
+  // 参数集用 CAVLC 熵编码
+  m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
+
+  // write various parameter sets
+  //bool writePS = m_bSeqFirst || (m_pcCfg->getReWriteParamSetsFlag() && (pcPic->getSlice(0)->getSliceType() == I_SLICE));
+  bool writePS = m_bSeqFirst || (m_pcCfg->getReWriteParamSetsFlag() && (pcSlice->isIRAP()));
+  if (writePS)
+  {
+    m_pcEncTop->setParamSetChanged(pcSlice->getSPS()->getSPSId(), pcSlice->getPPS()->getPPSId());
+  }
+  actualTotalBits += xWriteParameterSets(accessUnit, pcSlice, writePS);
 
-      pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
+  if (writePS)
+  {
+    // create prefix SEI messages at the beginning of the sequence
+    assert(leadingSeiMessages.empty());
 #if MCTS_EXTRACTION
-      encCABACTableIdx = pcSlice->getEncCABACTableIdx();
-      encCabacInitFlag = (pcSlice->getSliceType() != encCABACTableIdx && encCABACTableIdx != I_SLICE) ? true : false;
-      pcSlice->setCabacInitFlag(encCabacInitFlag);
+    xCreateIRAPLeadingSEIMessages(leadingSeiMessages, m_pcEncTop->getVPS(),  pcSlice->getSPS(), pcSlice->getPPS());
+#else
+    xCreateIRAPLeadingSEIMessages(leadingSeiMessages, pcSlice->getSPS(), pcSlice->getPPS());
 #endif
-      tmpBitsBeforeWriting = m_pcEntropyCoder->getNumberOfWrittenBits();
-      // 对 slice 头进行编码
-      m_pcEntropyCoder->encodeSliceHeader(pcSlice);
-      actualHeadBits += ( m_pcEntropyCoder->getNumberOfWrittenBits() - tmpBitsBeforeWriting );
-
-      // 条带处理结束
-      pcSlice->setFinalized(true);
-
-      pcSlice->clearSubstreamSizes(  );
-      {
-        UInt numBinsCoded = 0;
-        // 对条带进行编码
-        m_pcSliceEncoder->encodeSlice(pcPic, &(substreamsOut[0]), numBinsCoded);
-        binCountsInNalUnits+=numBinsCoded;
-      }
-
-      {
-        // Construct the final bitstream by concatenating substreams.
-        // The final bitstream is either nalu.m_Bitstream or pcBitstreamRedirect;
-        // Complete the slice header info.
-        // 通过合并子流构建最后的比特流
-        // 将熵编码器设置为CAVLC
-        m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        // 将编码区块波前前向进入点
-        m_pcEntropyCoder->encodeTilesWPPEntryPoint( pcSlice );
-
-        // Append substreams...
-        TComOutputBitstream *pcOut = pcBitstreamRedirect;
-        const Int numZeroSubstreamsAtStartOfSlice  = pcPic->getSubstreamForCtuAddr(pcSlice->getSliceSegmentCurStartCtuTsAddr(), false, pcSlice);
-        const Int numSubstreamsToCode  = pcSlice->getNumberOfSubstreamSizes()+1;
-        for ( UInt ui = 0 ; ui < numSubstreamsToCode; ui++ )
-        {
-          pcOut->addSubstream(&(substreamsOut[ui+numZeroSubstreamsAtStartOfSlice]));
-        }
-      }
-
-      // If current NALU is the first NALU of slice (containing slice header) and more NALUs exist (due to multiple dependent slices) then buffer it.
-      // If current NALU is the last NALU of slice and a NALU was buffered, then (a) Write current NALU (b) Update an write buffered NALU at approproate location in NALU list.
-      Bool bNALUAlignedWrittenToList    = false; // used to ensure current NALU is not written more than once to the NALU list.
-      xAttachSliceDataToNalUnit(nalu, pcBitstreamRedirect);
-      accessUnit.push_back(new NALUnitEBSP(nalu));
-      actualTotalBits += UInt(accessUnit.back()->m_nalUnitData.str().size()) * 8;
-      numBytesInVclNalUnits += (std::size_t)(accessUnit.back()->m_nalUnitData.str().size());
-      bNALUAlignedWrittenToList = true;
 
-      if (!bNALUAlignedWrittenToList)
-      {
-        nalu.m_Bitstream.writeAlignZero();
-        accessUnit.push_back(new NALUnitEBSP(nalu));
-      }
+    m_bSeqFirst = false;
+  }
+  if (m_pcCfg->getAccessUnitDelimiter())
+  {
+    xWriteAccessUnitDelimiter(accessUnit, pcSlice);
+  }
 
-      if( ( m_pcCfg->getPictureTimingSEIEnabled() || m_pcCfg->getDecodingUnitInfoSEIEnabled() ) &&
-          ( pcSlice->getSPS()->getVuiParametersPresentFlag() ) &&
-          ( ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getNalHrdParametersPresentFlag() )
-         || ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getVclHrdParametersPresentFlag() ) ) &&
-          ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getSubPicCpbParamsPresentFlag() ) )
-      {
-          UInt numNalus = 0;
-        UInt numRBSPBytes = 0;
-        for (AccessUnit::const_iterator it = accessUnit.begin(); it != accessUnit.end(); it++)
-        {
-          numRBSPBytes += UInt((*it)->m_nalUnitData.str().size());
-          numNalus ++;
-        }
-        duData.push_back(DUData());
-        duData.back().accumBitsDU = ( numRBSPBytes << 3 );
-        duData.back().accumNalsDU = numNalus;
-      }
-    } // end iteration over slices
+  // reset presence of BP SEI indication
+  m_bufferingPeriodSEIPresentInAU = false;
+  // create prefix SEI associated with a picture
+  xCreatePerPictureSEIMessages(iGOPid, leadingSeiMessages, nestedSeiMessages, pcSlice);
 
-    // cabac_zero_words processing
-    cabac_zero_word_padding(pcSlice, pcPic, binCountsInNalUnits, numBytesInVclNalUnits, accessUnit.back()->m_nalUnitData, m_pcCfg->getCabacZeroWordPaddingEnabled());
+  /* use the main bitstream buffer for storing the marshalled picture */
+  m_pcEntropyCoder->setBitstream(NULL);
 
-    // 运动估计编码
-    pcPic->compressMotion();
+  pcSlice = pcPic->getSlice(0);
 
-    //-- For time output for each slice
-    Double dEncTime = (Double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
+  if (pcSlice->getSPS()->getUseSAO())
+  {
+    Bool sliceEnabled[MAX_NUM_COMPONENT];
+    TComBitCounter tempBitCounter;
+    tempBitCounter.resetBits();
+    m_pcEncTop->getRDGoOnSbacCoder()->setBitstream(&tempBitCounter);
+    m_pcSAO->initRDOCabacCoder(m_pcEncTop->getRDGoOnSbacCoder(), pcSlice);
+    m_pcSAO->SAOProcess(pcPic, sliceEnabled, pcPic->getSlice(0)->getLambdas(),
+                        m_pcCfg->getTestSAODisableAtPictureLevel(),
+                        m_pcCfg->getSaoEncodingRate(),
+                        m_pcCfg->getSaoEncodingRateChroma(),
+                        m_pcCfg->getSaoCtuBoundary());
+    m_pcSAO->PCMLFDisableProcess(pcPic);
+    m_pcEncTop->getRDGoOnSbacCoder()->setBitstream(NULL);
 
-    std::string digestStr;
-    if (m_pcCfg->getDecodedPictureHashSEIType()!=HASHTYPE_NONE)
+    //assign SAO slice header
+    for(Int s=0; s< uiNumSliceSegments; s++)
     {
-      SEIDecodedPictureHash *decodedPictureHashSei = new SEIDecodedPictureHash();
-      m_seiEncoder.initDecodedPictureHashSEI(decodedPictureHashSei, pcPic, digestStr, pcSlice->getSPS()->getBitDepths());
-      trailingSeiMessages.push_back(decodedPictureHashSei);
+      pcPic->getSlice(s)->setSaoEnabledFlag(CHANNEL_TYPE_LUMA, sliceEnabled[COMPONENT_Y]);
+      assert(sliceEnabled[COMPONENT_Cb] == sliceEnabled[COMPONENT_Cr]);
+      pcPic->getSlice(s)->setSaoEnabledFlag(CHANNEL_TYPE_CHROMA, sliceEnabled[COMPONENT_Cb]);
     }
+  }
 
-    m_pcCfg->setEncodedFlag(iGOPid, true);
-
-    Double PSNR_Y;
+  // pcSlice is currently slice 0.
+  std::size_t binCountsInNalUnits   = 0; // For implementation of cabac_zero_word stuffing (section 7.4.3.10)
+  std::size_t numBytesInVclNalUnits = 0; // For implementation of cabac_zero_word stuffing (section 7.4.3.10)
 
-    xCalculateAddPSNRs( isField, isTff, iGOPid, pcPic, accessUnit, rcListPic, dEncTime, ip_conversion, snr_conversion, outputLogCtrl, &PSNR_Y );
-    
-    // Only produce the Green Metadata SEI message with the last picture.
-    if( m_pcCfg->getSEIGreenMetadataInfoSEIEnable() && pcSlice->getPOC() == ( m_pcCfg->getFramesToBeEncoded() - 1 )  )
+  // 对帧的每一个slice编码，先选出最优参数，完成预测，变换，量化，环路滤波，最后encodeSlice 熵编码
+  for( UInt sliceSegmentStartCtuTsAddr = 0, sliceIdxCount=0; sliceSegmentStartCtuTsAddr < pcPic->getPicSym()->getNumberOfCtusInFrame(); sliceIdxCount++, sliceSegmentStartCtuTsAddr=pcSlice->getSliceSegmentCurEndCtuTsAddr() )
+  {
+    pcSlice = pcPic->getSlice(sliceIdxCount);
+    if(sliceIdxCount > 0 && pcSlice->getSliceType()!= I_SLICE)
     {
-      SEIGreenMetadataInfo *seiGreenMetadataInfo = new SEIGreenMetadataInfo;
-      m_seiEncoder.initSEIGreenMetadataInfo(seiGreenMetadataInfo, (UInt)(PSNR_Y * 100 + 0.5));
-      trailingSeiMessages.push_back(seiGreenMetadataInfo);
+      pcSlice->checkColRefIdx(sliceIdxCount, pcPic);
     }
-    
-    xWriteTrailingSEIMessages(trailingSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS());
-    
-    printHash(m_pcCfg->getDecodedPictureHashSEIType(), digestStr);
+    pcPic->setCurrSliceIdx(sliceIdxCount);
+    m_pcSliceEncoder->setSliceIdx(sliceIdxCount);
+
+    pcSlice->setRPS(pcPic->getSlice(0)->getRPS());
+    pcSlice->setRPSidx(pcPic->getSlice(0)->getRPSidx());
 
-    // 码率控制相关的逻辑
-    if ( m_pcCfg->getUseRateCtrl() )
+    for ( UInt ui = 0 ; ui < numSubstreams; ui++ )
     {
-      Double avgQP     = m_pcRateCtrl->getRCPic()->calAverageQP();
-      Double avgLambda = m_pcRateCtrl->getRCPic()->calAverageLambda();
-      if ( avgLambda < 0.0 )
-      {
-        avgLambda = lambda;
-      }
+      substreamsOut[ui].clear();
+    }
 
-      m_pcRateCtrl->getRCPic()->updateAfterPicture( actualHeadBits, actualTotalBits, avgQP, avgLambda, pcSlice->getSliceType());
-      m_pcRateCtrl->getRCPic()->addToPictureLsit( m_pcRateCtrl->getPicList() );
+    m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
+    m_pcEntropyCoder->resetEntropy      ( pcSlice );
+    /* start slice NALunit */
+    OutputNALUnit nalu( pcSlice->getNalUnitType(), pcSlice->getTLayer() );
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
 
-      m_pcRateCtrl->getRCSeq()->updateAfterPic( actualTotalBits );
-      if ( pcSlice->getSliceType() != I_SLICE )
+    pcSlice->setNoRaslOutputFlag(false);
+    if (pcSlice->isIRAP())
+    {
+      if (pcSlice->getNalUnitType() >= NAL_UNIT_CODED_SLICE_BLA_W_LP && pcSlice->getNalUnitType() <= NAL_UNIT_CODED_SLICE_IDR_N_LP)
       {
-        m_pcRateCtrl->getRCGOP()->updateAfterPicture( actualTotalBits );
+        pcSlice->setNoRaslOutputFlag(true);
       }
-      else    // for intra picture, the estimated bits are used to update the current status in the GOP
+      //the inference for NoOutputPriorPicsFlag
+      // KJS: This cannot happen at the encoder
+      if (!m_bFirst && pcSlice->isIRAP() && pcSlice->getNoRaslOutputFlag())
       {
-        m_pcRateCtrl->getRCGOP()->updateAfterPicture( estimatedBits );
+        if (pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA)
+        {
+          pcSlice->setNoOutputPriorPicsFlag(true);
+        }
       }
-      if (m_pcRateCtrl->getCpbSaturationEnabled())
+    }
+
+    // cabac_init is decided in coding order, from the slices written before
+    pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
+#if MCTS_EXTRACTION
+    SliceType encCABACTableIdx = pcSlice->getEncCABACTableIdx();
+    Bool encCabacInitFlag = (pcSlice->getSliceType() != encCABACTableIdx && encCABACTableIdx != I_SLICE) ? true : false;
+    pcSlice->setCabacInitFlag(encCabacInitFlag);
+#endif
+    tmpBitsBeforeWriting = m_pcEntropyCoder->getNumberOfWrittenBits();
+    // 对 slice 头进行编码
+    m_pcEntropyCoder->encodeSliceHeader(pcSlice);
+    actualHeadBits += ( m_pcEntropyCoder->getNumberOfWrittenBits() - tmpBitsBeforeWriting );
+
+    // 条带处理结束
+    pcSlice->setFinalized(true);
+
+    pcSlice->clearSubstreamSizes(  );
+    {
+      UInt numBinsCoded = 0;
+      // 对条带进行编码
+      m_pcSliceEncoder->encodeSlice(pcPic, &(substreamsOut[0]), numBinsCoded);
+      binCountsInNalUnits+=numBinsCoded;
+    }
+
+    {
+      // Construct the final bitstream by concatenating substreams.
+      // The final bitstream is either nalu.m_Bitstream or pcBitstreamRedirect;
+      // Complete the slice header info.
+      // 通过合并子流构建最后的比特流
+      // 将熵编码器设置为CAVLC
+      m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
+      m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+      // 将编码区块波前前向进入点
+      m_pcEntropyCoder->encodeTilesWPPEntryPoint( pcSlice );
+
+      // Append substreams...
+      TComOutputBitstream *pcOut = pcBitstreamRedirect;
+      const Int numZeroSubstreamsAtStartOfSlice  = pcPic->getSubstreamForCtuAddr(pcSlice->getSliceSegmentCurStartCtuTsAddr(), false, pcSlice);
+      const Int numSubstreamsToCode  = pcSlice->getNumberOfSubstreamSizes()+1;
+      for ( UInt ui = 0 ; ui < numSubstreamsToCode; ui++ )
       {
-        m_pcRateCtrl->updateCpbState(actualTotalBits);
-        printf(" [CPB %6d bits]", m_pcRateCtrl->getCpbState());
+        pcOut->addSubstream(&(substreamsOut[ui+numZeroSubstreamsAtStartOfSlice]));
       }
     }
 
-    xCreatePictureTimingSEI(m_pcCfg->getEfficientFieldIRAPEnabled()?effFieldIRAPMap.GetIRAPGOPid():0, leadingSeiMessages, nestedSeiMessages, duInfoSeiMessages, pcSlice, isField, duData);
-    if (m_pcCfg->getScalableNestingSEIEnabled())
+    // If current NALU is the first NALU of slice (containing slice header) and more NALUs exist (due to multiple dependent slices) then buffer it.
+    // If current NALU is the last NALU of slice and a NALU was buffered, then (a) Write current NALU (b) Update an write buffered NALU at approproate location in NALU list.
+    Bool bNALUAlignedWrittenToList    = false; // used to ensure current NALU is not written more than once to the NALU list.
+    xAttachSliceDataToNalUnit(nalu, pcBitstreamRedirect);
+    accessUnit.push_back(new NALUnitEBSP(nalu));
+    actualTotalBits += UInt(accessUnit.back()->m_nalUnitData.str().size()) * 8;
+    numBytesInVclNalUnits += (std::size_t)(accessUnit.back()->m_nalUnitData.str().size());
+    bNALUAlignedWrittenToList = true;
+
+    if (!bNALUAlignedWrittenToList)
+    {
+      nalu.m_Bitstream.writeAlignZero();
+      accessUnit.push_back(new NALUnitEBSP(nalu));
+    }
+
+    if( ( m_pcCfg->getPictureTimingSEIEnabled() || m_pcCfg->getDecodingUnitInfoSEIEnabled() ) &&
+        ( pcSlice->getSPS()->getVuiParametersPresentFlag() ) &&
+        ( ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getNalHrdParametersPresentFlag() )
+       || ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getVclHrdParametersPresentFlag() ) ) &&
+        ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getSubPicCpbParamsPresentFlag() ) )
     {
-      xCreateScalableNestingSEI (leadingSeiMessages, nestedSeiMessages);
+        UInt numNalus = 0;
+      UInt numRBSPBytes = 0;
+      for (AccessUnit::const_iterator it = accessUnit.begin(); it != accessUnit.end(); it++)
+      {
+        numRBSPBytes += UInt((*it)->m_nalUnitData.str().size());
+        numNalus ++;
+      }
+      duData.push_back(DUData());
+      duData.back().accumBitsDU = ( numRBSPBytes << 3 );
+      duData.back().accumNalsDU = numNalus;
     }
-    xWriteLeadingSEIMessages(leadingSeiMessages, duInfoSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS(), duData);
-    xWriteDuSEIMessages(duInfoSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS(), duData);
+  } // end iteration over slices
 
-    pcPic->getPicYuvRec()->copyToPic(pcPicYuvRecOut);
+  // cabac_zero_words processing
+  cabac_zero_word_padding(pcSlice, pcPic, binCountsInNalUnits, numBytesInVclNalUnits, accessUnit.back()->m_nalUnitData, m_pcCfg->getCabacZeroWordPaddingEnabled());
 
-    // 设置重建标识
-    pcPic->setReconMark   ( true );
-    m_bFirst = false;
-    m_iNumPicCoded++;
-    m_totalCoded ++;
-    /* logging: insert a newline at end of picture period */
-    printf("\n");
-    fflush(stdout);
+  // 运动估计编码
+  pcPic->compressMotion();
 
-    if (m_pcCfg->getEfficientFieldIRAPEnabled())
+  //-- For time output for each slice
+  Double dEncTime = (Double)(clock()-picture.iBeforeTime) / CLOCKS_PER_SEC;
+
+  std::string digestStr;
+  if (m_pcCfg->getDecodedPictureHashSEIType()!=HASHTYPE_NONE)
+  {
+    SEIDecodedPictureHash *decodedPictureHashSei = new SEIDecodedPictureHash();
+    m_seiEncoder.initDecodedPictureHashSEI(decodedPictureHashSei, pcPic, digestStr, pcSlice->getSPS()->getBitDepths());
+    trailingSeiMessages.push_back(decodedPictureHashSei);
+  }
+
+  m_pcCfg->setEncodedFlag(iGOPid, true);
+
+  Double PSNR_Y;
+
+  xCalculateAddPSNRs( isField, isTff, iGOPid, pcPic, picture.bReferenced, accessUnit, rcListPic, dEncTime, ip_conversion, snr_conversion, outputLogCtrl, &PSNR_Y );
+  
+  // Only produce the Green Metadata SEI message with the last picture.
+  if( m_pcCfg->getSEIGreenMetadataInfoSEIEnable() && pcSlice->getPOC() == ( m_pcCfg->getFramesToBeEncoded() - 1 )  )
+  {
+    SEIGreenMetadataInfo *seiGreenMetadataInfo = new SEIGreenMetadataInfo;
+    m_seiEncoder.initSEIGreenMetadataInfo(seiGreenMetadataInfo, (UInt)(PSNR_Y * 100 + 0.5));
+    trailingSeiMessages.push_back(seiGreenMetadataInfo);
+  }
+  
+  xWriteTrailingSEIMessages(trailingSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS());
+  
+  printHash(m_pcCfg->getDecodedPictureHashSEIType(), digestStr);
+
+  // 码率控制相关的逻辑
+  if ( m_pcCfg->getUseRateCtrl() )
+  {
+    Double avgQP     = m_pcRateCtrl->getRCPic()->calAverageQP();
+    Double avgLambda = m_pcRateCtrl->getRCPic()->calAverageLambda();
+    if ( avgLambda < 0.0 )
     {
-      iGOPid=effFieldIRAPMap.restoreGOPid(iGOPid);
+      avgLambda = picture.lambda;
     }
-#if REDUCED_ENCODER_MEMORY
 
-    pcPic->releaseReconstructionIntermediateData();
-    if (!isField) // don't release the source data for field-coding because the fields are dealt with in pairs. // TODO: release source data for interlace simulations.
+    m_pcRateCtrl->getRCPic()->updateAfterPicture( actualHeadBits, actualTotalBits, avgQP, avgLambda, pcSlice->getSliceType());
+    m_pcRateCtrl->getRCPic()->addToPictureLsit( m_pcRateCtrl->getPicList() );
+
+    m_pcRateCtrl->getRCSeq()->updateAfterPic( actualTotalBits );
+    if ( pcSlice->getSliceType() != I_SLICE )
+    {
+      m_pcRateCtrl->getRCGOP()->updateAfterPicture( actualTotalBits );
+    }
+    else    // for intra picture, the estimated bits are used to update the current status in the GOP
     {
-      pcPic->releaseEncoderSourceImageData();
+      m_pcRateCtrl->getRCGOP()->updateAfterPicture( picture.estimatedBits );
     }
+    if (m_pcRateCtrl->getCpbSaturationEnabled())
+    {
+      m_pcRateCtrl->updateCpbState(actualTotalBits);
+      printf(" [CPB %6d bits]", m_pcRateCtrl->getCpbState());
+    }
+  }
 
-#endif
-  } // iGOPid-loop
+  xCreatePictureTimingSEI(IRAPGOPid, leadingSeiMessages, nestedSeiMessages, duInfoSeiMessages, pcSlice, isField, duData);
+  if (m_pcCfg->getScalableNestingSEIEnabled())
+  {
+    xCreateScalableNestingSEI (leadingSeiMessages, nestedSeiMessages);
+  }
+  xWriteLeadingSEIMessages(leadingSeiMessages, duInfoSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS(), duData);
+  xWriteDuSEIMessages(duInfoSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS(), duData);
 
-  delete pcBitstreamRedirect;
+  pcPic->getPicYuvRec()->copyToPic(picture.pcPicYuvRecOut);
 
-  assert ( (m_iNumPicCoded == iNumPicRcvd) );
+  // 设置重建标识
+  pcPic->setReconMark   ( true );
+  m_bFirst = false;
+  m_iNumPicCoded++;
+  m_totalCoded ++;
+  /* logging: insert a newline at end of picture period */
+  printf("\n");
+  fflush(stdout);
+
+#if REDUCED_ENCODER_MEMORY
+
+  pcPic->releaseReconstructionIntermediateData();
+  if (!isField) // don't release the source data for field-coding because the fields are dealt with in pairs. // TODO: release source data for interlace simulations.
+  {
+    pcPic->releaseEncoderSourceImageData();
+  }
+
+#endif
 }
 
 Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const TEncAnalyze::OutputLogControl &outputLogCtrl, const BitDepths &bitDepths)
@@ -2263,9 +2504,9 @@ UInt64 TEncGOP::xFindDistortionFrame (TComPicYuv* pcPic0, TComPicYuv* pcPic1, co
   return uiTotalDiff;
 }
 
-Void TEncGOP::xCalculateAddPSNRs( const Bool isField, const Bool isFieldTopFieldFirst, const Int iGOPid, TComPic* pcPic, const AccessUnit&accessUnit, TComList<TComPic*> &rcListPic, const Double dEncTime, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y )
+Void TEncGOP::xCalculateAddPSNRs( const Bool isField, const Bool isFieldTopFieldFirst, const Int iGOPid, TComPic* pcPic, const Bool isReferenced, const AccessUnit&accessUnit, TComList<TComPic*> &rcListPic, const Double dEncTime, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y )
 {
-  xCalculateAddPSNR( pcPic, pcPic->getPicYuvRec(), accessUnit, dEncTime, ip_conversion, snr_conversion, outputLogCtrl, PSNR_Y );
+  xCalculateAddPSNR( pcPic, pcPic->getPicYuvRec(), isReferenced, accessUnit, dEncTime, ip_conversion, snr_conversion, outputLogCtrl, PSNR_Y );
   //In case of field coding, compute the interlaced PSNR for both fields
   if(isField)
   {
@@ -2329,7 +2570,7 @@ Void TEncGOP::xCalculateAddPSNRs( const Bool isField, const Bool isFieldTopField
   }
 }
 
-Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const AccessUnit& accessUnit, Double dEncTime, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y )
+Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Bool isReferenced, const AccessUnit& accessUnit, Double dEncTime, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y )
 {
   TEncAnalyze::ResultData result;
 
@@ -2572,7 +2813,7 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   }
 
   TChar c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
-  if (!pcSlice->isReferenced())
+  if (!isReferenced)
   {
     c += 32;
   }
@@ -41,6 +41,7 @@
 #include <list>
 
 #include <stdlib.h>
+#include <time.h>
 
 #include "TLibCommon/TComList.h"
 #include "TLibCommon/TComPic.h"
@@ -87,6 +88,23 @@ class TEncGOP
     Int accumNalsDU;
   };
 
+  /// a picture of the GOP that has been set up but not yet compressed and written
+  class PendingPicture
+  {
+  public:
+    Int          iGOPid;
+    TComPic*     pcPic;
+    TComPicYuv*  pcPicYuvRecOut;
+    AccessUnit*  pcAccessUnit;
+    clock_t      iBeforeTime;
+    TEncSlice*   pcSliceEncoder;         ///< slice encoder compressing the picture
+    UInt         uiNumSliceSegments;
+    Bool         bResetEncoderDecisions; ///< ResetEncoderStateAfterIRAP
+    Bool         bReferenced;            ///< marking of the picture after its reference picture set was applied
+    Double       lambda;                 ///< rate control
+    Int          estimatedBits;          ///< rate control
+  };
+
 private:
 
   TEncAnalyze             m_gcAnalyzeAll;
@@ -195,8 +213,19 @@ protected:
   Void  xInitGOP          ( Int iPOCLast, Int iNumPicRcvd, Bool isField );
   Void  xGetBuffer        ( TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, Int iNumPicRcvd, Int iTimeOffset, TComPic*& rpcPic, TComPicYuv*& rpcPicYuvRecOut, Int pocCurr, Bool isField );
 
-  Void  xCalculateAddPSNRs         ( const Bool isField, const Bool isFieldTopFieldFirst, const Int iGOPid, TComPic* pcPic, const AccessUnit&accessUnit, TComList<TComPic*> &rcListPic, Double dEncTime, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y );
-  Void  xCalculateAddPSNR          ( TComPic* pcPic, TComPicYuv* pcPicD, const AccessUnit&, Double dEncTime, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y );
+  // compression of the independent pictures of a GOP in parallel
+  Bool  xCanCompressPicturesInParallel( Bool isField ) const;
+  Bool  xReferencesPendingPicture     ( Int pocCurr, Int iGOPid, const std::vector<PendingPicture> &pendingPictures ) const;
+  Void  xEncodePendingPictures        ( std::vector<PendingPicture> &pendingPictures, TComList<TComPic*>& rcListPic, TComOutputBitstream* pcBitstreamRedirect,
+                                        Bool isField, Bool isTff, Int IRAPGOPid, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl );
+  Void  xCompressPicture              ( PendingPicture &picture );
+  Void  xPrepareSubPelPlanes          ( TComSlice* pcSlice );
+  Void  xReleaseSubPelPlanes          ( TComList<TComPic*>& rcListPic );
+  Void  xWritePicture                 ( PendingPicture &picture, TComList<TComPic*>& rcListPic, TComOutputBitstream* pcBitstreamRedirect,
+                                        Bool isField, Bool isTff, Int IRAPGOPid, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl );
+
+  Void  xCalculateAddPSNRs         ( const Bool isField, const Bool isFieldTopFieldFirst, const Int iGOPid, TComPic* pcPic, const Bool isReferenced, const AccessUnit&accessUnit, TComList<TComPic*> &rcListPic, Double dEncTime, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y );
+  Void  xCalculateAddPSNR          ( TComPic* pcPic, TComPicYuv* pcPicD, const Bool isReferenced, const AccessUnit&, Double dEncTime, const InputColourSpaceConversion ip_conversion, const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y );
   Void  xCalculateInterlacedAddPSNR( TComPic* pcPicOrgFirstField, TComPic* pcPicOrgSecondField,
                                     TComPicYuv* pcPicRecFirstField, TComPicYuv* pcPicRecSecondField,
                                     const InputColourSpaceConversion snr_conversion, const TEncAnalyze::OutputLogControl &outputLogCtrl, Double* PSNR_Y );
@@ -0,0 +1,87 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncLookahead.cpp
+    \brief    source picture lookahead buffer class
+*/
+
+#include "TEncLookahead.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+TEncLookahead::TEncLookahead()
+: m_numFuture ( 0 )
+, m_firstFrame( 0 )
+, m_nextFrame ( 0 )
+, m_endOfInput( false )
+{
+}
+
+TEncLookahead::~TEncLookahead()
+{
+  destroy();
+}
+
+Void TEncLookahead::create( Int numPast, Int numFuture, Int firstFrame, Int width, Int height, ChromaFormat chromaFormatIDC, UInt maxCUWidth, UInt maxCUHeight, UInt maxTotalCUDepth )
+{
+  destroy();
+
+  const Int size = numPast + 1 + numFuture;
+  for( Int i = 0; i < size; i++ )
+  {
+    m_picYuvOrg.push_back( new TComPicYuv );
+    m_picYuvOrg.back()->create( width, height, chromaFormatIDC, maxCUWidth, maxCUHeight, maxTotalCUDepth, true );
+    m_picYuvTrueOrg.push_back( new TComPicYuv );
+    m_picYuvTrueOrg.back()->create( width, height, chromaFormatIDC, maxCUWidth, maxCUHeight, maxTotalCUDepth, true );
+  }
+  m_numFuture  = numFuture;
+  m_firstFrame = firstFrame;
+  m_nextFrame  = firstFrame;
+  m_endOfInput = false;
+}
+
+Void TEncLookahead::destroy()
+{
+  for( size_t i = 0; i < m_picYuvOrg.size(); i++ )
+  {
+    m_picYuvOrg[i]->destroy();
+    delete m_picYuvOrg[i];
+    m_picYuvTrueOrg[i]->destroy();
+    delete m_picYuvTrueOrg[i];
+  }
+  m_picYuvOrg.clear();
+  m_picYuvTrueOrg.clear();
+}
+
+//! \}
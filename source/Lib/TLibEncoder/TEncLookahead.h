@@ -0,0 +1,91 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncLookahead.h
+    \brief    source picture lookahead buffer class (header)
+*/
+
+#ifndef __TENCLOOKAHEAD__
+#define __TENCLOOKAHEAD__
+
+#include "TLibCommon/TComPicYuv.h"
+#include <vector>
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// ring buffer of the source pictures around the one being encoded, each of them read and converted only once
+class TEncLookahead
+{
+public:
+  TEncLookahead();
+  virtual ~TEncLookahead();
+
+  /** allocate the buffer
+   * \param numPast         number of pictures kept before the current one
+   * \param numFuture       number of pictures read ahead of the current one
+   * \param firstFrame      index of the first picture read, negative when pictures preceding the first one to encode are read as well
+   */
+  Void create( Int numPast, Int numFuture, Int firstFrame, Int width, Int height, ChromaFormat chromaFormatIDC, UInt maxCUWidth, UInt maxCUHeight, UInt maxTotalCUDepth );
+  Void destroy();
+
+  // input side
+  Bool        needsFrame( Int currFrame ) const   { return !m_endOfInput && m_nextFrame <= currFrame + m_numFuture; }
+  TComPicYuv* getPicYuvToRead()                   { return m_picYuvOrg    [ xGetSlot( m_nextFrame ) ]; }
+  TComPicYuv* getPicYuvTrueOrgToRead()            { return m_picYuvTrueOrg[ xGetSlot( m_nextFrame ) ]; }
+  Void        pushFrame()                         { m_nextFrame++; }
+  Void        setEndOfInput()                     { m_endOfInput = true; }
+
+  // output side, NULL when the picture was not read or has left the buffer
+  const TComPicYuv* getPicYuvOrg    ( Int frame ) const { return xIsBuffered( frame ) ? m_picYuvOrg    [ xGetSlot( frame ) ] : NULL; }
+  const TComPicYuv* getPicYuvTrueOrg( Int frame ) const { return xIsBuffered( frame ) ? m_picYuvTrueOrg[ xGetSlot( frame ) ] : NULL; }
+
+private:
+  Int  xGetSlot   ( Int frame ) const { const Int size = Int( m_picYuvOrg.size() ); return ( ( frame % size ) + size ) % size; }
+  Bool xIsBuffered( Int frame ) const { return frame >= m_firstFrame && frame < m_nextFrame && frame >= m_nextFrame - Int( m_picYuvOrg.size() ); }
+
+  std::vector<TComPicYuv*> m_picYuvOrg;           ///< source pictures after the input colour space conversion
+  std::vector<TComPicYuv*> m_picYuvTrueOrg;       ///< source pictures as read from the file
+  Int                      m_numFuture;
+  Int                      m_firstFrame;
+  Int                      m_nextFrame;           ///< index of the next picture to read
+  Bool                     m_endOfInput;
+};
+
+//! \}
+
+#endif // __TENCLOOKAHEAD__
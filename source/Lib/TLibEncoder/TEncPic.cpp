@@ -106,6 +106,10 @@ TEncPic::TEncPic()
 : m_acAQLayer(NULL)
 , m_uiMaxAQDepth(0)
 {
+  for (Int i = 0; i < PRE_MOTION_NUM_LEVELS; i++)
+  {
+    m_apcPreMotionPyramid[i] = NULL;
+  }
 }
 
 /** Destructor
@@ -165,7 +169,58 @@ Void TEncPic::destroy()
     delete[] m_acAQLayer;
     m_acAQLayer = NULL;
   }
+  for (Int i = 0; i < PRE_MOTION_NUM_LEVELS; i++)
+  {
+    if (m_apcPreMotionPyramid[i])
+    {
+      m_apcPreMotionPyramid[i]->destroy();
+      delete m_apcPreMotionPyramid[i];
+      m_apcPreMotionPyramid[i] = NULL;
+    }
+  }
+  m_preMotionFields.clear();
   TComPic::destroy();
 }
+
+/** Allocate the downsampled pictures of the pre-motion search, if not done yet
+ * \param iMarginX horizontal margin of the coarsest level, doubled at each finer level
+ * \param iMarginY vertical margin of the coarsest level, doubled at each finer level
+ */
+Void TEncPic::createPreMotionPyramid( Int iMarginX, Int iMarginY )
+{
+  const Int iWidth  = getPicSym()->getSPS().getPicWidthInLumaSamples();
+  const Int iHeight = getPicSym()->getSPS().getPicHeightInLumaSamples();
+  for (Int i = 0; i < PRE_MOTION_NUM_LEVELS; i++)
+  {
+    if (m_apcPreMotionPyramid[i] == NULL)
+    {
+      const Int iScale = PRE_MOTION_NUM_LEVELS - 1 - i;
+      m_apcPreMotionPyramid[i] = new TComPicYuv;
+      m_apcPreMotionPyramid[i]->createWithoutCUInfo( iWidth >> (i + 1), iHeight >> (i + 1), CHROMA_400, true, iMarginX << iScale, iMarginY << iScale );
+    }
+  }
+}
+
+/** Get the pre-motion vector of the block covering a position
+ * \param iRefPOC POC of the reference picture
+ * \param iPosX   horizontal luma position in the picture
+ * \param iPosY   vertical luma position in the picture
+ * \param rcMv    vector in quarter samples
+ * \return false when no vectors were estimated towards the reference picture
+ */
+Bool TEncPic::getPreMotionMv( Int iRefPOC, Int iPosX, Int iPosY, TComMv& rcMv ) const
+{
+  std::map<Int, std::vector<TComMv> >::const_iterator it = m_preMotionFields.find( iRefPOC );
+  if (it == m_preMotionFields.end())
+  {
+    return false;
+  }
+  const Int iFieldWidth  = getPreMotionFieldWidth();
+  const Int iFieldHeight = getPreMotionFieldHeight();
+  const Int iBlkX = std::min( std::max( iPosX / PRE_MOTION_BLOCK_SIZE, 0 ), iFieldWidth  - 1 );
+  const Int iBlkY = std::min( std::max( iPosY / PRE_MOTION_BLOCK_SIZE, 0 ), iFieldHeight - 1 );
+  rcMv = it->second[iBlkY * iFieldWidth + iBlkX];
+  return true;
+}
 //! \}
 
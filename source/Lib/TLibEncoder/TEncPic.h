@@ -40,10 +40,20 @@
 
 #include "TLibCommon/CommonDef.h"
 #include "TLibCommon/TComPic.h"
+#include "TLibCommon/TComMv.h"
+#include <map>
+#include <vector>
 
 //! \ingroup TLibEncoder
 //! \{
 
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+static const Int PRE_MOTION_NUM_LEVELS = 2;   ///< downsampled levels of the pre-motion search, halving the resolution each
+static const Int PRE_MOTION_BLOCK_SIZE = 16;  ///< size of the blocks of the pre-motion vector fields, in luma samples
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -97,6 +107,8 @@ class TEncPic : public TComPic
 private:
   TEncPicQPAdaptationLayer* m_acAQLayer;
   UInt                      m_uiMaxAQDepth;
+  TComPicYuv*               m_apcPreMotionPyramid[PRE_MOTION_NUM_LEVELS];  ///< downsampled luma of the source picture
+  std::map<Int, std::vector<TComMv> > m_preMotionFields;                   ///< pre-motion vectors towards each reference POC
 
 public:
   TEncPic();
@@ -119,6 +131,16 @@ public:
 
   TEncPicQPAdaptationLayer* getAQLayer( UInt uiDepth )  { return &m_acAQLayer[uiDepth]; }
   UInt                      getMaxAQDepth()             { return m_uiMaxAQDepth;        }
+
+  Void                      createPreMotionPyramid( Int iMarginX, Int iMarginY );
+  TComPicYuv*               getPreMotionPyramid( Int iLevel )        { return m_apcPreMotionPyramid[iLevel]; }
+  const TComPicYuv*         getPreMotionPyramid( Int iLevel ) const  { return m_apcPreMotionPyramid[iLevel]; }
+  Int                       getPreMotionFieldWidth() const           { return ( getPicSym()->getSPS().getPicWidthInLumaSamples()  + PRE_MOTION_BLOCK_SIZE - 1 ) / PRE_MOTION_BLOCK_SIZE; }
+  Int                       getPreMotionFieldHeight() const          { return ( getPicSym()->getSPS().getPicHeightInLumaSamples() + PRE_MOTION_BLOCK_SIZE - 1 ) / PRE_MOTION_BLOCK_SIZE; }
+  Void                      clearPreMotionFields()                   { m_preMotionFields.clear(); }
+  Bool                      hasPreMotionField( Int iRefPOC ) const   { return m_preMotionFields.count( iRefPOC ) != 0; }
+  std::vector<TComMv>&      getPreMotionField( Int iRefPOC )         { return m_preMotionFields[iRefPOC]; }
+  Bool                      getPreMotionMv( Int iRefPOC, Int iPosX, Int iPosY, TComMv& rcMv ) const;
 };
 
 //! \}
@@ -37,11 +37,77 @@
 
 #include <cfloat>
 #include <algorithm>
+#include <limits>
 
 #include "TEncPreanalyzer.h"
 
 using namespace std;
 
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+static const Int PRE_MOTION_MARGIN         = 32;  ///< margin of the coarsest pyramid level, doubled at each finer level
+static const Int PRE_MOTION_COARSE_RANGE   = 16;  ///< full search range at the coarsest level
+static const Int PRE_MOTION_REFINE_RANGE   = 2;   ///< refinement range around the best candidate at the finer level
+static const Int PRE_MOTION_COARSE_BLKSIZE = PRE_MOTION_BLOCK_SIZE >> PRE_MOTION_NUM_LEVELS;
+static const Int PRE_MOTION_REFINE_BLKSIZE = PRE_MOTION_BLOCK_SIZE >> ( PRE_MOTION_NUM_LEVELS - 1 );
+
+// ====================================================================================================================
+// Local functions
+// ====================================================================================================================
+
+/** Downsample a luma plane by two in both directions by averaging 2x2 blocks
+ */
+static Void downsampleLuma( const TComPicYuv* pcSrc, TComPicYuv* pcDst )
+{
+  const Int  iSrcStride = pcSrc->getStride(COMPONENT_Y);
+  const Int  iDstStride = pcDst->getStride(COMPONENT_Y);
+  const Int  iWidth     = pcDst->getWidth(COMPONENT_Y);
+  const Int  iHeight    = pcDst->getHeight(COMPONENT_Y);
+  const Pel* pSrc       = pcSrc->getAddr(COMPONENT_Y);
+  Pel*       pDst       = pcDst->getAddr(COMPONENT_Y);
+
+  for ( Int y = 0; y < iHeight; y++, pSrc += 2 * iSrcStride, pDst += iDstStride )
+  {
+    const Pel* pSrcBelow = pSrc + iSrcStride;
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      pDst[x] = ( pSrc[2*x] + pSrc[2*x+1] + pSrcBelow[2*x] + pSrcBelow[2*x+1] + 2 ) >> 2;
+    }
+  }
+}
+
+/** Sum of absolute differences of a block, stopping early when it exceeds the best value found so far
+ */
+static Distortion blockSAD( const Pel* pOrg, Int iOrgStride, const Pel* pRef, Int iRefStride, Int iBlkSize, Distortion uiBest )
+{
+  Distortion uiSAD = 0;
+  for ( Int y = 0; y < iBlkSize; y++, pOrg += iOrgStride, pRef += iRefStride )
+  {
+    for ( Int x = 0; x < iBlkSize; x++ )
+    {
+      uiSAD += abs( pOrg[x] - pRef[x] );
+    }
+    if ( uiSAD >= uiBest )
+    {
+      break;
+    }
+  }
+  return uiSAD;
+}
+
+/** Clip a vector so that the displaced block stays within the padded reference picture
+ */
+static TComMv clipToMargin( const TComPicYuv* pcRef, Int iPosX, Int iPosY, Int iBlkSize, const TComMv& rcMv )
+{
+  const Int iMarginX = pcRef->getMarginX(COMPONENT_Y);
+  const Int iMarginY = pcRef->getMarginY(COMPONENT_Y);
+  const Int iHor     = Clip3( -iMarginX - iPosX, pcRef->getWidth(COMPONENT_Y)  + iMarginX - iBlkSize - iPosX, rcMv.getHor() );
+  const Int iVer     = Clip3( -iMarginY - iPosY, pcRef->getHeight(COMPONENT_Y) + iMarginY - iBlkSize - iPosY, rcMv.getVer() );
+  return TComMv( iHor, iVer );
+}
+
 //! \ingroup TLibEncoder
 //! \{
 
@@ -149,5 +215,169 @@ Void TEncPreanalyzer::xPreanalyze( TEncPic* pcEPic )
     pcAQLayer->setAvgActivity( dAvgAct );
   }
 }
+
+/** Build the downsampled luma pictures used by the pre-motion search of later pictures referencing this one
+ * \param pcEPic Picture object whose source picture is downsampled
+ */
+Void TEncPreanalyzer::xBuildMotionPyramid( TEncPic* pcEPic )
+{
+  pcEPic->createPreMotionPyramid( PRE_MOTION_MARGIN, PRE_MOTION_MARGIN );
+
+  const TComPicYuv* pcSrc = pcEPic->getPicYuvOrg();
+  for ( Int i = 0; i < PRE_MOTION_NUM_LEVELS; i++ )
+  {
+    TComPicYuv* pcDst = pcEPic->getPreMotionPyramid(i);
+    downsampleLuma( pcSrc, pcDst );
+    pcDst->extendPicBorder();
+    pcSrc = pcDst;
+  }
+}
+
+/** Estimate a coarse motion field from the picture towards each of its reference pictures on the downsampled
+ *  pictures. The vectors are used as additional start candidates of the integer motion search.
+ * \param pcEPic Picture object whose reference picture lists are set up
+ */
+Void TEncPreanalyzer::xPreMotionSearch( TEncPic* pcEPic )
+{
+  pcEPic->clearPreMotionFields();
+
+  const TComSlice* pcSlice = pcEPic->getSlice(0);
+  std::vector<TComMv> cCoarseField;
+  for ( Int iList = 0; iList < NUM_REF_PIC_LIST_01; iList++ )
+  {
+    const RefPicList eRefPicList = RefPicList( iList );
+    for ( Int iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx( eRefPicList ); iRefIdx++ )
+    {
+      const TEncPic* pcRefPic = dynamic_cast<const TEncPic*>( pcSlice->getRefPic( eRefPicList, iRefIdx ) );
+      if ( pcRefPic == NULL || pcRefPic->getPreMotionPyramid(0) == NULL || pcEPic->hasPreMotionField( pcRefPic->getPOC() ) )
+      {
+        continue;
+      }
+
+      xEstimateCoarseField( pcEPic->getPreMotionPyramid( PRE_MOTION_NUM_LEVELS - 1 ), pcRefPic->getPreMotionPyramid( PRE_MOTION_NUM_LEVELS - 1 ), cCoarseField );
+      std::vector<TComMv>& rcField = pcEPic->getPreMotionField( pcRefPic->getPOC() );
+      xRefineField( pcEPic->getPreMotionPyramid( PRE_MOTION_NUM_LEVELS - 2 ), pcRefPic->getPreMotionPyramid( PRE_MOTION_NUM_LEVELS - 2 ), cCoarseField, rcField );
+    }
+  }
+}
+
+/** Full search of every block of the coarsest level
+ * \param pcOrg   coarsest level of the current picture
+ * \param pcRef   coarsest level of the reference picture
+ * \param rcField vectors of the blocks, in samples of the coarsest level
+ */
+Void TEncPreanalyzer::xEstimateCoarseField( const TComPicYuv* pcOrg, const TComPicYuv* pcRef, std::vector<TComMv>& rcField )
+{
+  const Int iBlkSize     = PRE_MOTION_COARSE_BLKSIZE;
+  const Int iOrgStride   = pcOrg->getStride(COMPONENT_Y);
+  const Int iRefStride   = pcRef->getStride(COMPONENT_Y);
+  const Int iFieldWidth  = ( pcOrg->getWidth(COMPONENT_Y)  + iBlkSize - 1 ) / iBlkSize;
+  const Int iFieldHeight = ( pcOrg->getHeight(COMPONENT_Y) + iBlkSize - 1 ) / iBlkSize;
+
+  rcField.assign( iFieldWidth * iFieldHeight, TComMv() );
+  for ( Int by = 0; by < iFieldHeight; by++ )
+  {
+    for ( Int bx = 0; bx < iFieldWidth; bx++ )
+    {
+      const Int  iPosX = bx * iBlkSize;
+      const Int  iPosY = by * iBlkSize;
+      const Pel* pOrg  = pcOrg->getAddr(COMPONENT_Y) + iPosY * iOrgStride + iPosX;
+      const Pel* pRef  = pcRef->getAddr(COMPONENT_Y) + iPosY * iRefStride + iPosX;
+
+      // the zero vector is tested first, so that it is kept on ties
+      Distortion uiBest = blockSAD( pOrg, iOrgStride, pRef, iRefStride, iBlkSize, std::numeric_limits<Distortion>::max() );
+      TComMv     cBest;
+      for ( Int y = -PRE_MOTION_COARSE_RANGE; y <= PRE_MOTION_COARSE_RANGE && uiBest > 0; y++ )
+      {
+        for ( Int x = -PRE_MOTION_COARSE_RANGE; x <= PRE_MOTION_COARSE_RANGE; x++ )
+        {
+          const TComMv cMv = clipToMargin( pcRef, iPosX, iPosY, iBlkSize, TComMv( x, y ) );
+          if ( cMv.getHor() != x || cMv.getVer() != y || ( x == 0 && y == 0 ) )
+          {
+            continue;
+          }
+          const Distortion uiSAD = blockSAD( pOrg, iOrgStride, pRef + y * iRefStride + x, iRefStride, iBlkSize, uiBest );
+          if ( uiSAD < uiBest )
+          {
+            uiBest = uiSAD;
+            cBest  = cMv;
+          }
+        }
+      }
+      rcField[by * iFieldWidth + bx] = cBest;
+    }
+  }
+}
+
+/** Refine the coarse vectors at the next finer level and store them in quarter samples of the full resolution
+ * \param pcOrg    finer level of the current picture
+ * \param pcRef    finer level of the reference picture
+ * \param rcCoarse vectors of the coarsest level, as estimated by xEstimateCoarseField
+ * \param rcField  refined vectors, one per block of PRE_MOTION_BLOCK_SIZE luma samples
+ */
+Void TEncPreanalyzer::xRefineField( const TComPicYuv* pcOrg, const TComPicYuv* pcRef, const std::vector<TComMv>& rcCoarse, std::vector<TComMv>& rcField )
+{
+  const Int iBlkSize     = PRE_MOTION_REFINE_BLKSIZE;
+  const Int iOrgStride   = pcOrg->getStride(COMPONENT_Y);
+  const Int iRefStride   = pcRef->getStride(COMPONENT_Y);
+  const Int iFieldWidth  = ( pcOrg->getWidth(COMPONENT_Y)  + iBlkSize - 1 ) / iBlkSize;
+  const Int iFieldHeight = ( pcOrg->getHeight(COMPONENT_Y) + iBlkSize - 1 ) / iBlkSize;
+  const Int iCoarseWidth = Int( rcCoarse.size() ) / iFieldHeight;
+  const Int iShift       = 2 + PRE_MOTION_NUM_LEVELS - 1;
+
+  rcField.assign( iFieldWidth * iFieldHeight, TComMv() );
+  for ( Int by = 0; by < iFieldHeight; by++ )
+  {
+    for ( Int bx = 0; bx < iFieldWidth; bx++ )
+    {
+      const Int  iPosX = bx * iBlkSize;
+      const Int  iPosY = by * iBlkSize;
+      const Pel* pOrg  = pcOrg->getAddr(COMPONENT_Y) + iPosY * iOrgStride + iPosX;
+      const Pel* pRef  = pcRef->getAddr(COMPONENT_Y) + iPosY * iRefStride + iPosX;
+
+      // candidates are the scaled vectors of the co-located coarse block and of its four neighbours
+      Distortion uiBest = std::numeric_limits<Distortion>::max();
+      TComMv     cBest;
+      static const Int aiNeighbour[5][2] = { { 0, 0 }, { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+      for ( Int n = 0; n < 5; n++ )
+      {
+        const Int cx = bx + aiNeighbour[n][0];
+        const Int cy = by + aiNeighbour[n][1];
+        if ( cx < 0 || cy < 0 || cx >= iCoarseWidth || cy >= iFieldHeight )
+        {
+          continue;
+        }
+        const TComMv& rcCand = rcCoarse[cy * iCoarseWidth + cx];
+        const TComMv  cMv    = clipToMargin( pcRef, iPosX, iPosY, iBlkSize, TComMv( rcCand.getHor() * 2, rcCand.getVer() * 2 ) );
+        const Distortion uiSAD = blockSAD( pOrg, iOrgStride, pRef + cMv.getVer() * iRefStride + cMv.getHor(), iRefStride, iBlkSize, uiBest );
+        if ( uiSAD < uiBest )
+        {
+          uiBest = uiSAD;
+          cBest  = cMv;
+        }
+      }
+
+      const TComMv cCentre = cBest;
+      for ( Int y = -PRE_MOTION_REFINE_RANGE; y <= PRE_MOTION_REFINE_RANGE; y++ )
+      {
+        for ( Int x = -PRE_MOTION_REFINE_RANGE; x <= PRE_MOTION_REFINE_RANGE; x++ )
+        {
+          const TComMv cMv = clipToMargin( pcRef, iPosX, iPosY, iBlkSize, TComMv( cCentre.getHor() + x, cCentre.getVer() + y ) );
+          if ( cMv == cCentre )
+          {
+            continue;
+          }
+          const Distortion uiSAD = blockSAD( pOrg, iOrgStride, pRef + cMv.getVer() * iRefStride + cMv.getHor(), iRefStride, iBlkSize, uiBest );
+          if ( uiSAD < uiBest )
+          {
+            uiBest = uiSAD;
+            cBest  = cMv;
+          }
+        }
+      }
+      rcField[by * iFieldWidth + bx] = TComMv( cBest.getHor() << iShift, cBest.getVer() << iShift );
+    }
+  }
+}
 //! \}
 
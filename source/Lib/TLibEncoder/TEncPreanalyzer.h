@@ -55,6 +55,12 @@ public:
   virtual ~TEncPreanalyzer();
 
   Void xPreanalyze( TEncPic* pcPic );
+  Void xBuildMotionPyramid( TEncPic* pcPic );
+  Void xPreMotionSearch( TEncPic* pcPic );
+
+private:
+  Void xEstimateCoarseField( const TComPicYuv* pcOrg, const TComPicYuv* pcRef, std::vector<TComMv>& rcField );
+  Void xRefineField( const TComPicYuv* pcOrg, const TComPicYuv* pcRef, const std::vector<TComMv>& rcCoarse, std::vector<TComMv>& rcField );
 };
 
 //! \}
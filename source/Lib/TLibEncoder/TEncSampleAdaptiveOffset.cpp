@@ -298,51 +298,73 @@ Void TEncSampleAdaptiveOffset::addPreDBFStatistics(SAOStatData*** blkStats)
  * 遍历图像的每一个CTU,对CTU的每个分量调用getBlkStats
  **/
 Void TEncSampleAdaptiveOffset::getStatistics(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv, TComPic* pPic, Bool isCalculatePreDeblockSamples)
+{
+  // the statistics of each CTU only depend on the samples, so the CTU rows are gathered concurrently
+  if (m_pcThreadPool && m_numCTUInHeight > 1)
+  {
+    for(Int ctuRowIdx = 0; ctuRowIdx < m_numCTUInHeight; ctuRowIdx++)
+    {
+      m_pcThreadPool->addTask( [this, ctuRowIdx, blkStats, orgYuv, srcYuv, pPic, isCalculatePreDeblockSamples]( Int )
+      {
+        for(Int ctuRsAddr = ctuRowIdx*m_numCTUInWidth; ctuRsAddr < (ctuRowIdx+1)*m_numCTUInWidth; ctuRsAddr++)
+        {
+          getCtuStatistics(blkStats, orgYuv, srcYuv, pPic, ctuRsAddr, isCalculatePreDeblockSamples);
+        }
+      } );
+    }
+    m_pcThreadPool->waitForAll();
+    return;
+  }
+
+  for(Int ctuRsAddr= 0; ctuRsAddr < m_numCTUsPic; ctuRsAddr++)
+  {
+    getCtuStatistics(blkStats, orgYuv, srcYuv, pPic, ctuRsAddr, isCalculatePreDeblockSamples);
+  }
+}
+
+Void TEncSampleAdaptiveOffset::getCtuStatistics(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv, TComPic* pPic, Int ctuRsAddr, Bool isCalculatePreDeblockSamples)
 {
   Bool isLeftAvail,isRightAvail,isAboveAvail,isBelowAvail,isAboveLeftAvail,isAboveRightAvail,isBelowLeftAvail,isBelowRightAvail;
 
   const Int numberOfComponents = getNumberValidComponents(m_chromaFormatIDC);
 
-  for(Int ctuRsAddr= 0; ctuRsAddr < m_numCTUsPic; ctuRsAddr++)
-  {
-    Int yPos   = (ctuRsAddr / m_numCTUInWidth)*m_maxCUHeight;
-    Int xPos   = (ctuRsAddr % m_numCTUInWidth)*m_maxCUWidth;
-    Int height = (yPos + m_maxCUHeight > m_picHeight)?(m_picHeight- yPos):m_maxCUHeight;
-    Int width  = (xPos + m_maxCUWidth  > m_picWidth )?(m_picWidth - xPos):m_maxCUWidth;
+  Int yPos   = (ctuRsAddr / m_numCTUInWidth)*m_maxCUHeight;
+  Int xPos   = (ctuRsAddr % m_numCTUInWidth)*m_maxCUWidth;
+  Int height = (yPos + m_maxCUHeight > m_picHeight)?(m_picHeight- yPos):m_maxCUHeight;
+  Int width  = (xPos + m_maxCUWidth  > m_picWidth )?(m_picWidth - xPos):m_maxCUWidth;
 
-    // 判断相邻CTU的有效性
-    pPic->getPicSym()->deriveLoopFilterBoundaryAvailibility(ctuRsAddr, isLeftAvail,isRightAvail,isAboveAvail,isBelowAvail,isAboveLeftAvail,isAboveRightAvail,isBelowLeftAvail,isBelowRightAvail);
+  // 判断相邻CTU的有效性
+  pPic->getPicSym()->deriveLoopFilterBoundaryAvailibility(ctuRsAddr, isLeftAvail,isRightAvail,isAboveAvail,isBelowAvail,isAboveLeftAvail,isAboveRightAvail,isBelowLeftAvail,isBelowRightAvail);
 
-    //NOTE: The number of skipped lines during gathering CTU statistics depends on the slice boundary availabilities.
-    //For simplicity, here only picture boundaries are considered.
+  //NOTE: The number of skipped lines during gathering CTU statistics depends on the slice boundary availabilities.
+  //For simplicity, here only picture boundaries are considered.
 
-    isRightAvail      = (xPos + m_maxCUWidth  < m_picWidth );
-    isBelowAvail      = (yPos + m_maxCUHeight < m_picHeight);
-    isBelowRightAvail = (isRightAvail && isBelowAvail);
-    isBelowLeftAvail  = ((xPos > 0) && (isBelowAvail));
-    isAboveRightAvail = ((yPos > 0) && (isRightAvail));
+  isRightAvail      = (xPos + m_maxCUWidth  < m_picWidth );
+  isBelowAvail      = (yPos + m_maxCUHeight < m_picHeight);
+  isBelowRightAvail = (isRightAvail && isBelowAvail);
+  isBelowLeftAvail  = ((xPos > 0) && (isBelowAvail));
+  isAboveRightAvail = ((yPos > 0) && (isRightAvail));
 
-    for(Int compIdx = 0; compIdx < numberOfComponents; compIdx++)
-    {
-      const ComponentID component = ComponentID(compIdx);
+  for(Int compIdx = 0; compIdx < numberOfComponents; compIdx++)
+  {
+    const ComponentID component = ComponentID(compIdx);
 
-      const UInt componentScaleX = getComponentScaleX(component, pPic->getChromaFormat());
-      const UInt componentScaleY = getComponentScaleY(component, pPic->getChromaFormat());
+    const UInt componentScaleX = getComponentScaleX(component, pPic->getChromaFormat());
+    const UInt componentScaleY = getComponentScaleY(component, pPic->getChromaFormat());
 
-      Int  srcStride  = srcYuv->getStride(component);
-      Pel* srcBlk     = srcYuv->getAddr(component) + ((yPos >> componentScaleY) * srcStride) + (xPos >> componentScaleX);
+    Int  srcStride  = srcYuv->getStride(component);
+    Pel* srcBlk     = srcYuv->getAddr(component) + ((yPos >> componentScaleY) * srcStride) + (xPos >> componentScaleX);
 
-      Int  orgStride  = orgYuv->getStride(component);
-      Pel* orgBlk     = orgYuv->getAddr(component) + ((yPos >> componentScaleY) * orgStride) + (xPos >> componentScaleX);
+    Int  orgStride  = orgYuv->getStride(component);
+    Pel* orgBlk     = orgYuv->getAddr(component) + ((yPos >> componentScaleY) * orgStride) + (xPos >> componentScaleX);
 
-      // 搜集一个CTU的某个分量的像素的统计信息
-      getBlkStats(component, pPic->getPicSym()->getSPS().getBitDepth(toChannelType(component)), blkStats[ctuRsAddr][component]
-                , srcBlk, orgBlk, srcStride, orgStride, (width  >> componentScaleX), (height >> componentScaleY)
-                , isLeftAvail,  isRightAvail, isAboveAvail, isBelowAvail, isAboveLeftAvail, isAboveRightAvail
-                , isCalculatePreDeblockSamples
-                );
+    // 搜集一个CTU的某个分量的像素的统计信息
+    getBlkStats(component, pPic->getPicSym()->getSPS().getBitDepth(toChannelType(component)), blkStats[ctuRsAddr][component]
+              , srcBlk, orgBlk, srcStride, orgStride, (width  >> componentScaleX), (height >> componentScaleY)
+              , isLeftAvail,  isRightAvail, isAboveAvail, isBelowAvail, isAboveLeftAvail, isAboveRightAvail
+              , isCalculatePreDeblockSamples
+              );
 
-    }
   }
 }
 
@@ -867,12 +889,16 @@ Void TEncSampleAdaptiveOffset::decideBlkParams(TComPic* pic, Bool* sliceEnabled,
 
     m_pcRDGoOnSbacCoder->load(m_pppcRDSbacCoder[ SAO_CABACSTATE_BLK_NEXT ]);
 
-    //apply reconstructed offsets
     reconParams[ctuRsAddr] = codedParams[ctuRsAddr];
     reconstructBlkSAOParam(reconParams[ctuRsAddr], mergeList);
-    offsetCTU(ctuRsAddr, srcYuv, resYuv, reconParams[ctuRsAddr], pic);
   } //ctuRsAddr
 
+  //apply reconstructed offsets, once all the decisions are made since they only depend on the statistics
+  if (!allBlksDisabled)
+  {
+    offsetCTUs(srcYuv, resYuv, reconParams, pic);
+  }
+
   if (!allBlksDisabled && (totalCost >= 0) && bTestSAODisableAtPictureLevel) //SAO has not beneficial in this case - disable it
   {
     for(Int ctuRsAddr = 0; ctuRsAddr < m_numCTUsPic; ctuRsAddr++)
@@ -925,32 +951,21 @@ Void TEncSampleAdaptiveOffset::getBlkStats(const ComponentID compIdx, const Int
                         , Bool isCalculatePreDeblockSamples
                         )
 {
-  if(m_lineBufWidth != m_maxCUWidth)
-  {
-    m_lineBufWidth = m_maxCUWidth;
-
-    if (m_signLineBuf1)
-    {
-      delete[] m_signLineBuf1;
-      m_signLineBuf1 = NULL;
-    }
-    m_signLineBuf1 = new SChar[m_lineBufWidth+1];
-
-    if (m_signLineBuf2)
-    {
-      delete[] m_signLineBuf2;
-      m_signLineBuf2 = NULL;
-    }
-    m_signLineBuf2 = new SChar[m_lineBufWidth+1];
-  }
-
-  Int x,y, startX, startY, endX, endY, edgeType, firstLineStartX, firstLineEndX;
-  SChar signLeft, signRight, signDown;
+  Int x,y, startX, startY, endX, endY, firstLineStartX, firstLineEndX;
   Int64 *diff, *count;
   Pel *srcLine, *orgLine;
   Int* skipLinesR = m_skipLinesR[compIdx];
   Int* skipLinesB = m_skipLinesB[compIdx];
 
+  // edge offset statistics of the samples [startX, endX) of numLines lines from line y
+  auto edgeStatsLines = [&](Int neighbourA, Int neighbourB, Int y, Int numLines, Int startX, Int endX)
+  {
+    if (numLines > 0 && endX > startX)
+    {
+      m_edgeStats(srcBlk + y*srcStride + startX, srcStride, orgBlk + y*orgStride + startX, orgStride, neighbourA, neighbourB, endX - startX, numLines, diff, count);
+    }
+  };
+
   for(Int typeIdx=0; typeIdx< NUM_SAO_NEW_TYPES; typeIdx++)
   {
     SAOStatData& statsData= statsDataTypes[typeIdx];
@@ -964,8 +979,6 @@ Void TEncSampleAdaptiveOffset::getBlkStats(const ComponentID compIdx, const Int
     {
     case SAO_TYPE_EO_0:
       {
-        diff +=2;
-        count+=2;
         endY   = (isBelowAvail) ? (height - skipLinesB[typeIdx]) : height;
         startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
                                                  : (isRightAvail ? (width - skipLinesR[typeIdx]) : (width - 1))
@@ -973,53 +986,21 @@ Void TEncSampleAdaptiveOffset::getBlkStats(const ComponentID compIdx, const Int
         endX   = (!isCalculatePreDeblockSamples) ? (isRightAvail ? (width - skipLinesR[typeIdx]) : (width - 1))
                                                  : (isRightAvail ? width : (width - 1))
                                                  ;
-        for (y=0; y<endY; y++)
-        {
-          signLeft = (SChar)sgn(srcLine[startX] - srcLine[startX-1]);
-          for (x=startX; x<endX; x++)
-          {
-            signRight =  (SChar)sgn(srcLine[x] - srcLine[x+1]);
-            edgeType  =  signRight + signLeft;
-            signLeft  = -signRight;
+        edgeStatsLines(-1, 1, 0, endY, startX, endX);
 
-            diff [edgeType] += (orgLine[x] - srcLine[x]);
-            count[edgeType] ++;
-          }
-          srcLine  += srcStride;
-          orgLine  += orgStride;
-        }
         if(isCalculatePreDeblockSamples)
         {
           if(isBelowAvail)
           {
             startX = isLeftAvail  ? 0 : 1;
             endX   = isRightAvail ? width : (width -1);
-
-            for(y=0; y<skipLinesB[typeIdx]; y++)
-            {
-              signLeft = (SChar)sgn(srcLine[startX] - srcLine[startX-1]);
-              for (x=startX; x<endX; x++)
-              {
-                signRight =  (SChar)sgn(srcLine[x] - srcLine[x+1]);
-                edgeType  =  signRight + signLeft;
-                signLeft  = -signRight;
-
-                diff [edgeType] += (orgLine[x] - srcLine[x]);
-                count[edgeType] ++;
-              }
-              srcLine  += srcStride;
-              orgLine  += orgStride;
-            }
+            edgeStatsLines(-1, 1, endY, skipLinesB[typeIdx], startX, endX);
           }
         }
       }
       break;
     case SAO_TYPE_EO_90:
       {
-        diff +=2;
-        count+=2;
-        SChar *signUpLine = m_signLineBuf1;
-
         startX = (!isCalculatePreDeblockSamples) ? 0
                                                  : (isRightAvail ? (width - skipLinesR[typeIdx]) : width)
                                                  ;
@@ -1028,70 +1009,19 @@ Void TEncSampleAdaptiveOffset::getBlkStats(const ComponentID compIdx, const Int
                                                  : width
                                                  ;
         endY   = isBelowAvail ? (height - skipLinesB[typeIdx]) : (height - 1);
-        if (!isAboveAvail)
-        {
-          srcLine += srcStride;
-          orgLine += orgStride;
-        }
+        edgeStatsLines(-srcStride, srcStride, startY, endY - startY, startX, endX);
 
-        Pel* srcLineAbove = srcLine - srcStride;
-        for (x=startX; x<endX; x++)
-        {
-          signUpLine[x] = (SChar)sgn(srcLine[x] - srcLineAbove[x]);
-        }
-
-        Pel* srcLineBelow;
-        for (y=startY; y<endY; y++)
-        {
-          srcLineBelow = srcLine + srcStride;
-
-          for (x=startX; x<endX; x++)
-          {
-            signDown  = (SChar)sgn(srcLine[x] - srcLineBelow[x]);
-            edgeType  = signDown + signUpLine[x];
-            signUpLine[x]= -signDown;
-
-            diff [edgeType] += (orgLine[x] - srcLine[x]);
-            count[edgeType] ++;
-          }
-          srcLine += srcStride;
-          orgLine += orgStride;
-        }
         if(isCalculatePreDeblockSamples)
         {
           if(isBelowAvail)
           {
-            startX = 0;
-            endX   = width;
-
-            for(y=0; y<skipLinesB[typeIdx]; y++)
-            {
-              srcLineBelow = srcLine + srcStride;
-              srcLineAbove = srcLine - srcStride;
-
-              for (x=startX; x<endX; x++)
-              {
-                edgeType = sgn(srcLine[x] - srcLineBelow[x]) + sgn(srcLine[x] - srcLineAbove[x]);
-                diff [edgeType] += (orgLine[x] - srcLine[x]);
-                count[edgeType] ++;
-              }
-              srcLine  += srcStride;
-              orgLine  += orgStride;
-            }
+            edgeStatsLines(-srcStride, srcStride, std::max(endY, startY), skipLinesB[typeIdx], 0, width);
           }
         }
-
       }
       break;
     case SAO_TYPE_EO_135:
       {
-        diff +=2;
-        count+=2;
-        SChar *signUpLine, *signDownLine, *signTmpLine;
-
-        signUpLine  = m_signLineBuf1;
-        signDownLine= m_signLineBuf2;
-
         startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
                                                  : (isRightAvail ? (width - skipLinesR[typeIdx]) : (width - 1))
                                                  ;
@@ -1101,81 +1031,27 @@ Void TEncSampleAdaptiveOffset::getBlkStats(const ComponentID compIdx, const Int
                                                  ;
         endY   = isBelowAvail ? (height - skipLinesB[typeIdx]) : (height - 1);
 
-        //prepare 2nd line's upper sign
-        Pel* srcLineBelow = srcLine + srcStride;
-        for (x=startX; x<endX+1; x++)
-        {
-          signUpLine[x] = (SChar)sgn(srcLineBelow[x] - srcLine[x-1]);
-        }
-
         //1st line
-        Pel* srcLineAbove = srcLine - srcStride;
         firstLineStartX = (!isCalculatePreDeblockSamples) ? (isAboveLeftAvail ? 0    : 1) : startX;
         firstLineEndX   = (!isCalculatePreDeblockSamples) ? (isAboveAvail     ? endX : 1) : endX;
-        for(x=firstLineStartX; x<firstLineEndX; x++)
-        {
-          edgeType = sgn(srcLine[x] - srcLineAbove[x-1]) - signUpLine[x+1];
-          diff [edgeType] += (orgLine[x] - srcLine[x]);
-          count[edgeType] ++;
-        }
-        srcLine  += srcStride;
-        orgLine  += orgStride;
-
+        edgeStatsLines(-srcStride-1, srcStride+1, 0, 1, firstLineStartX, firstLineEndX);
 
         //middle lines
-        for (y=1; y<endY; y++)
-        {
-          srcLineBelow = srcLine + srcStride;
-
-          for (x=startX; x<endX; x++)
-          {
-            signDown = (SChar)sgn(srcLine[x] - srcLineBelow[x+1]);
-            edgeType = signDown + signUpLine[x];
-            diff [edgeType] += (orgLine[x] - srcLine[x]);
-            count[edgeType] ++;
+        edgeStatsLines(-srcStride-1, srcStride+1, 1, endY - 1, startX, endX);
 
-            signDownLine[x+1] = -signDown;
-          }
-          signDownLine[startX] = (SChar)sgn(srcLineBelow[startX] - srcLine[startX-1]);
-
-          signTmpLine  = signUpLine;
-          signUpLine   = signDownLine;
-          signDownLine = signTmpLine;
-
-          srcLine += srcStride;
-          orgLine += orgStride;
-        }
         if(isCalculatePreDeblockSamples)
         {
           if(isBelowAvail)
           {
             startX = isLeftAvail  ? 0     : 1 ;
             endX   = isRightAvail ? width : (width -1);
-
-            for(y=0; y<skipLinesB[typeIdx]; y++)
-            {
-              srcLineBelow = srcLine + srcStride;
-              srcLineAbove = srcLine - srcStride;
-
-              for (x=startX; x< endX; x++)
-              {
-                edgeType = sgn(srcLine[x] - srcLineBelow[x+1]) + sgn(srcLine[x] - srcLineAbove[x-1]);
-                diff [edgeType] += (orgLine[x] - srcLine[x]);
-                count[edgeType] ++;
-              }
-              srcLine  += srcStride;
-              orgLine  += orgStride;
-            }
+            edgeStatsLines(-srcStride-1, srcStride+1, std::max(endY, 1), skipLinesB[typeIdx], startX, endX);
           }
         }
       }
       break;
     case SAO_TYPE_EO_45:
       {
-        diff +=2;
-        count+=2;
-        SChar *signUpLine = m_signLineBuf1+1;
-
         startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
                                                  : (isRightAvail ? (width - skipLinesR[typeIdx]) : (width - 1))
                                                  ;
@@ -1184,72 +1060,25 @@ Void TEncSampleAdaptiveOffset::getBlkStats(const ComponentID compIdx, const Int
                                                  ;
         endY   = isBelowAvail ? (height - skipLinesB[typeIdx]) : (height - 1);
 
-        //prepare 2nd line upper sign
-        Pel* srcLineBelow = srcLine + srcStride;
-        for (x=startX-1; x<endX; x++)
-        {
-          signUpLine[x] = (SChar)sgn(srcLineBelow[x] - srcLine[x+1]);
-        }
-
-
         //first line
-        Pel* srcLineAbove = srcLine - srcStride;
         firstLineStartX = (!isCalculatePreDeblockSamples) ? (isAboveAvail ? startX : endX)
                                                           : startX
                                                           ;
         firstLineEndX   = (!isCalculatePreDeblockSamples) ? ((!isRightAvail && isAboveRightAvail) ? width : endX)
                                                           : endX
                                                           ;
-        for(x=firstLineStartX; x<firstLineEndX; x++)
-        {
-          edgeType = sgn(srcLine[x] - srcLineAbove[x+1]) - signUpLine[x-1];
-          diff [edgeType] += (orgLine[x] - srcLine[x]);
-          count[edgeType] ++;
-        }
-
-        srcLine += srcStride;
-        orgLine += orgStride;
+        edgeStatsLines(-srcStride+1, srcStride-1, 0, 1, firstLineStartX, firstLineEndX);
 
         //middle lines
-        for (y=1; y<endY; y++)
-        {
-          srcLineBelow = srcLine + srcStride;
-
-          for(x=startX; x<endX; x++)
-          {
-            signDown = (SChar)sgn(srcLine[x] - srcLineBelow[x-1]);
-            edgeType = signDown + signUpLine[x];
+        edgeStatsLines(-srcStride+1, srcStride-1, 1, endY - 1, startX, endX);
 
-            diff [edgeType] += (orgLine[x] - srcLine[x]);
-            count[edgeType] ++;
-
-            signUpLine[x-1] = -signDown;
-          }
-          signUpLine[endX-1] = (SChar)sgn(srcLineBelow[endX-1] - srcLine[endX]);
-          srcLine  += srcStride;
-          orgLine  += orgStride;
-        }
         if(isCalculatePreDeblockSamples)
         {
           if(isBelowAvail)
           {
             startX = isLeftAvail  ? 0     : 1 ;
             endX   = isRightAvail ? width : (width -1);
-
-            for(y=0; y<skipLinesB[typeIdx]; y++)
-            {
-              srcLineBelow = srcLine + srcStride;
-              srcLineAbove = srcLine - srcStride;
-
-              for (x=startX; x<endX; x++)
-              {
-                edgeType = sgn(srcLine[x] - srcLineBelow[x-1]) + sgn(srcLine[x] - srcLineAbove[x+1]);
-                diff [edgeType] += (orgLine[x] - srcLine[x]);
-                count[edgeType] ++;
-              }
-              srcLine  += srcStride;
-              orgLine  += orgStride;
-            }
+            edgeStatsLines(-srcStride+1, srcStride-1, std::max(endY, 1), skipLinesB[typeIdx], startX, endX);
           }
         }
       }
@@ -40,10 +40,12 @@
 #include "TLibCommon/TComRom.h"
 #include "TLibCommon/TComMotionInfo.h"
 #include "TEncSearch.h"
+#include "TEncPic.h"
 #include "TLibCommon/TComTU.h"
 #include "TLibCommon/Debug.h"
 #include <math.h>
 #include <limits>
+#include <algorithm>
 
 
 //! \ingroup TLibEncoder
@@ -118,7 +120,9 @@ TEncSearch::TEncSearch()
 , m_pppcRDSbacCoder (NULL)
 , m_pcRDGoOnSbacCoder (NULL)
 , m_pTempPel (NULL)
+, m_uiMotionCacheStamp (0)
 , m_isInitialized (false)
+, m_iNumTZSearchCandidates (0)
 {
   for (UInt ch=0; ch<MAX_NUM_COMPONENT; ch++)
   {
@@ -305,9 +309,102 @@ Void TEncSearch::init(TEncCfg*       pcEncCfg,
   }
   m_pcQTTempTransformSkipTComYuv.create( maxCUWidth, maxCUHeight, pcEncCfg->getChromaFormatIdc() );
   m_tmpYuvPred.create(MAX_CU_SIZE, MAX_CU_SIZE, pcEncCfg->getChromaFormatIdc());
+
+  MotionCacheEntry cEmptyEntry;
+  cEmptyEntry.uiStamp = 0;
+  cEmptyEntry.iCUPosX = 0;
+  cEmptyEntry.iCUPosY = 0;
+  m_motionCache.assign( MAX_CU_DEPTH * NUMBER_OF_PART_SIZES * 4 * NUM_REF_PIC_LIST_01 * MAX_NUM_REF, cEmptyEntry );
   m_isInitialized = true;
 }
 
+Void TEncSearch::resetIntegerMv2Nx2N()
+{
+  for ( Int iRefList = 0; iRefList < NUM_REF_PIC_LIST_01; iRefList++ )
+  {
+    for ( Int iRefIdx = 0; iRefIdx < MAX_NUM_REF; iRefIdx++ )
+    {
+      m_integerMv2Nx2N[iRefList][iRefIdx].setZero();
+    }
+  }
+}
+
+/** index of the partition of a CU containing a sample
+ * \param ePartSize partition size of the CU
+ * \param iCUSize   width and height of the CU
+ * \param iX        horizontal position of the sample in the CU
+ * \param iY        vertical position of the sample in the CU
+ */
+static Int getPartIdxAt( PartSize ePartSize, Int iCUSize, Int iX, Int iY )
+{
+  switch ( ePartSize )
+  {
+    case SIZE_2NxN:  return iY >= iCUSize / 2     ? 1 : 0;
+    case SIZE_Nx2N:  return iX >= iCUSize / 2     ? 1 : 0;
+    case SIZE_NxN:   return ( iY >= iCUSize / 2 ? 2 : 0 ) + ( iX >= iCUSize / 2 ? 1 : 0 );
+    case SIZE_2NxnU: return iY >= iCUSize / 4     ? 1 : 0;
+    case SIZE_2NxnD: return iY >= iCUSize * 3 / 4 ? 1 : 0;
+    case SIZE_nLx2N: return iX >= iCUSize / 4     ? 1 : 0;
+    case SIZE_nRx2N: return iX >= iCUSize * 3 / 4 ? 1 : 0;
+    default:         return 0;
+  }
+}
+
+/** Collect the integer vectors the fast search found in the current CTU for the partitions of the current CU and of
+ * the CUs enclosing it (which are searched before their sub-CUs) that contain the centre of a prediction block.
+ * The partitions of the nearest CU come first; the 2Nx2N partition of the current CU is left out, as it is
+ * tested through m_integerMv2Nx2N.
+ * \returns number of vectors written to pcMvs, at most MOTION_CACHE_MAX_CANDIDATES
+ */
+Int TEncSearch::xGetMotionCacheCandidates( const TComDataCU* const pcCU, Int iPartIdx, RefPicList eRefPicList, Int iRefIdx, TComMv* pcMvs )
+{
+  Int iPosX, iPosY, iWidth, iHeight;
+  pcCU->getPartPosition( iPartIdx, iPosX, iPosY, iWidth, iHeight );
+  const Int iCentreX    = iPosX + iWidth  / 2;
+  const Int iCentreY    = iPosY + iHeight / 2;
+  const Int iCurrDepth  = pcCU->getDepth( 0 );
+  const Int iMaxCUWidth = pcCU->getSlice()->getSPS()->getMaxCUWidth();
+
+  Int iNumMvs = 0;
+  for ( Int iDepth = iCurrDepth; iDepth >= 0; iDepth-- )
+  {
+    const Int iCUSize = iMaxCUWidth >> iDepth;
+    const Int iCUPosX = iCentreX - iCentreX % iCUSize;
+    const Int iCUPosY = iCentreY - iCentreY % iCUSize;
+    for ( Int iSize = 0; iSize < NUMBER_OF_PART_SIZES; iSize++ )
+    {
+      if ( iDepth == iCurrDepth && ( iSize == SIZE_2Nx2N || iSize == pcCU->getPartitionSize( 0 ) ) )
+      {
+        continue;
+      }
+      const Int iPart = getPartIdxAt( PartSize( iSize ), iCUSize, iCentreX - iCUPosX, iCentreY - iCUPosY );
+      const MotionCacheEntry& rcEntry = m_motionCache[ ( ( ( iDepth * NUMBER_OF_PART_SIZES + iSize ) * 4 + iPart ) * NUM_REF_PIC_LIST_01 + eRefPicList ) * MAX_NUM_REF + iRefIdx ];
+      if ( rcEntry.uiStamp != m_uiMotionCacheStamp || rcEntry.iCUPosX != iCUPosX || rcEntry.iCUPosY != iCUPosY ||
+           std::find( pcMvs, pcMvs + iNumMvs, rcEntry.cMv ) != pcMvs + iNumMvs )
+      {
+        continue;
+      }
+      pcMvs[iNumMvs++] = rcEntry.cMv;
+      if ( iNumMvs == MOTION_CACHE_MAX_CANDIDATES )
+      {
+        return iNumMvs;
+      }
+    }
+  }
+  return iNumMvs;
+}
+
+/** Record the integer vector found by the fast search for a prediction block
+ */
+Void TEncSearch::xStoreMotionCache( const TComDataCU* const pcCU, Int iPartIdx, RefPicList eRefPicList, Int iRefIdx, const TComMv& rcMv )
+{
+  MotionCacheEntry& rcEntry = m_motionCache[ ( ( ( pcCU->getDepth( 0 ) * NUMBER_OF_PART_SIZES + pcCU->getPartitionSize( 0 ) ) * 4 + iPartIdx ) * NUM_REF_PIC_LIST_01 + eRefPicList ) * MAX_NUM_REF + iRefIdx ];
+  rcEntry.uiStamp = m_uiMotionCacheStamp;
+  rcEntry.iCUPosX = pcCU->getCUPelX();
+  rcEntry.iCUPosY = pcCU->getCUPelY();
+  rcEntry.cMv     = rcMv;
+}
+
 
 __inline Void TEncSearch::xTZSearchHelp( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance )
 {
@@ -420,6 +517,92 @@ __inline Void TEncSearch::xTZSearchHelp( const TComPattern* const pcPatternKey,
   }
 }
 
+/** Queue a search point of the TZ search, whose cost is computed together with the other queued points by
+ *  xTZSearchEvaluateCandidates. The queue is evaluated when it is full.
+ */
+__inline Void TEncSearch::xTZSearchAddCandidate( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance )
+{
+  TZSearchCandidate& rcCand = m_acTZSearchCandidates[m_iNumTZSearchCandidates++];
+  rcCand.iSearchX   = iSearchX;
+  rcCand.iSearchY   = iSearchY;
+  rcCand.ucPointNr  = ucPointNr;
+  rcCand.uiDistance = uiDistance;
+  if ( m_iNumTZSearchCandidates == TZ_SEARCH_MAX_CANDIDATES )
+  {
+    xTZSearchEvaluateCandidates( pcPatternKey, rcStruct );
+  }
+}
+
+/** Evaluate the queued search points in the order they were added, with the same result as calling xTZSearchHelp
+ *  for each of them. The SADs of all points are computed by one call of the multi-candidate distortion function,
+ *  as the best cost of the points evaluated before only decides whether the motion cost of a point is added.
+ */
+Void TEncSearch::xTZSearchEvaluateCandidates( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct )
+{
+  const Int iNumCand = m_iNumTZSearchCandidates;
+  m_iNumTZSearchCandidates = 0;
+  if ( iNumCand == 0 )
+  {
+    return;
+  }
+
+  const TZSearchCandidate* const pcCand = m_acTZSearchCandidates;
+  const Bool bSelectiveSampling = ( m_pcEncCfg->getRestrictMESampling() == false ) && m_pcEncCfg->getMotionEstimationSearchMethod() == MESEARCH_SELECTIVE;
+  m_pcRdCost->setDistParam( pcPatternKey, rcStruct.piRefY, rcStruct.iYStride, m_cDistParam );
+  if ( bSelectiveSampling || iNumCand == 1 || m_cDistParam.MultiDistFunc == NULL )
+  {
+    for ( Int i = 0; i < iNumCand; i++ )
+    {
+      xTZSearchHelp( pcPatternKey, rcStruct, pcCand[i].iSearchX, pcCand[i].iSearchY, pcCand[i].ucPointNr, pcCand[i].uiDistance );
+    }
+    return;
+  }
+
+  setDistParamComp(COMPONENT_Y);
+  m_cDistParam.bitDepth = pcPatternKey->getBitDepthY();
+  m_cDistParam.m_maximumDistortionForEarlyExit = rcStruct.uiBestSad;
+
+  // fast encoder decision: use subsampled SAD when rows > 8 for integer ME
+  if ( m_pcEncCfg->getFastInterSearchMode()==FASTINTERSEARCH_MODE1 || m_pcEncCfg->getFastInterSearchMode()==FASTINTERSEARCH_MODE3 )
+  {
+    if ( m_cDistParam.iRows > 8 )
+    {
+      m_cDistParam.iSubShift = 1;
+    }
+  }
+
+  const Pel* apiRefSrch[TZ_SEARCH_MAX_CANDIDATES];
+  Distortion auiSad[TZ_SEARCH_MAX_CANDIDATES];
+  for ( Int i = 0; i < iNumCand; i++ )
+  {
+    apiRefSrch[i] = rcStruct.piRefY + pcCand[i].iSearchY * rcStruct.iYStride + pcCand[i].iSearchX;
+  }
+  m_cDistParam.MultiDistFunc( &m_cDistParam, apiRefSrch, iNumCand, auiSad );
+
+  for ( Int i = 0; i < iNumCand; i++ )
+  {
+    Distortion uiSad = auiSad[i];
+    // only add motion cost if uiSad is smaller than best. Otherwise pointless
+    // to add motion cost.
+    if( uiSad < rcStruct.uiBestSad )
+    {
+      // motion cost
+      uiSad += m_pcRdCost->getCostOfVectorWithPredictor( pcCand[i].iSearchX, pcCand[i].iSearchY );
+
+      if( uiSad < rcStruct.uiBestSad )
+      {
+        rcStruct.uiBestSad      = uiSad;
+        rcStruct.iBestX         = pcCand[i].iSearchX;
+        rcStruct.iBestY         = pcCand[i].iSearchY;
+        rcStruct.uiBestDistance = pcCand[i].uiDistance;
+        rcStruct.uiBestRound    = 0;
+        rcStruct.ucPointNr      = pcCand[i].ucPointNr;
+        m_cDistParam.m_maximumDistortionForEarlyExit = uiSad;
+      }
+    }
+  }
+}
+
 __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB )
 {
   Int   iSrchRngHorLeft   = pcMvSrchRngLT->getHor();
@@ -438,11 +621,11 @@ __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey
     {
       if ( (iStartX - 1) >= iSrchRngHorLeft )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY, 0, 2 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX - 1, iStartY, 0, 2 );
       }
       if ( (iStartY - 1) >= iSrchRngVerTop )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iStartY - 1, 0, 2 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iStartY - 1, 0, 2 );
       }
     }
       break;
@@ -452,11 +635,11 @@ __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey
       {
         if ( (iStartX - 1) >= iSrchRngHorLeft )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY - 1, 0, 2 );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX - 1, iStartY - 1, 0, 2 );
         }
         if ( (iStartX + 1) <= iSrchRngHorRight )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY - 1, 0, 2 );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX + 1, iStartY - 1, 0, 2 );
         }
       }
     }
@@ -465,11 +648,11 @@ __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey
     {
       if ( (iStartY - 1) >= iSrchRngVerTop )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iStartY - 1, 0, 2 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iStartY - 1, 0, 2 );
       }
       if ( (iStartX + 1) <= iSrchRngHorRight )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY, 0, 2 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX + 1, iStartY, 0, 2 );
       }
     }
       break;
@@ -479,11 +662,11 @@ __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey
       {
         if ( (iStartY + 1) <= iSrchRngVerBottom )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY + 1, 0, 2 );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX - 1, iStartY + 1, 0, 2 );
         }
         if ( (iStartY - 1) >= iSrchRngVerTop )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY - 1, 0, 2 );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX - 1, iStartY - 1, 0, 2 );
         }
       }
     }
@@ -494,11 +677,11 @@ __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey
       {
         if ( (iStartY - 1) >= iSrchRngVerTop )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY - 1, 0, 2 );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX + 1, iStartY - 1, 0, 2 );
         }
         if ( (iStartY + 1) <= iSrchRngVerBottom )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY + 1, 0, 2 );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX + 1, iStartY + 1, 0, 2 );
         }
       }
     }
@@ -507,11 +690,11 @@ __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey
     {
       if ( (iStartX - 1) >= iSrchRngHorLeft )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY , 0, 2 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX - 1, iStartY , 0, 2 );
       }
       if ( (iStartY + 1) <= iSrchRngVerBottom )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iStartY + 1, 0, 2 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iStartY + 1, 0, 2 );
       }
     }
       break;
@@ -521,11 +704,11 @@ __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey
       {
         if ( (iStartX - 1) >= iSrchRngHorLeft )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX - 1, iStartY + 1, 0, 2 );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX - 1, iStartY + 1, 0, 2 );
         }
         if ( (iStartX + 1) <= iSrchRngHorRight )
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY + 1, 0, 2 );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX + 1, iStartY + 1, 0, 2 );
         }
       }
     }
@@ -534,11 +717,11 @@ __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey
     {
       if ( (iStartX + 1) <= iSrchRngHorRight )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX + 1, iStartY, 0, 2 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX + 1, iStartY, 0, 2 );
       }
       if ( (iStartY + 1) <= iSrchRngVerBottom )
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iStartY + 1, 0, 2 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iStartY + 1, 0, 2 );
       }
     }
       break;
@@ -548,6 +731,8 @@ __inline Void TEncSearch::xTZ2PointSearch( const TComPattern* const pcPatternKey
     }
       break;
   } // switch( rcStruct.ucPointNr )
+
+  xTZSearchEvaluateCandidates( pcPatternKey, rcStruct );
 }
 
 
@@ -574,38 +759,40 @@ __inline Void TEncSearch::xTZ8PointSquareSearch( const TComPattern* const pcPatt
   {
     if ( iLeft >= iSrchRngHorLeft ) // check top left
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iTop, 1, iDist );
+      xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft, iTop, 1, iDist );
     }
     // top middle
-    xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
+    xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
 
     if ( iRight <= iSrchRngHorRight ) // check top right
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iRight, iTop, 3, iDist );
+      xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight, iTop, 3, iDist );
     }
   } // check top
   if ( iLeft >= iSrchRngHorLeft ) // check middle left
   {
-    xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
+    xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
   }
   if ( iRight <= iSrchRngHorRight ) // check middle right
   {
-    xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
+    xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
   }
   if ( iBottom <= iSrchRngVerBottom ) // check bottom
   {
     if ( iLeft >= iSrchRngHorLeft ) // check bottom left
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iBottom, 6, iDist );
+      xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft, iBottom, 6, iDist );
     }
     // check bottom middle
-    xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
+    xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
 
     if ( iRight <= iSrchRngHorRight ) // check bottom right
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iRight, iBottom, 8, iDist );
+      xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight, iBottom, 8, iDist );
     }
   } // check bottom
+
+  xTZSearchEvaluateCandidates( pcPatternKey, rcStruct );
 }
 
 
@@ -643,26 +830,26 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( const TComPattern*const  pcPat
       {
         if ( iLeft >= iSrchRngHorLeft) // check top-left
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iTop, 1, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft, iTop, 1, iDist );
         }
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
         if ( iRight <= iSrchRngHorRight ) // check middle right
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iRight, iTop, 3, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight, iTop, 3, iDist );
         }
       }
       else
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
       }
     }
     if ( iLeft >= iSrchRngHorLeft ) // check middle left
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
+      xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
     }
     if ( iRight <= iSrchRngHorRight ) // check middle right
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
+      xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
     }
     if ( iBottom <= iSrchRngVerBottom ) // check bottom
     {
@@ -670,17 +857,17 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( const TComPattern*const  pcPat
       {
         if ( iLeft >= iSrchRngHorLeft) // check top-left
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iBottom, 6, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft, iBottom, 6, iDist );
         }
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
         if ( iRight <= iSrchRngHorRight ) // check middle right
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iRight, iBottom, 8, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight, iBottom, 8, iDist );
         }
       }
       else
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
       }
     }
   }
@@ -696,54 +883,54 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( const TComPattern*const  pcPat
       if (  iTop >= iSrchRngVerTop && iLeft >= iSrchRngHorLeft &&
           iRight <= iSrchRngHorRight && iBottom <= iSrchRngVerBottom ) // check border
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX,  iTop,      2, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2,  iTop_2,    1, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iTop_2,    3, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft,    iStartY,   4, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight,   iStartY,   5, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2,  iBottom_2, 6, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX,  iBottom,   7, iDist    );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX,  iTop,      2, iDist    );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft_2,  iTop_2,    1, iDist>>1 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight_2, iTop_2,    3, iDist>>1 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft,    iStartY,   4, iDist    );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight,   iStartY,   5, iDist    );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft_2,  iBottom_2, 6, iDist>>1 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, iDist>>1 );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX,  iBottom,   7, iDist    );
       }
       else // check border
       {
         if ( iTop >= iSrchRngVerTop ) // check top
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
         }
         if ( iTop_2 >= iSrchRngVerTop ) // check half top
         {
           if ( iLeft_2 >= iSrchRngHorLeft ) // check half left
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2, iTop_2, 1, (iDist>>1) );
+            xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft_2, iTop_2, 1, (iDist>>1) );
           }
           if ( iRight_2 <= iSrchRngHorRight ) // check half right
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iTop_2, 3, (iDist>>1) );
+            xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight_2, iTop_2, 3, (iDist>>1) );
           }
         } // check half top
         if ( iLeft >= iSrchRngHorLeft ) // check left
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
         }
         if ( iRight <= iSrchRngHorRight ) // check right
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
         }
         if ( iBottom_2 <= iSrchRngVerBottom ) // check half bottom
         {
           if ( iLeft_2 >= iSrchRngHorLeft ) // check half left
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2, iBottom_2, 6, (iDist>>1) );
+            xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft_2, iBottom_2, 6, (iDist>>1) );
           }
           if ( iRight_2 <= iSrchRngHorRight ) // check half right
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, (iDist>>1) );
+            xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, (iDist>>1) );
           }
         } // check half bottom
         if ( iBottom <= iSrchRngVerBottom ) // check bottom
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
         }
       } // check border
     }
@@ -752,39 +939,39 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( const TComPattern*const  pcPat
       if ( iTop >= iSrchRngVerTop && iLeft >= iSrchRngHorLeft &&
           iRight <= iSrchRngHorRight && iBottom <= iSrchRngVerBottom ) // check border
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop,    0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft,   iStartY, 0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight,  iStartY, 0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iTop,    0, iDist );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft,   iStartY, 0, iDist );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight,  iStartY, 0, iDist );
+        xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
         for ( Int index = 1; index < 4; index++ )
         {
           const Int iPosYT = iTop    + ((iDist>>2) * index);
           const Int iPosYB = iBottom - ((iDist>>2) * index);
           const Int iPosXL = iStartX - ((iDist>>2) * index);
           const Int iPosXR = iStartX + ((iDist>>2) * index);
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
         }
       }
       else // check border
       {
         if ( iTop >= iSrchRngVerTop ) // check top
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 0, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iTop, 0, iDist );
         }
         if ( iLeft >= iSrchRngHorLeft ) // check left
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 0, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iLeft, iStartY, 0, iDist );
         }
         if ( iRight <= iSrchRngHorRight ) // check right
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 0, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iRight, iStartY, 0, iDist );
         }
         if ( iBottom <= iSrchRngVerBottom ) // check bottom
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
+          xTZSearchAddCandidate( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
         }
         for ( Int index = 1; index < 4; index++ )
         {
@@ -797,44 +984,52 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( const TComPattern*const  pcPat
           {
             if ( iPosXL >= iSrchRngHorLeft ) // check left
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
+              xTZSearchAddCandidate( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
             }
             if ( iPosXR <= iSrchRngHorRight ) // check right
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
+              xTZSearchAddCandidate( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
             }
           } // check top
           if ( iPosYB <= iSrchRngVerBottom ) // check bottom
           {
             if ( iPosXL >= iSrchRngHorLeft ) // check left
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
+              xTZSearchAddCandidate( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
             }
             if ( iPosXR <= iSrchRngHorRight ) // check right
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
+              xTZSearchAddCandidate( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
             }
           } // check bottom
         } // for ...
       } // check border
     } // iDist <= 8
   } // iDist == 1
+
+  xTZSearchEvaluateCandidates( pcPatternKey, rcStruct );
 }
 
+/** Test the 9 fractional positions around baseRefMv
+ * \param ppiSubPelRef     when not NULL, the 16 quarter-sample phases [ver*4+hor] of the reference picture at the
+ *                         integer vector, read instead of the blocks interpolated by xExtDIFUpSamplingH/Q
+ * \param iSubPelRefStride stride of the planes of ppiSubPelRef
+ */
 Distortion TEncSearch::xPatternRefinement( TComPattern* pcPatternKey,
                                            TComMv baseRefMv,
                                            Int iFrac, TComMv& rcMvFrac,
-                                           Bool bAllowUseOfHadamard
+                                           Bool bAllowUseOfHadamard,
+                                           const Pel* const* ppiSubPelRef, Int iSubPelRefStride
                                          )
 {
   Distortion  uiDist;
   Distortion  uiDistBest  = std::numeric_limits<Distortion>::max();
   UInt        uiDirecBest = 0;
 
-  Pel*  piRefPos;
-  Int iRefStride = m_filteredBlock[0][0].getStride(COMPONENT_Y);
+  const Pel* piRefPos;
+  Int iRefStride = ppiSubPelRef ? iSubPelRefStride : m_filteredBlock[0][0].getStride(COMPONENT_Y);
 
-  m_pcRdCost->setDistParam( pcPatternKey, m_filteredBlock[0][0].getAddr(COMPONENT_Y), iRefStride, 1, m_cDistParam, m_pcEncCfg->getUseHADME() && bAllowUseOfHadamard );
+  m_pcRdCost->setDistParam( pcPatternKey, ppiSubPelRef ? ppiSubPelRef[0] : m_filteredBlock[0][0].getAddr(COMPONENT_Y), iRefStride, 1, m_cDistParam, m_pcEncCfg->getUseHADME() && bAllowUseOfHadamard );
 
   const TComMv* pcMvRefine = (iFrac == 2 ? s_acMvRefineH : s_acMvRefineQ);
 
@@ -870,14 +1065,21 @@ Distortion TEncSearch::xPatternRefinement( TComPattern* pcPatternKey,
 
     Int horVal = cMvTest.getHor() * iFrac;
     Int verVal = cMvTest.getVer() * iFrac;
-    piRefPos = m_filteredBlock[ verVal & 3 ][ horVal & 3 ].getAddr(COMPONENT_Y);
-    if ( horVal == 2 && ( verVal & 1 ) == 0 )
+    if ( ppiSubPelRef )
     {
-      piRefPos += 1;
+      piRefPos = ppiSubPelRef[ ( verVal & 3 ) * 4 + ( horVal & 3 ) ] + ( verVal >> 2 ) * iRefStride + ( horVal >> 2 );
     }
-    if ( ( horVal & 1 ) == 0 && verVal == 2 )
+    else
     {
-      piRefPos += iRefStride;
+      piRefPos = m_filteredBlock[ verVal & 3 ][ horVal & 3 ].getAddr(COMPONENT_Y);
+      if ( horVal == 2 && ( verVal & 1 ) == 0 )
+      {
+        piRefPos += 1;
+      }
+      if ( ( horVal & 1 ) == 0 && verVal == 2 )
+      {
+        piRefPos += iRefStride;
+      }
     }
     cMvTest = pcMvRefine[i];
     cMvTest += rcMvFrac;
@@ -1336,6 +1538,7 @@ Void TEncSearch::xIntraCodingTUBlock(       TComYuv*    pcOrgYuv,
     );
 
   //--- inverse transform ---
+  Bool bReconstructed = false;
 
 #if DEBUG_STRING
   if ( (uiAbsSum > 0) || (DebugOptionList::DebugString_InvTran.getInt()&debugPredModeMask) )
@@ -1344,8 +1547,19 @@ Void TEncSearch::xIntraCodingTUBlock(       TComYuv*    pcOrgYuv,
   if ( uiAbsSum > 0 )
 #endif
   {
-    // 反变换
-    m_pcTrQuant->invTransformNxN ( rTu, compID, piResi, uiStride, pcCoeff, cQP DEBUG_STRING_PASS_INTO_OPTIONAL(&sDebug, (DebugOptionList::DebugString_InvTran.getInt()&debugPredModeMask)) );
+#if !DEBUG_STRING
+    if (!bUseCrossCPrediction)
+    {
+      // inverse transform, addition of the prediction and clipping in one pass
+      m_pcTrQuant->invTransformRecNxN ( rTu, compID, piResi, uiStride, pcCoeff, cQP, piPred, uiStride, piReco, uiStride );
+      bReconstructed = true;
+    }
+    else
+#endif
+    {
+      // 反变换
+      m_pcTrQuant->invTransformNxN ( rTu, compID, piResi, uiStride, pcCoeff, cQP DEBUG_STRING_PASS_INTO_OPTIONAL(&sDebug, (DebugOptionList::DebugString_InvTran.getInt()&debugPredModeMask)) );
+    }
   }
   else
   {
@@ -1437,12 +1651,15 @@ Void TEncSearch::xIntraCodingTUBlock(       TComYuv*    pcOrgYuv,
 
       for( UInt uiY = 0; uiY < uiHeight; uiY++ )
       {
-        for( UInt uiX = 0; uiX < uiWidth; uiX++ )
+        if (!bReconstructed)
         {
-          pReco    [ uiX ] = Pel(ClipBD<Int>( Int(pPred[uiX]) + Int(pResi[uiX]), bitDepth ));
-          pRecQt   [ uiX ] = pReco[ uiX ];
-          pRecIPred[ uiX ] = pReco[ uiX ];
+          for( UInt uiX = 0; uiX < uiWidth; uiX++ )
+          {
+            pReco[ uiX ] = Pel(ClipBD<Int>( Int(pPred[uiX]) + Int(pResi[uiX]), bitDepth ));
+          }
         }
+        ::memcpy( pRecQt,    pReco, uiWidth * sizeof( Pel ) );
+        ::memcpy( pRecIPred, pReco, uiWidth * sizeof( Pel ) );
         pPred     += uiStride;
         pResi     += uiStride;
         pReco     += uiStride;
@@ -2364,6 +2581,29 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
       const Bool bUseHadamard=pcCU->getCUTransquantBypass(0) == 0;
       m_pcRdCost->setDistParam(distParam, sps.getBitDepth(CHANNEL_TYPE_LUMA), piOrg, uiStride, piPred, uiStride, puRect.width, puRect.height, bUseHadamard);
       distParam.bApplyWeight = false;
+
+      // The horizontal angular modes are predicted transposed, without the final flip, and compared with the
+      // transposed original: the Hadamard and SAD costs of a square block and of its transpose are equal.
+      assert( puRect.width == puRect.height );
+      Pel orgTransposed[MAX_CU_SIZE*MAX_CU_SIZE];
+      for( UInt y = 0; y < puRect.height; y++ )
+      {
+        for( UInt x = 0; x < puRect.width; x++ )
+        {
+          orgTransposed[x*puRect.height+y] = piOrg[y*uiStride+x];
+        }
+      }
+      DistParam distParamTransposed;
+      m_pcRdCost->setDistParam(distParamTransposed, sps.getBitDepth(CHANNEL_TYPE_LUMA), orgTransposed, puRect.height, piPred, uiStride, puRect.width, puRect.height, bUseHadamard);
+      distParamTransposed.bApplyWeight = false;
+
+      // The mode bits only depend on the index of the mode in the most probable mode list (or on its absence),
+      // and are estimated once per index.
+      Int  mpmModes[NUM_MOST_PROBABLE_MODES];
+      UInt mpmModeBits[NUM_MOST_PROBABLE_MODES+1];
+      Bool mpmModeBitsKnown[NUM_MOST_PROBABLE_MODES+1] = { false, false, false, false };
+      pcCU->getIntraDirPredictor( uiPartOffset, mpmModes, COMPONENT_Y );
+
       // ==== 从所有的35种模式中选出若干最优模式 ====
       // 遍历35中帧内预测模式，选取若干个代价比较小的模式作为后续处理的模式
       // 总共有35种模式，numModesAvailable=35
@@ -2375,18 +2615,32 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
         // 在帧内预测之前，使用重建后的YUV图像对当前PU的相邻样点进行滤波
         const Bool bUseFilter=TComPrediction::filteringIntraReferenceSamples(COMPONENT_Y, uiMode, puRect.width, puRect.height, chFmt, sps.getSpsRangeExtension().getIntraSmoothingDisabledFlag());
 
+        const Bool bUseDPCM   = TComPrediction::UseDPCMForFirstPassIntraEstimation(tuRecurseWithPU, uiMode);
+        const Bool bTranspose = uiMode > DC_IDX && uiMode < 18 && !bUseDPCM;
+
         // 对亮度块进行预测
-        predIntraAng( COMPONENT_Y, uiMode, piOrg, uiStride, piPred, uiStride, tuRecurseWithPU, bUseFilter, TComPrediction::UseDPCMForFirstPassIntraEstimation(tuRecurseWithPU, uiMode) );
+        predIntraAng( COMPONENT_Y, uiMode, piOrg, uiStride, piPred, uiStride, tuRecurseWithPU, bUseFilter, bUseDPCM, bTranspose );
 
         // use hadamard transform here
         // 对残差信号进行Hadamard变换计算satd值
         // 使用hadamard变换，计算satd的值
-        uiSad+=distParam.DistFunc(&distParam);
-
-        UInt   iModeBits = 0;
+        uiSad+=bTranspose ? distParamTransposed.DistFunc(&distParamTransposed) : distParam.DistFunc(&distParam);
 
-        // NB xModeBitsIntra will not affect the mode for chroma that may have already been pre-estimated.
-        iModeBits+=xModeBitsIntra( pcCU, uiMode, uiPartOffset, uiDepth, CHANNEL_TYPE_LUMA );
+        Int mpmIdx = NUM_MOST_PROBABLE_MODES;
+        for( Int i = 0; i < NUM_MOST_PROBABLE_MODES; i++ )
+        {
+          if( mpmModes[i] == Int(uiMode) )
+          {
+            mpmIdx = i;
+          }
+        }
+        if( !mpmModeBitsKnown[mpmIdx] )
+        {
+          // NB xModeBitsIntra will not affect the mode for chroma that may have already been pre-estimated.
+          mpmModeBits[mpmIdx]      = xModeBitsIntra( pcCU, uiMode, uiPartOffset, uiDepth, CHANNEL_TYPE_LUMA );
+          mpmModeBitsKnown[mpmIdx] = true;
+        }
+        UInt   iModeBits = mpmModeBits[mpmIdx];
         // 利用SATD值计算每种预测模式的率失真代价，选取失真代价最小的几种模式为预测模式集
 
         // 计算此种模式下的代价
@@ -3976,12 +4230,45 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
     {
       pIntegerMv2Nx2NPred = &(m_integerMv2Nx2N[eRefPicList][iRefIdxPred]);
     }
+    // vector of the pre-motion search on the downsampled pictures, whose search window is added to the one of the predictor
+    const TComMv *pPreMotionMv=0;
+    TComMv        cPreMotionMv;
+    const TEncPic* pcEPic = m_pcEncCfg->getPreMotionSearchEnabled() ? dynamic_cast<const TEncPic*>( pcCU->getPic() ) : NULL;
+    if ( pcEPic != NULL )
+    {
+      Int iPosX, iPosY, iWidth, iHeight;
+      pcCU->getPartPosition( iPartIdx, iPosX, iPosY, iWidth, iHeight );
+      if ( pcEPic->getPreMotionMv( pcCU->getSlice()->getRefPOC( eRefPicList, iRefIdxPred ), iPosX + iWidth / 2, iPosY + iHeight / 2, cPreMotionMv ) )
+      {
+        TComMv cPreMotionSrchRngLT;
+        TComMv cPreMotionSrchRngRB;
+#if MCTS_ENC_CHECK
+        xSetSearchRange(pcCU, cPreMotionMv, iSrchRng, cPreMotionSrchRngLT, cPreMotionSrchRngRB, &cPattern);
+#else
+        xSetSearchRange(pcCU, cPreMotionMv, iSrchRng, cPreMotionSrchRngLT, cPreMotionSrchRngRB);
+#endif
+        cMvSrchRngLT.set( std::min( cMvSrchRngLT.getHor(), cPreMotionSrchRngLT.getHor() ), std::min( cMvSrchRngLT.getVer(), cPreMotionSrchRngLT.getVer() ) );
+        cMvSrchRngRB.set( std::max( cMvSrchRngRB.getHor(), cPreMotionSrchRngRB.getHor() ), std::max( cMvSrchRngRB.getVer(), cPreMotionSrchRngRB.getVer() ) );
+        pPreMotionMv = &cPreMotionMv;
+      }
+    }
+    // vectors found for the blocks of this CU and of the enclosing CUs that cover the centre of the prediction block
+    TComMv acCachedMvs[MOTION_CACHE_MAX_CANDIDATES];
+    Int    iNumCachedMvs = 0;
+    if ( m_pcEncCfg->getUseMotionSearchCache() )
+    {
+      iNumCachedMvs = xGetMotionCacheCandidates( pcCU, iPartIdx, eRefPicList, iRefIdxPred, acCachedMvs );
+    }
     // 快速搜索
-    xPatternSearchFast  ( pcCU, &cPattern, piRefY, iRefStride, &cMvSrchRngLT, &cMvSrchRngRB, rcMv, ruiCost, pIntegerMv2Nx2NPred );
+    xPatternSearchFast  ( pcCU, &cPattern, piRefY, iRefStride, &cMvSrchRngLT, &cMvSrchRngRB, rcMv, ruiCost, pIntegerMv2Nx2NPred, pPreMotionMv, acCachedMvs, iNumCachedMvs );
     if (pcCU->getPartitionSize(0) == SIZE_2Nx2N)
     {
       m_integerMv2Nx2N[eRefPicList][iRefIdxPred] = rcMv;
     }
+    if ( m_pcEncCfg->getUseMotionSearchCache() )
+    {
+      xStoreMotionCache( pcCU, iPartIdx, eRefPicList, iRefIdxPred, rcMv );
+    }
   }
 
   m_pcRdCost->selectMotionLambda( true, 0, pcCU->getCUTransquantBypass(uiPartAddr) );
@@ -3989,7 +4276,21 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
 
   const Bool bIsLosslessCoded = pcCU->getCUTransquantBypass(uiPartAddr) != 0;
   // 进行亚像素搜索(1/2像素，1/4像素等)，以提高搜索的精度
-  xPatternSearchFracDIF( bIsLosslessCoded, &cPattern, piRefY, iRefStride, &rcMv, cMvHalf, cMvQter, ruiCost );
+  // the quarter-sample planes of the reference picture, interpolated once by TEncGOP when SubPelPlanes is enabled
+  TComPic*   pcRefPic = pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred );
+  const Pel* apiSubPelRef[16];
+  if ( pcRefPic->hasSubPelPlanes() )
+  {
+    const Int iPicOffset = Int( piRefY - pcRefPic->getPicYuvRec()->getAddr(COMPONENT_Y) );
+    for ( Int iVerFrac = 0; iVerFrac < 4; iVerFrac++ )
+    {
+      for ( Int iHorFrac = 0; iHorFrac < 4; iHorFrac++ )
+      {
+        apiSubPelRef[iVerFrac * 4 + iHorFrac] = pcRefPic->getPicYuvSubPel( iVerFrac, iHorFrac )->getAddr(COMPONENT_Y) + iPicOffset;
+      }
+    }
+  }
+  xPatternSearchFracDIF( bIsLosslessCoded, &cPattern, piRefY, iRefStride, &rcMv, cMvHalf, cMvQter, ruiCost, pcRefPic->hasSubPelPlanes() ? apiSubPelRef : NULL );
 
   m_pcRdCost->setCostScale( 0 );
   // 整像素
@@ -4193,7 +4494,10 @@ Void TEncSearch::xPatternSearchFast( const TComDataCU* const  pcCU,
                                      const TComMv* const      pcMvSrchRngRB,
                                      TComMv&                  rcMv,
                                      Distortion&              ruiSAD,
-                                     const TComMv* const      pIntegerMv2Nx2NPred )
+                                     const TComMv* const      pIntegerMv2Nx2NPred,
+                                     const TComMv* const      pPreMotionMv,
+                                     const TComMv* const      pcCachedMvs,
+                                     const Int                iNumCachedMvs )
 {
   assert (MD_LEFT < NUM_MV_PREDICTORS);
   pcCU->getMvPredLeft       ( m_acMvPredictors[MD_LEFT] );
@@ -4205,15 +4509,15 @@ Void TEncSearch::xPatternSearchFast( const TComDataCU* const  pcCU,
   switch ( m_motionEstimationSearchMethod )
   {
     case MESEARCH_DIAMOND:
-      xTZSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred, false );
+      xTZSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred, pPreMotionMv, pcCachedMvs, iNumCachedMvs, false );
       break;
 
     case MESEARCH_SELECTIVE:
-      xTZSearchSelective( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred );
+      xTZSearchSelective( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred, pPreMotionMv, pcCachedMvs, iNumCachedMvs );
       break;
 
     case MESEARCH_DIAMOND_ENHANCED:
-      xTZSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred, true );
+      xTZSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pIntegerMv2Nx2NPred, pPreMotionMv, pcCachedMvs, iNumCachedMvs, true );
       break;
 
     case MESEARCH_FULL: // shouldn't get here.
@@ -4255,6 +4559,9 @@ Void TEncSearch::xTZSearch( const TComDataCU* const pcCU,
                             TComMv&                  rcMv,
                             Distortion&              ruiSAD,
                             const TComMv* const      pIntegerMv2Nx2NPred,
+                            const TComMv* const      pPreMotionMv,
+                            const TComMv* const      pcCachedMvs,
+                            const Int                iNumCachedMvs,
                             const Bool               bExtendedSettings)
 {
   const Bool bUseAdaptiveRaster                      = bExtendedSettings;
@@ -4326,6 +4633,39 @@ Void TEncSearch::xTZSearch( const TComDataCU* const pcCU,
     }
   }
 
+  // test whether the vector of the pre-motion search is a better start point
+  if ( pPreMotionMv != 0 )
+  {
+    TComMv cMv = *pPreMotionMv;
+    pcCU->clipMv( cMv );
+#if ME_ENABLE_ROUNDING_OF_MVS
+    cMv.divideByPowerOf2(2);
+#else
+    cMv >>= 2;
+#endif
+    if (cMv != rcMv && (cMv.getHor() != cStruct.iBestX || cMv.getVer() != cStruct.iBestY))
+    {
+      xTZSearchHelp( pcPatternKey, cStruct, cMv.getHor(), cMv.getVer(), 0, 0 );
+    }
+  }
+
+  // test whether one of the vectors found for the overlapping blocks of the CTU is a better start point
+  for ( Int i = 0; i < iNumCachedMvs; i++ )
+  {
+    TComMv cMv = pcCachedMvs[i];
+    cMv <<= 2;
+    pcCU->clipMv( cMv );
+#if ME_ENABLE_ROUNDING_OF_MVS
+    cMv.divideByPowerOf2(2);
+#else
+    cMv >>= 2;
+#endif
+    if (cMv != rcMv && (cMv.getHor() != cStruct.iBestX || cMv.getVer() != cStruct.iBestY))
+    {
+      xTZSearchHelp( pcPatternKey, cStruct, cMv.getHor(), cMv.getVer(), 0, 0 );
+    }
+  }
+
   Int   iSrchRngHorLeft   = pcMvSrchRngLT->getHor();
   Int   iSrchRngHorRight  = pcMvSrchRngRB->getHor();
   Int   iSrchRngVerTop    = pcMvSrchRngLT->getVer();
@@ -4472,9 +4812,10 @@ Void TEncSearch::xTZSearch( const TComDataCU* const pcCU,
       {
         for ( iStartX = iSrchRngHorLeft; iStartX <= iSrchRngHorRight; iStartX += iRaster )
         {
-          xTZSearchHelp( pcPatternKey, cStruct, iStartX, iStartY, 0, iRaster );
+          xTZSearchAddCandidate( pcPatternKey, cStruct, iStartX, iStartY, 0, iRaster );
         }
       }
+      xTZSearchEvaluateCandidates( pcPatternKey, cStruct );
     }
   }
 
@@ -4562,7 +4903,10 @@ Void TEncSearch::xTZSearchSelective( const TComDataCU* const   pcCU,
                                      const TComMv* const       pcMvSrchRngRB,
                                      TComMv                   &rcMv,
                                      Distortion               &ruiSAD,
-                                     const TComMv* const       pIntegerMv2Nx2NPred )
+                                     const TComMv* const       pIntegerMv2Nx2NPred,
+                                     const TComMv* const       pPreMotionMv,
+                                     const TComMv* const       pcCachedMvs,
+                                     const Int                 iNumCachedMvs )
 {
   const Bool bTestOtherPredictedMV    = true;
   const Bool bTestZeroVector          = true;
@@ -4631,6 +4975,33 @@ Void TEncSearch::xTZSearchSelective( const TComDataCU* const   pcCU,
     xTZSearchHelp( pcPatternKey, cStruct, 0, 0, 0, 0 );
   }
 
+  // test whether the vector of the pre-motion search is a better start point
+  if ( pPreMotionMv != 0 )
+  {
+    TComMv cMv = *pPreMotionMv;
+    pcCU->clipMv( cMv );
+#if ME_ENABLE_ROUNDING_OF_MVS
+    cMv.divideByPowerOf2(2);
+#else
+    cMv >>= 2;
+#endif
+    xTZSearchHelp( pcPatternKey, cStruct, cMv.getHor(), cMv.getVer(), 0, 0 );
+  }
+
+  // test whether one of the vectors found for the overlapping blocks of the CTU is a better start point
+  for ( Int i = 0; i < iNumCachedMvs; i++ )
+  {
+    TComMv cMv = pcCachedMvs[i];
+    cMv <<= 2;
+    pcCU->clipMv( cMv );
+#if ME_ENABLE_ROUNDING_OF_MVS
+    cMv.divideByPowerOf2(2);
+#else
+    cMv >>= 2;
+#endif
+    xTZSearchHelp( pcPatternKey, cStruct, cMv.getHor(), cMv.getVer(), 0, 0 );
+  }
+
   if ( pIntegerMv2Nx2NPred != 0 )
   {
     TComMv integerMv2Nx2NPred = *pIntegerMv2Nx2NPred;
@@ -4756,7 +5127,8 @@ Void TEncSearch::xPatternSearchFracDIF(
                                        TComMv*      pcMvInt,
                                        TComMv&      rcMvHalf,
                                        TComMv&      rcMvQter,
-                                       Distortion&  ruiCost
+                                       Distortion&  ruiCost,
+                                       const Pel* const* ppiSubPelRef
                                       )
 {
   //  Reference pattern initialization (integer scale)
@@ -4777,22 +5149,38 @@ Void TEncSearch::xPatternSearchFracDIF(
   cPatternRoi.setTileBorders(pcPatternKey->getTileLeftTopPelPosX(), pcPatternKey->getTileLeftTopPelPosY(), pcPatternKey->getTileRightBottomPelPosX(), pcPatternKey->getTileRightBottomPelPosY());
 #endif
 
+  // precomputed planes of the reference picture at the integer vector
+  const Pel* apiSubPelRef[16];
+  if ( ppiSubPelRef )
+  {
+    for ( Int i = 0; i < 16; i++ )
+    {
+      apiSubPelRef[i] = ppiSubPelRef[i] + iOffset;
+    }
+  }
+
   //  Half-pel refinement
-  xExtDIFUpSamplingH ( &cPatternRoi );
+  if ( ppiSubPelRef == NULL )
+  {
+    xExtDIFUpSamplingH ( &cPatternRoi );
+  }
 
   rcMvHalf = *pcMvInt;   rcMvHalf <<= 1;    // for mv-cost
   TComMv baseRefMv(0, 0);
-  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 2, rcMvHalf, !bIsLosslessCoded );
+  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 2, rcMvHalf, !bIsLosslessCoded, ppiSubPelRef ? apiSubPelRef : NULL, iRefStride );
 
   m_pcRdCost->setCostScale( 0 );
 
-  xExtDIFUpSamplingQ ( &cPatternRoi, rcMvHalf );
+  if ( ppiSubPelRef == NULL )
+  {
+    xExtDIFUpSamplingQ ( &cPatternRoi, rcMvHalf );
+  }
   baseRefMv = rcMvHalf;
   baseRefMv <<= 1;
 
   rcMvQter = *pcMvInt;   rcMvQter <<= 1;    // for mv-cost
   rcMvQter += rcMvHalf;  rcMvQter <<= 1;
-  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 1, rcMvQter, !bIsLosslessCoded );
+  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 1, rcMvQter, !bIsLosslessCoded, ppiSubPelRef ? apiSubPelRef : NULL, iRefStride );
 }
 
 
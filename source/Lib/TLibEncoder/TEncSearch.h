@@ -118,6 +118,20 @@ protected:
 
   TComMv          m_integerMv2Nx2N[NUM_REF_PIC_LIST_01][MAX_NUM_REF];
 
+  /// integer vector found by the fast search for a prediction block of the current CTU
+  typedef struct
+  {
+    UInt        uiStamp;    ///< m_uiMotionCacheStamp of the CTU the vector was found in
+    Int         iCUPosX;    ///< position of the CU in the picture
+    Int         iCUPosY;
+    TComMv      cMv;
+  } MotionCacheEntry;
+
+  static const Int  MOTION_CACHE_MAX_CANDIDATES = 8;
+  /// indexed by CU depth, partition size, partition index, reference list and reference index
+  std::vector<MotionCacheEntry> m_motionCache;
+  UInt            m_uiMotionCacheStamp;
+
   Bool            m_isInitialized;
 public:
   TEncSearch();
@@ -143,7 +157,8 @@ protected:
   /// sub-function for motion vector refinement used in fractional-pel accuracy
   Distortion  xPatternRefinement( TComPattern* pcPatternKey,
                                   TComMv baseRefMv,
-                                  Int iFrac, TComMv& rcMvFrac, Bool bAllowUseOfHadamard
+                                  Int iFrac, TComMv& rcMvFrac, Bool bAllowUseOfHadamard,
+                                  const Pel* const* ppiSubPelRef = NULL, Int iSubPelRefStride = 0
                                  );
 
   typedef struct
@@ -158,8 +173,23 @@ protected:
     UChar       ucPointNr;
   } IntTZSearchStruct;
 
+  /// search point queued for xTZSearchEvaluateCandidates
+  typedef struct
+  {
+    Int         iSearchX;
+    Int         iSearchY;
+    UChar       ucPointNr;
+    UInt        uiDistance;
+  } TZSearchCandidate;
+
+  static const Int  TZ_SEARCH_MAX_CANDIDATES = 16;
+  TZSearchCandidate m_acTZSearchCandidates[TZ_SEARCH_MAX_CANDIDATES];
+  Int               m_iNumTZSearchCandidates;
+
   // sub-functions for ME
   __inline Void xTZSearchHelp         ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+  __inline Void xTZSearchAddCandidate ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+  Void          xTZSearchEvaluateCandidates( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct );
   __inline Void xTZ2PointSearch       ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB );
   __inline Void xTZ8PointSquareSearch ( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist );
   __inline Void xTZ8PointDiamondSearch( const TComPattern* const pcPatternKey, IntTZSearchStruct& rcStruct, const TComMv* const pcMvSrchRngLT, const TComMv* const pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist, const Bool bCheckCornersAtDist1 );
@@ -208,6 +238,11 @@ public:
 
   /// set ME search range
   Void setAdaptiveSearchRange   ( Int iDir, Int iRefIdx, Int iSearchRange) { assert(iDir < MAX_NUM_REF_LIST_ADAPT_SR && iRefIdx<Int(MAX_IDX_ADAPT_SR)); m_aaiAdaptSR[iDir][iRefIdx] = iSearchRange; }
+  Int  getAdaptiveSearchRange   ( Int iDir, Int iRefIdx ) const { assert(iDir < MAX_NUM_REF_LIST_ADAPT_SR && iRefIdx<Int(MAX_IDX_ADAPT_SR)); return m_aaiAdaptSR[iDir][iRefIdx]; }
+  /// clear the integer 2Nx2N motion vectors used as an additional start point of the fast search
+  Void resetIntegerMv2Nx2N      ();
+  /// forget the vectors of the motion search cache, at the start of a CTU
+  Void resetMotionCache         ()                               { m_uiMotionCacheStamp++; }
 
   Void xEncPCM    (TComDataCU* pcCU, UInt uiAbsPartIdx, Pel* piOrg, Pel* piPCM, Pel* piPred, Pel* piResi, Pel* piReco, UInt uiStride, UInt uiWidth, UInt uiHeight, const ComponentID compID );
   Void IPCMSearch (TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv* rpcPredYuv, TComYuv* rpcResiYuv, TComYuv* rpcRecoYuv );
@@ -379,6 +414,9 @@ protected:
                                     TComMv&                  rcMv,
                                     Distortion&              ruiSAD,
                                     const TComMv* const      pIntegerMv2Nx2NPred,
+                                    const TComMv* const      pPreMotionMv,
+                                    const TComMv* const      pcCachedMvs,
+                                    const Int                iNumCachedMvs,
                                     const Bool               bExtendedSettings
                                     );
 
@@ -390,9 +428,23 @@ protected:
                                     const TComMv* const      pcMvSrchRngRB,
                                     TComMv&                  rcMv,
                                     Distortion&              ruiSAD,
-                                    const TComMv* const      pIntegerMv2Nx2NPred
+                                    const TComMv* const      pIntegerMv2Nx2NPred,
+                                    const TComMv* const      pPreMotionMv,
+                                    const TComMv* const      pcCachedMvs,
+                                    const Int                iNumCachedMvs
                                     );
 
+  Int  xGetMotionCacheCandidates  ( const TComDataCU* const pcCU,
+                                    Int          iPartIdx,
+                                    RefPicList   eRefPicList,
+                                    Int          iRefIdx,
+                                    TComMv*      pcMvs );
+  Void xStoreMotionCache          ( const TComDataCU* const pcCU,
+                                    Int          iPartIdx,
+                                    RefPicList   eRefPicList,
+                                    Int          iRefIdx,
+                                    const TComMv& rcMv );
+
   Void xSetSearchRange            ( const TComDataCU* const pcCU,
                                     const TComMv&      cMvPred,
                                     const Int          iSrchRng,
@@ -416,7 +468,10 @@ protected:
                                     const TComMv* const      pcMvSrchRngRB,
                                     TComMv&                  rcMv,
                                     Distortion&              ruiSAD,
-                                    const TComMv* const      pIntegerMv2Nx2NPred
+                                    const TComMv* const      pIntegerMv2Nx2NPred,
+                                    const TComMv* const      pPreMotionMv,
+                                    const TComMv* const      pcCachedMvs,
+                                    const Int                iNumCachedMvs
                                   );
 
   Void xPatternSearch             ( const TComPattern* const pcPatternKey,
@@ -435,7 +490,8 @@ protected:
                                     TComMv*      pcMvInt,
                                     TComMv&      rcMvHalf,
                                     TComMv&      rcMvQter,
-                                    Distortion&  ruiCost
+                                    Distortion&  ruiCost,
+                                    const Pel* const* ppiSubPelRef = NULL
                                    );
 
   Void xExtDIFUpSamplingH( TComPattern* pcPattern );
@@ -47,7 +47,11 @@
 // ====================================================================================================================
 
 TEncSlice::TEncSlice()
- : m_encCABACTableIdx(I_SLICE)
+ : m_pcEncTop(NULL)
+ , m_pcSubstreamSyncContextStates(NULL)
+ , m_numSubstreamSyncContextStates(0)
+ , m_substreamsInParallelAllowed(true)
+ , m_encCABACTableIdx(I_SLICE)
 {
 }
 
@@ -63,6 +67,7 @@ Void TEncSlice::create( Int iWidth, Int iHeight, ChromaFormat chromaFormat, UInt
 
   // create residual picture
   m_picYuvResi.create( iWidth, iHeight, chromaFormat, iMaxCUWidth, iMaxCUHeight, uhTotalDepth, true );
+
 }
 
 Void TEncSlice::destroy()
@@ -70,6 +75,10 @@ Void TEncSlice::destroy()
   m_picYuvPred.destroy();
   m_picYuvResi.destroy();
 
+  delete [] m_pcSubstreamSyncContextStates;
+  m_pcSubstreamSyncContextStates = NULL;
+  m_numSubstreamSyncContextStates = 0;
+
   // free lambda and QP arrays
   m_vdRdPicLambda.clear();
   m_vdRdPicQp.clear();
@@ -80,6 +89,7 @@ Void TEncSlice::init( TEncTop* pcEncTop )
 {
   // 获取编码器配置
   m_pcCfg             = pcEncTop;
+  m_pcEncTop          = pcEncTop;
   m_pcListPic         = pcEncTop->getListPic();
 
   m_pcGOPEncoder      = pcEncTop->getGOPEncoder();
@@ -104,6 +114,23 @@ Void TEncSlice::init( TEncTop* pcEncTop )
   m_pcRateCtrl        = pcEncTop->getRateCtrl();
 }
 
+/** Initialise a slice encoder that compresses pictures concurrently with the slice encoder of TEncTop.
+ * The CTU coding engines are those of pcWorker; the entropy coder used for writing the slices is shared, as
+ * encodeSlice is only ever called on the slice encoder of TEncTop.
+ */
+Void TEncSlice::init( TEncTop* pcEncTop, TEncSliceWorker* pcWorker )
+{
+  init( pcEncTop );
+
+  m_pcCuEncoder       = pcWorker->getCuEncoder();
+  m_pcPredSearch      = pcWorker->getPredSearch();
+  m_pcEntropyCoder    = pcWorker->getEntropyCoder();
+  m_pcTrQuant         = pcWorker->getTrQuant();
+  m_pcRdCost          = pcWorker->getRdCost();
+  m_pppcRDSbacCoder   = pcWorker->getRDSbacCoder();
+  m_pcRDGoOnSbacCoder = pcWorker->getRDGoOnSbacCoder();
+}
+
 Void TEncSlice::updateLambda(TComSlice* pSlice, Double dQP)
 {
   Int iQP = (Int)dQP;
@@ -816,6 +843,13 @@ Void TEncSlice::compressSlice( TComPic* pcPic, const Bool bCompressEntireSlice,
     }
   }
 
+  // compress the tiles and WPP rows concurrently when possible; the result is identical to the loop below
+  if ( xCanCompressSubstreamsInParallel( pcPic, bCompressEntireSlice ) )
+  {
+    xCompressSubstreamsInParallel( pcPic, startCtuTsAddr, boundingCtuTsAddr, bFastDeltaQP );
+    return;
+  }
+
   // 遍历 Slice Segment 中的 CTU for every CTU in the slice segment (may terminate sooner if there is a byte limit on the slice-segment)
 
   for( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ++ctuTsAddr )
@@ -831,7 +865,15 @@ Void TEncSlice::compressSlice( TComPic* pcPic, const Bool bCompressEntireSlice,
     const UInt firstCtuRsAddrOfTile = pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(ctuRsAddr))->getFirstCtuRsAddr();
     const UInt tileXPosInCtus = firstCtuRsAddrOfTile % frameWidthInCtus;
     const UInt ctuXPosInCtus  = ctuRsAddr % frameWidthInCtus;
-    
+
+    // each substream (tile, or CTU row of a tile with WPP) starts the fast motion search afresh, as it does on a
+    // worker thread, so that the bitstream does not depend on the number of threads
+    if ( ( m_pcCfg->getEntropyCodingSyncEnabledFlag() || pcPic->getPicSym()->getNumTiles() > 1 ) &&
+         xIsFirstCtuOfSubstream( pcPic, ctuTsAddr, startCtuTsAddr ) )
+    {
+      m_pcPredSearch->resetIntegerMv2Nx2N();
+    }
+
     if (ctuRsAddr == firstCtuRsAddrOfTile)
     {
       m_pppcRDSbacCoder[0][CI_CURR_BEST]->resetEntropy(pcSlice);
@@ -1046,6 +1088,272 @@ Void TEncSlice::compressSlice( TComPic* pcPic, const Bool bCompressEntireSlice,
   //}
 }
 
+/** Check whether the substreams (WPP CTU rows and tiles) of the current slice segment can be compressed on
+ * the worker threads. Tools whose decisions depend on state shared across substreams (rate control, slice
+ * termination on a byte limit, adaptive QP selection and the luma-level lambda updates) keep the sequential loop,
+ * as does a picture that is itself being compressed on a worker thread.
+ */
+Bool TEncSlice::xCanCompressSubstreamsInParallel( TComPic* pcPic, const Bool bCompressEntireSlice )
+{
+  const TComSlice* pcSlice = pcPic->getSlice(getSliceIdx());
+
+  if ( !m_substreamsInParallelAllowed || m_pcEncTop->getThreadPool()->getNumThreads() < 2 )
+  {
+    return false;
+  }
+  if ( !m_pcCfg->getEntropyCodingSyncEnabledFlag() && pcPic->getPicSym()->getNumTiles() == 1 )
+  {
+    return false;
+  }
+  if ( m_pcCfg->getUseRateCtrl() || m_pcCfg->getLumaLevelToDeltaQPMapping().isEnabled() )
+  {
+    return false;
+  }
+#if JVET_V0078
+  if ( m_pcCfg->getSmoothQPReductionEnable() )
+  {
+    return false;
+  }
+#endif
+#if ADAPTIVE_QP_SELECTION
+  if ( m_pcCfg->getUseAdaptQpSelect() )
+  {
+    return false;
+  }
+#endif
+  if ( pcSlice->getSliceMode() == FIXED_NUMBER_OF_BYTES || ( !bCompressEntireSlice && pcSlice->getSliceSegmentMode() == FIXED_NUMBER_OF_BYTES ) )
+  {
+    return false;
+  }
+  return true;
+}
+
+/** Check whether a CTU is the first one of a substream of the slice segment starting at startCtuTsAddr,
+ * i.e. the first CTU of the segment, of a tile, or of a CTU row of a tile when WPP is enabled.
+ */
+Bool TEncSlice::xIsFirstCtuOfSubstream( TComPic* pcPic, const UInt ctuTsAddr, const UInt startCtuTsAddr )
+{
+  const TComPicSym* pcPicSym             = pcPic->getPicSym();
+  const UInt        frameWidthInCtus     = pcPicSym->getFrameWidthInCtus();
+  const UInt        ctuRsAddr            = pcPicSym->getCtuTsToRsAddrMap(ctuTsAddr);
+  const UInt        firstCtuRsAddrOfTile = pcPicSym->getTComTile(pcPicSym->getTileIdxMap(ctuRsAddr))->getFirstCtuRsAddr();
+
+  return ctuTsAddr == startCtuTsAddr || ctuRsAddr == firstCtuRsAddrOfTile ||
+         ( m_pcCfg->getEntropyCodingSyncEnabledFlag() && ctuRsAddr % frameWidthInCtus == firstCtuRsAddrOfTile % frameWidthInCtus );
+}
+
+/** Compress the substreams of a slice segment on the worker threads.
+ * A substream is the part of the slice segment in one tile, or in one CTU row of a tile when WPP is enabled.
+ * Tiles are independent; a CTU of a WPP row starts once the CTU above-right of it has been compressed, which is
+ * the same dependency the WPP context synchronisation imposes. The slice and picture statistics are accumulated
+ * afterwards in CTU order.
+ */
+Void TEncSlice::xCompressSubstreamsInParallel( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, const Bool bFastDeltaQP )
+{
+  TComSlice* const  pcSlice          = pcPic->getSlice(getSliceIdx());
+  TComPicSym* const pcPicSym         = pcPic->getPicSym();
+  TComThreadPool*   pcThreadPool     = m_pcEncTop->getThreadPool();
+
+  // split the slice segment into substreams
+  std::vector<UInt> substreamStartCtuTsAddr;
+  for ( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ctuTsAddr++ )
+  {
+    if ( xIsFirstCtuOfSubstream( pcPic, ctuTsAddr, startCtuTsAddr ) )
+    {
+      substreamStartCtuTsAddr.push_back( ctuTsAddr );
+    }
+  }
+  const UInt numSubstreams = UInt( substreamStartCtuTsAddr.size() );
+  substreamStartCtuTsAddr.push_back( boundingCtuTsAddr );
+
+  if ( numSubstreams > m_numSubstreamSyncContextStates )
+  {
+    delete [] m_pcSubstreamSyncContextStates;
+    m_pcSubstreamSyncContextStates    = new TEncSbac[numSubstreams];
+    m_numSubstreamSyncContextStates   = numSubstreams;
+  }
+
+  // a dependent slice segment starting after the second CTU of a row does not store the WPP state of that row:
+  // the next row uses the one stored by the preceding slice segment, as in the sequential loop
+  const Bool wavefrontsEnabled   = m_pcCfg->getEntropyCodingSyncEnabledFlag();
+  const UInt frameWidthInCtus    = pcPicSym->getFrameWidthInCtus();
+  const UInt startCtuRsAddr      = pcPicSym->getCtuTsToRsAddrMap(startCtuTsAddr);
+  const UInt startTileXPosInCtus = pcPicSym->getTComTile(pcPicSym->getTileIdxMap(startCtuRsAddr))->getFirstCtuRsAddr() % frameWidthInCtus;
+  if ( wavefrontsEnabled && startCtuRsAddr % frameWidthInCtus > startTileXPosInCtus + 1 )
+  {
+    m_pcSubstreamSyncContextStates[0].loadContexts( &m_entropyCodingSyncContextState );
+  }
+
+  for ( Int threadIdx = 0; threadIdx < pcThreadPool->getNumThreads(); threadIdx++ )
+  {
+    m_pcEncTop->getSliceWorker(threadIdx)->initSlice( m_pcRdCost, m_pcTrQuant, m_pcPredSearch, bFastDeltaQP );
+  }
+
+  // the CTUs are initialised up front, as a substream looks at the address and slice of the CTUs of its
+  // neighbouring substreams (to find out they are unavailable) while those may still be being compressed
+  for ( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ctuTsAddr++ )
+  {
+    const UInt ctuRsAddr = pcPicSym->getCtuTsToRsAddrMap(ctuTsAddr);
+    pcPic->getCtu( ctuRsAddr )->initCtu( pcPic, ctuRsAddr );
+  }
+
+  std::vector<Int> numWrittenBits( boundingCtuTsAddr - startCtuTsAddr, 0 );
+  m_substreamProgress.reset( numSubstreams );
+
+  // substreams are started in order, so a substream only ever waits for one that is already running
+  for ( UInt substreamIdx = 0; substreamIdx < numSubstreams; substreamIdx++ )
+  {
+    const UInt substreamStart = substreamStartCtuTsAddr[substreamIdx];
+    const UInt substreamEnd   = substreamStartCtuTsAddr[substreamIdx + 1];
+    pcThreadPool->addTask( [=, &numWrittenBits]( Int threadIdx )
+    {
+      xCompressSubstream( pcPic, substreamIdx, substreamStart, substreamEnd, startCtuTsAddr, boundingCtuTsAddr,
+                          m_pcEncTop->getSliceWorker(threadIdx), &numWrittenBits[0] );
+    } );
+  }
+  pcThreadPool->waitForAll();
+
+  // keep the WPP state of the last row stored, which a following dependent slice segment may continue from
+  if ( wavefrontsEnabled )
+  {
+    for ( Int substreamIdx = Int( numSubstreams ) - 1; substreamIdx >= 0; substreamIdx-- )
+    {
+      const UInt substreamStartRsAddr = pcPicSym->getCtuTsToRsAddrMap( substreamStartCtuTsAddr[substreamIdx] );
+      const UInt tileXPosInCtus       = pcPicSym->getTComTile(pcPicSym->getTileIdxMap(substreamStartRsAddr))->getFirstCtuRsAddr() % frameWidthInCtus;
+      const UInt substreamLength      = substreamStartCtuTsAddr[substreamIdx + 1] - substreamStartCtuTsAddr[substreamIdx];
+      if ( substreamStartRsAddr % frameWidthInCtus + substreamLength > tileXPosInCtus + 1 )
+      {
+        m_entropyCodingSyncContextState.loadContexts( &m_pcSubstreamSyncContextStates[substreamIdx] );
+        break;
+      }
+    }
+  }
+
+  for ( UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ctuTsAddr++ )
+  {
+    TComDataCU* pCtu = pcPic->getCtu( pcPicSym->getCtuTsToRsAddrMap(ctuTsAddr) );
+    const Int numberOfWrittenBits = numWrittenBits[ctuTsAddr - startCtuTsAddr];
+
+    pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + numberOfWrittenBits) );
+    pcSlice->setSliceSegmentBits(pcSlice->getSliceSegmentBits()+numberOfWrittenBits);
+
+    m_uiPicTotalBits += pCtu->getTotalBits();
+    m_dPicRdCost     += pCtu->getTotalCost();
+    m_uiPicDist      += pCtu->getTotalDistortion();
+  }
+
+  // store context state at the end of this slice-segment, in case the next slice is a dependent slice and continues using the CABAC contexts.
+  if( pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag() )
+  {
+    m_lastSliceSegmentEndContextState.loadContexts( m_pppcRDSbacCoder[0][CI_CURR_BEST] );//ctx end of dep.slice
+  }
+}
+
+/** Compress the CTUs of one substream of the slice segment with the coding engines of a worker thread.
+ * This follows the per-CTU steps of the sequential loop in compressSlice.
+ */
+Void TEncSlice::xCompressSubstream( TComPic* pcPic, const UInt substreamIdx, const UInt substreamStartCtuTsAddr, const UInt substreamEndCtuTsAddr,
+                                    const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, TEncSliceWorker* pcWorker, Int* numWrittenBits )
+{
+  TComSlice* const  pcSlice          = pcPic->getSlice(getSliceIdx());
+  TComPicSym* const pcPicSym         = pcPic->getPicSym();
+  const UInt        frameWidthInCtus = pcPicSym->getFrameWidthInCtus();
+
+  TEncCu*       pcCuEncoder       = pcWorker->getCuEncoder();
+  TEncEntropy*  pcEntropyCoder    = pcWorker->getEntropyCoder();
+  TEncSbac*     pcRDSbacCoder     = pcWorker->getRDSbacCoder()[0][CI_CURR_BEST];
+  TEncSbac*     pcRDGoOnSbacCoder = pcWorker->getRDGoOnSbacCoder();
+  TEncBinCABAC* pRDSbacBinCoder   = (TEncBinCABAC *) pcRDSbacCoder->getEncBinIf();
+  TComBitCounter &tempBitCounter  = *pcWorker->getBitCounter();
+
+  pcEntropyCoder->setEntropyCoder   ( pcRDSbacCoder );
+  pcEntropyCoder->resetEntropy      ( pcSlice );
+  if ( substreamStartCtuTsAddr == startCtuTsAddr )
+  {
+    // the first substream continues from the state set up for the start of the slice segment
+    pcRDSbacCoder->loadContexts( m_pppcRDSbacCoder[0][CI_CURR_BEST] );
+  }
+  pRDSbacBinCoder->setBinCountingEnableFlag( false );
+  pRDSbacBinCoder->setBinsCoded( 0 );
+  pcWorker->getPredSearch()->resetIntegerMv2Nx2N();
+
+  for( UInt ctuTsAddr = substreamStartCtuTsAddr; ctuTsAddr < substreamEndCtuTsAddr; ++ctuTsAddr )
+  {
+    const UInt ctuRsAddr = pcPicSym->getCtuTsToRsAddrMap(ctuTsAddr);
+    const TComTile *pCurrentTile    = pcPicSym->getTComTile(pcPicSym->getTileIdxMap(ctuRsAddr));
+    const UInt firstCtuRsAddrOfTile = pCurrentTile->getFirstCtuRsAddr();
+    const UInt tileXPosInCtus = firstCtuRsAddrOfTile % frameWidthInCtus;
+    const UInt ctuXPosInCtus  = ctuRsAddr % frameWidthInCtus;
+
+    // a WPP row waits for the CTU above-right of the current one (or the last CTU of the row above)
+    if ( m_pcCfg->getEntropyCodingSyncEnabledFlag() && substreamIdx > 0 && substreamStartCtuTsAddr != pcPicSym->getCtuRsToTsAddrMap(firstCtuRsAddrOfTile) )
+    {
+      m_substreamProgress.wait( substreamIdx - 1, std::min( ctuXPosInCtus + 2, tileXPosInCtus + pCurrentTile->getTileWidthInCtus() ) );
+    }
+
+    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr ); // already initialised by xCompressSubstreamsInParallel
+
+    // update CABAC state
+    if (ctuRsAddr == firstCtuRsAddrOfTile)
+    {
+      pcRDSbacCoder->resetEntropy(pcSlice);
+    }
+    else if ( ctuXPosInCtus == tileXPosInCtus && m_pcCfg->getEntropyCodingSyncEnabledFlag())
+    {
+      // reset and then update contexts to the state at the end of the top-right CTU (if within current slice and tile).
+      pcRDSbacCoder->resetEntropy(pcSlice);
+      TComDataCU *pCtuUp = pCtu->getCtuAbove();
+      if ( pCtuUp && ((ctuRsAddr%frameWidthInCtus+1) < frameWidthInCtus)  )
+      {
+        TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
+        if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
+        {
+          // the first substream of a dependent slice segment continues from the state of the preceding segment
+          pcRDSbacCoder->loadContexts( substreamIdx == 0 ? &m_entropyCodingSyncContextState : &m_pcSubstreamSyncContextStates[substreamIdx - 1] );
+        }
+      }
+    }
+
+    pcEntropyCoder->setEntropyCoder ( pcRDGoOnSbacCoder );
+    pcEntropyCoder->setBitstream( &tempBitCounter );
+    tempBitCounter.resetBits();
+    pcRDGoOnSbacCoder->load( pcRDSbacCoder );
+
+    ((TEncBinCABAC*)pcRDGoOnSbacCoder->getEncBinIf())->setBinCountingEnableFlag(true);
+
+    pcCuEncoder->compressCtu( pCtu );
+
+    pcEntropyCoder->setEntropyCoder ( pcRDSbacCoder );
+    pcEntropyCoder->setBitstream( &tempBitCounter );
+    pRDSbacBinCoder->setBinCountingEnableFlag( true );
+    pcRDSbacCoder->resetBits();
+    pRDSbacBinCoder->setBinsCoded( 0 );
+
+    pcCuEncoder->encodeCtu( pCtu );
+
+    pRDSbacBinCoder->setBinCountingEnableFlag( false );
+
+    numWrittenBits[ctuTsAddr - startCtuTsAddr] = pcEntropyCoder->getNumberOfWrittenBits();
+
+    // Store probabilities of second CTU in line into buffer - used only if wavefront-parallel-processing is enabled.
+    if ( ctuXPosInCtus == tileXPosInCtus+1 && m_pcCfg->getEntropyCodingSyncEnabledFlag())
+    {
+      m_pcSubstreamSyncContextStates[substreamIdx].loadContexts( pcRDSbacCoder );
+    }
+
+    m_substreamProgress.set( substreamIdx, ctuXPosInCtus + 1 );
+  }
+
+  if ( substreamEndCtuTsAddr == boundingCtuTsAddr )
+  {
+    // hand the state at the end of the slice segment back to the shared coder (used for dependent slices)
+    m_pppcRDSbacCoder[0][CI_CURR_BEST]->loadContexts( pcRDSbacCoder );
+  }
+
+  pcRDSbacCoder->setBitstream(NULL);
+  pcRDGoOnSbacCoder->setBitstream(NULL);
+}
+
 Void TEncSlice::encodeSlice   ( TComPic* pcPic, TComOutputBitstream* pcSubstreams, UInt &numBinsCoded )
 {
   TComSlice *const pcSlice           = pcPic->getSlice(getSliceIdx());
@@ -43,6 +43,7 @@
 #include "TLibCommon/TComList.h"
 #include "TLibCommon/TComPic.h"
 #include "TLibCommon/TComPicYuv.h"
+#include "TLibCommon/TComThreadPool.h"
 #include "TEncCu.h"
 #include "WeightPredAnalysis.h"
 #include "TEncRateCtrl.h"
@@ -52,6 +53,7 @@
 
 class TEncTop;
 class TEncGOP;
+class TEncSliceWorker;
 
 // ====================================================================================================================
 // Class definition
@@ -64,6 +66,7 @@ class TEncSlice
 private:
   // encoder configuration
   TEncCfg*                m_pcCfg;                              ///< encoder configuration class
+  TEncTop*                m_pcEncTop;                           ///< encoder (owner of the worker threads)
 
   // pictures
   TComList<TComPic*>*     m_pcListPic;                          ///< list of pictures
@@ -97,6 +100,10 @@ private:
   UInt                    m_uiSliceIdx;
   TEncSbac                m_lastSliceSegmentEndContextState;    ///< context storage for state at the end of the previous slice-segment (used for dependent slices only).
   TEncSbac                m_entropyCodingSyncContextState;      ///< context storate for state of contexts at the wavefront/WPP/entropy-coding-sync second CTU of tile-row
+  TEncSbac*               m_pcSubstreamSyncContextStates;       ///< per substream copy of m_entropyCodingSyncContextState, used when substreams are compressed in parallel
+  UInt                    m_numSubstreamSyncContextStates;
+  TComRowProgress         m_substreamProgress;                  ///< horizontal position reached by each substream of the slice segment
+  Bool                    m_substreamsInParallelAllowed;        ///< false while the slice is compressed on a worker thread itself
   SliceType               m_encCABACTableIdx;
   Int                     m_gopID;
 
@@ -111,6 +118,7 @@ public:
   Void    create              ( Int iWidth, Int iHeight, ChromaFormat chromaFormat, UInt iMaxCUWidth, UInt iMaxCUHeight, UChar uhTotalDepth );
   Void    destroy             ();
   Void    init                ( TEncTop* pcEncTop );
+  Void    init                ( TEncTop* pcEncTop, TEncSliceWorker* pcWorker );     ///< compress with the coding engines of pcWorker
   Void    resetEncoderDecisions() { m_encCABACTableIdx = I_SLICE; }
 
   /// preparation of slice encoding (reference marking, QP and lambda)
@@ -136,9 +144,17 @@ public:
   Void    setSliceIdx(UInt i)   { m_uiSliceIdx = i;                       }
 
   SliceType getEncCABACTableIdx() const           { return m_encCABACTableIdx;        }
+  Void    setSubstreamsInParallelAllowed( Bool b ) { m_substreamsInParallelAllowed = b; }
 
 private:
   Double  xGetQPValueAccordingToLambda ( Double lambda );
+
+  // parallel compression of the substreams (tiles and WPP CTU rows) of a slice segment
+  Bool    xCanCompressSubstreamsInParallel( TComPic* pcPic, const Bool bCompressEntireSlice );
+  Bool    xIsFirstCtuOfSubstream          ( TComPic* pcPic, const UInt ctuTsAddr, const UInt startCtuTsAddr );
+  Void    xCompressSubstreamsInParallel   ( TComPic* pcPic, const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, const Bool bFastDeltaQP );
+  Void    xCompressSubstream              ( TComPic* pcPic, const UInt substreamIdx, const UInt substreamStartCtuTsAddr, const UInt substreamEndCtuTsAddr,
+                                            const UInt startCtuTsAddr, const UInt boundingCtuTsAddr, TEncSliceWorker* pcWorker, Int* numWrittenBits );
 };
 
 //! \}
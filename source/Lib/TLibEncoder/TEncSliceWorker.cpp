@@ -0,0 +1,183 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncSliceWorker.cpp
+    \brief    per-thread set of CTU coding engines used for parallel slice compression
+*/
+
+#include "TEncSliceWorker.h"
+#include "TEncTop.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+TEncSliceWorker::TEncSliceWorker()
+: m_pppcRDSbacCoder   ( NULL )
+, m_pppcBinCoderCABAC ( NULL )
+, m_uiMaxTotalCUDepth ( 0 )
+{
+  m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
+}
+
+TEncSliceWorker::~TEncSliceWorker()
+{
+  destroy();
+}
+
+Void TEncSliceWorker::create( UInt maxTotalCUDepth, UInt maxCUWidth, UInt maxCUHeight, ChromaFormat chromaFormat )
+{
+  m_uiMaxTotalCUDepth = maxTotalCUDepth;
+  m_cCuEncoder.create( maxTotalCUDepth, maxCUWidth, maxCUHeight, chromaFormat );
+
+  m_pppcRDSbacCoder = new TEncSbac** [m_uiMaxTotalCUDepth+1];
+#if FAST_BIT_EST
+  m_pppcBinCoderCABAC = new TEncBinCABACCounter** [m_uiMaxTotalCUDepth+1];
+#else
+  m_pppcBinCoderCABAC = new TEncBinCABAC** [m_uiMaxTotalCUDepth+1];
+#endif
+
+  for ( UInt uiDepth = 0; uiDepth < m_uiMaxTotalCUDepth+1; uiDepth++ )
+  {
+    m_pppcRDSbacCoder[uiDepth] = new TEncSbac* [CI_NUM];
+#if FAST_BIT_EST
+    m_pppcBinCoderCABAC[uiDepth] = new TEncBinCABACCounter* [CI_NUM];
+#else
+    m_pppcBinCoderCABAC[uiDepth] = new TEncBinCABAC* [CI_NUM];
+#endif
+
+    for ( Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++ )
+    {
+      m_pppcRDSbacCoder[uiDepth][iCIIdx] = new TEncSbac;
+#if FAST_BIT_EST
+      m_pppcBinCoderCABAC[uiDepth][iCIIdx] = new TEncBinCABACCounter;
+#else
+      m_pppcBinCoderCABAC[uiDepth][iCIIdx] = new TEncBinCABAC;
+#endif
+      m_pppcRDSbacCoder[uiDepth][iCIIdx]->init( m_pppcBinCoderCABAC[uiDepth][iCIIdx] );
+    }
+  }
+}
+
+Void TEncSliceWorker::destroy()
+{
+  if ( m_pppcRDSbacCoder == NULL )
+  {
+    return;
+  }
+
+  m_cCuEncoder.destroy();
+  m_cSearch.destroy();
+
+  for ( UInt uiDepth = 0; uiDepth < m_uiMaxTotalCUDepth+1; uiDepth++ )
+  {
+    for ( Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++ )
+    {
+      delete m_pppcRDSbacCoder[uiDepth][iCIIdx];
+      delete m_pppcBinCoderCABAC[uiDepth][iCIIdx];
+    }
+    delete [] m_pppcRDSbacCoder[uiDepth];
+    delete [] m_pppcBinCoderCABAC[uiDepth];
+  }
+  delete [] m_pppcRDSbacCoder;
+  delete [] m_pppcBinCoderCABAC;
+
+  m_pppcRDSbacCoder   = NULL;
+  m_pppcBinCoderCABAC = NULL;
+}
+
+Void TEncSliceWorker::init( TEncTop* pcEncTop, TComSPS &sps )
+{
+  m_cRdCost.init();
+  m_cRdCost.setCostMode( pcEncTop->getCostMode() );
+
+  m_cCuEncoder.init( pcEncTop, &m_cSearch, &m_cTrQuant, &m_cRdCost, &m_cEntropyCoder, pcEncTop->getBinCABAC(),
+                     m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder, pcEncTop->getRateCtrl() );
+  m_cCuEncoder.setSliceEncoder( pcEncTop->getSliceEncoder() );
+  m_cCuEncoder.setSplitClassifier( pcEncTop->getCuSplitClassifier() );
+
+  m_cTrQuant.init( 1 << pcEncTop->getQuadtreeTULog2MaxSize(),
+                   pcEncTop->getUseRDOQ(),
+                   pcEncTop->getUseRDOQTS(),
+                   pcEncTop->getUseSelectiveRDOQ(),
+                   true
+                  ,pcEncTop->getUseTransformSkipFast()
+#if ADAPTIVE_QP_SELECTION
+                  ,pcEncTop->getUseAdaptQpSelect()
+#endif
+                  );
+
+  // the scaling lists have already been set up in the SPS by TEncTop::xInitScalingLists
+  const Int maxLog2TrDynamicRange[MAX_NUM_CHANNEL_TYPE] =
+  {
+      sps.getMaxLog2TrDynamicRange(CHANNEL_TYPE_LUMA),
+      sps.getMaxLog2TrDynamicRange(CHANNEL_TYPE_CHROMA)
+  };
+  if ( pcEncTop->getUseScalingListId() == SCALING_LIST_OFF )
+  {
+    m_cTrQuant.setFlatScalingList( maxLog2TrDynamicRange, sps.getBitDepths() );
+    m_cTrQuant.setUseScalingList( false );
+  }
+  else
+  {
+    m_cTrQuant.setScalingList( &(sps.getScalingList()), maxLog2TrDynamicRange, sps.getBitDepths() );
+    m_cTrQuant.setUseScalingList( true );
+  }
+
+  m_cSearch.init( pcEncTop, &m_cTrQuant, pcEncTop->getSearchRange(), pcEncTop->getBipredSearchRange(), pcEncTop->getMotionEstimationSearchMethod(),
+                  pcEncTop->getMaxCUWidth(), pcEncTop->getMaxCUHeight(), pcEncTop->getMaxTotalCUDepth(),
+                  &m_cEntropyCoder, &m_cRdCost, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+}
+
+Void TEncSliceWorker::initSlice( const TComRdCost* pcRdCost, const TComTrQuant* pcTrQuant, const TEncSearch* pcSearch, Bool bFastDeltaQP )
+{
+  // the RD cost holds only plain parameters (lambdas, distortion weights, function pointers)
+  m_cRdCost = *pcRdCost;
+
+#if RDOQ_CHROMA_LAMBDA
+  m_cTrQuant.setLambdas( pcTrQuant->getLambdas() );
+#else
+  m_cTrQuant.setLambda( pcTrQuant->getLambda() );
+#endif
+
+  for ( Int iDir = 0; iDir < MAX_NUM_REF_LIST_ADAPT_SR; iDir++ )
+  {
+    for ( Int iRefIdx = 0; iRefIdx < MAX_IDX_ADAPT_SR; iRefIdx++ )
+    {
+      m_cSearch.setAdaptiveSearchRange( iDir, iRefIdx, pcSearch->getAdaptiveSearchRange( iDir, iRefIdx ) );
+    }
+  }
+
+  m_cCuEncoder.setFastDeltaQp( bFastDeltaQP );
+}
+
+//! \}
@@ -0,0 +1,109 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncSliceWorker.h
+    \brief    per-thread set of CTU coding engines used for parallel slice compression (header)
+*/
+
+#ifndef __TENCSLICEWORKER__
+#define __TENCSLICEWORKER__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComBitCounter.h"
+#include "TLibCommon/TComRdCost.h"
+#include "TLibCommon/TComTrQuant.h"
+
+#include "TEncCu.h"
+#include "TEncSearch.h"
+#include "TEncEntropy.h"
+#include "TEncSbac.h"
+
+class TEncTop;
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// private copy of everything TEncCu::compressCtu/encodeCtu modify, so that several CTUs can be compressed concurrently
+class TEncSliceWorker
+{
+private:
+  TEncCu                  m_cCuEncoder;
+  TEncSearch              m_cSearch;
+  TComTrQuant             m_cTrQuant;
+  TComRdCost              m_cRdCost;
+  TEncEntropy             m_cEntropyCoder;
+
+  TEncSbac***             m_pppcRDSbacCoder;
+  TEncSbac                m_cRDGoOnSbacCoder;
+#if FAST_BIT_EST
+  TEncBinCABACCounter***  m_pppcBinCoderCABAC;
+  TEncBinCABACCounter     m_cRDGoOnBinCoderCABAC;
+#else
+  TEncBinCABAC***         m_pppcBinCoderCABAC;
+  TEncBinCABAC            m_cRDGoOnBinCoderCABAC;
+#endif
+  TComBitCounter          m_cBitCounter;
+  UInt                    m_uiMaxTotalCUDepth;
+
+public:
+  TEncSliceWorker();
+  virtual ~TEncSliceWorker();
+
+  Void  create            ( UInt maxTotalCUDepth, UInt maxCUWidth, UInt maxCUHeight, ChromaFormat chromaFormat );
+  Void  destroy           ();
+  /// mirror the initialisation done by TEncTop::init for the shared coding engines
+  Void  init              ( TEncTop* pcEncTop, TComSPS &sps );
+  /// copy the slice-level state (lambdas, distortion weights, search ranges) from the coding engines of a slice encoder
+  Void  initSlice         ( const TComRdCost* pcRdCost, const TComTrQuant* pcTrQuant, const TEncSearch* pcSearch, Bool bFastDeltaQP );
+
+  TEncCu*                 getCuEncoder        () { return &m_cCuEncoder;        }
+  TEncSearch*             getPredSearch       () { return &m_cSearch;           }
+  TComTrQuant*            getTrQuant          () { return &m_cTrQuant;          }
+  TComRdCost*             getRdCost           () { return &m_cRdCost;           }
+  TEncEntropy*            getEntropyCoder     () { return &m_cEntropyCoder;     }
+  TEncSbac***             getRDSbacCoder      () { return m_pppcRDSbacCoder;    }
+  TEncSbac*               getRDGoOnSbacCoder  () { return &m_cRDGoOnSbacCoder;  }
+  TComBitCounter*         getBitCounter       () { return &m_cBitCounter;       }
+};
+
+//! \}
+
+#endif // __TENCSLICEWORKER__
@@ -91,69 +91,53 @@ const Double TEncTemporalFilter::s_refStrengths[3][2] =
 #endif
 
 TEncTemporalFilter::TEncTemporalFilter() :
-  m_FrameSkip(0),
   m_chromaFormatIDC(NUM_CHROMA_FORMAT),
   m_sourceWidth(0),
   m_sourceHeight(0),
   m_QP(0),
   m_GOPSize(0),
   m_framesToBeEncoded(0),
-  m_bClipInputVideoToRec709Range(false),
-  m_inputColourSpaceConvert(NUMBER_INPUT_COLOUR_SPACE_CONVERSIONS)
+  m_gopBasedTemporalFilterFutureReference(false),
+  m_threadPool(NULL)
 {}
 
-void TEncTemporalFilter::init(const Int frameSkip,
-                              const Int inputBitDepth[MAX_NUM_CHANNEL_TYPE],
-                              const Int MSBExtendedBitDepth[MAX_NUM_CHANNEL_TYPE],
-                              const Int internalBitDepth[MAX_NUM_CHANNEL_TYPE],
+void TEncTemporalFilter::init(const Int internalBitDepth[MAX_NUM_CHANNEL_TYPE],
                               const Int width,
                               const Int height,
-                              const Int *padding,
                               const Int frames,
-                              const Bool Rec709,
-                              const std::string &filename,
-                              const ChromaFormat inputChromaFormatIDC,
-                              const InputColourSpaceConversion colorSpaceConv,
+                              const ChromaFormat chromaFormatIDC,
                               const Int QP,
                               const Int GOPSize,
                               const std::map<Int, Double> &temporalFilterStrengths,
-                              const Bool gopBasedTemporalFilterFutureReference)
+                              const Bool gopBasedTemporalFilterFutureReference,
+                              TComThreadPool *threadPool)
 {
-  m_FrameSkip = frameSkip;
   for (Int i = 0; i < MAX_NUM_CHANNEL_TYPE; i++)
   {
-    m_inputBitDepth[i] = inputBitDepth[i];
-    m_MSBExtendedBitDepth[i] = MSBExtendedBitDepth[i];
     m_internalBitDepth[i] = internalBitDepth[i];
   }
 
   m_sourceWidth = width;
   m_sourceHeight = height;
-  for (Int i = 0; i < 2; i++)
-  {
-    m_sourcePadding[i] = padding[i];
-  }
   m_framesToBeEncoded = frames; // NOT USED.
-  m_bClipInputVideoToRec709Range = Rec709;
-  m_inputFileName = filename;
-  m_chromaFormatIDC = inputChromaFormatIDC;
-  m_inputColourSpaceConvert = colorSpaceConv;
+  m_chromaFormatIDC = chromaFormatIDC;
   m_QP = QP;
   m_GOPSize = GOPSize; // NOT USED.
   m_temporalFilterStrengths = temporalFilterStrengths;
   m_gopBasedTemporalFilterFutureReference = gopBasedTemporalFilterFutureReference;
+  m_threadPool = threadPool;
 }
 
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
 
-Bool TEncTemporalFilter::filter(TComPicYuv *orgPic, Int receivedPoc)
+Bool TEncTemporalFilter::filter(TComPicYuv *orgPic, Int receivedPoc, const TEncLookahead &lookahead)
 {
   Bool isFilterThisFrame = false;
   if (m_QP >= 17)  // disable filter for QP < 17
   {
-    for (map<Int, Double>::iterator it = m_temporalFilterStrengths.begin(); it != m_temporalFilterStrengths.end(); ++it)
+    for (std::map<Int, Double>::iterator it = m_temporalFilterStrengths.begin(); it != m_temporalFilterStrengths.end(); ++it)
     {
       Int filteredFrame = it->first;
       if (receivedPoc % filteredFrame == 0)
@@ -166,19 +150,13 @@ Bool TEncTemporalFilter::filter(TComPicYuv *orgPic, Int receivedPoc)
 
   if (isFilterThisFrame)
   {
-    Int offset = m_FrameSkip;
-    TVideoIOYuv yuvFrames;
-    yuvFrames.open(m_inputFileName, false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth);
-    yuvFrames.skipFrames(std::max(offset + receivedPoc - s_range, 0), m_sourceWidth - m_sourcePadding[0], m_sourceHeight - m_sourcePadding[1], m_chromaFormatIDC);
-
-
     std::deque<TemporalFilterSourcePicInfo> srcFrameInfo;
 
-    Int firstFrame = receivedPoc + offset - s_range;
-    Int lastFrame = receivedPoc + offset + s_range;
+    Int firstFrame = receivedPoc - s_range;
+    Int lastFrame = receivedPoc + s_range;
     if (!m_gopBasedTemporalFilterFutureReference)
     {
-      lastFrame = receivedPoc + offset - 1;
+      lastFrame = receivedPoc - 1;
     }
     Int origOffset = -s_range;
 
@@ -195,43 +173,49 @@ Bool TEncTemporalFilter::filter(TComPicYuv *orgPic, Int receivedPoc)
     subsampleLuma(origPadded, origSubsampled2);
     subsampleLuma(origSubsampled2, origSubsampled4);
 
-    // determine motion vectors
+    // collect the neighbouring pictures
+    std::vector<const TComPicYuv*> srcPicYuvs;
     for (Int poc = firstFrame; poc <= lastFrame; poc++)
     {
-      if (poc < 0)
-      {
-        origOffset++;
-        continue; // frame not available
-      }
-      else if (poc == offset + receivedPoc)
+      const TComPicYuv *srcPicYuv = lookahead.getPicYuvOrg(poc);
+      if (poc == receivedPoc)
       { // hop over frame that will be filtered
-        yuvFrames.skipFrames(1, m_sourceWidth - m_sourcePadding[0], m_sourceHeight - m_sourcePadding[1], m_chromaFormatIDC);
         origOffset++;
         continue;
       }
+      else if (srcPicYuv == NULL)
+      {
+        if (poc > receivedPoc)
+        {
+          return false; // end of input
+        }
+        origOffset++;
+        continue; // frame not available
+      }
       srcFrameInfo.push_back(TemporalFilterSourcePicInfo());
-      TemporalFilterSourcePicInfo &srcPic=srcFrameInfo.back();
+      srcFrameInfo.back().origOffset = origOffset;
+      srcPicYuvs.push_back(srcPicYuv);
+      origOffset++;
+    }
+
+    // determine motion vectors, independently for each neighbouring picture
+    runTasks(Int(srcFrameInfo.size()), [&](Int i)
+    {
+      TemporalFilterSourcePicInfo &srcPic=srcFrameInfo[i];
 
-      TComPicYuv     dummyPicBufferTO; // Only used temporary in yuvFrames.read
       srcPic.picBuffer.createWithoutCUInfo(m_sourceWidth, m_sourceHeight, m_chromaFormatIDC, true, s_padding, s_padding);
-      dummyPicBufferTO.createWithoutCUInfo(m_sourceWidth, m_sourceHeight, m_chromaFormatIDC, true, s_padding, s_padding);
-      if (!yuvFrames.read(&srcPic.picBuffer, &dummyPicBufferTO, m_inputColourSpaceConvert, m_sourcePadding, m_chromaFormatIDC, m_bClipInputVideoToRec709Range))
-      {
-        return false; // eof or read fail
-      }
+      srcPicYuvs[i]->copyToPic(&srcPic.picBuffer);
       srcPic.picBuffer.extendPicBorder();
       srcPic.mvs.allocate(m_sourceWidth / 4, m_sourceHeight / 4);
 
       motionEstimation(srcPic.mvs, origPadded, srcPic.picBuffer, origSubsampled2, origSubsampled4);
-      srcPic.origOffset = origOffset;
-      origOffset++;
-    }
+    });
 
     // filter
     TComPicYuv newOrgPic;
     newOrgPic.createWithoutCUInfo(m_sourceWidth, m_sourceHeight, m_chromaFormatIDC, true, s_padding, s_padding);
     Double overallStrength = -1.0;
-    for (map<Int, Double>::iterator it = m_temporalFilterStrengths.begin(); it != m_temporalFilterStrengths.end(); ++it)
+    for (std::map<Int, Double>::iterator it = m_temporalFilterStrengths.begin(); it != m_temporalFilterStrengths.end(); ++it)
     {
       Int frame = it->first;
       Double strength = it->second;
@@ -246,7 +230,6 @@ Bool TEncTemporalFilter::filter(TComPicYuv *orgPic, Int receivedPoc)
     // move filtered to orgPic
     newOrgPic.copyToPic(orgPic);
 
-    yuvFrames.close();
     return true;
   }
   return false;
@@ -646,11 +629,87 @@ Void TEncTemporalFilter::bilateralFilter(const TComPicYuv &orgPic,
 {
   const int numRefs = Int(srcFrameInfo.size());
   std::vector<TComPicYuv> correctedPics(numRefs);
-  for (Int i = 0; i < numRefs; i++)
+  runTasks(numRefs, [&](Int i)
   {
     correctedPics[i].createWithoutCUInfo( m_sourceWidth, m_sourceHeight, orgPic.getChromaFormat(), true, s_padding, s_padding );
     applyMotion(srcFrameInfo[i].mvs, srcFrameInfo[i].picBuffer, correctedPics[i]);
+  });
+
+  for(Int c=0; c< getNumberValidComponents(m_chromaFormatIDC); c++)
+  {
+    const ComponentID compID=(ComponentID)c;
+    const Int height = orgPic.getHeight(compID);
+#if JVET_V0056_MCTF
+    // the noise of a block is measured on its first line, so a task filters whole rows of blocks
+    const Int rowsPerTask = isLuma(compID) ? 8 : 4;
+#else
+    const Int rowsPerTask = 8;
+#endif
+    const std::vector<Double> weightLUT = getWeightLUT(compID);
+    runTasks((height + rowsPerTask - 1) / rowsPerTask, [&](Int task)
+    {
+      bilateralFilterRows(orgPic, srcFrameInfo, correctedPics, newOrgPic, compID, overallStrength, weightLUT,
+                          task * rowsPerTask, std::min(height, (task + 1) * rowsPerTask));
+    });
+  }
+}
+
+/** Table of the exponential term of the filter weight for each absolute sample difference,
+ *  with one table for each sigma scaling of JVET-V0056.
+ */
+std::vector<Double> TEncTemporalFilter::getWeightLUT(const ComponentID compID) const
+{
+  const Double lumaSigmaSq = (m_QP - s_sigmaZeroPoint) * (m_QP - s_sigmaZeroPoint) * s_sigmaMultiplier;
+  const Double chromaSigmaSq = 30 * 30;
+  const Double sigmaSq = isChroma(compID)? chromaSigmaSq : lumaSigmaSq;
+  const Pel maxSampleValue = (1<<m_internalBitDepth[toChannelType(compID)])-1;
+  const Double bitDepthDiffWeighting=1024.0 / (maxSampleValue+1);
+  const Int numValues = maxSampleValue + 1;
+
+#if JVET_V0056_MCTF
+  std::vector<Double> lut(4 * numValues);
+  for (Int k = 0; k < 4; k++)
+  {
+    // k = 2 * (noise >= 25) + (error >= 50)
+    Double sw = 1;
+    sw *= (k < 2) ? 1.3 : 0.8;
+    sw *= ((k & 1) == 0) ? 1.3 : 1;
+    for (Int absDiff = 0; absDiff < numValues; absDiff++)
+    {
+      Double diff = (Double)absDiff;
+      diff *= bitDepthDiffWeighting;
+      Double diffSq = diff * diff;
+      lut[k * numValues + absDiff] = exp(-diffSq / (2 * sw * sigmaSq));
+    }
+  }
+#else
+  std::vector<Double> lut(numValues);
+  for (Int absDiff = 0; absDiff < numValues; absDiff++)
+  {
+    Double diff = (Double)absDiff;
+    diff *= bitDepthDiffWeighting;
+    Double diffSq = diff * diff;
+    lut[absDiff] = exp(-diffSq / (2 * sigmaSq));
   }
+#endif
+  return lut;
+}
+
+Void TEncTemporalFilter::bilateralFilterRows(const TComPicYuv &orgPic,
+#if JVET_V0056_MCTF
+                                                   std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo,
+#else
+                                             const std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo,
+#endif
+                                             const std::vector<TComPicYuv> &correctedPics,
+                                                   TComPicYuv &newOrgPic,
+                                             const ComponentID compID,
+                                             const Double overallStrength,
+                                             const std::vector<Double> &weightLUT,
+                                             const Int startY,
+                                             const Int endY) const
+{
+  const int numRefs = Int(srcFrameInfo.size());
 
   Int refStrengthRow = 2;
   if (numRefs == s_range*2)
@@ -662,105 +721,123 @@ Void TEncTemporalFilter::bilateralFilter(const TComPicYuv &orgPic,
     refStrengthRow = 1;
   }
 
-  const Double lumaSigmaSq = (m_QP - s_sigmaZeroPoint) * (m_QP - s_sigmaZeroPoint) * s_sigmaMultiplier;
-  const Double chromaSigmaSq = 30 * 30;
-  
-  for(Int c=0; c< getNumberValidComponents(m_chromaFormatIDC); c++)
-  {
-    const ComponentID compID=(ComponentID)c;
-    const Int height = orgPic.getHeight(compID);
-    const Int width  = orgPic.getWidth(compID);
-    const Pel *srcPelRow = orgPic.getAddr(compID);
-    const Int srcStride = orgPic.getStride(compID);
-          Pel *dstPelRow = newOrgPic.getAddr(compID);
-    const Int dstStride = newOrgPic.getStride(compID);
-    const Double sigmaSq = isChroma(compID)? chromaSigmaSq : lumaSigmaSq;
-    const Double weightScaling = overallStrength * (isChroma(compID) ? s_chromaFactor : 0.4);
-    const Pel maxSampleValue = (1<<m_internalBitDepth[toChannelType(compID)])-1;
-    const Double bitDepthDiffWeighting=1024.0 / (maxSampleValue+1);
+  const Int width  = orgPic.getWidth(compID);
+  const Int srcStride = orgPic.getStride(compID);
+  const Pel *srcPelRow = orgPic.getAddr(compID) + startY * srcStride;
+  const Int dstStride = newOrgPic.getStride(compID);
+        Pel *dstPelRow = newOrgPic.getAddr(compID) + startY * dstStride;
+  const Double weightScaling = overallStrength * (isChroma(compID) ? s_chromaFactor : 0.4);
+  const Pel maxSampleValue = (1<<m_internalBitDepth[toChannelType(compID)])-1;
+  const Int numValues = maxSampleValue + 1;
 #if JVET_V0056_MCTF
-    const Int blkSize = isLuma(compID) ? 8 : 4;
+  const Int blkSize = isLuma(compID) ? 8 : 4;
 #endif
 
-    for (Int y = 0; y < height; y++, srcPelRow+=srcStride, dstPelRow+=dstStride)
+  // weight of each reference picture apart from the exponential term, and the table of that term
+  std::vector<Double> refWeights(numRefs);
+  std::vector<const Double*> refWeightLUTs(numRefs, &weightLUT[0]);
+#if !JVET_V0056_MCTF
+  for (Int i = 0; i < numRefs; i++)
+  {
+    const Int index = std::min(1, std::abs(srcFrameInfo[i].origOffset) - 1);
+    refWeights[i] = weightScaling * s_refStrengths[refStrengthRow][index];
+  }
+#endif
+
+  for (Int y = startY; y < endY; y++, srcPelRow+=srcStride, dstPelRow+=dstStride)
+  {
+    const Pel *srcPel=srcPelRow;
+          Pel *dstPel=dstPelRow;
+    for (Int x = 0; x < width; x++, srcPel++, dstPel++)
     {
-      const Pel *srcPel=srcPelRow;
-            Pel *dstPel=dstPelRow;
-      for (Int x = 0; x < width; x++, srcPel++, dstPel++)
-      {
-        const Int orgVal = (Int) *srcPel;
-        Double temporalWeightSum = 1.0;
-        Double newVal = (Double) orgVal;
+      const Int orgVal = (Int) *srcPel;
+      Double temporalWeightSum = 1.0;
+      Double newVal = (Double) orgVal;
 #if JVET_V0056_MCTF
-        if ((y % blkSize == 0) && (x % blkSize == 0))
+      if ((y % blkSize == 0) && (x % blkSize == 0))
+      {
+        for (Int i = 0; i < numRefs; i++)
         {
-          for (Int i = 0; i < numRefs; i++)
+          Double variance = 0, diffsum = 0;
+          for (Int y1 = 0; y1 < blkSize - 1; y1++)
           {
-            Double variance = 0, diffsum = 0;
-            for (Int y1 = 0; y1 < blkSize - 1; y1++)
+            for (Int x1 = 0; x1 < blkSize - 1; x1++)
             {
-              for (Int x1 = 0; x1 < blkSize - 1; x1++)
-              {
-                Int pix  = *(srcPel + x1);
-                Int pixR = *(srcPel + x1 + 1);
-                Int pixD = *(srcPel + x1 + srcStride);
-                Int ref  = *(correctedPics[i].getAddr(compID) + ((y + y1) * correctedPics[i].getStride(compID) + x + x1));
-                Int refR = *(correctedPics[i].getAddr(compID) + ((y + y1) * correctedPics[i].getStride(compID) + x + x1 + 1));
-                Int refD = *(correctedPics[i].getAddr(compID) + ((y + y1 + 1) * correctedPics[i].getStride(compID) + x + x1));
-
-                Int diff  = pix  - ref;
-                Int diffR = pixR - refR;
-                Int diffD = pixD - refD;
-
-                variance += diff * diff;
-                diffsum  += (diffR - diff) * (diffR - diff);
-                diffsum  += (diffD - diff) * (diffD - diff);
-              }
+              Int pix  = *(srcPel + x1);
+              Int pixR = *(srcPel + x1 + 1);
+              Int pixD = *(srcPel + x1 + srcStride);
+              Int ref  = *(correctedPics[i].getAddr(compID) + ((y + y1) * correctedPics[i].getStride(compID) + x + x1));
+              Int refR = *(correctedPics[i].getAddr(compID) + ((y + y1) * correctedPics[i].getStride(compID) + x + x1 + 1));
+              Int refD = *(correctedPics[i].getAddr(compID) + ((y + y1 + 1) * correctedPics[i].getStride(compID) + x + x1));
+
+              Int diff  = pix  - ref;
+              Int diffR = pixR - refR;
+              Int diffD = pixD - refD;
+
+              variance += diff * diff;
+              diffsum  += (diffR - diff) * (diffR - diff);
+              diffsum  += (diffD - diff) * (diffD - diff);
             }
-            srcFrameInfo[i].mvs.get(x / blkSize, y / blkSize).noise = (int) round((300 * variance + 50) / (10 * diffsum + 50));
           }
+          srcFrameInfo[i].mvs.get(x / blkSize, y / blkSize).noise = (int) round((300 * variance + 50) / (10 * diffsum + 50));
         }
+      }
 
+      if (x % blkSize == 0)
+      {
         Double minError = 9999999;
         for (Int i = 0; i < numRefs; i++)
         {
           minError = std::min(minError, (Double) srcFrameInfo[i].mvs.get(x / blkSize, y / blkSize).error);
         }
-#endif
         for (Int i = 0; i < numRefs; i++)
         {
-#if JVET_V0056_MCTF
           const Int error = srcFrameInfo[i].mvs.get(x / blkSize, y / blkSize).error;
           const Int noise = srcFrameInfo[i].mvs.get(x / blkSize, y / blkSize).noise;
-#endif
-          const Pel *pCorrectedPelPtr=correctedPics[i].getAddr(compID)+(y*correctedPics[i].getStride(compID)+x);
-          const Int refVal = (Int) *pCorrectedPelPtr;
-          Double diff = (Double)(refVal - orgVal);
-          diff *= bitDepthDiffWeighting;
-          Double diffSq = diff * diff;
-#if JVET_V0056_MCTF
           const Int index = std::min(3, std::abs(srcFrameInfo[i].origOffset) - 1);
-          Double ww = 1, sw = 1;
+          Double ww = 1;
           ww *= (noise < 25) ? 1 : 1.2;
-          sw *= (noise < 25) ? 1.3 : 0.8;
           ww *= (error < 50) ? 1.2 : ((error > 100) ? 0.8 : 1);
-          sw *= (error < 50) ? 1.3 : 1;
           ww *= ((minError + 1) / (error + 1));
-          const Double weight = weightScaling * s_refStrengths[refStrengthRow][index] * ww * exp(-diffSq / (2 * sw * sigmaSq));
-#else
-          const Int index = std::min(1, std::abs(srcFrameInfo[i].origOffset) - 1);
-          const Double weight = weightScaling * s_refStrengths[refStrengthRow][index] * exp(-diffSq / (2 * sigmaSq));
-#endif
-          newVal += weight * refVal;
-          temporalWeightSum += weight;
+          refWeights[i] = weightScaling * s_refStrengths[refStrengthRow][index] * ww;
+          refWeightLUTs[i] = &weightLUT[(2 * (noise < 25 ? 0 : 1) + (error < 50 ? 0 : 1)) * numValues];
         }
-        newVal /= temporalWeightSum;
-        Pel sampleVal = (Pel)round(newVal);
-        sampleVal=(sampleVal<0?0 : (sampleVal>maxSampleValue ? maxSampleValue : sampleVal));
-        *dstPel = sampleVal;
       }
+#endif
+      for (Int i = 0; i < numRefs; i++)
+      {
+        const Pel *pCorrectedPelPtr=correctedPics[i].getAddr(compID)+(y*correctedPics[i].getStride(compID)+x);
+        const Int refVal = (Int) *pCorrectedPelPtr;
+        const Double weight = refWeights[i] * refWeightLUTs[i][std::abs(refVal - orgVal)];
+        newVal += weight * refVal;
+        temporalWeightSum += weight;
+      }
+      newVal /= temporalWeightSum;
+      Pel sampleVal = (Pel)round(newVal);
+      sampleVal=(sampleVal<0?0 : (sampleVal>maxSampleValue ? maxSampleValue : sampleVal));
+      *dstPel = sampleVal;
     }
   }
 }
 
+Void TEncTemporalFilter::runTasks(const Int numTasks, const std::function<Void(Int)> &task) const
+{
+  if (m_threadPool == NULL || m_threadPool->getNumThreads() < 2 || numTasks < 2)
+  {
+    for (Int i = 0; i < numTasks; i++)
+    {
+      task(i);
+    }
+    return;
+  }
+  for (Int i = 0; i < numTasks; i++)
+  {
+    m_threadPool->addTask([&task, i](Int)
+    {
+      task(i);
+    });
+  }
+  m_threadPool->waitForAll();
+}
+
 //! \}
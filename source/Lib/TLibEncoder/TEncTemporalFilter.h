@@ -38,10 +38,13 @@
 #ifndef __TEMPORAL_FILTER__
 #define __TEMPORAL_FILTER__
 #include "TLibCommon/TComPicYuv.h"
-#include "Utilities/TVideoIOYuv.h"
+#include "TLibCommon/TComThreadPool.h"
+#include "TEncLookahead.h"
 #include <sstream>
 #include <map>
 #include <deque>
+#include <vector>
+#include <functional>
 
  //! \ingroup EncoderLib
  //! \{
@@ -107,23 +110,22 @@ public:
    TEncTemporalFilter();
   ~TEncTemporalFilter() {}
 
-  void init(const Int frameSkip,
-            const Int inputBitDepth[MAX_NUM_CHANNEL_TYPE],
-            const Int MSBExtendedBitDepth[MAX_NUM_CHANNEL_TYPE], const Int InternalBitDepth[MAX_NUM_CHANNEL_TYPE],
+  void init(const Int InternalBitDepth[MAX_NUM_CHANNEL_TYPE],
             const Int width,
             const Int height,
-            const Int *pad,
             const Int frames,
-            const Bool Rec709,
-            const std::string &filename,
-            const ChromaFormat inputChromaFormatIDC,
-            const InputColourSpaceConversion colorSpaceConv,
+            const ChromaFormat chromaFormatIDC,
             const Int qp,
             const Int GOPSize,
             const std::map<Int, Double> &temporalFilterStrengths,
-            const Bool gopBasedTemporalFilterFutureReference);
+            const Bool gopBasedTemporalFilterFutureReference,
+            TComThreadPool *threadPool = NULL);
 
-  Bool filter(TComPicYuv *orgPic, Int frame);
+  Int  getNumPastFrames() const   { return s_range; }
+  Int  getNumFutureFrames() const { return m_gopBasedTemporalFilterFutureReference ? s_range : 0; }
+
+  /// filters orgPic, the picture of the given frame index, with its neighbours taken from the lookahead buffer
+  Bool filter(TComPicYuv *orgPic, Int frame, const TEncLookahead &lookahead);
 
 private:
   // Private static member variables
@@ -141,10 +143,6 @@ private:
 #endif
 
   // Private member variables
-  Int m_FrameSkip;
-  std::string m_inputFileName;
-  Int m_inputBitDepth[MAX_NUM_CHANNEL_TYPE];
-  Int m_MSBExtendedBitDepth[MAX_NUM_CHANNEL_TYPE];
   Int m_internalBitDepth[MAX_NUM_CHANNEL_TYPE];
   ChromaFormat m_chromaFormatIDC;
   Int m_sourceWidth;
@@ -152,11 +150,9 @@ private:
   Int m_QP;
   Int m_GOPSize;
   std::map<Int, Double> m_temporalFilterStrengths;
-  Int m_sourcePadding[2];
   Int m_framesToBeEncoded;
-  Bool m_bClipInputVideoToRec709Range;
-  InputColourSpaceConversion m_inputColourSpaceConvert;
   Bool m_gopBasedTemporalFilterFutureReference;
+  TComThreadPool *m_threadPool;                   ///< runs the motion estimation of the neighbouring pictures and the filtering of block rows
 
   // Private functions
   Void subsampleLuma(const TComPicYuv &input, TComPicYuv &output, const Int factor = 2) const;
@@ -170,7 +166,15 @@ private:
 #else
   Void bilateralFilter(const TComPicYuv &orgPic, const std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo, TComPicYuv &newOrgPic, Double overallStrength) const;
 #endif
+  std::vector<Double> getWeightLUT(const ComponentID compID) const;
+#if JVET_V0056_MCTF
+  Void bilateralFilterRows(const TComPicYuv &orgPic, std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo, const std::vector<TComPicYuv> &correctedPics, TComPicYuv &newOrgPic,
+#else
+  Void bilateralFilterRows(const TComPicYuv &orgPic, const std::deque<TemporalFilterSourcePicInfo> &srcFrameInfo, const std::vector<TComPicYuv> &correctedPics, TComPicYuv &newOrgPic,
+#endif
+                           const ComponentID compID, const Double overallStrength, const std::vector<Double> &weightLUT, const Int startY, const Int endY) const;
   Void applyMotion(const Array2D<MotionVector> &mvs, const TComPicYuv &input, TComPicYuv &output) const;
+  Void runTasks(const Int numTasks, const std::function<Void(Int)> &task) const;
 }; // END CLASS DEFINITION TEncTemporalFilter
 
 //! \}
@@ -60,6 +60,9 @@ TEncTop::TEncTop() :
   m_uiNumAllPicCoded  =  0;
   m_pppcRDSbacCoder   =  NULL;
   m_pppcBinCoderCABAC =  NULL;
+  m_pcSliceWorkers    =  NULL;
+  m_pcPictureSliceEncoders = NULL;
+  m_pcPictureWorkers  =  NULL;
   m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
 #if ENC_DEC_TRACE
   if (g_hTrace == NULL)
@@ -92,13 +95,20 @@ Void TEncTop::create ()
   // initialize global variables
   initROM();
 
+  // besides the substreams and pictures compressed by the slice workers, the threads run the deblocking filter and
+  // SAO of a picture by CTU rows
+  if ( m_numThreads > 1 )
+  {
+    m_cThreadPool.create( m_numThreads );
+  }
+
   // create processing unit classes
   m_cGOPEncoder.        create( );
   m_cSliceEncoder.      create( getSourceWidth(), getSourceHeight(), m_chromaFormatIDC, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth );
   m_cCuEncoder.         create( m_maxTotalCUDepth, m_maxCUWidth, m_maxCUHeight, m_chromaFormatIDC );
   if (m_bUseSAO)
   {
-    m_cEncSAO.create( getSourceWidth(), getSourceHeight(), m_chromaFormatIDC, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth, m_log2SaoOffsetScale[CHANNEL_TYPE_LUMA], m_log2SaoOffsetScale[CHANNEL_TYPE_CHROMA] );
+    m_cEncSAO.create( getSourceWidth(), getSourceHeight(), m_chromaFormatIDC, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth, m_log2SaoOffsetScale[CHANNEL_TYPE_LUMA], m_log2SaoOffsetScale[CHANNEL_TYPE_CHROMA], &m_cThreadPool );
     m_cEncSAO.createEncData(getSaoCtuBoundary());
   }
 #if ADAPTIVE_QP_SELECTION
@@ -108,7 +118,7 @@ Void TEncTop::create ()
   }
 #endif
 
-  m_cLoopFilter.create( m_maxTotalCUDepth );
+  m_cLoopFilter.create( m_maxTotalCUDepth, &m_cThreadPool );
 
   if ( m_RCEnableRateControl )
   {
@@ -143,6 +153,29 @@ Void TEncTop::create ()
       m_pppcRDSbacCoder   [iDepth][iCIIdx]->init( m_pppcBinCoderCABAC [iDepth][iCIIdx] );
     }
   }
+
+  // independent pictures of a GOP are compressed concurrently, each with a slice encoder of its own
+  if ( m_numParallelPictures > 1 )
+  {
+    m_pcPictureSliceEncoders = new TEncSlice[m_numParallelPictures-1];
+    m_pcPictureWorkers       = new TEncSliceWorker[m_numParallelPictures-1];
+    for ( Int i = 0; i < m_numParallelPictures-1; i++ )
+    {
+      m_pcPictureSliceEncoders[i].create( getSourceWidth(), getSourceHeight(), m_chromaFormatIDC, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth );
+      m_pcPictureWorkers[i].create( m_maxTotalCUDepth, m_maxCUWidth, m_maxCUHeight, m_chromaFormatIDC );
+    }
+  }
+
+  // tiles, the CTU rows of a wavefront slice and independent pictures are compressed concurrently, each worker thread
+  // using its own coding engines
+  if ( m_numThreads > 1 && ( m_entropyCodingSyncEnabledFlag || m_iNumColumnsMinus1 > 0 || m_iNumRowsMinus1 > 0 || m_numParallelPictures > 1 ) )
+  {
+    m_pcSliceWorkers = new TEncSliceWorker[m_numThreads];
+    for ( Int i = 0; i < m_numThreads; i++ )
+    {
+      m_pcSliceWorkers[i].create( m_maxTotalCUDepth, m_maxCUWidth, m_maxCUHeight, m_chromaFormatIDC );
+    }
+  }
 }
 
 Void TEncTop::destroy ()
@@ -151,6 +184,7 @@ Void TEncTop::destroy ()
   m_cGOPEncoder.        destroy();
   m_cSliceEncoder.      destroy();
   m_cCuEncoder.         destroy();
+  m_cCuSplitClassifier. destroy();
   m_cEncSAO.            destroyEncData();
   m_cEncSAO.            destroy();
   m_cLoopFilter.        destroy();
@@ -175,6 +209,14 @@ Void TEncTop::destroy ()
   delete [] m_pppcRDSbacCoder;
   delete [] m_pppcBinCoderCABAC;
 
+  m_cThreadPool.destroy();
+  delete [] m_pcSliceWorkers;
+  m_pcSliceWorkers = NULL;
+  delete [] m_pcPictureSliceEncoders;
+  m_pcPictureSliceEncoders = NULL;
+  delete [] m_pcPictureWorkers;
+  m_pcPictureWorkers = NULL;
+
   // destroy ROM
   destroyROM();
 
@@ -194,6 +236,8 @@ Void TEncTop::init(Bool isFieldCoding)
     m_cRateCtrl.initHrdParam(sps0.getVuiParameters()->getHrdParameters(), m_iFrameRate, m_RCInitialCpbFullness);
   }
 
+  // re-select the distortion functions: the SIMD extension may have been restricted since construction
+  m_cRdCost.init();
   m_cRdCost.setCostMode(m_costMode);
 
   // initialize PPS
@@ -208,6 +252,11 @@ Void TEncTop::init(Bool isFieldCoding)
     xInitScalingLists(sps0, pps1);
   }
 
+  if ( !m_cCuSplitClassifier.init( m_cuSplitClassifier, m_cuSplitThresholdFileName, m_cuSplitStatsFileName ) )
+  {
+    exit(1);
+  }
+
   // initialize processing unit classes
   m_cGOPEncoder.  init( this );
   m_cSliceEncoder.init( this );
@@ -231,6 +280,20 @@ Void TEncTop::init(Bool isFieldCoding)
   // initialize encoder search class
   m_cSearch.init( this, &m_cTrQuant, m_iSearchRange, m_bipredSearchRange, m_motionEstimationSearchMethod, m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth, &m_cEntropyCoder, &m_cRdCost, getRDSbacCoder(), getRDGoOnSbacCoder() );
 
+  if ( m_pcSliceWorkers )
+  {
+    for ( Int i = 0; i < m_cThreadPool.getNumThreads(); i++ )
+    {
+      m_pcSliceWorkers[i].init( this, sps0 );
+    }
+  }
+  for ( Int i = 0; i < m_numParallelPictures-1; i++ )
+  {
+    m_pcPictureWorkers[i].init( this, sps0 );
+    m_pcPictureSliceEncoders[i].init( this, &m_pcPictureWorkers[i] );
+    m_pcPictureWorkers[i].getCuEncoder()->setSliceEncoder( &m_pcPictureSliceEncoders[i] );
+  }
+
   m_iMaxRefPicNum = 0;
 }
 
@@ -361,6 +424,10 @@ Void TEncTop::encode( Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvT
     {
       m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcPicCurr ) );
     }
+    if ( getPreMotionSearchEnabled() )
+    {
+      m_cPreanalyzer.xBuildMotionPyramid( dynamic_cast<TEncPic*>( pcPicCurr ) );
+    }
   }
 
   if ((m_iNumPicRcvd == 0) || (!flush && (m_iPOCLast != 0) && (m_iNumPicRcvd != m_iGOPSize) && (m_iGOPSize != 0)))
@@ -478,6 +545,10 @@ Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvTr
       {
         m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcField ) );
       }
+      if ( getPreMotionSearchEnabled() )
+      {
+        m_cPreanalyzer.xBuildMotionPyramid( dynamic_cast<TEncPic*>( pcField ) );
+      }
     }
 
     if ( m_iNumPicRcvd && ((flush&&fieldNum==1) || (m_iPOCLast/2)==0 || m_iNumPicRcvd==m_iGOPSize ) )
@@ -556,20 +627,21 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic, Int ppsId )
 
   if (rpcPic==0)
   {
-    if ( getUseAdaptiveQP() )
+    if ( getUseAdaptiveQP() || getPreMotionSearchEnabled() )
     {
+      const UInt uiMaxAQDepth = getUseAdaptiveQP() ? pps.getMaxCuDQPDepth() + 1 : 0;
       TEncPic* pcEPic = new TEncPic;
 #if REDUCED_ENCODER_MEMORY
 #if SHUTTER_INTERVAL_SEI_PROCESSING
-      pcEPic->create( sps, pps, pps.getMaxCuDQPDepth() + 1, getShutterFilterFlag() );
+      pcEPic->create( sps, pps, uiMaxAQDepth, getShutterFilterFlag() );
 #else
-      pcEPic->create( sps, pps, pps.getMaxCuDQPDepth()+1);
+      pcEPic->create( sps, pps, uiMaxAQDepth);
 #endif
 #else
 #if SHUTTER_INTERVAL_SEI_PROCESSING
-      pcEPic->create(sps, pps, pps.getMaxCuDQPDepth() + 1, false, getShutterFilterFlag() );
+      pcEPic->create(sps, pps, uiMaxAQDepth, false, getShutterFilterFlag() );
 #else
-      pcEPic->create( sps, pps, pps.getMaxCuDQPDepth()+1, false);
+      pcEPic->create( sps, pps, uiMaxAQDepth, false);
 #endif
 #endif
       rpcPic = pcEPic;
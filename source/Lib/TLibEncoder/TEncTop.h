@@ -44,6 +44,7 @@
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/TComLoopFilter.h"
 #include "TLibCommon/AccessUnit.h"
+#include "TLibCommon/TComThreadPool.h"
 
 #include "Utilities/TVideoIOYuv.h"
 
@@ -56,7 +57,9 @@
 #include "TEncSearch.h"
 #include "TEncSampleAdaptiveOffset.h"
 #include "TEncPreanalyzer.h"
+#include "TEncCuSplitClassifier.h"
 #include "TEncRateCtrl.h"
+#include "TEncSliceWorker.h"
 //! \ingroup TLibEncoder
 //! \{
 
@@ -93,6 +96,7 @@ private:
   TEncGOP                 m_cGOPEncoder;                  ///< GOP encoder
   TEncSlice               m_cSliceEncoder;                ///< slice encoder
   TEncCu                  m_cCuEncoder;                   ///< CU encoder
+  TEncCuSplitClassifier   m_cCuSplitClassifier;           ///< early CU split decisions, shared by the CU encoders
   // SPS
   ParameterSetMap<TComSPS> m_spsMap;                      ///< SPS. This is the base value. This is copied to TComPicSym
   ParameterSetMap<TComPPS> m_ppsMap;                      ///< PPS. This is the base value. This is copied to TComPicSym
@@ -113,6 +117,12 @@ private:
 
   TEncRateCtrl            m_cRateCtrl;                    ///< Rate control class
 
+  // parallel processing
+  TComThreadPool          m_cThreadPool;                  ///< worker threads for parallel CTU compression
+  TEncSliceWorker*        m_pcSliceWorkers;               ///< coding engines used by each worker thread
+  TEncSlice*              m_pcPictureSliceEncoders;       ///< slice encoders of the 2nd, 3rd, ... picture compressed concurrently
+  TEncSliceWorker*        m_pcPictureWorkers;             ///< coding engines of m_pcPictureSliceEncoders
+
 protected:
   Void  xGetNewPicBuffer  ( TComPic*& rpcPic, Int ppsId ); ///< get picture buffer which will be processed. If ppsId<0, then the ppsMap will be queried for the first match.
   Void  xInitVPS          (TComVPS &vps, const TComSPS &sps); ///< initialize VPS from encoder options
@@ -145,7 +155,9 @@ public:
   TEncSampleAdaptiveOffset* getSAO              () { return  &m_cEncSAO;              }
   TEncGOP*                getGOPEncoder         () { return  &m_cGOPEncoder;          }
   TEncSlice*              getSliceEncoder       () { return  &m_cSliceEncoder;        }
+  TEncPreanalyzer*        getPreanalyzer        () { return  &m_cPreanalyzer;         }
   TEncCu*                 getCuEncoder          () { return  &m_cCuEncoder;           }
+  TEncCuSplitClassifier*  getCuSplitClassifier  () { return  &m_cCuSplitClassifier;   }
   TEncEntropy*            getEntropyCoder       () { return  &m_cEntropyCoder;        }
   TEncCavlc*              getCavlcCoder         () { return  &m_cCavlcCoder;          }
   TEncSbac*               getSbacCoder          () { return  &m_cSbacCoder;           }
@@ -155,6 +167,10 @@ public:
   TEncSbac***             getRDSbacCoder        () { return  m_pppcRDSbacCoder;       }
   TEncSbac*               getRDGoOnSbacCoder    () { return  &m_cRDGoOnSbacCoder;     }
   TEncRateCtrl*           getRateCtrl           () { return &m_cRateCtrl;             }
+  TComThreadPool*         getThreadPool         () { return &m_cThreadPool;           }
+  TEncSliceWorker*        getSliceWorker        ( Int threadIdx ) { return &m_pcSliceWorkers[threadIdx]; }
+  /// slice encoder compressing the pictureIdx-th of the pictures compressed concurrently
+  TEncSlice*              getPictureSliceEncoder( Int pictureIdx ) { return pictureIdx == 0 ? &m_cSliceEncoder : &m_pcPictureSliceEncoders[pictureIdx-1]; }
   Void selectReferencePictureSet(TComSlice* slice, Int POCCurr, Int GOPid );
   Int getReferencePictureSetIdxForSOP(Int POCCurr, Int GOPid );
 
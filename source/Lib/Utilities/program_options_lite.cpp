@@ -586,8 +586,13 @@ namespace df
         error_reporter.error(filename) << "Failed to open config file\n";
         return;
       }
-      CfgStreamParser csp(filename, opts, error_reporter);
-      csp.scanStream(cfgstream);
+      parseConfigStream(opts, filename, cfgstream, error_reporter);
+    }
+
+    void parseConfigStream(Options& opts, const string& name, istream& in, ErrorReporter& error_reporter)
+    {
+      CfgStreamParser csp(name, opts, error_reporter);
+      csp.scanStream(in);
     }
 
   }
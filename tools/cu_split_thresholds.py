@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+#
+# Derives the thresholds of the encoder option CUSplitClassifier from CU statistics files written with
+# CUSplitStatsFile (encodings with CUSplitClassifier=0), and writes them in the format of CUSplitThresholdFile.
+#
+# For each slice class and log2 CU size, the early split threshold is the lowest variance above which the CUs whose
+# neighbours are all smaller have been split with at least the split precision; the early termination threshold is
+# the highest SATD below which the CUs without smaller neighbours have not been split with at least the termination
+# precision. Most of these CUs are not split anyway and a wrong termination costs more than a wrong split, hence the
+# higher default precision of the termination.
+#
+# usage: cu_split_thresholds.py [--split-precision P] [--terminate-precision P] [--min-samples N]
+#                               stats_file [stats_file ...] > thresholds.txt
+
+import argparse
+import collections
+import sys
+
+
+def threshold(samples, precision, min_samples):
+    """samples: (value, positive) sorted from the most to the least confident value; returns the last value up to
+    which the proportion of positives is at least precision, or None"""
+    best = None
+    positives = 0
+    for count, (value, positive) in enumerate(samples, 1):
+        positives += positive
+        if count >= min_samples and positives >= precision * count:
+            best = value
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--split-precision', type=float, default=0.95, help='minimum proportion of correct early splits')
+    parser.add_argument('--terminate-precision', type=float, default=0.995,
+                        help='minimum proportion of correct early terminations')
+    parser.add_argument('--min-samples', type=int, default=50, help='minimum number of CUs below a threshold')
+    parser.add_argument('stats', nargs='+', help='CUSplitStatsFile outputs')
+    args = parser.parse_args()
+
+    split_samples = collections.defaultdict(list)
+    terminate_samples = collections.defaultdict(list)
+    for name in args.stats:
+        with open(name) as f:
+            for line in f:
+                if line.startswith('#'):
+                    continue
+                fields = line.split()
+                key = (fields[0], int(fields[1]))
+                variance, satd = float(fields[2]), float(fields[3])
+                neighbours, min_size, max_size, split = (int(v) for v in fields[5:9])
+                if neighbours >= 2 and max_size < key[1]:
+                    split_samples[key].append((variance, split))
+                if neighbours >= 1 and min_size >= key[1]:
+                    terminate_samples[key].append((satd, 1 - split))
+
+    print('# slice log2Size splitVariance terminateSatd (precision %g, %g)' % (args.split_precision, args.terminate_precision))
+    for key in sorted(set(split_samples) | set(terminate_samples)):
+        split = threshold(sorted(split_samples[key], reverse=True), args.split_precision, args.min_samples)
+        terminate = threshold(sorted(terminate_samples[key]), args.terminate_precision, args.min_samples)
+        print('%s %d %s %s' % (key[0], key[1], 'none' if split is None else '%.4g' % split,
+                               'none' if terminate is None else '%.4g' % terminate))
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+#
+# Measures the speed and the coding efficiency of the encoder presets (option Preset) relative to the medium preset.
+#
+# Without --clips, a fixed set of synthetic 4:2:0 8-bit clips is generated deterministically in the work directory,
+# so that the results only depend on the encoder. A clip list file holds one clip per line:
+#   <name> <yuv file> <width> <height> <frame rate> <frames>
+#
+# Each clip is encoded at QP 22, 27, 32 and 37 with the intra and random access configurations of cfg/ and every
+# preset. The table reports the luma BD-rate against medium (cubic fit of the log rate over the PSNR, averaged over the
+# clips) and the encoder time relative to medium (process CPU time reported by the encoder, summed over all clips and
+# QPs).
+#
+# usage: preset_benchmark.py --encoder bin/.../TAppEncoder [--clips list] [--work dir] [-j jobs] [--latex]
+
+import argparse
+import math
+import os
+import random
+import re
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+PRESETS = ['ultrafast', 'superfast', 'veryfast', 'faster', 'fast', 'medium', 'slow', 'slower', 'veryslow', 'placebo']
+CONFIGS = {'intra': 'encoder_intra_main.cfg', 'randomaccess': 'encoder_randomaccess_main.cfg'}
+QPS = [22, 27, 32, 37]
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+# ====================================================================================================================
+# Synthetic clips
+# ====================================================================================================================
+
+def value_noise(width, height, cell, rng):
+    """bilinearly interpolated random lattice in [0, 1)"""
+    gw, gh = width // cell + 2, height // cell + 2
+    grid = [[rng.random() for _ in range(gw)] for _ in range(gh)]
+    plane = []
+    for y in range(height):
+        gy, fy = divmod(y, cell)
+        fy /= cell
+        row0, row1 = grid[gy], grid[gy + 1]
+        line = []
+        for x in range(width):
+            gx, fx = divmod(x, cell)
+            fx /= cell
+            top = row0[gx] + (row0[gx + 1] - row0[gx]) * fx
+            bottom = row1[gx] + (row1[gx + 1] - row1[gx]) * fx
+            line.append(top + (bottom - top) * fy)
+        plane.append(line)
+    return plane
+
+
+def texture(width, height, seed):
+    """multi-octave noise with a few edges, as a background larger than the clip"""
+    rng = random.Random(seed)
+    octaves = [(value_noise(width, height, cell, rng), weight) for cell, weight in ((64, 0.5), (16, 0.3), (4, 0.2))]
+    plane = []
+    for y in range(height):
+        line = []
+        for x in range(width):
+            v = sum(o[y][x] * w for o, w in octaves)
+            if (x // 48 + y // 40) % 5 == 0:
+                v = 0.35 * v + 0.6
+            line.append(int(16 + 219 * v))
+        plane.append(line)
+    return plane
+
+
+def write_clip(path, width, height, frames, seed, pan, objects):
+    """a background panning by pan samples per frame, objects (size, velocity) moving across it and temporal noise"""
+    rng = random.Random(seed)
+    margin = abs(pan[0]) * frames + 1, abs(pan[1]) * frames + 1
+    bw, bh = width + margin[0], height + margin[1]
+    background = texture(bw, bh, seed)
+    sprites = [(texture(size, size, seed + 1 + i), size, vx, vy, rng.randrange(width - size), rng.randrange(height - size))
+               for i, (size, vx, vy) in enumerate(objects)]
+    chroma = [bytes([128 + (i % 7) - 3 for i in range((width // 2) * (height // 2))]), bytes([128] * ((width // 2) * (height // 2)))]
+    with open(path, 'wb') as f:
+        for n in range(frames):
+            ox = n * pan[0] if pan[0] >= 0 else margin[0] - 1 + n * pan[0]
+            oy = n * pan[1] if pan[1] >= 0 else margin[1] - 1 + n * pan[1]
+            luma = [background[y + oy][ox:ox + width] for y in range(height)]
+            luma = [list(line) for line in luma]
+            for sprite, size, vx, vy, x0, y0 in sprites:
+                px = (x0 + n * vx) % (width - size)
+                py = (y0 + n * vy) % (height - size)
+                for y in range(size):
+                    luma[py + y][px:px + size] = sprite[y]
+            f.write(bytes(min(235, max(16, v + rng.randint(-2, 2))) for line in luma for v in line))
+            for plane in chroma:
+                f.write(plane)
+
+
+def synthetic_clips(work):
+    clips = [('pan', 416, 240, 30, 17, 1, (2, 1), [(48, 3, 1), (32, -2, 2)]),
+             ('objects', 416, 240, 30, 17, 2, (0, 0), [(64, 5, 0), (48, -3, -2), (32, 1, 4), (24, -6, 3)])]
+    result = []
+    for name, width, height, rate, frames, seed, pan, objects in clips:
+        path = os.path.join(work, name + '.yuv')
+        if not os.path.exists(path):
+            write_clip(path, width, height, frames, seed, pan, objects)
+        result.append((name, path, width, height, rate, frames))
+    return result
+
+
+# ====================================================================================================================
+# Encoding and BD-rate
+# ====================================================================================================================
+
+def encode(encoder, work, clip, config, preset, qp):
+    name, path, width, height, rate, frames = clip
+    tag = '%s_%s_%s_%d' % (name, config, preset, qp)
+    log = os.path.join(work, tag + '.log')
+    if not os.path.exists(log):
+        cmd = [encoder, '-c', os.path.join(REPO, 'cfg', CONFIGS[config]), '--Preset=' + preset,
+               '-i', path, '-wdt', str(width), '-hgt', str(height), '-fr', str(rate), '-f', str(frames), '-q', str(qp),
+               '--Level=4', '-b', os.path.join(work, tag + '.bin'), '-o', '']
+        output = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True).stdout
+        with open(log + '.tmp', 'w') as f:
+            f.write(output)
+        os.rename(log + '.tmp', log)
+    with open(log) as f:
+        text = f.read()
+    summary = re.search(r'SUMMARY -+\s+Total Frames.*\n\s+\d+\s+a\s+([\d.]+)\s+([\d.]+)', text)
+    time = re.search(r'Total Time:\s+([\d.]+)', text)
+    if not summary or not time:
+        sys.exit('encoding %s failed, see %s' % (tag, log))
+    return float(summary.group(1)), float(summary.group(2)), float(time.group(1))
+
+
+def cubic_fit(x, y):
+    """least squares cubic polynomial coefficients, lowest order first"""
+    n = 4
+    a = [[sum(xi ** (i + j) for xi in x) for j in range(n)] for i in range(n)]
+    b = [sum(yi * xi ** i for xi, yi in zip(x, y)) for i in range(n)]
+    for i in range(n):
+        p = max(range(i, n), key=lambda r: abs(a[r][i]))
+        a[i], a[p], b[i], b[p] = a[p], a[i], b[p], b[i]
+        for r in range(n):
+            if r != i:
+                f = a[r][i] / a[i][i]
+                a[r] = [u - f * v for u, v in zip(a[r], a[i])]
+                b[r] -= f * b[i]
+    return [b[i] / a[i][i] for i in range(n)]
+
+
+def bd_rate(anchor, test):
+    """anchor, test: lists of (rate, psnr); returns the average rate difference in percent"""
+    def integral(c, lo, hi):
+        return sum(c[i] * (hi ** (i + 1) - lo ** (i + 1)) / (i + 1) for i in range(4))
+    ca = cubic_fit([p for _, p in anchor], [math.log(r) for r, _ in anchor])
+    ct = cubic_fit([p for _, p in test], [math.log(r) for r, _ in test])
+    lo = max(min(p for _, p in anchor), min(p for _, p in test))
+    hi = min(max(p for _, p in anchor), max(p for _, p in test))
+    return (math.exp((integral(ct, lo, hi) - integral(ca, lo, hi)) / (hi - lo)) - 1) * 100
+
+
+# ====================================================================================================================
+# Main
+# ====================================================================================================================
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--encoder', required=True, help='TAppEncoder executable')
+    parser.add_argument('--clips', help='clip list file (default: synthetic clips)')
+    parser.add_argument('--work', default='preset_benchmark', help='directory of the clips, bitstreams and logs')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(), help='number of concurrent encodings')
+    parser.add_argument('--latex', action='store_true', help='print the table as LaTeX rows')
+    args = parser.parse_args()
+
+    os.makedirs(args.work, exist_ok=True)
+    if args.clips:
+        with open(args.clips) as f:
+            clips = [(v[0], v[1], int(v[2]), int(v[3]), int(v[4]), int(v[5]))
+                     for v in (line.split() for line in f) if v and not v[0].startswith('#')]
+    else:
+        clips = synthetic_clips(args.work)
+
+    # the presets of a clip and QP run next to each other, so that slow changes of the machine load affect all alike
+    runs = [(clip, config, preset, qp) for config in CONFIGS for clip in clips for qp in QPS for preset in PRESETS]
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        results = dict(zip(((c[0], config, preset, qp) for c, config, preset, qp in runs),
+                           pool.map(lambda r: encode(args.encoder, args.work, *r), runs)))
+
+    if args.latex:
+        print('% preset & ' + ' & '.join('%s BD-rate & %s time' % (c, c) for c in CONFIGS) + ' \\\\')
+    else:
+        print('%-10s' % 'preset' + ''.join('  %12s BD-rate %4s time' % (c, c[:4]) for c in CONFIGS))
+    for preset in PRESETS:
+        cells = []
+        for config in CONFIGS:
+            rates = [bd_rate([results[(c[0], config, 'medium', qp)][:2] for qp in QPS],
+                             [results[(c[0], config, preset, qp)][:2] for qp in QPS]) for c in clips]
+            time = sum(results[(c[0], config, preset, qp)][2] for c in clips for qp in QPS)
+            anchor = sum(results[(c[0], config, 'medium', qp)][2] for c in clips for qp in QPS)
+            cells.append((sum(rates) / len(rates), 100 * time / anchor))
+        if args.latex:
+            print('%s & ' % preset + ' & '.join('%+.1f\\%% & %.0f\\%%' % cell for cell in cells) + ' \\\\')
+        else:
+            print('%-10s' % preset + ''.join('  %19.1f%% %8.0f%%' % cell for cell in cells))
+
+
+if __name__ == '__main__':
+    sys.exit(main())